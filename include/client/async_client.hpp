@@ -0,0 +1,237 @@
+#ifndef ASYNC_CLIENT_HPP
+#define ASYNC_CLIENT_HPP
+#include <coroutine>
+#include <deque>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../include/common/net.hpp"
+#include "../include/common/protocol.hpp"
+#include "../include/common/task.hpp"
+
+class AsyncClient;
+
+/**
+ * @class IoContext
+ * @brief      AsyncClient.
+ *  poll()     ; ,
+ *   ,       
+ * ,         ,  .
+ */
+class IoContext {
+public:
+	IoContext();
+	~IoContext();
+	IoContext(const IoContext&) = delete;
+	IoContext& operator=(const IoContext&) = delete;
+	/**
+	 * @brief  ;      ,
+	 *  -  run()
+	 * @note ,   ,  
+	 */
+	void spawn(coro::Task<void> task);
+	/**
+	 * @brief  ,         stop()
+	 * @details   ,   ,    
+	 *     (   )
+	 */
+	void run();
+	/**
+	 * @brief  run()   
+	 */
+	void stop() { m_stopped = true; }
+	/**
+	 * @brief  
+	 */
+	size_t activeTasks() const { return m_activeTasks; }
+private:
+	friend class AsyncClient;
+	static coro::Detached runDetached(IoContext& context, coro::Task<void> task);
+	void attach(AsyncClient* client);
+	void detach(AsyncClient* client);
+	/**
+	 * @brief     
+	 */
+	void schedule(std::coroutine_handle<> handle) { m_ready.push_back(handle); }
+	/**
+	 * @brief  ,  ,   
+	 * @return true - -  
+	 */
+	bool resumeReady();
+
+	std::vector<AsyncClient*> m_clients; //   (nullptr -    )
+	std::vector<std::coroutine_handle<>> m_ready; // ,   
+	std::vector<pollfd> m_fds; //  poll  
+	std::vector<size_t> m_owners; //    m_clients    m_fds
+	size_t m_activeTasks = 0;
+	bool m_stopped = false;
+};
+
+/**
+ * @class AsyncClient
+ * @brief   :     IoContext.
+ *
+ *    :
+ * @code
+ * coro::Task<void> session(AsyncClient& client) {
+ *     const bool connected = co_await client.connect();
+ *     if (!connected) co_return;
+ *     auto reply = co_await client.request("hello");
+ * }
+ * @endcode
+ *     request()   
+ * :    sendmsg   ,  
+ *     ,    .
+ */
+class AsyncClient {
+public:
+	static constexpr size_t MAX_SEND_BATCH = 64; //    sendmsg/WSASend
+	static constexpr size_t RECEIVE_BUFFER_SIZE = 64 * 1024; //   recv
+
+	/**
+	 * @struct Reply
+	 * @brief  ;     .
+	 */
+	struct Reply {
+		protocol::MessageType type = protocol::MessageType::Text;
+		std::string payload;
+	};
+
+	/**
+	 * @class ConnectAwaiter
+	 * @brief co_await connect(): true -  .
+	 */
+	class ConnectAwaiter {
+	public:
+		explicit ConnectAwaiter(AsyncClient& client) : m_client(client) {}
+		bool await_ready();
+		void await_suspend(std::coroutine_handle<> handle);
+		bool await_resume() const { return m_result; }
+	private:
+		friend class AsyncClient;
+		AsyncClient& m_client;
+		std::coroutine_handle<> m_handle;
+		bool m_result = false;
+	};
+
+	/**
+	 * @class WriteAwaiter
+	 * @brief co_await write(): true -   .
+	 */
+	class WriteAwaiter {
+	public:
+		WriteAwaiter(AsyncClient& client, uint64_t target) : m_client(client), m_target(target) {}
+		bool await_ready();
+		void await_suspend(std::coroutine_handle<> handle);
+		bool await_resume() const { return m_result; }
+	private:
+		friend class AsyncClient;
+		AsyncClient& m_client;
+		uint64_t m_target; //      
+		std::coroutine_handle<> m_handle;
+		bool m_result = false;
+	};
+
+	/**
+	 * @class ReadAwaiter
+	 * @brief co_await readFrame()/request():    std::nullopt,
+	 *   .
+	 */
+	class ReadAwaiter {
+	public:
+		explicit ReadAwaiter(AsyncClient& client) : m_client(client) {}
+		bool await_ready();
+		void await_suspend(std::coroutine_handle<> handle);
+		std::optional<Reply> await_resume() { return std::move(m_result); }
+	private:
+		friend class AsyncClient;
+		AsyncClient& m_client;
+		std::coroutine_handle<> m_handle;
+		std::optional<Reply> m_result;
+	};
+
+	/**
+	 * @param context  ,     
+	 * @param serverAddr IP-  ( "127.0.0.1")
+	 * @param port  
+	 */
+	AsyncClient(IoContext& context, const std::string& serverAddr, uint16_t port);
+	/**
+	 * @note        
+	 */
+	~AsyncClient();
+	AsyncClient(const AsyncClient&) = delete;
+	AsyncClient& operator=(const AsyncClient&) = delete;
+
+	/**
+	 * @brief    
+	 */
+	[[nodiscard]] ConnectAwaiter connect() { return ConnectAwaiter(*this); }
+	/**
+	 * @brief      
+	 * @details       
+	 */
+	[[nodiscard]] WriteAwaiter write(const char* data, size_t size);
+	[[nodiscard]] WriteAwaiter write(const std::string& message) { return write(message.data(), message.size()); }
+	/**
+	 * @brief     
+	 */
+	[[nodiscard]] ReadAwaiter readFrame() { return ReadAwaiter(*this); }
+	/**
+	 * @brief       
+	 * @details  -  ,     :
+	 *       
+	 */
+	[[nodiscard]] ReadAwaiter request(const char* data, size_t size);
+	[[nodiscard]] ReadAwaiter request(const std::string& message) { return request(message.data(), message.size()); }
+	/**
+	 * @brief  ;    
+	 */
+	void close();
+	bool isConnected() const { return m_connected; }
+	/**
+	 * @brief ,  
+	 */
+	size_t pendingReads() const { return m_readers.size(); }
+private:
+	friend class IoContext;
+	/**
+	 * @brief           
+	 */
+	uint64_t enqueue(const char* data, size_t size);
+	/**
+	 * @brief     
+	 */
+	void flush();
+	/**
+	 * @brief  poll,    (0 -   )
+	 */
+	short pollEvents() const;
+	/**
+	 * @brief   poll:  , , 
+	 */
+	void onEvents(short revents);
+	void finishConnect();
+	void receive();
+	/**
+	 * @brief       
+	 */
+	void fail();
+
+	IoContext& m_context;
+	std::string m_serverAddr;
+	uint16_t m_port;
+	SOCKET m_socket = INVALID_SOCKET;
+	bool m_connected = false;
+	ConnectAwaiter* m_connecting = nullptr; //   connect()
+	protocol::FrameDecoder m_decoder; //  ,  TCP
+	buffers::Buffer m_receiveBuffer; //    recv
+	std::deque<buffers::Buffer> m_sendQueue; // ,     (    )
+	uint64_t m_queuedTotal = 0; //      
+	uint64_t m_writtenTotal = 0; //     
+	std::deque<WriteAwaiter*> m_writers; //  write()   
+	std::deque<ReadAwaiter*> m_readers; //     
+	std::deque<Reply> m_inbox; // ,     
+};
+#endif
@@ -5,31 +5,107 @@
 #include <vector>
 #include <future>
 #include <atomic>
+#include <thread>
+#include <functional>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
 #include <csignal>
 #include <chrono>
 #include <locale>
+#include <map>
+#include <set>
+#include <random>
+#include <unordered_map>
 
-#include <winsock2.h>
-#include <ws2tcpip.h>
-#include <windows.h>
-
-
-#pragma comment (lib, "ws2_32.lib")
+#include "../include/common/net.hpp"
+#include "../include/common/protocol.hpp"
+#include "../include/common/compression.hpp"
+#ifdef __linux__
+#include "../include/common/shm_ring.hpp"
+#endif
 /**
  * @class Client
  * @brief ,     .
  *   ,   .
+ *
+ *        
+ * ,      .    
+ * :    ,  Publish,   , 
+ *      (Server::replyInOrder);  
+ *     .    
+ *  .    
+ *          
+ *  .  -    : ,   
+ *    ,   .
+ *
+ *   (setCompression)      Hello;
+ *    ,       .
+ *     .
+ *
+ *  Linux        Unix- 
+ * ( "unix:PATH")       ( "shm:PATH", .
+ * shm::Channel): API  ,     
+ *   .
  */
 class Client {
 public:
 	/**
 	 * @brief        .
+	 * @details       
+	 */
+	using MessageCallback = std::function<void(const protocol::FrameView&)>;
+	/**
+	 * @brief   request().
+	 */
+	enum class RequestStatus {
+		Ok, //   (    Error  )
+		Timeout, //   
+		Cancelled, //   cancel()
+		Disconnected //        
+	};
+	/**
+	 * @struct Reply
+	 * @brief   ;     .
+	 */
+	struct Reply {
+		RequestStatus status = RequestStatus::Ok;
+		protocol::MessageType type = protocol::MessageType::Text;
+		std::string payload;
+	};
+	/**
+	 * @brief    ;    
+	 * @details  ,   ,  
+	 *    ,   cancel()
+	 */
+	using ReplyCallback = std::function<void(Reply&&)>;
+	/**
+	 * @struct Request
+	 * @brief   :    .
 	 */
-	using MessageCallback = std::function<void(const std::string&)>;
+	struct Request {
+		uint64_t id = 0; // 0 -    (  )
+		std::future<Reply> reply;
+	};
+	static constexpr std::chrono::milliseconds DEFAULT_REQUEST_TIMEOUT{ 5000 }; //    
+	/**
+	 * @struct ReconnectPolicy
+	 * @brief       .
+	 * @details    n   
+	 * [0, min(maxDelay, initialDelay * 2^n)]: ,  
+	 *  ( ),    
+	 */
+	struct ReconnectPolicy {
+		std::chrono::milliseconds connectTimeout{ 2000 }; //   
+		std::chrono::milliseconds initialDelay{ 50 }; //    
+		std::chrono::milliseconds maxDelay{ 5000 }; //   
+		int maxAttempts = 10; //   (0 -  )
+		size_t replayBytes = 1024 * 1024; //    (0 -   )
+	};
 	/**
 	 * @brief  
-	 * @param serverAddr IP-  ( "127.0.0.1")
-	 * @param port   (1-65535)
+	 * @param serverAddr IP-  ( "127.0.0.1"), "unix:PATH"  "shm:PATH"
+	 * @param port   (1-65535);     
 	 */
 	Client(const std::string& serverAddr, uint16_t port);
 	/**
@@ -40,21 +116,146 @@ public:
 	/**
 	 * @brief   
 	 * @return true -  , false - 
-	 * @note     (10 )
+	 * @note     ReconnectPolicy::connectTimeout;
+	 *    
 	 */
 	bool connectToServer();
 	/**
 	 * @brief   
-	 * @note    
+	 * @note     ,  ;
+	 *   ,    Disconnected.
+	 *     
 	 */
 	void disconnect();
+	/**
+	 * @brief        
+	 */
+	void setAutoReconnect(bool enable) { m_autoReconnect = enable; }
+	/**
+	 * @note   
+	 */
+	void setReconnectPolicy(const ReconnectPolicy& policy) { m_reconnectPolicy = policy; }
+	/**
+	 * @brief    (Hello   )
+	 * @note   
+	 */
+	void setCompression(const compression::Options& options) { m_compression = options; }
+	/**
+	 * @brief      
+	 */
+	bool compressing() const { return m_compressing; }
+	/**
+	 * @brief     (   ,  )
+	 */
+	size_t unacknowledged() const;
+	/**
+	 * @brief    :  
+	 *     (-1 -   )
+	 */
+	std::chrono::milliseconds lastRecovery() const { return std::chrono::milliseconds(m_lastRecovery.load()); }
+	static constexpr size_t DEFAULT_SEND_HIGH_WATER_MARK = 4 * 1024 * 1024; //    
+	static constexpr size_t MAX_SEND_BATCH = 64; //    sendmsg/WSASend
 	/**
 	 * @brief  
-	 * @param message  
-	 * @return true -  , false - 
-	 * @note      (  autoReconnect)
+	 * @param message   (   MessageType::Text)
+	 * @return true -   (    -
+	 *   ), false - 
+	 * @note      (  autoReconnect).
+	 *    , ,     . 
+	 *    ,     
+	 *     
 	 */
 	bool sendMessage(const std::string& message);
+	/**
+	 * @brief    (FLAG_CORRELATED):  
+	 *    ,      
+	 *    ,      
+	 * @param timeout  ;      Timeout
+	 * @return   ( cancel()), 0 -  
+	 * (    Disconnected)
+	 * @note    ;   - expireRequests()
+	 */
+	uint64_t request(const char* data, size_t size, ReplyCallback callback,
+		std::chrono::milliseconds timeout = DEFAULT_REQUEST_TIMEOUT);
+	/**
+	 * @brief     std::future
+	 */
+	Request request(const std::string& message, std::chrono::milliseconds timeout = DEFAULT_REQUEST_TIMEOUT);
+	/**
+	 * @brief  :   Cancelled,    
+	 * @return false -   
+	 */
+	bool cancel(uint64_t id);
+	/**
+	 * @brief   
+	 */
+	size_t outstandingRequests() const;
+	/**
+	 * @brief      (Timeout)
+	 * @return    , -1 -  
+	 */
+	int expireRequests();
+	/**
+	 * @brief   :     
+	 * @return   sendMessage;     Subscribe
+	 */
+	bool subscribe(const std::string& topic);
+	/**
+	 * @brief    (  Unsubscribe)
+	 */
+	bool unsubscribe(const std::string& topic);
+	/**
+	 * @brief    
+	 * @details    ,    
+	 */
+	bool publish(const std::string& topic, const std::string& message);
+	/**
+	 * @brief ,   
+	 */
+	void setUsername(const std::string& username) { m_username = username; }
+	/**
+	 * @brief       
+	 * @return false -      
+	 * @details      (startSending())
+	 *   writeQueued()/flush()
+	 */
+	bool queueMessage(const char* data, size_t size);
+	/**
+	 * @brief      type    
+	 * @param flags  ;    ,   
+	 * @return   queueMessage
+	 */
+	bool queueFrame(protocol::MessageType type, uint8_t flags, const char* data, size_t size);
+	/**
+	 * @brief      ,  
+	 * @return false -   ( )
+	 * @details      MAX_SEND_BATCH  ;
+	 *      
+	 */
+	bool writeQueued();
+	/**
+	 * @brief    ,     
+	 * @return  : true - , false -  
+	 * @note      ,   
+	 */
+	std::future<bool> flush();
+	/**
+	 * @brief    
+	 */
+	size_t queuedBytes() const;
+	/**
+	 * @brief      (0 -  )
+	 */
+	void setSendHighWaterMark(size_t bytes);
+	/**
+	 * @brief  ,   ; sendMessage()
+	 *      
+	 */
+	void startSending();
+	/**
+	 * @brief      
+	 */
+	void stopSending();
 	/**
 	 * @brief   
 	 * @return true -  , false - 
@@ -75,25 +276,207 @@ public:
 	/**
 	 * @brief  
 	 * @return true -  , false -  
-	 * @note   m_reconnectDelayMs  m_maxReconnectAttempts
+	 *   disconnect()
+	 * @note      ReconnectPolicy; 
+	 *    
 	 */
 	bool tryReconnect();
+	/**
+	 * @brief        
+	 * @note   startReceiving()
+	 */
+	void setMessageCallback(MessageCallback callback) { m_messageCallback = std::move(callback); }
+	/**
+	 * @brief   recv      
+	 * @return false -     
+	 * @details        
+	 * poll()  nativeHandle()      
+	 */
+	bool receiveOnce();
+	/**
+	 * @brief   poll/select:  ,    
+	 *   -  eventfd ( ,    
+	 *   receiveOnce(),  true)
+	 */
+	SOCKET nativeHandle() const { return m_pollHandle; }
 private:
 	/**
 	 * @brief     
-	 * @details   4096 ,  
+	 * @details  receiveOnce()  ,  
 	 */
 	void receiveMessages();
+	/**
+	 * @brief    ;     
+	 */
+	bool openConnection();
+	/**
+	 * @brief   ,   
+	 * @details        ( 
+	 *  ),      disconnect():
+	 *       ,   
+	 */
+	void dropConnection();
+	/**
+	 * @brief     (m_reconnectMutex )
+	 */
+	std::chrono::milliseconds backoffDelay(int attempt);
+	bool replayEnabled() const { return m_autoReconnect && m_reconnectPolicy.replayBytes > 0; }
+	/**
+	 * @brief      (m_sendMutex )
+	 * @details      
+	 */
+	void rememberFrame(const buffers::Buffer& frame, protocol::MessageType type);
+	/**
+	 * @brief      ,  
+	 */
+	void acknowledge();
+	/**
+	 * @brief        
+	 *  (m_sendMutex )
+	 */
+	void replayFrames();
+	/**
+	 * @brief  ,    
+	 */
+	void dispatch(const protocol::FrameView& frame);
+	/**
+	 * @brief  : ,       
+	 *  
+	 * @param correlated     correlation
+	 */
+	buffers::Buffer encodeFrame(protocol::MessageType type, const char* data, size_t size,
+		bool correlated = false, uint64_t correlation = 0) const;
+	/**
+	 * @brief      (  sendMessage   )
+	 * @param correlated  :     , 
+	 *  PendingRequest
+	 */
+	bool sendFrame(buffers::Buffer frame, protocol::MessageType type, bool correlated = false);
+	/**
+	 * @brief  ,     
+	 * @return false -     
+	 */
+	bool completeRequest(uint64_t id, Reply&& reply);
+	/**
+	 * @brief       (  )
+	 */
+	void failRequests(RequestStatus status);
+	/**
+	 * @struct PendingRequest
+	 * @brief         .
+	 */
+	struct PendingRequest {
+		ReplyCallback callback;
+		std::multimap<std::chrono::steady_clock::time_point, uint64_t>::iterator deadline;
+		buffers::Buffer frame; //      ( -  )
+	};
+	/**
+	 * @struct Unacked
+	 * @brief    .
+	 */
+	struct Unacked {
+		buffers::Buffer frame;
+		protocol::MessageType type;
+	};
+	static constexpr int RECEIVE_POLL_MS = 100; //       
+	/**
+	 * @brief     ,     
+	 */
+	bool queueEncoded(buffers::Buffer frame, protocol::MessageType type);
+	/**
+	 * @brief      (m_sendMutex )
+	 */
+	void pushFrame(buffers::Buffer frame);
+	/**
+	 * @brief    
+	 * @param wait      ( -   EWOULDBLOCK)
+	 */
+	bool drainSendQueue(bool wait);
+	/**
+	 * @brief  n       
+	 */
+	void completeSend(size_t bytes);
+	/**
+	 * @brief      flush()  false
+	 */
+	void failSendQueue();
+	/**
+	 * @brief   
+	 */
+	void sendLoop();
+#ifdef __linux__
+	/**
+	 * @brief    (  m_connectMutex)  nullptr
+	 * @details   ,     
+	 *  
+	 */
+	std::shared_ptr<shm::Channel> sharedChannel();
+	/**
+	 * @brief   ,    
+	 * @param[out] received    
+	 * @return false -      
+	 */
+	bool receiveRing(shm::Channel& channel, bool& received);
+	/**
+	 * @brief     :    ,
+	 *     shm::SPIN,    eventfd   waitMs
+	 */
+	void receiveShared(shm::Channel& channel, int waitMs);
+	/**
+	 * @brief        vectors
+	 * @param wait    futex  ( -  0)
+	 * @return  , SIZE_MAX -     
+	 */
+	size_t writeRing(shm::Channel& channel, const net::IoVec* vectors, size_t count, bool wait);
+#endif
 	std::string m_username; //   .
-	SOCKET m_socket = INVALID_SOCKET; //   .
+	SOCKET m_socket = INVALID_SOCKET; //    (  m_connectMutex;     -  ).
+	SOCKET m_pollHandle = INVALID_SOCKET; //   nativeHandle().
+#ifdef __linux__
+	std::shared_ptr<shm::Channel> m_shm; //   "shm:" (  m_drainMutex  m_connectMutex).
+#endif
 	std::string m_serverAddr; //  .
 	uint16_t m_port; //  .
 	std::atomic <bool> m_connected{ false }; // , ,     .
 	std::atomic <bool> m_receiving{ false }; // , ,     .
 	std::thread m_receiveThread; //     .
+	MessageCallback m_messageCallback; //   ( -   ).
+	protocol::FrameDecoder m_decoder; //  ,  TCP.
+	buffers::Buffer m_receiveBuffer; //    recv (   ).
+	mutable std::mutex m_sendMutex; //     .
+	std::mutex m_drainMutex; //       .
+	std::condition_variable m_sendReady; //   .
+	std::condition_variable m_sendSpace; //  ,    .
+	std::deque<buffers::Buffer> m_sendQueue; // ,     (    ).
+	size_t m_queuedBytes = 0; //   .
+	uint64_t m_queuedTotal = 0; //      .
+	uint64_t m_writtenTotal = 0; //     .
+	std::vector<std::pair<uint64_t, std::promise<bool>>> m_flushWaiters; //  flush():   .
+	size_t m_sendHighWaterMark = DEFAULT_SEND_HIGH_WATER_MARK; //   (0 -  ).
+	bool m_sendFailed = false; //     .
+	std::atomic<bool> m_sending{ false }; //    .
+	std::thread m_sendThread; //  .
 	std::atomic<bool> m_autoReconnect{ false }; // , ,    .
-	int m_reconnectDelayMs = 10000; //     ( ).
+	ReconnectPolicy m_reconnectPolicy; //     .
+	std::mutex m_connectMutex; //     .
+	std::mutex m_reconnectMutex; //    m_reconnecting (    ).
+	bool m_reconnecting = false; // -  ;     (m_reconnectMutex).
+	std::chrono::steady_clock::time_point m_lostAt; //    (m_connectMutex).
+	std::atomic<int64_t> m_lastRecovery{ -1 }; //     .
+	std::condition_variable m_reconnectWake; //     disconnect().
+	std::atomic<bool> m_closing{ false }; //  disconnect():  .
+	std::minstd_rand m_random{ std::random_device{}() }; //   (m_reconnectMutex).
+	std::deque<Unacked> m_unacked; //  :       (m_sendMutex).
+	size_t m_unackedBytes = 0; //    .
+	size_t m_droppedReplies = 0; // ,  ,    .
+	std::set<std::string> m_topics; // ,    (m_sendMutex).
+	compression::Options m_compression; //  .
+	std::atomic<bool> m_compressing{ false }; //      .
+	std::atomic<compression::Dictionary> m_dictionary{ compression::Dictionary::None }; // ,  .
 	DWORD timeout = 100000; // -     ( ).
-	int m_maxReconnectAttempts = 3; //     .
+	mutable std::mutex m_requestsMutex; //    .
+	std::unordered_map<uint64_t, PendingRequest> m_requests; //     .
+	std::multimap<std::chrono::steady_clock::time_point, uint64_t> m_deadlines; //    .
+	uint64_t m_nextRequestId = 1; //   .
 };
 #endif
\ No newline at end of file
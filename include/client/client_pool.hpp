@@ -0,0 +1,63 @@
+#ifndef CLIENT_POOL_HPP
+#define CLIENT_POOL_HPP
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../include/client/client.hpp"
+
+/**
+ * @class ClientPool
+ * @brief   Client   .
+ *
+ *         
+ *  :       .
+ *      ,   
+ *        .
+ * @code
+ * ClientPool pool("127.0.0.1", 8080, 4);
+ * pool.connect();
+ * Client::Request request = pool.request("hello");
+ * Client::Reply reply = request.reply.get();
+ * @endcode
+ */
+class ClientPool {
+public:
+	/**
+	 * @param connections   (  )
+	 */
+	ClientPool(const std::string& serverAddr, uint16_t port, size_t connections);
+	~ClientPool();
+	ClientPool(const ClientPool&) = delete;
+	ClientPool& operator=(const ClientPool&) = delete;
+	/**
+	 * @brief          
+	 * @return   
+	 */
+	size_t connect();
+	void disconnect();
+	/**
+	 * @brief     
+	 * @return ,   ( Client::cancel),  nullptr,
+	 *     (   Disconnected)
+	 */
+	Client* request(const char* data, size_t size, Client::ReplyCallback callback,
+		std::chrono::milliseconds timeout = Client::DEFAULT_REQUEST_TIMEOUT);
+	Client::Request request(const std::string& message, std::chrono::milliseconds timeout = Client::DEFAULT_REQUEST_TIMEOUT);
+	/**
+	 * @brief      
+	 */
+	size_t outstandingRequests() const;
+	size_t size() const { return m_clients.size(); }
+	Client& client(size_t index) { return *m_clients[index]; }
+private:
+	/**
+	 * @brief        nullptr
+	 */
+	Client* pick();
+
+	std::vector<std::unique_ptr<Client>> m_clients;
+	std::atomic<size_t> m_next{ 0 }; //    :    
+};
+#endif
@@ -0,0 +1,385 @@
+#ifndef BUFFER_POOL_HPP
+#define BUFFER_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+/**
+ * @namespace buffers
+ * @brief   -   .
+ *
+ *     :     -
+ *           .
+ *      (256  - 1  +  );
+ *       . , 
+ *  ,        
+ *   .
+ */
+namespace buffers {
+    class BufferPool;
+
+    /**
+     * @struct BufferBlock
+     * @brief  ;     .
+     */
+    struct alignas(16) BufferBlock {
+        BufferPool* owner = nullptr; // ,   
+        BufferBlock* next = nullptr; //     
+        std::atomic<uint32_t> refs{ 0 }; //  Buffer,   
+        int sizeClass = -1; //  , -1 -    
+        size_t capacity = 0; //   
+
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    /**
+     * @struct PoolStats
+     * @brief   (    ).
+     */
+    struct PoolStats {
+        uint64_t acquired = 0; //  
+        uint64_t hits = 0; //      
+        uint64_t misses = 0; //     
+        int64_t outstanding = 0; //    
+        int64_t highWater = 0; //    
+        int64_t cachedBytes = 0; //    
+
+        /**
+         * @brief      , 0..1
+         */
+        double hitRate() const { return acquired ? static_cast<double>(hits) / static_cast<double>(acquired) : 1.0; }
+    };
+
+    /**
+     * @class Buffer
+     * @brief     .
+     *        , 
+     *         .
+     *      .
+     */
+    class Buffer {
+    public:
+        Buffer() = default;
+        Buffer(const Buffer& other) : m_block(other.m_block), m_offset(other.m_offset), m_size(other.m_size) {
+            if (m_block) m_block->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        Buffer(Buffer&& other) noexcept : m_block(other.m_block), m_offset(other.m_offset), m_size(other.m_size) {
+            other.m_block = nullptr;
+            other.m_offset = other.m_size = 0;
+        }
+        Buffer& operator=(Buffer other) noexcept {
+            swap(other);
+            return *this;
+        }
+        ~Buffer() { reset(); }
+
+        char* data() { return m_block ? m_block->data() + m_offset : nullptr; }
+        const char* data() const { return m_block ? m_block->data() + m_offset : nullptr; }
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        /**
+         * @brief       
+         */
+        size_t tailroom() const { return m_block ? m_block->capacity - m_offset - m_size : 0; }
+        /**
+         * @brief       (   )
+         */
+        bool unique() const { return m_block && m_block->refs.load(std::memory_order_acquire) == 1; }
+        explicit operator bool() const { return m_block != nullptr; }
+
+        /**
+         * @brief      
+         */
+        void resize(size_t size) { m_size = size; }
+        /**
+         * @brief       
+         */
+        Buffer slice(size_t offset, size_t size) const {
+            Buffer result(*this);
+            result.m_offset += offset;
+            result.m_size = size;
+            return result;
+        }
+        /**
+         * @brief   
+         */
+        void consume(size_t bytes) {
+            m_offset += bytes;
+            m_size -= bytes;
+        }
+        /**
+         * @brief  ;      
+         *      
+         */
+        void append(const char* bytes, size_t count);
+        /**
+         * @brief    
+         */
+        void reset();
+        void swap(Buffer& other) noexcept {
+            std::swap(m_block, other.m_block);
+            std::swap(m_offset, other.m_offset);
+            std::swap(m_size, other.m_size);
+        }
+    private:
+        friend class BufferPool;
+        Buffer(BufferBlock* block, size_t size) : m_block(block), m_size(size) {}
+
+        BufferBlock* m_block = nullptr;
+        size_t m_offset = 0; //    
+        size_t m_size = 0; //  
+    };
+
+    /**
+     * @class BufferPool
+     * @brief    .
+     */
+    class BufferPool {
+    public:
+        static constexpr size_t MIN_CLASS_SIZE = 256; //   
+        static constexpr int CLASS_COUNT = 13; // 256  * 2^12 = 1 
+        static constexpr size_t CLASS_HEADROOM = 64; //       
+        static constexpr size_t MAX_CACHED_BYTES = 64 << 20; //      
+
+        BufferPool(const BufferPool&) = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+
+        /**
+         * @brief   
+         */
+        static BufferPool& local() {
+            thread_local LocalHandle handle;
+            return *handle.pool;
+        }
+
+        /**
+         * @brief   size    
+         */
+        static Buffer get(size_t size) { return local().acquire(size); }
+
+        /**
+         * @brief     size  (size() == size)
+         * @note   -
+         */
+        Buffer acquire(size_t size) {
+            drainRemote();
+            const int sizeClass = classFor(size);
+            BufferBlock* block = nullptr;
+            if (sizeClass >= 0 && m_free[sizeClass]) {
+                block = m_free[sizeClass];
+                m_free[sizeClass] = block->next;
+                bump(m_hits);
+                set(m_cachedBytes, m_cachedBytes.load(std::memory_order_relaxed) - static_cast<int64_t>(block->capacity));
+            }
+            else {
+                const size_t capacity = sizeClass >= 0 ? classSize(sizeClass) : size;
+                void* memory = ::operator new(sizeof(BufferBlock) + capacity);
+                block = new (memory) BufferBlock();
+                block->owner = this;
+                block->sizeClass = sizeClass;
+                block->capacity = capacity;
+                bump(m_misses);
+            }
+            block->next = nullptr;
+            block->refs.store(1, std::memory_order_relaxed);
+            bump(m_acquired);
+            const int64_t outstanding = m_outstanding.load(std::memory_order_relaxed) + 1;
+            set(m_outstanding, outstanding);
+            if (outstanding > m_highWater.load(std::memory_order_relaxed)) set(m_highWater, outstanding);
+            return Buffer(block, size);
+        }
+
+        /**
+         * @brief   
+         * @note     
+         */
+        PoolStats stats() const {
+            PoolStats result;
+            result.acquired = m_acquired.load(std::memory_order_relaxed);
+            result.hits = m_hits.load(std::memory_order_relaxed);
+            result.misses = m_misses.load(std::memory_order_relaxed);
+            result.outstanding = m_outstanding.load(std::memory_order_relaxed);
+            result.highWater = m_highWater.load(std::memory_order_relaxed);
+            result.cachedBytes = m_cachedBytes.load(std::memory_order_relaxed);
+            return result;
+        }
+
+        /**
+         * @brief     
+         * @details highWater -    
+         */
+        static PoolStats totalStats() {
+            PoolStats total;
+            Registry& registry = Registry::instance();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            for (const auto& pool : registry.pools) {
+                PoolStats s = pool->stats();
+                total.acquired += s.acquired;
+                total.hits += s.hits;
+                total.misses += s.misses;
+                total.outstanding += s.outstanding;
+                total.highWater += s.highWater;
+                total.cachedBytes += s.cachedBytes;
+            }
+            return total;
+        }
+
+        /**
+         * @brief    ;   
+         */
+        static void release(BufferBlock* block) {
+            BufferPool* owner = block->owner;
+            if (owner->m_thread.load(std::memory_order_relaxed) == threadTag()) {
+                owner->recycle(block);
+                return;
+            }
+            //  :     ( push)
+            BufferBlock* head = owner->m_remote.load(std::memory_order_relaxed);
+            do {
+                block->next = head;
+            } while (!owner->m_remote.compare_exchange_weak(head, block,
+                std::memory_order_release, std::memory_order_relaxed));
+        }
+    private:
+        /**
+         * @brief  :     
+         */
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<BufferPool>> pools;
+
+            static Registry& instance() {
+                static Registry* registry = new Registry(); //   thread_local-
+                return *registry;
+            }
+        };
+
+        /**
+         * @brief        
+         */
+        struct LocalHandle {
+            BufferPool* pool = nullptr;
+
+            LocalHandle() {
+                Registry& registry = Registry::instance();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                for (auto& candidate : registry.pools) {
+                    if (candidate->m_thread.load(std::memory_order_relaxed) == nullptr) {
+                        pool = candidate.get();
+                        break;
+                    }
+                }
+                if (!pool) {
+                    registry.pools.emplace_back(new BufferPool());
+                    pool = registry.pools.back().get();
+                }
+                pool->m_thread.store(threadTag(), std::memory_order_relaxed);
+            }
+            ~LocalHandle() {
+                //     ;    
+                //       
+                pool->drainRemote();
+                pool->trim();
+                pool->m_thread.store(nullptr, std::memory_order_release);
+            }
+        };
+
+        BufferPool() = default;
+
+        static const void* threadTag() {
+            thread_local char tag;
+            return &tag;
+        }
+
+        static size_t classSize(int sizeClass) { return (MIN_CLASS_SIZE << sizeClass) + CLASS_HEADROOM; }
+
+        static int classFor(size_t size) {
+            for (int i = 0; i < CLASS_COUNT; ++i) {
+                if (size <= classSize(i)) return i;
+            }
+            return -1;
+        }
+
+        //    -,    RMW
+        static void bump(std::atomic<uint64_t>& counter) {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        static void set(std::atomic<int64_t>& counter, int64_t value) {
+            counter.store(value, std::memory_order_relaxed);
+        }
+
+        void recycle(BufferBlock* block) {
+            set(m_outstanding, m_outstanding.load(std::memory_order_relaxed) - 1);
+            const int64_t cached = m_cachedBytes.load(std::memory_order_relaxed);
+            if (block->sizeClass < 0 || cached + static_cast<int64_t>(block->capacity) > static_cast<int64_t>(MAX_CACHED_BYTES)) {
+                block->~BufferBlock();
+                ::operator delete(block);
+                return;
+            }
+            block->next = m_free[block->sizeClass];
+            m_free[block->sizeClass] = block;
+            set(m_cachedBytes, cached + static_cast<int64_t>(block->capacity));
+        }
+
+        void drainRemote() {
+            if (!m_remote.load(std::memory_order_relaxed)) return;
+            BufferBlock* block = m_remote.exchange(nullptr, std::memory_order_acquire);
+            while (block) {
+                BufferBlock* next = block->next;
+                recycle(block);
+                block = next;
+            }
+        }
+
+        void trim() {
+            for (BufferBlock*& head : m_free) {
+                while (head) {
+                    BufferBlock* next = head->next;
+                    head->~BufferBlock();
+                    ::operator delete(head);
+                    head = next;
+                }
+            }
+            set(m_cachedBytes, 0);
+        }
+
+        BufferBlock* m_free[CLASS_COUNT] = {}; //     
+        std::atomic<const void*> m_thread{ nullptr }; // -, nullptr -  
+        alignas(64) std::atomic<BufferBlock*> m_remote{ nullptr }; // ,   
+        alignas(64) std::atomic<uint64_t> m_acquired{ 0 };
+        std::atomic<uint64_t> m_hits{ 0 };
+        std::atomic<uint64_t> m_misses{ 0 };
+        std::atomic<int64_t> m_outstanding{ 0 };
+        std::atomic<int64_t> m_highWater{ 0 };
+        std::atomic<int64_t> m_cachedBytes{ 0 };
+    };
+
+    inline void Buffer::reset() {
+        if (m_block && m_block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            BufferPool::release(m_block);
+        }
+        m_block = nullptr;
+        m_offset = m_size = 0;
+    }
+
+    inline void Buffer::append(const char* bytes, size_t count) {
+        if (count == 0) return;
+        if (!unique() || tailroom() < count) {
+            //     ,       
+            const size_t needed = m_size + count;
+            Buffer grown = BufferPool::get(needed < m_size * 2 ? m_size * 2 : needed);
+            if (m_size) std::memcpy(grown.data(), data(), m_size);
+            grown.resize(m_size);
+            swap(grown);
+        }
+        std::memcpy(data() + m_size, bytes, count);
+        m_size += count;
+    }
+}
+#endif
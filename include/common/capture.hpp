@@ -0,0 +1,218 @@
+#ifndef CAPTURE_HPP
+#define CAPTURE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../include/common/protocol.hpp"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @namespace capture
+ * @brief       .
+ *
+ *     FILE_HEADER_SIZE ,    
+ * BLOCK_SIZE .        , 
+ *        ,    
+ * .  - RecordHeader   ,  
+ * RECORD_ALIGN.   (kind == Padding)   
+ * :    .     
+ *   (little-endian   ).
+ */
+namespace capture {
+    constexpr char MAGIC[8] = { 'C', 'S', 'C', 'A', 'P', 'T', 'R', '1' };
+    constexpr uint32_t VERSION = 1;
+    constexpr size_t FILE_HEADER_SIZE = 64;
+    constexpr size_t BLOCK_SIZE = 2 * 1024 * 1024; //     MAX_PAYLOAD_SIZE
+    constexpr size_t RECORD_ALIGN = 8;
+    constexpr uint64_t NO_CONNECTION = 0; //     (  )
+
+    /**
+     * @brief  .
+     */
+    enum class RecordKind : uint8_t {
+        Padding = 0, //   
+        Frame = 1 // ,   
+    };
+
+    /**
+     * @struct FileHeader
+     * @brief  .
+     */
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t blockSize;
+        uint64_t startedAtNs; //  ,     
+        char reserved[40];
+    };
+    static_assert(sizeof(FileHeader) == FILE_HEADER_SIZE, "capture file header size");
+
+    /**
+     * @struct RecordHeader
+     * @brief   .
+     */
+    struct RecordHeader {
+        uint32_t size; //  
+        RecordKind kind;
+        protocol::MessageType type;
+        uint8_t flags; //      (  ,   )
+        uint8_t reserved;
+        uint64_t connection; //      (NO_CONNECTION -  )
+        uint64_t timeNs; //     
+    };
+    static_assert(sizeof(RecordHeader) == 24, "capture record header size");
+
+    /**
+     * @brief     size   
+     */
+    constexpr size_t recordSize(size_t size) {
+        return (sizeof(RecordHeader) + size + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1);
+    }
+
+    /**
+     * @struct Record
+     * @brief  ; payload    Reader.
+     */
+    struct Record {
+        uint64_t connection;
+        uint64_t timeNs;
+        protocol::MessageType type;
+        uint8_t flags;
+        const char* payload;
+        size_t size;
+    };
+
+    /**
+     * @class Reader
+     * @brief           
+     *   .
+     * @details    : Record   
+     * .  :     
+     *     ,    
+     */
+    class Reader {
+    public:
+        Reader() = default;
+        ~Reader() { unmap(); }
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        /**
+         * @return false -        
+         */
+        bool open(const std::string& path, std::string& error) {
+            unmap();
+            m_records.clear();
+            if (!map(path, error)) return false;
+            FileHeader header{};
+            if (m_size < sizeof(header)) {
+                error = "file is too short";
+                return false;
+            }
+            std::memcpy(&header, m_data, sizeof(header));
+            if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION
+                || header.blockSize < recordSize(0)) {
+                error = "not a capture file";
+                return false;
+            }
+            m_startedAtNs = header.startedAtNs;
+
+            for (size_t block = FILE_HEADER_SIZE; block < m_size; block += header.blockSize) {
+                const size_t end = std::min(m_size, block + header.blockSize);
+                size_t offset = block;
+                while (offset + sizeof(RecordHeader) <= end) {
+                    RecordHeader record;
+                    std::memcpy(&record, m_data + offset, sizeof(record));
+                    if (record.kind != RecordKind::Frame) break;
+                    //  :  ,   
+                    if (offset + sizeof(record) + record.size > end) break;
+                    m_records.push_back({ record.connection, record.timeNs, record.type, record.flags,
+                        m_data + offset + sizeof(record), record.size });
+                    offset += recordSize(record.size);
+                }
+            }
+            std::stable_sort(m_records.begin(), m_records.end(),
+                [](const Record& a, const Record& b) { return a.timeNs < b.timeNs; });
+            return true;
+        }
+
+        const std::vector<Record>& records() const { return m_records; }
+        uint64_t startedAtNs() const { return m_startedAtNs; }
+    private:
+#ifdef _WIN32
+        bool map(const std::string& path, std::string& error) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file) {
+                error = "cannot open " + path;
+                return false;
+            }
+            m_copy.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            m_data = m_copy.data();
+            m_size = m_copy.size();
+            return true;
+        }
+
+        void unmap() {
+            m_copy.clear();
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+        std::vector<char> m_copy; //  mmap   
+#else
+        /**
+         * @details ,    ,  : 
+         *    
+         */
+        bool map(const std::string& path, std::string& error) {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                error = "cannot open " + path;
+                return false;
+            }
+            struct stat info {};
+            if (::fstat(fd, &info) != 0) {
+                error = "cannot stat " + path;
+                ::close(fd);
+                return false;
+            }
+            m_size = static_cast<size_t>(info.st_size);
+            if (m_size > 0) {
+                void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data == MAP_FAILED) {
+                    error = "cannot map " + path;
+                    m_size = 0;
+                    ::close(fd);
+                    return false;
+                }
+                //       
+                ::madvise(data, m_size, MADV_SEQUENTIAL);
+                m_data = static_cast<const char*>(data);
+            }
+            ::close(fd); //    
+            return true;
+        }
+
+        void unmap() {
+            if (m_data) ::munmap(const_cast<char*>(m_data), m_size);
+            m_data = nullptr;
+            m_size = 0;
+        }
+#endif
+
+        const char* m_data = nullptr; //  
+        size_t m_size = 0;
+        std::vector<Record> m_records;
+        uint64_t m_startedAtNs = 0;
+    };
+}
+#endif
@@ -0,0 +1,413 @@
+#ifndef COMPRESSION_HPP
+#define COMPRESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include "../include/common/buffer_pool.hpp"
+#include "../include/common/protocol.hpp"
+
+/**
+ * @namespace compression
+ * @brief   ,    .
+ *
+ *  - LZ77    LZ4:   +
+ *   2- ,   , 
+ *        .  
+ *      ,     
+ *  :      ,
+ *         .
+ *
+ * :    Hello     
+ * ,   Hello  ,  .   
+ *   .   (FLAG_COMPRESSED) 
+ *    -      .
+ *   : varint  ,  , .
+ */
+namespace compression {
+    /**
+     * @brief   .
+     */
+    enum class Dictionary : uint8_t {
+        None = 0, //  
+        Chat = 1 //       
+    };
+
+    constexpr uint8_t CODEC_LZ = 0x01; //     Hello
+    constexpr size_t HELLO_SIZE = 2; //    
+
+    /**
+     * @struct Options
+     * @brief     .
+     */
+    struct Options {
+        bool enabled = false; //  ()   () 
+        size_t threshold = 64; //     
+        Dictionary dictionary = Dictionary::Chat;
+    };
+
+    /**
+     * @brief   (  Dictionary::None)
+     */
+    inline std::string_view dictionaryText(Dictionary dictionary) {
+        //     :    
+        static constexpr char CHAT[] =
+            "{\"type\":\"message\",\"user\":\"\",\"text\":\"\",\"time\":\"\",\"id\":}"
+            "http://https://www..com/.org/.html?id=&page=index "
+            "Error: Invalid message format Received: Server is busy. Try again later. "
+            "January February March April May June July August September October November December "
+            "Monday Tuesday Wednesday Thursday Friday Saturday Sunday "
+            "0123456789 00:00 12:30 2024 2025 2026 "
+            "information because between different following government important without "
+            "through another example however question something problem program number "
+            "system should really always around before little people would could about "
+            "there their which where these those other after first never still every "
+            "right thing think going being doing make made take know want need like "
+            "look come give work call find tell feel seem keep help show turn start "
+            "happy birthday congratulations welcome everyone everybody anyone someone "
+            "good morning good afternoon good evening good night see you later "
+            "talk to you soon let me know what do you think i don't know i'm not sure "
+            "sounds good to me that's great thank you so much thanks a lot no problem "
+            "you're welcome sorry for the delay on my way be right back just a moment "
+            "how are you doing i'm fine and you what's up not much did you see the "
+            "can you please send me the link meeting tomorrow at today tonight this "
+            "week next week last week yesterday weekend hello hi hey yes no ok okay "
+            "sure maybe lol haha :) :( :D the and that have for not with this but from "
+            "they will what when your you are was were has had can all just one time ";
+        switch (dictionary) {
+        case Dictionary::Chat:
+            return std::string_view(CHAT, sizeof(CHAT) - 1);
+        default:
+            return std::string_view();
+        }
+    }
+
+    inline bool knownDictionary(uint8_t value) {
+        return value <= static_cast<uint8_t>(Dictionary::Chat);
+    }
+
+    namespace detail {
+        constexpr size_t MIN_MATCH = 4;
+        constexpr size_t LAST_LITERALS = 5; //    -  
+        constexpr size_t MATCH_LIMIT = 12; //      
+        constexpr size_t MAX_OFFSET = 65535;
+        constexpr unsigned HASH_BITS = 12;
+
+        inline uint32_t read32(const char* data) {
+            uint32_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+
+        inline uint32_t hash(uint32_t sequence, unsigned bits) {
+            return (sequence * 2654435761u) >> (32 - bits);
+        }
+
+        /**
+         * @brief    a  b,   limit  a
+         */
+        inline size_t matchLength(const char* a, const char* b, const char* limit) {
+            const char* start = a;
+            while (a < limit && *a == *b) {
+                ++a;
+                ++b;
+            }
+            return static_cast<size_t>(a - start);
+        }
+
+        inline char* writeLength(char* out, size_t length) {
+            for (; length >= 255; length -= 255) *out++ = static_cast<char>(255);
+            *out++ = static_cast<char>(length);
+            return out;
+        }
+
+        /**
+         * @brief -  :     
+         */
+        struct DictionaryTable {
+            std::string_view text;
+            uint16_t positions[1u << HASH_BITS] = {}; //  + 1, 0 - 
+
+            explicit DictionaryTable(Dictionary dictionary) : text(dictionaryText(dictionary)) {
+                for (size_t pos = 0; pos + MIN_MATCH <= text.size(); ++pos) {
+                    positions[hash(read32(text.data() + pos), HASH_BITS)] = static_cast<uint16_t>(pos + 1);
+                }
+            }
+        };
+
+        inline const DictionaryTable* dictionaryTable(Dictionary dictionary) {
+            static const DictionaryTable chat(Dictionary::Chat);
+            return dictionary == Dictionary::Chat ? &chat : nullptr;
+        }
+
+        /**
+         * @brief  :  [anchor, anchor + literals)  
+         * @return    nullptr,    
+         */
+        inline char* writeSequence(char* op, char* end, const char* anchor, size_t literals, size_t offset, size_t length) {
+            const size_t matchCode = length - MIN_MATCH;
+            if (static_cast<size_t>(end - op) < 1 + literals / 255 + 1 + literals + 2 + matchCode / 255 + 1) return nullptr;
+            char* token = op++;
+            *token = static_cast<char>((literals >= 15 ? 15 : literals) << 4 | (matchCode >= 15 ? 15 : matchCode));
+            if (literals >= 15) op = writeLength(op, literals - 15);
+            std::memcpy(op, anchor, literals);
+            op += literals;
+            *op++ = static_cast<char>(offset & 0xFF);
+            *op++ = static_cast<char>(offset >> 8);
+            if (matchCode >= 15) op = writeLength(op, matchCode - 15);
+            return op;
+        }
+    }
+
+    /**
+     * @brief  
+     * @param capacity   out; ,    , 
+     * @return    0,      capacity
+     * @details    -  
+     * (    ,     
+     *   );     ,   .
+     *     ,   
+     *  
+     */
+    inline size_t compress(const char* in, size_t size, char* out, size_t capacity, Dictionary dictionary) {
+        using namespace detail;
+        thread_local uint32_t table[1u << HASH_BITS]; //  + 1  
+        unsigned bits = 8;
+        while (bits < HASH_BITS && (size_t(1) << bits) < size) ++bits;
+        std::memset(table, 0, sizeof(uint32_t) << bits);
+
+        const DictionaryTable* shared = dictionaryTable(dictionary);
+        const char* const end = in + size;
+        const char* const matchEnd = end - (size < LAST_LITERALS ? size : LAST_LITERALS);
+        char* op = out;
+        char* const opEnd = out + capacity;
+        const char* anchor = in;
+        const char* ip = in;
+        if (size > MATCH_LIMIT) {
+            const char* const searchEnd = end - MATCH_LIMIT;
+            unsigned misses = 0;
+            while (ip < searchEnd) {
+                const uint32_t sequence = read32(ip);
+                const uint32_t slot = hash(sequence, bits);
+                const uint32_t candidate = table[slot];
+                table[slot] = static_cast<uint32_t>(ip - in) + 1;
+                size_t length = 0;
+                size_t offset = 0;
+                if (candidate != 0) {
+                    const char* ref = in + candidate - 1;
+                    offset = static_cast<size_t>(ip - ref);
+                    if (offset <= MAX_OFFSET && read32(ref) == sequence) {
+                        length = MIN_MATCH + matchLength(ip + MIN_MATCH, ref + MIN_MATCH, matchEnd);
+                    }
+                }
+                if (length == 0 && shared) {
+                    const uint16_t position = shared->positions[hash(sequence, HASH_BITS)];
+                    if (position != 0) {
+                        const char* ref = shared->text.data() + position - 1;
+                        const size_t available = shared->text.size() - (position - 1); //   
+                        offset = static_cast<size_t>(ip - in) + available;
+                        if (offset <= MAX_OFFSET && available >= MIN_MATCH && read32(ref) == sequence) {
+                            const char* limit = ip + available < matchEnd ? ip + available : matchEnd;
+                            length = MIN_MATCH + matchLength(ip + MIN_MATCH, ref + MIN_MATCH, limit);
+                        }
+                    }
+                }
+                if (length == 0) {
+                    ip += 1 + (misses++ >> 5);
+                    continue;
+                }
+                misses = 0;
+                op = writeSequence(op, opEnd, anchor, static_cast<size_t>(ip - anchor), offset, length);
+                if (!op) return 0;
+                ip += length;
+                anchor = ip;
+            }
+        }
+        //  
+        const size_t literals = static_cast<size_t>(end - anchor);
+        if (static_cast<size_t>(opEnd - op) < 1 + literals / 255 + 1 + literals) return 0;
+        *op++ = static_cast<char>((literals >= 15 ? 15 : literals) << 4);
+        if (literals >= 15) op = writeLength(op, literals - 15);
+        std::memcpy(op, anchor, literals);
+        op += literals;
+        return static_cast<size_t>(op - out);
+    }
+
+    /**
+     * @brief     outSize 
+     * @return false -   (    :
+     *    )
+     */
+    inline bool decompress(const char* in, size_t size, char* out, size_t outSize, Dictionary dictionary) {
+        using namespace detail;
+        const std::string_view shared = dictionaryText(dictionary);
+        const uint8_t* ip = reinterpret_cast<const uint8_t*>(in);
+        const uint8_t* const ipEnd = ip + size;
+        char* op = out;
+        char* const opEnd = out + outSize;
+        auto readLength = [&ip, ipEnd](size_t& length) {
+            uint8_t byte;
+            do {
+                if (ip == ipEnd) return false;
+                byte = *ip++;
+                length += byte;
+            } while (byte == 255 && length <= protocol::MAX_PAYLOAD_SIZE);
+            return length <= protocol::MAX_PAYLOAD_SIZE;
+        };
+
+        while (ip < ipEnd) {
+            const uint8_t token = *ip++;
+            size_t literals = token >> 4;
+            if (literals == 15 && !readLength(literals)) return false;
+            if (literals > static_cast<size_t>(ipEnd - ip) || literals > static_cast<size_t>(opEnd - op)) return false;
+            std::memcpy(op, ip, literals);
+            op += literals;
+            ip += literals;
+            if (ip == ipEnd) break; //   -  
+
+            if (ipEnd - ip < 2) return false;
+            const size_t offset = static_cast<size_t>(ip[0]) | static_cast<size_t>(ip[1]) << 8;
+            ip += 2;
+            size_t length = token & 15;
+            if (length == 15 && !readLength(length)) return false;
+            length += MIN_MATCH;
+            if (offset == 0 || length > static_cast<size_t>(opEnd - op)) return false;
+
+            const size_t produced = static_cast<size_t>(op - out);
+            if (offset > produced) {
+                //    ,  -   
+                const size_t back = offset - produced;
+                if (back > shared.size()) return false;
+                const size_t fromDictionary = back < length ? back : length;
+                std::memcpy(op, shared.data() + shared.size() - back, fromDictionary);
+                op += fromDictionary;
+                length -= fromDictionary;
+            }
+            const char* ref = op - offset;
+            if (offset >= length) {
+                std::memcpy(op, ref, length);
+                op += length;
+            }
+            else {
+                // :   offset 
+                for (size_t i = 0; i < length; ++i) *op++ = ref[i];
+            }
+        }
+        return op == opEnd;
+    }
+
+    namespace detail {
+        /**
+         * @brief    : prefix ( ) 
+         *  
+         * @return  ,     
+         */
+        inline buffers::Buffer encodeFrame(protocol::MessageType type, uint8_t flags, const char* prefix, size_t prefixSize,
+            const char* payload, size_t size, Dictionary dictionary) {
+            char sizeField[protocol::MAX_VARINT_SIZE];
+            const size_t sizeFieldSize = protocol::encodeVarint(sizeField, size);
+            //         
+            if (size <= sizeFieldSize + 2) return buffers::Buffer();
+            const size_t blockCapacity = size - sizeFieldSize - 2;
+
+            buffers::Buffer frame = buffers::BufferPool::get(protocol::MAX_HEADER_SIZE + prefixSize + sizeFieldSize + 1 + blockCapacity);
+            char* body = frame.data() + protocol::MAX_HEADER_SIZE;
+            if (prefixSize > 0) std::memcpy(body, prefix, prefixSize);
+            std::memcpy(body + prefixSize, sizeField, sizeFieldSize);
+            body[prefixSize + sizeFieldSize] = static_cast<char>(dictionary);
+            const size_t blockOffset = prefixSize + sizeFieldSize + 1;
+            const size_t blockSize = compress(payload, size, body + blockOffset, blockCapacity, dictionary);
+            if (blockSize == 0) return buffers::Buffer();
+
+            const size_t bodySize = blockOffset + blockSize;
+            char header[protocol::MAX_HEADER_SIZE];
+            const size_t headerSize = protocol::encodeHeader(header, type, flags | protocol::FLAG_COMPRESSED, bodySize);
+            std::memcpy(body - headerSize, header, headerSize);
+            frame.resize(protocol::MAX_HEADER_SIZE + bodySize);
+            frame.consume(protocol::MAX_HEADER_SIZE - headerSize);
+            return frame;
+        }
+    }
+
+    /**
+     * @brief     (FLAG_COMPRESSED)
+     * @return  ,     :    
+     */
+    inline buffers::Buffer makeFrame(protocol::MessageType type, const char* payload, size_t size, Dictionary dictionary,
+        uint8_t flags = protocol::FLAG_NONE) {
+        return detail::encodeFrame(type, flags, nullptr, 0, payload, size, dictionary);
+    }
+
+    /**
+     * @brief     ;   
+     */
+    inline buffers::Buffer makeCorrelatedFrame(protocol::MessageType type, uint64_t correlation, const char* payload,
+        size_t size, Dictionary dictionary, uint8_t flags = protocol::FLAG_NONE) {
+        char prefix[protocol::MAX_CORRELATION_SIZE];
+        const size_t prefixSize = protocol::encodeVarint(prefix, correlation);
+        return detail::encodeFrame(type, flags | protocol::FLAG_CORRELATED, prefix, prefixSize, payload, size, dictionary);
+    }
+
+    /**
+     * @brief     FLAG_COMPRESSED   
+     * @param frame    ;   payload 
+     * storage   storage, FLAG_COMPRESSED 
+     * @return false -  ,    
+     *   MAX_PAYLOAD_SIZE
+     */
+    inline bool inflate(protocol::FrameView& frame, buffers::Buffer& storage) {
+        size_t original = 0;
+        size_t pos = 0;
+        for (;; ++pos) {
+            if (pos == frame.size || pos == protocol::MAX_VARINT_SIZE) return false;
+            const uint8_t byte = static_cast<uint8_t>(frame.payload[pos]);
+            original |= static_cast<size_t>(byte & 0x7F) << (7 * pos);
+            if (!(byte & 0x80)) break;
+        }
+        ++pos;
+        if (original > protocol::MAX_PAYLOAD_SIZE || pos == frame.size) return false;
+        const uint8_t dictionary = static_cast<uint8_t>(frame.payload[pos++]);
+        if (!knownDictionary(dictionary)) return false;
+
+        storage = buffers::BufferPool::get(original > 0 ? original : 1);
+        if (!decompress(frame.payload + pos, frame.size - pos, storage.data(), original, static_cast<Dictionary>(dictionary))) {
+            return false;
+        }
+        storage.resize(original);
+        frame.payload = storage.data();
+        frame.size = original;
+        frame.flags &= static_cast<uint8_t>(~protocol::FLAG_COMPRESSED);
+        frame.storage = &storage;
+        return true;
+    }
+
+    /**
+     * @brief  Hello:  ()   ()   
+     * @param out  HELLO_SIZE 
+     */
+    inline void encodeHello(char* out, bool compress, Dictionary dictionary) {
+        out[0] = static_cast<char>(compress ? CODEC_LZ : 0);
+        out[1] = static_cast<char>(dictionary);
+    }
+
+    inline buffers::Buffer makeHello(bool compress, Dictionary dictionary) {
+        char payload[HELLO_SIZE];
+        encodeHello(payload, compress, dictionary);
+        return protocol::makeFrame(protocol::MessageType::Hello, payload, sizeof(payload));
+    }
+
+    /**
+     * @brief  Hello;   (  ) 
+     * @return false -   HELLO_SIZE
+     * @details     None
+     */
+    inline bool parseHello(const protocol::FrameView& frame, bool& compress, Dictionary& dictionary) {
+        if (frame.size < HELLO_SIZE) return false;
+        compress = (static_cast<uint8_t>(frame.payload[0]) & CODEC_LZ) != 0;
+        const uint8_t value = static_cast<uint8_t>(frame.payload[1]);
+        dictionary = knownDictionary(value) ? static_cast<Dictionary>(value) : Dictionary::None;
+        return true;
+    }
+}
+#endif
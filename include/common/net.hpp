@@ -0,0 +1,245 @@
+#ifndef NET_HPP
+#define NET_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+
+#pragma comment (lib, "ws2_32.lib")
+
+//  Winsock send()   SIGPIPE,   
+#define MSG_NOSIGNAL 0
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <cerrno>
+
+/**
+ * @brief   Winsock   POSIX-.
+ *         Linux 
+ *     .
+ */
+using SOCKET = int;
+using DWORD = uint32_t;
+constexpr SOCKET INVALID_SOCKET = -1;
+constexpr int SOCKET_ERROR = -1;
+// recv()   SO_RCVTIMEO  EAGAIN  WSAETIMEDOUT
+constexpr int WSAETIMEDOUT = EAGAIN;
+
+constexpr int SD_BOTH = SHUT_RDWR;
+
+inline int closesocket(SOCKET s) { return ::close(s); }
+inline int WSAGetLastError() { return errno; }
+#endif
+
+/**
+ * @namespace net
+ * @brief -   .
+ */
+namespace net {
+#ifdef _WIN32
+    using IoVec = WSABUF;
+#else
+    using IoVec = iovec;
+#endif
+
+    /**
+     * @brief     (iovec/WSABUF)
+     */
+    inline void setIoVec(IoVec& vec, const char* data, size_t size) {
+#ifdef _WIN32
+        vec.buf = const_cast<char*>(data);
+        vec.len = static_cast<ULONG>(size);
+#else
+        vec.iov_base = const_cast<char*>(data);
+        vec.iov_len = size;
+#endif
+    }
+
+    /**
+     * @brief       (sendmsg/WSASend)
+     * @param dontWait       ( POSIX -
+     * MSG_DONTWAIT;  Windows     )
+     * @return     SOCKET_ERROR
+     */
+    inline int sendVector(SOCKET s, IoVec* vectors, size_t count, bool dontWait) {
+#ifdef _WIN32
+        (void)dontWait;
+        DWORD sent = 0;
+        if (WSASend(s, vectors, static_cast<DWORD>(count), &sent, 0, nullptr, nullptr) != 0) return SOCKET_ERROR;
+        return static_cast<int>(sent);
+#else
+        msghdr message{};
+        message.msg_iov = vectors;
+        message.msg_iovlen = count;
+        return static_cast<int>(sendmsg(s, &message, MSG_NOSIGNAL | (dontWait ? MSG_DONTWAIT : 0)));
+#endif
+    }
+
+    /**
+     * @brief    ,     
+     */
+    inline bool wouldBlock(int error) {
+#ifdef _WIN32
+        return error == WSAEWOULDBLOCK;
+#else
+        return error == EAGAIN || error == EWOULDBLOCK;
+#endif
+    }
+
+    /**
+     * @brief   
+     * @return true - , false - 
+     * @note  Windows  WSAStartup,  POSIX   
+     */
+    inline bool startup() {
+#ifdef _WIN32
+        WSADATA wsaData;
+        return WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+#else
+        return true;
+#endif
+    }
+
+    /**
+     * @brief    (   startup())
+     */
+    inline void shutdown() {
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+
+    /**
+     * @brief   SO_RCVTIMEO/SO_SNDTIMEO
+     * @param s 
+     * @param option SO_RCVTIMEO  SO_SNDTIMEO
+     * @param timeoutMs   
+     */
+    inline void setTimeout(SOCKET s, int option, DWORD timeoutMs) {
+#ifdef _WIN32
+        setsockopt(s, SOL_SOCKET, option, (char*)&timeoutMs, sizeof(timeoutMs));
+#else
+        timeval tv{};
+        tv.tv_sec = timeoutMs / 1000;
+        tv.tv_usec = (timeoutMs % 1000) * 1000;
+        setsockopt(s, SOL_SOCKET, option, &tv, sizeof(tv));
+#endif
+    }
+
+    /**
+     * @brief     
+     * @return true - , false - 
+     */
+    inline bool setNonBlocking(SOCKET s) {
+#ifdef _WIN32
+        u_long mode = 1;
+        return ioctlsocket(s, FIONBIO, &mode) == 0;
+#else
+        int flags = fcntl(s, F_GETFL, 0);
+        return flags != -1 && fcntl(s, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+    }
+
+    /**
+     * @brief     
+     */
+    inline bool setBlocking(SOCKET s) {
+#ifdef _WIN32
+        u_long mode = 0;
+        return ioctlsocket(s, FIONBIO, &mode) == 0;
+#else
+        int flags = fcntl(s, F_GETFL, 0);
+        return flags != -1 && fcntl(s, F_SETFL, flags & ~O_NONBLOCK) == 0;
+#endif
+    }
+
+    /**
+     * @brief      connect,  
+     *        POLLOUT
+     */
+    inline bool connectInProgress(int error) {
+#ifdef _WIN32
+        return error == WSAEWOULDBLOCK;
+#else
+        return error == EINPROGRESS;
+#endif
+    }
+
+    /**
+     * @brief      (poll/WSAPoll)
+     * @param timeoutMs   , -1 -  
+     * @return    , 0 - , SOCKET_ERROR - 
+     */
+    inline int poll(pollfd* fds, size_t count, int timeoutMs) {
+#ifdef _WIN32
+        return WSAPoll(fds, static_cast<ULONG>(count), timeoutMs);
+#else
+        return ::poll(fds, static_cast<nfds_t>(count), timeoutMs);
+#endif
+    }
+
+    constexpr int CONNECT_CANCEL_POLL_MS = 50; //    
+
+    /**
+     * @brief   :  connect   POLLOUT
+     * @param timeoutMs    
+     * @param cancel  :   CONNECT_CANCEL_POLL_MS,
+     *       
+     * @return 0 - ,    (ETIMEDOUT/WSAETIMEDOUT -
+     *  , ECANCELED/WSAECANCELLED - )
+     * @note     
+     */
+    inline int connectWithTimeout(SOCKET s, const sockaddr* addr, socklen_t size, int timeoutMs,
+        const std::atomic<bool>* cancel = nullptr) {
+#ifdef _WIN32
+        constexpr int TIMED_OUT = WSAETIMEDOUT;
+        constexpr int CANCELLED = WSAECANCELLED;
+#else
+        constexpr int TIMED_OUT = ETIMEDOUT;
+        constexpr int CANCELLED = ECANCELED;
+#endif
+        if (!setNonBlocking(s)) return WSAGetLastError();
+        int error = 0;
+        if (::connect(s, addr, size) == SOCKET_ERROR) {
+            error = WSAGetLastError();
+            if (connectInProgress(error)) {
+                pollfd fd{};
+                fd.fd = s;
+                fd.events = POLLOUT;
+                int ready = 0;
+                for (int left = timeoutMs; left > 0 && ready == 0; left -= CONNECT_CANCEL_POLL_MS) {
+                    if (cancel && cancel->load()) break;
+                    ready = net::poll(&fd, 1, cancel ? std::min(left, CONNECT_CANCEL_POLL_MS) : left);
+                }
+                if (ready == 0) {
+                    error = cancel && cancel->load() ? CANCELLED : TIMED_OUT;
+                }
+                else if (ready < 0) {
+                    error = WSAGetLastError();
+                }
+                else {
+                    socklen_t length = sizeof(error);
+                    error = 0;
+                    getsockopt(s, SOL_SOCKET, SO_ERROR, (char*)&error, &length);
+                }
+            }
+        }
+        if (error == 0 && !setBlocking(s)) error = WSAGetLastError();
+        return error;
+    }
+}
+#endif
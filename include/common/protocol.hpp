@@ -0,0 +1,325 @@
+#ifndef PROTOCOL_HPP
+#define PROTOCOL_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "../include/common/buffer_pool.hpp"
+
+/**
+ * @namespace protocol
+ * @brief      .
+ *
+ *  :
+ * -    (varint, LEB128,  5 );
+ * -   (1 );
+ * -  (1 );
+ * -  .
+ *
+ *       ,  TCP  
+ *  :  recv()    ,  
+ *     recv().
+ */
+namespace protocol {
+    /**
+     * @brief     .
+     */
+    enum class MessageType : uint8_t {
+        Text = 1, //   ()
+        Error = 2, //    
+        Subscribe = 3, //    ( -  );     
+        Unsubscribe = 4, //   ;    
+        Publish = 5, //  : "\n";     
+        Hello = 6 //  :       
+    };
+
+    constexpr char TOPIC_SEPARATOR = '\n'; //       Publish
+
+    /**
+     * @brief  ,   
+     */
+    constexpr bool isPubSub(MessageType type) {
+        return type >= MessageType::Subscribe && type <= MessageType::Publish;
+    }
+
+    constexpr uint8_t FLAG_NONE = 0; //   
+    //      (varint  64 ); 
+    //    ,       
+    constexpr uint8_t FLAG_CORRELATED = 0x01;
+    //  (  ) , . compression.hpp
+    constexpr uint8_t FLAG_COMPRESSED = 0x02;
+    constexpr size_t MAX_CORRELATION_SIZE = 10; //  varint 64- 
+    constexpr size_t MAX_PAYLOAD_SIZE = 1 << 20; //    
+    constexpr size_t MAX_VARINT_SIZE = 5; //    32- 
+    constexpr size_t MAX_HEADER_SIZE = MAX_VARINT_SIZE + 2; //  +  + 
+
+    /**
+     * @struct FrameView
+     * @brief  ; payload   ,    .
+     */
+    struct FrameView {
+        MessageType type = MessageType::Text;
+        uint8_t flags = FLAG_NONE;
+        const char* payload = nullptr;
+        size_t size = 0;
+        //    ,      
+        // ;        
+        const buffers::Buffer* storage = nullptr;
+    };
+
+    /**
+     * @brief    .
+     */
+    enum class ParseStatus {
+        Complete, //  
+        Incomplete, //   
+        TooLarge, //   MAX_PAYLOAD_SIZE
+        Malformed //  varint
+    };
+
+    /**
+     * @brief  varint (LEB128)
+     * @param out    MAX_CORRELATION_SIZE  (MAX_VARINT_SIZE  32- )
+     * @return   
+     */
+    inline size_t encodeVarint(char* out, uint64_t value) {
+        size_t pos = 0;
+        do {
+            uint8_t byte = value & 0x7F;
+            value >>= 7;
+            if (value) byte |= 0x80;
+            out[pos++] = static_cast<char>(byte);
+        } while (value);
+        return pos;
+    }
+
+    /**
+     * @brief   
+     * @param out    MAX_HEADER_SIZE 
+     * @return    
+     */
+    inline size_t encodeHeader(char* out, MessageType type, uint8_t flags, size_t payloadSize) {
+        size_t pos = encodeVarint(out, static_cast<uint32_t>(payloadSize));
+        out[pos++] = static_cast<char>(type);
+        out[pos++] = static_cast<char>(flags);
+        return pos;
+    }
+
+    /**
+     * @brief     
+     */
+    inline void appendFrame(std::string& out, MessageType type, uint8_t flags, const char* payload, size_t size) {
+        char header[MAX_HEADER_SIZE];
+        size_t headerSize = encodeHeader(header, type, flags, size);
+        out.append(header, headerSize);
+        out.append(payload, size);
+    }
+
+    /**
+     * @brief     
+     */
+    inline std::string encodeFrame(MessageType type, const std::string& payload, uint8_t flags = FLAG_NONE) {
+        std::string frame;
+        frame.reserve(MAX_HEADER_SIZE + payload.size());
+        appendFrame(frame, type, flags, payload.data(), payload.size());
+        return frame;
+    }
+
+    /**
+     * @brief      (      )
+     */
+    inline buffers::Buffer makeFrame(MessageType type, const char* payload, size_t size, uint8_t flags = FLAG_NONE) {
+        buffers::Buffer frame = buffers::BufferPool::get(MAX_HEADER_SIZE + size);
+        size_t headerSize = encodeHeader(frame.data(), type, flags, size);
+        if (size > 0) std::memcpy(frame.data() + headerSize, payload, size);
+        frame.resize(headerSize + size);
+        return frame;
+    }
+
+    /**
+     * @brief        (FLAG_CORRELATED)
+     */
+    inline buffers::Buffer makeCorrelatedFrame(MessageType type, uint64_t correlation, const char* payload, size_t size,
+        uint8_t flags = FLAG_NONE) {
+        char prefix[MAX_CORRELATION_SIZE];
+        const size_t prefixSize = encodeVarint(prefix, correlation);
+
+        buffers::Buffer frame = buffers::BufferPool::get(MAX_HEADER_SIZE + prefixSize + size);
+        size_t headerSize = encodeHeader(frame.data(), type, flags | FLAG_CORRELATED, prefixSize + size);
+        std::memcpy(frame.data() + headerSize, prefix, prefixSize);
+        if (size > 0) std::memcpy(frame.data() + headerSize + prefixSize, payload, size);
+        frame.resize(headerSize + prefixSize + size);
+        return frame;
+    }
+
+    /**
+     * @brief        FLAG_CORRELATED
+     * @param frame ;   payload    
+     * ,  FLAG_CORRELATED 
+     * @return false -  
+     */
+    inline bool takeCorrelation(FrameView& frame, uint64_t& correlation) {
+        correlation = 0;
+        for (size_t pos = 0; pos < frame.size && pos < MAX_CORRELATION_SIZE; ++pos) {
+            const uint8_t byte = static_cast<uint8_t>(frame.payload[pos]);
+            correlation |= static_cast<uint64_t>(byte & 0x7F) << (7 * pos);
+            if (!(byte & 0x80)) {
+                frame.payload += pos + 1;
+                frame.size -= pos + 1;
+                frame.flags &= static_cast<uint8_t>(~FLAG_CORRELATED);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief   
+     * @param data  
+     * @param size  
+     * @param frame ,     (payload  )
+     * @param headerSize  
+     * @param limit    (  MAX_PAYLOAD_SIZE)
+     */
+    inline ParseStatus parseHeader(const char* data, size_t size, FrameView& frame, size_t& headerSize,
+        size_t limit = MAX_PAYLOAD_SIZE) {
+        uint32_t value = 0;
+        size_t pos = 0;
+        for (;; ++pos) {
+            if (pos == MAX_VARINT_SIZE) return ParseStatus::Malformed;
+            if (pos == size) return ParseStatus::Incomplete;
+            uint8_t byte = static_cast<uint8_t>(data[pos]);
+            if (pos == MAX_VARINT_SIZE - 1 && (byte & 0xF0)) return ParseStatus::Malformed;
+            value |= static_cast<uint32_t>(byte & 0x7F) << (7 * pos);
+            if (!(byte & 0x80)) break;
+        }
+        //      ,    
+        if (value > limit) return ParseStatus::TooLarge;
+        if (size < pos + 3) return ParseStatus::Incomplete;
+        frame.type = static_cast<MessageType>(data[pos + 1]);
+        frame.flags = static_cast<uint8_t>(data[pos + 2]);
+        frame.size = value;
+        headerSize = pos + 3;
+        return ParseStatus::Complete;
+    }
+
+    /**
+     * @brief     .
+     */
+    enum class DecodeStatus {
+        Ok, //     
+        Stopped, //   false ( )
+        TooLarge, //    
+        Malformed //  
+    };
+
+    /**
+     * @class FrameDecoder
+     * @brief    .
+     *
+     * ,     ,   
+     * .      ,
+     *          
+     * ,      .
+     */
+    class FrameDecoder {
+    public:
+        /**
+         * @brief    
+         * @param onFrame bool(const FrameView&): false  
+         * @warning    false,    
+         *       
+         */
+        template <typename Handler>
+        DecodeStatus feed(const char* data, size_t size, Handler&& onFrame) {
+            if (hasPartial()) {
+                if (!m_partial) {
+                    //  ,   
+                    const size_t take = size < MAX_HEADER_SIZE - m_headerSize ? size : MAX_HEADER_SIZE - m_headerSize;
+                    std::memcpy(m_header + m_headerSize, data, take);
+                    size_t headerSize = 0;
+                    ParseStatus status = parseHeader(m_header, m_headerSize + take, m_frame, headerSize, m_limit);
+                    if (status == ParseStatus::TooLarge) return DecodeStatus::TooLarge;
+                    if (status == ParseStatus::Malformed) return DecodeStatus::Malformed;
+                    if (status == ParseStatus::Incomplete) {
+                        m_headerSize += take;
+                        return DecodeStatus::Ok;
+                    }
+                    data += headerSize - m_headerSize;
+                    size -= headerSize - m_headerSize;
+                    m_headerSize = 0;
+                    startPayload();
+                }
+                const size_t missing = m_frame.size - m_partial.size();
+                const size_t take = size < missing ? size : missing;
+                m_partial.append(data, take);
+                data += take;
+                size -= take;
+                if (m_partial.size() < m_frame.size) return DecodeStatus::Ok;
+
+                FrameView frame = m_frame;
+                frame.payload = m_partial.data();
+                frame.storage = &m_partial;
+                if (!onFrame(static_cast<const FrameView&>(frame))) return DecodeStatus::Stopped;
+                reset();
+            }
+
+            while (size > 0) {
+                FrameView frame;
+                size_t headerSize = 0;
+                ParseStatus status = parseHeader(data, size, frame, headerSize, m_limit);
+                if (status == ParseStatus::TooLarge) return DecodeStatus::TooLarge;
+                if (status == ParseStatus::Malformed) return DecodeStatus::Malformed;
+                if (status == ParseStatus::Incomplete) {
+                    std::memcpy(m_header, data, size);
+                    m_headerSize = size;
+                    return DecodeStatus::Ok;
+                }
+                if (size - headerSize < frame.size) {
+                    m_frame = frame;
+                    startPayload();
+                    m_partial.append(data + headerSize, size - headerSize);
+                    return DecodeStatus::Ok;
+                }
+                frame.payload = data + headerSize;
+                if (!onFrame(static_cast<const FrameView&>(frame))) return DecodeStatus::Stopped;
+                data += headerSize + frame.size;
+                size -= headerSize + frame.size;
+            }
+            return DecodeStatus::Ok;
+        }
+
+        /**
+         * @brief    ;     MAX_PAYLOAD_SIZE
+         */
+        void setLimit(size_t limit) {
+            m_limit = static_cast<uint32_t>(limit < MAX_PAYLOAD_SIZE ? limit : MAX_PAYLOAD_SIZE);
+        }
+
+        /**
+         * @brief    
+         */
+        bool hasPartial() const { return m_headerSize > 0 || m_partial; }
+
+        /**
+         * @brief        
+         */
+        void reset() {
+            m_partial.reset();
+            m_headerSize = 0;
+        }
+    private:
+        void startPayload() {
+            m_partial = buffers::BufferPool::get(m_frame.size);
+            m_partial.resize(0);
+        }
+
+        char m_header[MAX_HEADER_SIZE]; //  ,  TCP
+        size_t m_headerSize = 0; //    
+        uint32_t m_limit = MAX_PAYLOAD_SIZE; //     
+        FrameView m_frame; //    
+        buffers::Buffer m_partial; //    (   )
+    };
+}
+#endif
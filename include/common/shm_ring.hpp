@@ -0,0 +1,380 @@
+#ifndef SHM_RING_HPP
+#define SHM_RING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <linux/futex.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include "../include/common/net.hpp"
+
+/**
+ * @namespace shm
+ * @brief         ( Linux).
+ *
+ *    Unix-     SCM_RIGHTS
+ * memfd     ( ->    -> )  
+ * eventfd.      ,    TCP.   - SPSC:
+ *   tail,  - head,  ,  
+ *  ,    .   
+ * eventfd:   readerWaiting,    
+ *  ,     eventfd,    .
+ * ,  ,    writerWaiting;   
+ *   futex spaceSeq,   -   eventfd. Unix- 
+ * :     .
+ */
+namespace shm {
+    constexpr uint32_t MAGIC = 0x53484d31; // "SHM1"
+    constexpr size_t DEFAULT_RING_SIZE = 256 * 1024; //      ( )
+    constexpr auto SPIN = std::chrono::microseconds(50); //       
+    constexpr size_t HANDSHAKE_FDS = 3; // memfd, eventfd , eventfd 
+
+    /**
+     * @struct RingState
+     * @brief   ;      -.
+     */
+    struct RingState {
+        alignas(64) std::atomic<uint64_t> head{ 0 }; //   ( )
+        alignas(64) std::atomic<uint64_t> tail{ 0 }; //   ( )
+        alignas(64) std::atomic<uint32_t> readerWaiting{ 0 }; //  ,  
+        std::atomic<uint32_t> writerWaiting{ 0 }; //  ,  
+        std::atomic<uint32_t> spaceSeq{ 0 }; //  futex  
+    };
+
+    /**
+     * @struct Layout
+     * @brief   ;     DATA_OFFSET.
+     */
+    struct Layout {
+        uint32_t magic;
+        uint32_t ringSize;
+        std::atomic<uint32_t> serverClosed{ 0 }; //   
+        RingState toServer;
+        RingState toClient;
+    };
+
+    constexpr size_t DATA_OFFSET = (sizeof(Layout) + 4095) & ~size_t(4095);
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+        "shared rings need address-free atomics");
+
+    /**
+     * @class Ring
+     * @brief       .
+     * @details  head/tail  ,  -  .
+     *      ( ), 
+     *     ,   
+     */
+    class Ring {
+    public:
+        Ring() = default;
+        Ring(RingState* state, char* data, size_t size) : m_state(state), m_data(data), m_size(size) {}
+
+        RingState& state() { return *m_state; }
+        /**
+         * @return     SIZE_MAX,   
+         */
+        size_t readable() const {
+            const uint64_t used = m_state->tail.load(std::memory_order_acquire) - m_state->head.load(std::memory_order_relaxed);
+            return used <= m_size ? static_cast<size_t>(used) : SIZE_MAX;
+        }
+        /**
+         * @return    SIZE_MAX,   
+         */
+        size_t writable() const {
+            const uint64_t used = m_state->tail.load(std::memory_order_relaxed) - m_state->head.load(std::memory_order_acquire);
+            return used <= m_size ? static_cast<size_t>(m_size - used) : SIZE_MAX;
+        }
+        /**
+         * @brief        tail
+         * @return   (SIZE_MAX -  )
+         */
+        size_t write(const char* data, size_t size) {
+            const size_t space = writable();
+            if (space == SIZE_MAX) return SIZE_MAX;
+            const size_t count = size < space ? size : space;
+            if (count == 0) return 0;
+            const uint64_t tail = m_state->tail.load(std::memory_order_relaxed);
+            const size_t offset = static_cast<size_t>(tail) & (m_size - 1);
+            const size_t first = count < m_size - offset ? count : m_size - offset;
+            std::memcpy(m_data + offset, data, first);
+            if (count > first) std::memcpy(m_data, data + first, count - first);
+            m_state->tail.store(tail + count, std::memory_order_release);
+            return count;
+        }
+        /**
+         * @brief      head (  )
+         * @param[out] size  ; SIZE_MAX -  
+         */
+        const char* peek(size_t& size) const {
+            size = readable();
+            if (size == 0 || size == SIZE_MAX) return nullptr;
+            const size_t offset = static_cast<size_t>(m_state->head.load(std::memory_order_relaxed)) & (m_size - 1);
+            if (size > m_size - offset) size = m_size - offset;
+            return m_data + offset;
+        }
+        /**
+         * @brief   
+         */
+        void consume(size_t size) {
+            m_state->head.store(m_state->head.load(std::memory_order_relaxed) + size, std::memory_order_release);
+        }
+    private:
+        RingState* m_state = nullptr;
+        char* m_data = nullptr;
+        size_t m_size = 0;
+    };
+
+    /**
+     * @brief   :  readerWaiting
+     * @return false -    ( ),  
+     */
+    inline bool prepareRead(Ring& ring) {
+        ring.state().readerWaiting.store(1, std::memory_order_seq_cst);
+        if (ring.readable() == 0) return true;
+        ring.state().readerWaiting.store(0, std::memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * @brief    :  writerWaiting
+     * @return false -    ( )
+     */
+    inline bool prepareWrite(Ring& ring) {
+        ring.state().writerWaiting.store(1, std::memory_order_seq_cst);
+        if (ring.writable() == 0) return true;
+        ring.state().writerWaiting.store(0, std::memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * @brief   :    
+     * @return true -   
+     */
+    inline bool takeReaderWaiting(Ring& ring) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return ring.state().readerWaiting.load(std::memory_order_relaxed)
+            && ring.state().readerWaiting.exchange(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief   :    
+     * @return true -   
+     */
+    inline bool takeWriterWaiting(Ring& ring) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return ring.state().writerWaiting.load(std::memory_order_relaxed)
+            && ring.state().writerWaiting.exchange(0, std::memory_order_relaxed);
+    }
+
+    inline void notify(int eventFd) {
+        uint64_t one = 1;
+        ssize_t written = ::write(eventFd, &one, sizeof(one));
+        (void)written;
+    }
+
+    /**
+     * @brief   eventfd ( )
+     */
+    inline void drainEvent(int eventFd) {
+        uint64_t value;
+        ssize_t readBytes = ::read(eventFd, &value, sizeof(value));
+        (void)readBytes;
+    }
+
+    /**
+     * @brief   futex spaceSeq,    seq,   timeoutMs
+     * @details Futex  FUTEX_PRIVATE:      
+     */
+    inline void waitSpace(RingState& state, uint32_t seq, int timeoutMs) {
+        timespec timeout{ timeoutMs / 1000, static_cast<long>(timeoutMs % 1000) * 1000000 };
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&state.spaceSeq), FUTEX_WAIT, seq, &timeout, nullptr, 0);
+    }
+
+    inline void wakeSpace(RingState& state) {
+        state.spaceSeq.fetch_add(1, std::memory_order_release);
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&state.spaceSeq), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    /**
+     * @class Channel
+     * @brief       eventfd.
+     */
+    class Channel {
+    public:
+        ~Channel() {
+            if (m_layout) munmap(m_layout, m_mappedSize);
+            for (int fd : { m_memFd, m_serverEvent, m_clientEvent }) {
+                if (fd >= 0) ::close(fd);
+            }
+        }
+        Channel(const Channel&) = delete;
+        Channel& operator=(const Channel&) = delete;
+
+        /**
+         * @brief    eventfd   ( )
+         * @return nullptr -  memfd/mmap/eventfd
+         */
+        static std::unique_ptr<Channel> create(size_t ringSize = DEFAULT_RING_SIZE) {
+            std::unique_ptr<Channel> channel(new Channel());
+            channel->m_memFd = memfd_create("client-server-shm", MFD_CLOEXEC);
+            channel->m_serverEvent = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            channel->m_clientEvent = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (channel->m_memFd < 0 || channel->m_serverEvent < 0 || channel->m_clientEvent < 0
+                || ftruncate(channel->m_memFd, static_cast<off_t>(DATA_OFFSET + 2 * ringSize)) < 0
+                || !channel->map(DATA_OFFSET + 2 * ringSize)) {
+                return nullptr;
+            }
+            Layout* layout = new (channel->m_layout) Layout();
+            layout->magic = MAGIC;
+            layout->ringSize = static_cast<uint32_t>(ringSize);
+            channel->setupRings(ringSize);
+            return channel;
+        }
+
+        /**
+         * @brief  ,    ( )
+         * @details      
+         * @return nullptr -      
+         */
+        static std::unique_ptr<Channel> attach(int memFd, int serverEvent, int clientEvent) {
+            std::unique_ptr<Channel> channel(new Channel());
+            channel->m_memFd = memFd;
+            channel->m_serverEvent = serverEvent;
+            channel->m_clientEvent = clientEvent;
+            struct stat info {};
+            if (fstat(memFd, &info) < 0 || static_cast<size_t>(info.st_size) < DATA_OFFSET
+                || !channel->map(static_cast<size_t>(info.st_size))) {
+                return nullptr;
+            }
+            const Layout* layout = channel->m_layout;
+            const size_t ringSize = layout->ringSize;
+            if (layout->magic != MAGIC || ringSize == 0 || (ringSize & (ringSize - 1)) != 0
+                || DATA_OFFSET + 2 * ringSize != channel->m_mappedSize) {
+                return nullptr;
+            }
+            channel->setupRings(ringSize);
+            return channel;
+        }
+
+        Ring& toServer() { return m_toServer; }
+        Ring& toClient() { return m_toClient; }
+        Layout& layout() { return *m_layout; }
+        int memFd() const { return m_memFd; }
+        int serverEvent() const { return m_serverEvent; }
+        int clientEvent() const { return m_clientEvent; }
+    private:
+        Channel() = default;
+
+        bool map(size_t size) {
+            void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_memFd, 0);
+            if (memory == MAP_FAILED) return false;
+            m_layout = static_cast<Layout*>(memory);
+            m_mappedSize = size;
+            return true;
+        }
+
+        void setupRings(size_t ringSize) {
+            char* data = reinterpret_cast<char*>(m_layout) + DATA_OFFSET;
+            m_toServer = Ring(&m_layout->toServer, data, ringSize);
+            m_toClient = Ring(&m_layout->toClient, data + ringSize, ringSize);
+        }
+
+        Layout* m_layout = nullptr;
+        size_t m_mappedSize = 0;
+        int m_memFd = -1;
+        int m_serverEvent = -1; //  :   toServer    toClient
+        int m_clientEvent = -1; //    :   toClient
+        Ring m_toServer;
+        Ring m_toClient;
+    };
+
+    /**
+     * @brief     
+     * @details         
+     * ,     
+     */
+    inline std::chrono::microseconds spinTime() {
+        static const bool useful = std::thread::hardware_concurrency() > 1;
+        return useful ? SPIN : std::chrono::microseconds(0);
+    }
+
+    /**
+     * @brief     
+     */
+    inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    /**
+     * @brief   memfd  eventfd  (   SCM_RIGHTS)
+     * @return false -  
+     */
+    inline bool sendChannel(int socket, const Channel& channel) {
+        const int fds[HANDSHAKE_FDS] = { channel.memFd(), channel.serverEvent(), channel.clientEvent() };
+        char tag = 'S';
+        iovec part{ &tag, 1 };
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))];
+        msghdr msg{};
+        msg.msg_iov = &part;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+        std::memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+        ssize_t sent;
+        do {
+            sent = ::sendmsg(socket, &msg, MSG_NOSIGNAL);
+        } while (sent < 0 && errno == EINTR);
+        return sent == 1;
+    }
+
+    /**
+     * @brief        timeoutMs   
+     * @return nullptr -       
+     */
+    inline std::unique_ptr<Channel> receiveChannel(int socket, int timeoutMs) {
+        pollfd entry{ socket, POLLIN, 0 };
+        if (::poll(&entry, 1, timeoutMs) <= 0) return nullptr;
+        char tag = 0;
+        iovec part{ &tag, 1 };
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * HANDSHAKE_FDS)];
+        msghdr msg{};
+        msg.msg_iov = &part;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        ssize_t received;
+        do {
+            received = ::recvmsg(socket, &msg, MSG_CMSG_CLOEXEC);
+        } while (received < 0 && errno == EINTR);
+        int fds[HANDSHAKE_FDS] = { -1, -1, -1 };
+        size_t count = 0;
+        cmsghdr* cmsg = received == 1 ? CMSG_FIRSTHDR(&msg) : nullptr;
+        if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            std::memcpy(fds, CMSG_DATA(cmsg), sizeof(int) * std::min(count, HANDSHAKE_FDS));
+        }
+        if (tag != 'S' || count != HANDSHAKE_FDS || (msg.msg_flags & MSG_CTRUNC)) {
+            for (size_t i = 0; i < std::min(count, HANDSHAKE_FDS); ++i) ::close(fds[i]);
+            return nullptr;
+        }
+        return Channel::attach(fds[0], fds[1], fds[2]);
+    }
+}
+#endif
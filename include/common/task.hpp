@@ -0,0 +1,159 @@
+#ifndef TASK_HPP
+#define TASK_HPP
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+/**
+ * @namespace coro
+ * @brief  C++20      .
+ *
+ * Task -  :     
+ * co_await ( start()   ),   
+ *     ,   .
+ *  ,  , ,  
+ *      .
+ * @warning GCC 12   co_await    if
+ * (if (co_await x)):      .
+ */
+namespace coro {
+    template <typename T = void>
+    class Task;
+
+    namespace detail {
+        /**
+         * @brief        
+         */
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+                std::coroutine_handle<> continuation = handle.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+            void await_resume() const noexcept {}
+        };
+
+        struct PromiseBase {
+            std::coroutine_handle<> continuation; // ,  
+            std::exception_ptr error; //  ,   co_await
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+            void unhandled_exception() noexcept { error = std::current_exception(); }
+        };
+
+        template <typename T>
+        struct Promise : PromiseBase {
+            std::optional<T> value;
+
+            Task<T> get_return_object() noexcept;
+            template <typename U>
+            void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+            T take() {
+                if (error) std::rethrow_exception(error);
+                return std::move(*value);
+            }
+        };
+
+        template <>
+        struct Promise<void> : PromiseBase {
+            Task<void> get_return_object() noexcept;
+            void return_void() const noexcept {}
+            void take() const {
+                if (error) std::rethrow_exception(error);
+            }
+        };
+    }
+
+    /**
+     * @class Task
+     * @brief     T;   .
+     * @details  Task    : ,
+     *  -,    
+     */
+    template <typename T>
+    class [[nodiscard]] Task {
+    public:
+        using promise_type = detail::Promise<T>;
+        using Handle = std::coroutine_handle<promise_type>;
+
+        Task() = default;
+        explicit Task(Handle handle) noexcept : m_handle(handle) {}
+        Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                reset();
+                m_handle = std::exchange(other.m_handle, {});
+            }
+            return *this;
+        }
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+        ~Task() { reset(); }
+
+        bool valid() const { return static_cast<bool>(m_handle); }
+        bool done() const { return !m_handle || m_handle.done(); }
+
+        /**
+         * @brief      
+         * @note     co_await
+         */
+        void start() { m_handle.resume(); }
+
+        /**
+         * @brief     (  )
+         */
+        T result() { return m_handle.promise().take(); }
+
+        auto operator co_await() const noexcept {
+            struct Awaiter {
+                Handle handle;
+                bool await_ready() const noexcept { return !handle || handle.done(); }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                    handle.promise().continuation = awaiting;
+                    return handle;
+                }
+                T await_resume() { return handle.promise().take(); }
+            };
+            return Awaiter{ m_handle };
+        }
+    private:
+        void reset() {
+            if (m_handle) m_handle.destroy();
+            m_handle = {};
+        }
+
+        Handle m_handle;
+    };
+
+    namespace detail {
+        template <typename T>
+        Task<T> Promise<T>::get_return_object() noexcept {
+            return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+        }
+
+        inline Task<void> Promise<void>::get_return_object() noexcept {
+            return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+        }
+    }
+
+    /**
+     * @struct Detached
+     * @brief   :    
+     *     .
+     * @note ,   ,   (  std::thread)
+     */
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() const noexcept { return {}; }
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept {}
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+    };
+}
+#endif
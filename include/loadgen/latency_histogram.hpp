@@ -0,0 +1,122 @@
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+/**
+ * @class LatencyHistogram
+ * @brief     HDR Histogram.
+ *
+ *  ()   -
+ * :      SUB_BUCKETS  ,
+ *      1 / SUB_BUCKETS (< 1%)
+ *    64- .  -   
+ * ,   ;   .
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 7;
+    static constexpr uint64_t SUB_BUCKETS = 1ull << SUB_BUCKET_BITS; // 128    
+    static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS) * SUB_BUCKETS + SUB_BUCKETS;
+
+    LatencyHistogram() : m_counts(BUCKET_COUNT, 0) {}
+
+    /**
+     * @brief  
+     */
+    void record(uint64_t value) {
+        ++m_counts[indexOf(value)];
+        ++m_total;
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+    }
+
+    /**
+     * @brief    (, )
+     */
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            m_counts[i] += other.m_counts[i];
+        }
+        m_total += other.m_total;
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+    }
+
+    /**
+     * @brief  
+     * @param percentile 0..100
+     * @return   ,     (  max)
+     */
+    uint64_t percentile(double percentile) const {
+        if (m_total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(m_total) + 0.5);
+        rank = std::max<uint64_t>(1, std::min(rank, m_total));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += m_counts[i];
+            if (seen >= rank) return std::min(highestOf(i), m_max);
+        }
+        return m_max;
+    }
+
+    uint64_t count() const { return m_total; }
+    uint64_t min() const { return m_total ? m_min : 0; }
+    uint64_t max() const { return m_max; }
+
+    /**
+     * @brief    
+     */
+    double mean() const {
+        if (m_total == 0) return 0;
+        double sum = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            if (m_counts[i]) sum += static_cast<double>(m_counts[i]) * static_cast<double>(lowestOf(i) + highestOf(i)) / 2.0;
+        }
+        return sum / static_cast<double>(m_total);
+    }
+private:
+    /**
+     * @details   2 * SUB_BUCKETS  ; 
+     *  b >= 1  [SUB_BUCKETS << b, 2 * SUB_BUCKETS << b)
+     *   1 << b
+     */
+    static size_t indexOf(uint64_t value) {
+        const int msb = 63 - countLeadingZeros(value | 1);
+        const int shift = std::max(0, msb - SUB_BUCKET_BITS);
+        return (static_cast<size_t>(shift) << SUB_BUCKET_BITS) + static_cast<size_t>(value >> shift);
+    }
+
+    static int shiftOf(size_t index) {
+        return index < 2 * SUB_BUCKETS ? 0 : static_cast<int>(index >> SUB_BUCKET_BITS) - 1;
+    }
+
+    static uint64_t lowestOf(size_t index) {
+        const int shift = shiftOf(index);
+        return static_cast<uint64_t>(index - (static_cast<size_t>(shift) << SUB_BUCKET_BITS)) << shift;
+    }
+
+    static uint64_t highestOf(size_t index) {
+        const int shift = shiftOf(index);
+        return lowestOf(index) + ((1ull << shift) - 1);
+    }
+
+    static int countLeadingZeros(uint64_t value) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return 63 - static_cast<int>(index);
+#else
+        return __builtin_clzll(value);
+#endif
+    }
+
+    std::vector<uint64_t> m_counts; //  
+    uint64_t m_total = 0;
+    uint64_t m_min = UINT64_MAX;
+    uint64_t m_max = 0;
+};
+#endif
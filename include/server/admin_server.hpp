@@ -0,0 +1,84 @@
+#ifndef ADMIN_SERVER_HPP
+#define ADMIN_SERVER_HPP
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include "../include/common/net.hpp"
+
+class ConnectionRegistry;
+
+/**
+ * @class AdminServer
+ * @brief  HTTP-   .
+ *
+ * GET /metrics      Prometheus,
+ * GET /stats -  JSON.      
+ * ,       : 
+ *    .
+ *
+ *      GET /connections ( 
+ * ).  POST /connections/ID/send (  
+ *   Text)  POST /connections/ID/close , 
+ *    ,      X-Admin-Token:
+ *  POST         , 
+ *      CORS   .
+ *         .
+ */
+class AdminServer {
+public:
+    static constexpr size_t MAX_REQUEST_SIZE = 4096; //  -  
+    static constexpr DWORD REQUEST_TIMEOUT_MS = 2000; //     
+    static constexpr const char* TOKEN_HEADER = "X-Admin-Token"; //   
+
+    /**
+     * @param port   
+     * @param address   (   )
+     * @param connections   , nullptr -  /connections
+     * @param controlToken   send  close,  -  
+     */
+    explicit AdminServer(uint16_t port, const std::string& address = "127.0.0.1",
+        ConnectionRegistry* connections = nullptr, const std::string& controlToken = std::string());
+    ~AdminServer();
+    AdminServer(const AdminServer&) = delete;
+    AdminServer& operator=(const AdminServer&) = delete;
+
+    /**
+     * @brief      
+     * @return false,      
+     */
+    bool start();
+    /**
+     * @brief  ,     
+     */
+    void stop();
+private:
+    void run();
+    void handle(SOCKET client);
+    /**
+     * @brief  HTTP-   method path   body
+     * @param token   X-Admin-Token ( -  )
+     */
+    std::string respond(const std::string& method, const std::string& path, const std::string& body,
+        const std::string& token);
+    /**
+     * @brief   /connections  /connections/ID/...
+     * @param[out] status HTTP-,    
+     * @return  JSON-
+     */
+    std::string respondConnections(const std::string& method, const std::string& route,
+        const std::string& body, const std::string& token, std::string& status);
+    /**
+     * @brief    m_controlToken  ,    
+     */
+    bool authorized(const std::string& token) const;
+
+    uint16_t m_port;
+    std::string m_address;
+    ConnectionRegistry* m_connections;
+    std::string m_controlToken; //   send  close,  -  
+    SOCKET m_socket = INVALID_SOCKET;
+    std::atomic<bool> m_running{ false };
+    std::thread m_thread;
+};
+#endif
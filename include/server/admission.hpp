@@ -0,0 +1,112 @@
+#ifndef ADMISSION_HPP
+#define ADMISSION_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @struct AdmissionOptions
+ * @brief    (0 -  ).
+ */
+struct AdmissionOptions {
+    unsigned maxConnections = 0; //    (0 -  MAX_CLIENTS)
+    unsigned maxPerSource = 0; //    IP-
+    double messageRate = 0; //     
+    unsigned messageBurst = 0; //    (0 -  messageRate)
+    uint32_t shedLatencyUs = 50000; //    ,    
+    unsigned shedQueueDepth = 0; //      ,    
+};
+
+/**
+ * @struct TokenBucket
+ * @brief   :    ,
+ *     rate  burst.
+ */
+struct TokenBucket {
+    double tokens = -1; // -1 -    
+    std::chrono::steady_clock::time_point updated;
+
+    /**
+     * @brief  ,   
+     * @return false -   
+     */
+    bool take(double rate, double burst, std::chrono::steady_clock::time_point now) {
+        if (tokens < 0) {
+            tokens = burst;
+        }
+        else if (now > updated) {
+            tokens += rate * std::chrono::duration<double>(now - updated).count();
+            if (tokens > burst) tokens = burst;
+        }
+        updated = now;
+        if (tokens < 1) return false;
+        tokens -= 1;
+        return true;
+    }
+};
+
+/**
+ * @class AdmissionController
+ * @brief      .
+ *
+ *        ,
+ *   IPv4-,     
+ * .      :  
+ *     (  64K    ).
+ */
+class AdmissionController {
+public:
+    static constexpr size_t SOURCE_SLOTS = 1 << 16; //    ( )
+    static constexpr uint32_t NO_SOURCE = 0; //     
+
+    explicit AdmissionController(const AdmissionOptions& options = AdmissionOptions())
+        : m_options(options) {
+        if (m_options.maxPerSource > 0) {
+            m_sources.reset(new std::atomic<uint32_t>[SOURCE_SLOTS]());
+        }
+    }
+    AdmissionController(const AdmissionController&) = delete;
+    AdmissionController& operator=(const AdmissionController&) = delete;
+
+    const AdmissionOptions& options() const { return m_options; }
+    bool limitsSources() const { return m_sources != nullptr; }
+    bool limitsMessages() const { return m_options.messageRate > 0; }
+    double messageBurst() const {
+        return m_options.messageBurst > 0 ? m_options.messageBurst : (m_options.messageRate < 1 ? 1 : m_options.messageRate);
+    }
+
+    /**
+     * @brief     address (IPv4,   )
+     * @return   releaseSource, NO_SOURCE    -1, 
+     *   
+     */
+    int64_t admitSource(uint32_t address) {
+        if (!m_sources) return NO_SOURCE;
+        const uint32_t slot = hash(address);
+        std::atomic<uint32_t>& count = m_sources[slot];
+        uint32_t current = count.load(std::memory_order_relaxed);
+        do {
+            if (current >= m_options.maxPerSource) return -1;
+        } while (!count.compare_exchange_weak(current, current + 1, std::memory_order_relaxed));
+        return static_cast<int64_t>(slot) + 1;
+    }
+
+    /**
+     * @brief  ,  admitSource
+     */
+    void releaseSource(uint32_t source) {
+        if (source == NO_SOURCE || !m_sources) return;
+        m_sources[source - 1].fetch_sub(1, std::memory_order_relaxed);
+    }
+private:
+    static uint32_t hash(uint32_t address) {
+        return (address * 2654435761u) >> (32 - 16);
+    }
+
+    AdmissionOptions m_options;
+    std::unique_ptr<std::atomic<uint32_t>[]> m_sources; //    
+};
+#endif
@@ -0,0 +1,69 @@
+#ifndef CAPTURE_WRITER_HPP
+#define CAPTURE_WRITER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "../include/common/capture.hpp"
+
+/**
+ * @class CaptureWriter
+ * @brief      ( Linux).
+ *
+ *      (  limit)  mmap, 
+ *       ,    
+ * .     capture::BLOCK_SIZE 
+ *    ;      .
+ *     .      
+ * .   ,      
+ *  capture_dropped.
+ */
+class CaptureWriter {
+public:
+    /**
+     * @struct Cursor
+     * @brief   -.
+     */
+    struct Cursor {
+        char* position = nullptr;
+        char* end = nullptr;
+    };
+
+    CaptureWriter() = default;
+    ~CaptureWriter();
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    /**
+     * @brief   path   
+     * @details     (O_EXCL)
+     * @param limit     
+     * @return false -   ,     
+     */
+    bool open(const std::string& path, size_t limit);
+    /**
+     * @brief       
+     * @note ,  - 
+     */
+    void close();
+    /**
+     * @brief    connection,    time
+     * @param cursor  ;       
+     */
+    void record(Cursor& cursor, uint64_t connection, std::chrono::steady_clock::time_point time,
+        const protocol::FrameView& frame);
+private:
+    /**
+     * @brief    
+     * @return false -  
+     */
+    bool reserve(Cursor& cursor);
+
+    int m_fd = -1;
+    char* m_base = nullptr; //  
+    size_t m_limit = 0; //  
+    std::chrono::steady_clock::time_point m_start; //    
+    alignas(64) std::atomic<size_t> m_used{ capture::FILE_HEADER_SIZE }; //   
+};
+#endif
@@ -0,0 +1,225 @@
+#ifndef CONNECTION_REGISTRY_HPP
+#define CONNECTION_REGISTRY_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../include/common/net.hpp"
+#include "../include/common/buffer_pool.hpp"
+#include "../include/common/protocol.hpp"
+#include "../include/server/mpsc_queue.hpp"
+
+class Reactor;
+
+/**
+ * @struct ConnectionCommand
+ * @brief        .
+ * @details  -  Reactor::post  
+ *   ;      
+ */
+struct ConnectionCommand : MpscNode {
+    SOCKET socket = INVALID_SOCKET; //  (    
+    uint64_t connectionId = 0; // :     )
+    bool close = false; // true - , false -  frame
+    buffers::Buffer frame; //  
+    std::string reason; //    
+};
+
+/**
+ * @class ConnectionRegistry
+ * @brief    :  ,  
+ *  CHUNK_SIZE,    .
+ *
+ *  -     .   
+ * ,      , 
+ *   .        ( 
+ *   ABA),   ,    - O(1) 
+ *   .        
+ * (   );  ,     
+ * ,         .
+ *  ,    ,   
+ *   ,      .
+ */
+class ConnectionRegistry {
+public:
+    using Id = uint64_t;
+    static constexpr Id INVALID_ID = 0;
+    static constexpr size_t CHUNK_SIZE = 1024; //     (64 )
+    static constexpr size_t MAX_CAPACITY = size_t(1) << 22; //  :   - 32 
+
+    /**
+     * @struct Slot
+     * @brief  :   .
+     * @details    - ,  
+     *    ;    -,  
+     *      
+     */
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> state{ 0 }; //  ( 32 ),    LIVE
+        std::atomic<uint32_t> nextFree{ 0 }; //     
+        SOCKET socket = INVALID_SOCKET;
+        Reactor* owner = nullptr; //   (Linux); nullptr -   
+        uint64_t engineId = 0; //    
+        std::chrono::steady_clock::time_point connectedAt;
+        std::atomic<uint64_t> bytesIn{ 0 }; //  
+        std::atomic<uint64_t> messages{ 0 }; //  
+#ifndef __linux__
+        std::mutex sendMutex; //    send()     
+#endif
+
+        /**
+         * @brief    ( -,   RMW)
+         */
+        static void bump(std::atomic<uint64_t>& counter, uint64_t value) {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @class Ref
+     * @brief  :   ,   
+     *       .
+     */
+    class Ref {
+    public:
+        Ref() = default;
+        Ref(const Ref&) = delete;
+        Ref& operator=(const Ref&) = delete;
+        Ref(Ref&& other) noexcept : m_slot(other.m_slot) { other.m_slot = nullptr; }
+        ~Ref() { release(); }
+        explicit operator bool() const { return m_slot != nullptr; }
+        const Slot* operator->() const { return m_slot; }
+        const Slot& operator*() const { return *m_slot; }
+    private:
+        friend class ConnectionRegistry;
+        explicit Ref(Slot* slot) : m_slot(slot) {}
+        void release();
+
+        Slot* m_slot = nullptr;
+    };
+
+    /**
+     * @param capacity   (  MAX_CAPACITY);  
+     *    .      
+     *   
+     */
+    explicit ConnectionRegistry(size_t capacity);
+    ConnectionRegistry(const ConnectionRegistry&) = delete;
+    ConnectionRegistry& operator=(const ConnectionRegistry&) = delete;
+
+    /**
+     * @brief     
+     * @param owner  , nullptr -    
+     * @return   INVALID_ID,   
+     * @note     
+     */
+    Id add(SOCKET socket, Reactor* owner, uint64_t engineId);
+    /**
+     * @brief   
+     * @details    id    ; 
+     * ,   ,  
+     * @note       
+     */
+    void remove(Id id);
+    /**
+     * @brief    
+     * @return   -     id 
+     * @note     
+     */
+    Ref find(Id id);
+    /**
+     * @brief       
+     * @note  -,    
+     */
+    Slot& owned(Id id) { return slotAt(indexOf(id)); }
+    /**
+     * @brief    type   payload
+     * @details  Linux   -    
+     * ;        sendMutex 
+     * @return false -       
+     * @note     
+     */
+    bool send(Id id, protocol::MessageType type, const char* payload, size_t size);
+    /**
+     * @brief  
+     * @details    ;    
+     *  shutdown,     
+     * @return false -   
+     * @note     
+     */
+    bool close(Id id, const std::string& reason);
+    /**
+     * @brief  visit(id, slot)    
+     * @details      ;
+     *      visit
+     */
+    template <typename Visit>
+    void forEach(Visit&& visit) {
+        const size_t used = m_used.load(std::memory_order_acquire);
+        for (size_t index = 0; index < used; ++index) {
+            const uint64_t state = slotAt(index).state.load(std::memory_order_acquire);
+            if (!(state & LIVE)) continue;
+            const Id id = makeId(index, state);
+            Ref ref = find(id);
+            if (ref) visit(id, *ref);
+        }
+    }
+    /**
+     * @brief   
+     */
+    size_t size() const { return m_count.load(std::memory_order_relaxed); }
+    size_t capacity() const { return m_capacity; }
+private:
+    static constexpr uint32_t NO_SLOT = UINT32_MAX; //    
+    static constexpr uint64_t LIVE = 1; //    
+    static constexpr uint64_t REF = 2; //      
+    static constexpr uint64_t REF_MASK = 0xFFFFFFFEull; //   
+
+    static Id makeId(size_t index, uint64_t state) {
+        return (state & ~0xFFFFFFFFull) | static_cast<uint32_t>(index + 1);
+    }
+    static size_t indexOf(Id id) { return static_cast<size_t>(static_cast<uint32_t>(id)) - 1; }
+    /**
+     * @brief      
+     * @details         (
+     * m_used)     
+     */
+    Slot& slotAt(size_t index) const {
+        return m_chunks[index / CHUNK_SIZE].load(std::memory_order_acquire)[index % CHUNK_SIZE];
+    }
+    /**
+     * @brief     nullptr,      
+     */
+    Slot* findSlot(size_t index) const {
+        Slot* chunk = m_chunks[index / CHUNK_SIZE].load(std::memory_order_acquire);
+        return chunk ? chunk + index % CHUNK_SIZE : nullptr;
+    }
+    /**
+     * @brief    nullptr,    
+     */
+    Slot* slotOf(Id id) const {
+        const uint32_t number = static_cast<uint32_t>(id);
+        return number == 0 || number > m_capacity ? nullptr : findSlot(number - 1);
+    }
+    void pushFree(uint32_t index);
+    uint32_t popFree();
+    /**
+     * @brief          
+     * @return false -    capacity
+     */
+    bool grow();
+
+    const size_t m_capacity;
+    std::unique_ptr<std::atomic<Slot*>[]> m_chunks; //    ; nullptr -  
+    std::vector<std::unique_ptr<Slot[]>> m_chunkStorage; //   (m_growMutex)
+    std::mutex m_growMutex; //  ; ,      
+    size_t m_allocated = 0; //   (m_growMutex)
+    alignas(64) std::atomic<uint64_t> m_freeHead{ NO_SLOT }; //  ( 32 )   
+    alignas(64) std::atomic<size_t> m_used{ 0 }; //      - 
+    std::atomic<size_t> m_count{ 0 };
+};
+#endif
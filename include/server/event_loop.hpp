@@ -0,0 +1,558 @@
+#ifndef EVENT_LOOP_HPP
+#define EVENT_LOOP_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+#include <sys/uio.h>
+#include "../include/common/net.hpp"
+#include "../include/common/protocol.hpp"
+#include "../include/common/compression.hpp"
+#include "../include/server/timer_wheel.hpp"
+#include "../include/server/admission.hpp"
+#include "../include/server/session.hpp"
+#include "../include/server/router.hpp"
+#include "../include/server/pubsub.hpp"
+#include "../include/server/handoff.hpp"
+#include "../include/server/connection_registry.hpp"
+#include "../include/server/capture_writer.hpp"
+
+class Server;
+
+/**
+ * @struct Connection
+ * @brief      .
+ *      ,   
+ *   ,  , ,   
+ *     .
+ */
+struct Connection {
+    SOCKET socket = INVALID_SOCKET; //  
+    uint64_t id = 0; //    ( ,    )
+    protocol::FrameDecoder decoder; //  ,  TCP
+    buffers::Buffer pending; //  ,       ( )
+    bool readPaused = false; //  ,    pending
+    bool replyBacklog = false; //  :      (Server::MAX_REPLY_BACKLOG)
+    ConnectionClass connectionClass = ConnectionClass::New; //  
+    std::chrono::steady_clock::time_point lastActivity; //   
+    std::chrono::steady_clock::time_point lastWrite; //        
+    TimerNode timers[TIMER_KIND_COUNT]; //  ,    (TimerKind)
+    uint32_t source = AdmissionController::NO_SOURCE; //    AdmissionController
+    TokenBucket messageBucket; //   
+    std::unique_ptr<Session> session; // -,   
+    uint64_t requestSeq = 0; //   
+    uint64_t replySeq = 0; //  ,    
+    std::unique_ptr<std::deque<std::unique_ptr<RouteJob>>> deferredReplies; // [i] -   replySeq + i,      (    )
+    unsigned poolJobs = 0; //  ,     
+    std::unique_ptr<Subscriber> subscriber; //   ,   
+    bool compressReplies = false; //     Hello
+    compression::Dictionary replyDictionary = compression::Dictionary::None; //   
+    ConnectionRegistry::Id registryId = ConnectionRegistry::INVALID_ID; //    
+    int sendError = 0; // errno ,   sendFrame/sendEncoded  false (0 -   )
+
+    /**
+     * @brief    :     
+     */
+    bool readStopped() const { return readPaused || replyBacklog; }
+    /**
+     * @brief     sendFrame/sendEncoded
+     */
+    std::string sendFailure() const {
+        return sendError != 0 ? "socket error: " + std::to_string(sendError) : "send failed";
+    }
+};
+
+/**
+ * @struct EpollConnection
+ * @brief  epoll-:   MSG_ZEROCOPY.
+ *        , 
+ *   ,       
+ *       .
+ */
+struct EpollConnection : Connection {
+    /**
+     * @struct ZeroCopyHold
+     * @brief ,       seq.
+     */
+    struct ZeroCopyHold {
+        uint32_t seq;
+        buffers::Buffer buffer;
+    };
+
+    bool zeroCopy = false; // SO_ZEROCOPY       
+    uint32_t zeroCopySeq = 0; //   MSG_ZEROCOPY- ( )
+    std::vector<ZeroCopyHold> zeroCopyHolds; //     
+};
+
+/**
+ * @struct ReactorTuning
+ * @brief      .
+ */
+struct ReactorTuning {
+    int cpu = -1; //  , -1 -  
+    bool numaLocal = false; //      NUMA  cpu
+    bool quickAck = false; // TCP_QUICKACK  ,   
+    uint32_t spinUs = 0; //       (EventLoop)
+    int eventBatch = 256; //    epoll_wait (EventLoop)
+    size_t readBufferSize = 64 * 1024; //   recv (EventLoop)
+};
+
+/**
+ * @class Reactor
+ * @brief    - .
+ *          
+ * Server::onData;      sendFrame().
+ */
+class Reactor {
+public:
+    /**
+     * @note     ,   
+     */
+    virtual ~Reactor();
+    /**
+     * @brief   
+     * @return true -  , false -  
+     */
+    virtual bool start() = 0;
+    /**
+     * @brief       
+     */
+    virtual void stop() = 0;
+    /**
+     * @brief      
+     * @param payload ;        
+     * @param storage  ,    payload (FrameView::storage):
+     *        
+     * @return false,     ( )
+     * @note     
+     */
+    virtual bool sendFrame(Connection& conn, protocol::MessageType type, uint8_t flags,
+        const char* payload, size_t size, const buffers::Buffer* storage = nullptr) = 0;
+    /**
+     * @brief      
+     * @param reason   
+     * @warning    conn 
+     */
+    virtual void closeConnection(Connection& conn, const std::string& reason) = 0;
+    /**
+     * @brief        
+     * @return nullptr -   
+     * @note     
+     */
+    virtual Connection* findConnection(SOCKET socket, uint64_t id) = 0;
+    /**
+     * @brief      ,   
+     * @details      ;  
+     *    ,      
+     * @return false,     ( )
+     * @note     
+     */
+    virtual bool sendEncoded(Connection& conn, const buffers::Buffer& frame) = 0;
+    /**
+     * @brief     ,    
+     */
+    virtual size_t queuedBytes(const Connection& conn) const = 0;
+    /**
+     * @brief   ,    replyBacklog
+     * @details ,    ,      
+     *     ,    
+     * @note     
+     */
+    virtual void resumeRead(Connection& conn) = 0;
+    /**
+     * @brief         
+     * @details   ; eventfd ,   
+     *     
+     * @note     
+     */
+    void post(RouteJob* job) {
+        m_completions.push(job);
+        if (!m_completionsPending.exchange(true, std::memory_order_acq_rel)) wake();
+    }
+    /**
+     * @brief     nullptr
+     * @note     
+     */
+    RouteJob* takeCompletion() { return m_completions.pop(); }
+    /**
+     * @brief   ,    
+     * @note     ,     stop()
+     */
+    void post(Broadcast* broadcast) {
+        m_broadcasts.push(broadcast);
+        if (!m_completionsPending.exchange(true, std::memory_order_acq_rel)) wake();
+    }
+    /**
+     * @brief      nullptr
+     * @note     
+     */
+    Broadcast* takeBroadcast() { return m_broadcasts.pop(); }
+    /**
+     * @brief   ,    
+     * @note     
+     */
+    void post(handoff::Adoption* adoption) {
+        m_adoptions.push(adoption);
+        if (!m_completionsPending.exchange(true, std::memory_order_acq_rel)) wake();
+    }
+    /**
+     * @brief     nullptr
+     * @note     
+     */
+    handoff::Adoption* takeAdoption() { return m_adoptions.pop(); }
+    /**
+     * @brief        
+     * @note     
+     */
+    void post(ConnectionCommand* command) {
+        m_commands.push(command);
+        if (!m_completionsPending.exchange(true, std::memory_order_acq_rel)) wake();
+    }
+    /**
+     * @brief    nullptr
+     * @note     
+     */
+    ConnectionCommand* takeCommand() { return m_commands.pop(); }
+    /**
+     * @brief  ,    , 
+     *   ( Server::onConnect)
+     * @param connectionClass     :  
+     *   
+     * @return   nullptr ( )
+     * @note     
+     */
+    virtual Connection* adoptSocket(SOCKET socket, ConnectionClass connectionClass) = 0;
+    /**
+     * @brief        :
+     *   ,     
+     *   Server::handOff    
+     * @note     
+     */
+    void beginHandoff() {
+        m_handoffRequested.store(true, std::memory_order_release);
+        wake();
+    }
+    /**
+     * @brief     
+     * @note     
+     */
+    TopicTable& topics() { return m_topics; }
+    /**
+     * @brief     
+     * @note     
+     */
+    int connectionCount() const { return m_connectionCount.load(std::memory_order_relaxed); }
+    /**
+     * @brief    ,      (  start())
+     */
+    void setTuning(const ReactorTuning& tuning) { m_tuning = tuning; }
+    /**
+     * @brief     (  start())
+     */
+    void setMaxConnections(int maxConnections) { m_maxConnections = maxConnections; }
+    /**
+     * @brief       (  start())
+     */
+    void setAdmission(AdmissionController* admission) { m_admission = admission; }
+    /**
+     * @brief  ,      (  start())
+     */
+    void setRegistry(ConnectionRegistry* registry) { m_registry = registry; }
+    /**
+     * @brief     (  start())
+     */
+    void setTimeouts(const TimeoutPolicies& timeouts) { m_timeouts = timeouts; }
+    /**
+     * @brief   threshold      
+     *    (0 -  ;   start())
+     */
+    void setZeroCopyThreshold(size_t threshold) { m_zeroCopyThreshold = threshold; }
+    /**
+     * @brief        (  start())
+     */
+    void setPubSub(const PubSubOptions& options) { m_topics.setOptions(options); }
+    /**
+     * @brief    ,     
+     * ,  ,   
+     * @note      
+     */
+    void updateReadDeadline(Connection& conn);
+    /**
+     * @brief     Active    
+     *       
+     * @details       New  
+     *      
+     * @note     
+     */
+    void activate(Connection& conn);
+    /**
+     * @brief    :    
+     * @note     
+     */
+    std::chrono::steady_clock::time_point now() const { return m_now; }
+    /**
+     * @brief    ,     
+     * @note     
+     */
+    CaptureWriter::Cursor& captureCursor() { return m_captureCursor; }
+protected:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief       
+     * @details  numaLocal       
+     *  (MPOL_LOCAL),      
+     * @note     
+     */
+    void pinThread();
+    /**
+     * @brief   ,   pinThread(),  
+     * NUMA   (  numaLocal)
+     */
+    void moveToLocalNode(void* data, size_t size);
+    /**
+     * @brief   TCP_QUICKACK,     
+     * @details     ,  
+     *   .   
+     *    ,       
+     *    ( 40 )
+     * @note     
+     */
+    void rearmQuickAck(const Connection& conn) {
+        if (!m_tuning.quickAck || !conn.decoder.hasPartial()) return;
+        int enable = 1;
+        setsockopt(conn.socket, IPPROTO_TCP, TCP_QUICKACK, &enable, sizeof(enable));
+    }
+    /**
+     * @brief        
+     */
+    void initTimers(Connection& conn);
+    /**
+     * @brief    
+     * @note   ,   conn
+     */
+    void cancelTimers(Connection& conn);
+    /**
+     * @brief   ,      
+     */
+    void armWriteDeadline(Connection& conn);
+    /**
+     * @brief   :   
+     */
+    void cancelWriteDeadline(Connection& conn);
+    /**
+     * @brief    
+     * @details       : 
+     *     lastActivity   
+     *    .       lastWrite.
+     */
+    void expireTimers();
+    /**
+     * @brief       (-1 - )
+     * @details       OVERLOAD_RECHECK_MS,
+     *        ;
+     *    -    
+     */
+    int timerTimeoutMs() const {
+        const int timeout = m_timers.timeoutMs(Clock::now());
+        if (!m_overloaded && !m_handingOff) return timeout;
+        return timeout < 0 || timeout > OVERLOAD_RECHECK_MS ? OVERLOAD_RECHECK_MS : timeout;
+    }
+    /**
+     * @brief        
+     * @param address IPv4-  (  )
+     * @return false -   ,   
+     */
+    bool admitSource(Connection& conn, uint32_t address);
+    /**
+     * @brief      
+     * @return IPv4- (  );  Unix- - 127.0.0.1
+     */
+    static uint32_t sourceAddress(const sockaddr_storage& address);
+    /**
+     * @brief       
+     * @note    
+     */
+    void releaseSource(Connection& conn);
+    /**
+     * @brief     id   
+     * @note       
+     */
+    void registerConnection(Connection& conn) {
+        if (m_registry) conn.registryId = m_registry->add(conn.socket, this, conn.id);
+    }
+    /**
+     * @brief     
+     * @note      ,   
+     */
+    void unregisterConnection(Connection& conn) {
+        if (m_registry && conn.registryId != ConnectionRegistry::INVALID_ID) m_registry->remove(conn.registryId);
+        conn.registryId = ConnectionRegistry::INVALID_ID;
+    }
+    /**
+     * @brief   "Server is busy"   
+     */
+    void rejectSocket(SOCKET socket, const char* reason);
+    /**
+     * @brief       
+     *     
+     * @param events   (CQE),   
+     * @details  -      
+     *   ;       .
+     *       , 
+     * ,   5% .   , 
+     *     listen,     .
+     */
+    void updateAdmission(size_t events);
+    /**
+     * @brief  ,     
+     */
+    void pauseForCapacity();
+    /**
+     * @brief  beginHandoff()     
+     * @note     
+     */
+    void updateHandoff();
+    /**
+     * @brief    ,  Server::handOff
+     *  ;    
+     */
+    virtual void handOffConnections() = 0;
+    /**
+     * @brief       
+     */
+    virtual void enableAccept(bool enable) = 0;
+    /**
+     * @brief       (eventfd)
+     */
+    virtual void wake() = 0;
+    /**
+     * @brief     
+     * @return true - post()       
+     * @details     : , 
+     *   ,   
+     */
+    bool takeCompletionsPending() {
+        return m_completionsPending.load(std::memory_order_relaxed)
+            && m_completionsPending.exchange(false, std::memory_order_acq_rel);
+    }
+    const TimeoutPolicy& policy(const Connection& conn) const {
+        return m_timeouts[static_cast<size_t>(conn.connectionClass)];
+    }
+
+    alignas(64) std::atomic<int> m_connectionCount{ 0 }; //  -:   
+    alignas(64) std::atomic<bool> m_completionsPending{ false }; //  m_completions  m_broadcasts  ,  
+    MpscQueue<RouteJob> m_completions; //      
+    MpscQueue<Broadcast> m_broadcasts; //   
+    MpscQueue<handoff::Adoption> m_adoptions; // ,    
+    MpscQueue<ConnectionCommand> m_commands; //      
+    std::atomic<bool> m_handoffRequested{ false }; // beginHandoff() 
+    bool m_handingOff = false; //  ,    
+    TopicTable m_topics; //   
+    ReactorTuning m_tuning; //   ,    
+    int m_maxConnections = 0; //   
+    AdmissionController* m_admission = nullptr; //   
+    ConnectionRegistry* m_registry = nullptr; //   
+    bool m_accepting = true; //   
+    bool m_overloaded = false; //   ,  
+    double m_iterationUs = 0; //    
+    double m_eventDepth = 0; //      
+    static constexpr int OVERLOAD_RECHECK_MS = 10; //        
+    TimeoutPolicies m_timeouts = defaultTimeouts(); //    
+    size_t m_zeroCopyThreshold = 0; //    , 0 - 
+    TimerWheel m_timers; //   
+    CaptureWriter::Cursor m_captureCursor; //      
+    Clock::time_point m_now = Clock::now(); //    
+};
+
+/**
+ * @class EventLoop
+ * @brief  edge-triggered epoll-.
+ *        
+ *  /     . 
+ *       SO_REUSEPORT-, 
+ *   ,      .
+ *      Server::onData.
+ */
+class EventLoop : public Reactor {
+public:
+    /**
+     * @brief  
+     * @param server ,    
+     * @param listenSocket   (   )
+     */
+    EventLoop(Server& server, SOCKET listenSocket);
+    /**
+     * @brief  
+     * @note      
+     */
+    ~EventLoop() override;
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+    /**
+     * @brief  epoll    
+     * @return true -  , false -  epoll/eventfd
+     */
+    bool start() override;
+    /**
+     * @brief  ,      
+     */
+    void stop() override;
+    /**
+     * @brief      writev,   EPOLLOUT
+     * @details          MSG_ZEROCOPY
+     */
+    bool sendFrame(Connection& conn, protocol::MessageType type, uint8_t flags,
+        const char* payload, size_t size, const buffers::Buffer* storage = nullptr) override;
+    void closeConnection(Connection& conn, const std::string& reason) override;
+    Connection* findConnection(SOCKET socket, uint64_t id) override;
+    bool sendEncoded(Connection& conn, const buffers::Buffer& frame) override;
+    size_t queuedBytes(const Connection& conn) const override { return conn.pending.size(); }
+    /**
+     * @brief    epoll:     
+     *    ,   EPOLLET  
+     */
+    void resumeRead(Connection& conn) override;
+    /**
+     * @details MSG_ZEROCOPY     : 
+     *         
+     */
+    Connection* adoptSocket(SOCKET socket, ConnectionClass connectionClass) override;
+private:
+    static constexpr size_t MAX_PENDING = 1 << 20; //   
+    static constexpr int MAX_IOV = 4; //    write()
+    static constexpr auto ZERO_COPY_LINGER = std::chrono::seconds(30); //    
+
+    void run();
+    void acceptAll();
+    EpollConnection* addConnection(std::unique_ptr<EpollConnection> conn);
+    void forget(EpollConnection& conn);
+    void handOffConnections() override;
+    void enableAccept(bool enable) override;
+    void wake() override;
+    bool onReadable(Connection& conn);
+    bool onWritable(Connection& conn);
+    bool write(Connection& conn, const iovec* parts, int count);
+    bool writeZeroCopy(EpollConnection& conn, iovec* parts, int count, const buffers::Buffer& storage);
+    void reapZeroCopy(EpollConnection& conn);
+    void releaseOrphans();
+
+    Server& m_server;
+    SOCKET m_listenSocket;
+    int m_epollFd = -1; //  epoll
+    int m_wakeFd = -1; // eventfd    ,     (  )
+    std::atomic<bool> m_running{ false };
+    std::thread m_thread;
+    uint64_t m_nextConnId = 1;
+    std::vector<char> m_readBuffer; //       (  )
+    std::unordered_map<SOCKET, std::unique_ptr<EpollConnection>> m_connections;
+    //  MSG_ZEROCOPY  :     
+    // ,      ZERO_COPY_LINGER
+    std::vector<std::pair<Clock::time_point, buffers::Buffer>> m_zeroCopyOrphans;
+};
+#endif
@@ -0,0 +1,94 @@
+#ifndef HANDOFF_HPP
+#define HANDOFF_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../include/common/net.hpp"
+#include "../include/server/mpsc_queue.hpp"
+
+/**
+ * @namespace handoff
+ * @brief        ( Linux).
+ *
+ *    Unix-;     
+ *      SCM_RIGHTS,    
+ *    Ready.     
+ *         
+ *    ,    (   ) - Done.
+ *  - SOCK_SEQPACKET:      
+ *  ,        .
+ */
+namespace handoff {
+    /**
+     * @brief    ( ).
+     */
+    enum class Kind : uint8_t {
+        Listeners = 1, //  -> :   
+        Ready = 2, //  -> :  ,  
+        Connection = 3, //  -> :    
+        Done = 4 //  -> :  
+    };
+
+    constexpr size_t MAX_MESSAGE = 64 * 1024; //   
+    constexpr size_t MAX_FDS = 64; //    
+
+    /**
+     * @struct ConnectionState
+     * @brief  ,   .
+     * @details ,       :
+     *         
+     */
+    struct ConnectionState {
+        uint8_t connectionClass = 0; // ConnectionClass
+        bool compressReplies = false; //   
+        uint8_t replyDictionary = 0; // compression::Dictionary
+        std::vector<std::string> topics; // 
+    };
+
+    /**
+     * @struct Adoption
+     * @brief ,        .
+     */
+    struct Adoption : MpscNode {
+        SOCKET socket = INVALID_SOCKET;
+        ConnectionState state;
+    };
+
+    std::string encode(const ConnectionState& state);
+    /**
+     * @return false -  
+     */
+    bool decode(const std::string& data, ConnectionState& state);
+
+    /**
+     * @brief  Unix-    path ( 0600),   
+     * @return   -1 (  errno)
+     */
+    int listen(const std::string& path);
+    /**
+     * @brief       timeoutMs
+     * @return   -1 (errno = EPERM -   ,
+     *   )
+     */
+    int accept(int listener, int timeoutMs);
+    /**
+     * @brief     
+     * @return   -1 (  errno)
+     */
+    int connect(const std::string& path);
+    /**
+     * @brief     (  MAX_FDS)
+     * @param wait false -      (MSG_DONTWAIT)
+     * @return false -    ;   
+     */
+    bool send(int channel, Kind kind, const std::string& data, const int* fds, size_t count, bool wait = true);
+    /**
+     * @brief   ,     timeoutMs
+     * @param[out] fds   ( FD_CLOEXEC),  
+     * @return false -  ,     
+     * (errno = ETIMEDOUT,    )
+     */
+    bool receive(int channel, Kind& kind, std::string& data, std::vector<int>& fds, int timeoutMs);
+}
+#endif
@@ -0,0 +1,101 @@
+#ifndef INPUT_VALIDATOR_HPP
+#define INPUT_VALIDATOR_HPP
+
+#include <string>
+#include <cstddef>
+#include "../include/common/protocol.hpp"
+
+/**
+ * @class InputValidator
+ * @brief   
+ * @details      SSE2/AVX2 
+ *  ;       .
+ */
+class InputValidator {
+public:
+    /**
+     * @brief    .
+     */
+    enum class Kernel {
+        Scalar, //   ()
+        Sse2, // 16   
+        Avx2 // 32   
+    };
+
+    /**
+     * @struct BatchResult
+     * @brief    .
+     */
+    struct BatchResult {
+        size_t frame = 0; //     (count,   )
+        size_t offset = 0; //        (npos -    )
+    };
+
+    static constexpr size_t npos = static_cast<size_t>(-1); //   
+
+    /**
+    * @brief   
+    * @param message   
+    * @return true -  , false -  
+    *
+    *   :
+    * -   
+    * -  ? MAX_MESSAGE_LENGTH
+    * -   
+    */
+    static bool validateMessage(const std::string& message) {
+        return validateMessage(message.data(), message.size());
+    }
+    /**
+    * @brief      ,    std::string
+    * @param badOffset   nullptr,    
+    *  (npos,     )
+    */
+    static bool validateMessage(const char* data, size_t size, size_t* badOffset = nullptr) {
+        if (badOffset) *badOffset = npos;
+        if (size == 0 || size > MAX_MESSAGE_LENGTH) return false;
+        const size_t offset = findInvalid(data, size);
+        if (badOffset) *badOffset = offset;
+        return offset == npos;
+    }
+    /**
+     * @brief    (,    recv)   
+     * @return        
+     */
+    static BatchResult validateBatch(const protocol::FrameView* frames, size_t count);
+    /**
+     * @brief        
+     * @return    npos
+     */
+    static size_t findInvalid(const char* data, size_t size) { return activeKernel().find(data, size); }
+    /**
+     * @brief      
+     * @note     (. isSupported)
+     */
+    static size_t findInvalid(Kernel kernel, const char* data, size_t size);
+    /**
+     * @brief    
+     */
+    static bool isSupported(Kernel kernel);
+    /**
+     * @brief ,    
+     */
+    static Kernel kernel() { return activeKernel().kind; }
+    /**
+     * @brief    
+     */
+    static const char* kernelName(Kernel kernel);
+private:
+    static constexpr size_t MAX_MESSAGE_LENGTH = protocol::MAX_PAYLOAD_SIZE;//    .
+
+    using FindFunction = size_t(*)(const char* data, size_t size);
+    struct ActiveKernel {
+        Kernel kind;
+        FindFunction find;
+    };
+    /**
+     * @brief      ( )
+     */
+    static const ActiveKernel& activeKernel();
+};
+#endif
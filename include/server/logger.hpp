@@ -0,0 +1,182 @@
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @namespace logging
+ * @brief   .
+ *
+ *      (, ,
+ * , )   SPSC-    
+ * .      ,   
+ * ,      write   .
+ *         .
+ */
+namespace logging {
+    /**
+     * @brief   .
+     */
+    enum class LogLevel : uint8_t {
+        Debug, // 
+        Info, // , , 
+        Warning, //    
+        Error, // 
+        Off //  
+    };
+
+    /**
+     * @brief   .
+     */
+    enum class LogEvent : uint8_t {
+        Text, //  
+        Connected, //  
+        Disconnected, //   ( - )
+        Message //   ( -  )
+    };
+
+    /**
+     * @struct LogRecord
+     * @brief     ( -).
+     */
+    struct LogRecord {
+        static constexpr size_t TEXT_SIZE = 96; //  ;  - 
+
+        int64_t timestamp = 0; //    (system_clock)
+        uint64_t connection = 0; //    
+        uint64_t size = 0; //     
+        LogLevel level = LogLevel::Info;
+        LogEvent event = LogEvent::Text;
+        uint16_t textSize = 0;
+        char text[TEXT_SIZE];
+    };
+
+    /**
+     * @struct LoggerStats
+     * @brief  .
+     */
+    struct LoggerStats {
+        uint64_t written = 0; //  
+        uint64_t dropped = 0; //  -  
+        uint64_t sampledOut = 0; //   
+    };
+
+    /**
+     * @class Logger
+     * @brief  :      .
+     */
+    class Logger {
+    public:
+        static constexpr size_t RING_CAPACITY = 8192; //     ( )
+
+        /**
+         * @brief  
+         */
+        static Logger& instance();
+
+        /**
+         * @brief   ;     
+         */
+        void start();
+        /**
+         * @brief       
+         */
+        void stop();
+
+        void setLevel(LogLevel level) { m_level.store(level, std::memory_order_relaxed); }
+        LogLevel level() const { return m_level.load(std::memory_order_relaxed); }
+        bool enabled(LogLevel level) const { return level >= this->level() && level != LogLevel::Off; }
+        /**
+         * @brief   N-    (1 - , 0 -  )
+         */
+        void setSampleRate(unsigned rate) { m_sampleRate.store(rate, std::memory_order_relaxed); }
+
+        /**
+         * @brief      
+         * @return false,      
+         */
+        bool write(LogLevel level, LogEvent event, uint64_t connection, uint64_t size,
+            const char* text, size_t textSize);
+        /**
+         * @brief ,       
+         */
+        bool sampleMessage();
+
+        /**
+         * @brief  
+         * @note     
+         */
+        LoggerStats stats() const;
+    private:
+        struct Ring;
+        struct RingHandle;
+
+        Logger() = default;
+        Ring& localRing();
+        void run();
+        size_t drain(std::vector<LogRecord>& batch);
+        void flush(std::vector<LogRecord>& batch);
+        void reportDrops();
+
+        std::atomic<LogLevel> m_level{ LogLevel::Info };
+        std::atomic<unsigned> m_sampleRate{ 1 };
+        std::atomic<bool> m_running{ false };
+        std::thread m_thread;
+        mutable std::mutex m_ringsMutex; //    (     )
+        std::vector<std::unique_ptr<Ring>> m_rings;
+        std::atomic<uint64_t> m_written{ 0 };
+        std::atomic<uint64_t> m_retiredDropped{ 0 }; //    
+        std::atomic<uint64_t> m_retiredSampled{ 0 };
+        uint64_t m_reportedDrops = 0; //      
+    };
+
+    inline void write(LogLevel level, LogEvent event, uint64_t connection, uint64_t size,
+        const char* text, size_t textSize) {
+        Logger& logger = Logger::instance();
+        if (logger.enabled(level)) logger.write(level, event, connection, size, text, textSize);
+    }
+
+    inline void connected(uint64_t connection) {
+        write(LogLevel::Info, LogEvent::Connected, connection, 0, nullptr, 0);
+    }
+
+    inline void disconnected(uint64_t connection, const std::string& reason) {
+        write(LogLevel::Info, LogEvent::Disconnected, connection, 0, reason.data(), reason.size());
+    }
+
+    /**
+     * @brief     ;      
+     */
+    inline void message(uint64_t connection, const char* payload, size_t size) {
+        Logger& logger = Logger::instance();
+        if (logger.enabled(LogLevel::Info) && logger.sampleMessage()) {
+            logger.write(LogLevel::Info, LogEvent::Message, connection, size, payload, size);
+        }
+    }
+
+    inline void info(const std::string& text) {
+        write(LogLevel::Info, LogEvent::Text, 0, 0, text.data(), text.size());
+    }
+
+    inline void warning(const std::string& text) {
+        write(LogLevel::Warning, LogEvent::Text, 0, 0, text.data(), text.size());
+    }
+
+    inline void error(const std::string& text) {
+        write(LogLevel::Error, LogEvent::Text, 0, 0, text.data(), text.size());
+    }
+
+    /**
+     * @brief    (debug, info, warning, error, off)
+     * @return false,   
+     */
+    bool parseLevel(const std::string& name, LogLevel& level);
+}
+#endif
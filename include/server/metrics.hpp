@@ -0,0 +1,256 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace metrics
+ * @brief ,     .
+ *
+ *       ,   -:
+ *  -      RMW   , 
+ *     -.      
+ *  ( relaxed-),   
+ *    .
+ */
+namespace metrics {
+    /**
+     * @brief  .
+     */
+    enum class Counter : uint8_t {
+        Accepts, //  
+        Rejects, // ,   
+        BytesIn, //    
+        BytesOut, //   
+        Messages, //  
+        ValidationFailures, // ,   InputValidator
+        ProtocolErrors, //     
+        Timeouts, // ,   
+        ZeroCopySends, //  MSG_ZEROCOPY/SEND_ZC
+        ZeroCopyCopied, //       
+        RateLimited, //     
+        CapacityPauses, //     
+        OverloadPauses, //     
+        PoolJobs, // ,     
+        PoolSteals, // ,     
+        PoolRejected, // ,  -   
+        PubSubPublished, //  
+        PubSubDelivered, //  ,  
+        PubSubDropped, //  ,      
+        PubSubDisconnects, //  ,   Disconnect
+        CompressedIn, //     
+        DecompressedBytesIn, //     
+        DecompressedBytesOut, //   
+        DecompressNanos, //  , 
+        CompressedOut, //   
+        CompressBytesIn, //  ,    ( ,    )
+        CompressBytesOut, // ,    ( ,    )
+        CompressNanos, //  , 
+        CompressSkipped, //    ,    
+        HandedOff, // ,     
+        Adopted, // ,    
+        CaptureFrames, // ,     
+        CaptureDropped, // ,    :  
+        Count
+    };
+
+    /**
+     * @brief :  ,   .
+     */
+    enum class Gauge : uint8_t {
+        Connections, //  
+        AcceptPaused, // ,  
+        PoolWorkers, //  
+        PoolQueued, //    
+        Subscriptions, //   
+        PubSubQueued, //     
+        Count
+    };
+
+    constexpr size_t COUNTER_COUNT = static_cast<size_t>(Counter::Count);
+    constexpr size_t GAUGE_COUNT = static_cast<size_t>(Gauge::Count);
+
+    struct HistogramSnapshot;
+
+    /**
+     * @class Histogram
+     * @brief -   : 8   
+     *   (   12.5%),   2^40 .
+     * @note   -,     .
+     */
+    class Histogram {
+    public:
+        static constexpr unsigned SUB_BITS = 3;
+        static constexpr unsigned SUB_BUCKETS = 1u << SUB_BITS; //    
+        static constexpr unsigned MAX_BITS = 40; //  2^40 - 1    
+        static constexpr size_t BUCKET_COUNT = (MAX_BITS - SUB_BITS + 1) * SUB_BUCKETS;
+
+        void record(uint64_t value) {
+            bump(m_buckets[bucketOf(value)], 1);
+            bump(m_count, 1);
+            bump(m_sum, value);
+            if (value > m_max.load(std::memory_order_relaxed)) m_max.store(value, std::memory_order_relaxed);
+        }
+
+        static size_t bucketOf(uint64_t value) {
+            if (value >= (uint64_t(1) << MAX_BITS)) value = (uint64_t(1) << MAX_BITS) - 1;
+            if (value < SUB_BUCKETS) return static_cast<size_t>(value);
+            const unsigned msb = 63u - static_cast<unsigned>(countLeadingZeros(value));
+            return (msb - SUB_BITS + 1) * SUB_BUCKETS + ((value >> (msb - SUB_BITS)) & (SUB_BUCKETS - 1));
+        }
+
+        /**
+         * @brief    index ( index == BUCKET_COUNT -  )
+         */
+        static uint64_t lowerBound(size_t index) {
+            if (index < SUB_BUCKETS) return index;
+            const size_t octave = index / SUB_BUCKETS;
+            const uint64_t sub = index % SUB_BUCKETS;
+            return (SUB_BUCKETS + sub) << (octave - 1);
+        }
+
+        /**
+         * @brief     
+         */
+        void collect(HistogramSnapshot& out) const;
+        /**
+         * @brief  other   
+         * @note    ,   
+         */
+        void merge(const Histogram& other);
+    private:
+        //    ,    RMW
+        static void bump(std::atomic<uint64_t>& counter, uint64_t value) {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        static int countLeadingZeros(uint64_t value) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanReverse64(&index, value);
+            return 63 - static_cast<int>(index);
+#else
+            return __builtin_clzll(value);
+#endif
+        }
+
+        std::atomic<uint64_t> m_buckets[BUCKET_COUNT] = {};
+        std::atomic<uint64_t> m_count{ 0 };
+        std::atomic<uint64_t> m_sum{ 0 };
+        std::atomic<uint64_t> m_max{ 0 };
+    };
+
+    /**
+     * @struct ThreadMetrics
+     * @brief   ;    .
+     */
+    struct alignas(64) ThreadMetrics {
+        std::atomic<uint64_t> counters[COUNTER_COUNT] = {};
+        std::atomic<int64_t> gauges[GAUGE_COUNT] = {};
+        Histogram echoLatency; //   -   , 
+
+        /**
+         * @brief   other   
+         * @note    
+         */
+        void merge(const ThreadMetrics& other);
+    };
+
+    namespace detail {
+        ThreadMetrics* attach();
+        void detach(ThreadMetrics* metrics);
+
+        /**
+         * @brief        
+         *       
+         */
+        struct LocalHandle {
+            ThreadMetrics* metrics = attach();
+            ~LocalHandle() { detach(metrics); }
+        };
+    }
+
+    /**
+     * @brief    
+     */
+    inline ThreadMetrics& local() {
+        thread_local detail::LocalHandle handle;
+        return *handle.metrics;
+    }
+
+    inline void add(Counter counter, uint64_t value = 1) {
+        std::atomic<uint64_t>& slot = local().counters[static_cast<size_t>(counter)];
+        slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    inline void adjust(Gauge gauge, int64_t delta) {
+        std::atomic<int64_t>& slot = local().gauges[static_cast<size_t>(gauge)];
+        slot.store(slot.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief         
+     */
+    inline void recordEchoLatency(std::chrono::steady_clock::duration latency) {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count();
+        local().echoLatency.record(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+    }
+
+    /**
+     * @struct HistogramSnapshot
+     * @brief     .
+     */
+    struct HistogramSnapshot {
+        std::vector<uint64_t> buckets = std::vector<uint64_t>(Histogram::BUCKET_COUNT);
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+
+        /**
+         * @param percentile 0..100
+         * @return     (  max)
+         */
+        uint64_t percentile(double percentile) const;
+        /**
+         * @brief     bound
+         * @details bound     
+         */
+        uint64_t countBelow(uint64_t bound) const;
+    };
+
+    /**
+     * @struct Snapshot
+     * @brief       .
+     */
+    struct Snapshot {
+        uint64_t counters[COUNTER_COUNT] = {};
+        int64_t gauges[GAUGE_COUNT] = {};
+        HistogramSnapshot echoLatency;
+        double uptimeSeconds = 0;
+        double cpuSeconds = 0; //    (user + system)
+
+        uint64_t counter(Counter counter) const { return counters[static_cast<size_t>(counter)]; }
+        int64_t gauge(Gauge gauge) const { return gauges[static_cast<size_t>(gauge)]; }
+    };
+
+    /**
+     * @brief    
+     * @note    ;    
+     */
+    Snapshot snapshot();
+
+    /**
+     * @brief     Prometheus
+     */
+    std::string formatPrometheus(const Snapshot& snapshot);
+    /**
+     * @brief   JSON
+     */
+    std::string formatJson(const Snapshot& snapshot);
+}
+#endif
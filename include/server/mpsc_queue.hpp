@@ -0,0 +1,78 @@
+#ifndef MPSC_QUEUE_HPP
+#define MPSC_QUEUE_HPP
+
+#include <atomic>
+
+/**
+ * @struct MpscNode
+ * @brief   MpscQueue;    .
+ */
+struct MpscNode {
+    std::atomic<MpscNode*> next{ nullptr };
+};
+
+/**
+ * @class MpscQueue
+ * @brief    :  ,  .
+ *
+ *    atomic exchange     ,
+ *   ;     RMW, 
+ * ,    .    :
+ *     .
+ * @tparam T  ,  MpscNode
+ */
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : m_head(&m_stub), m_tail(&m_stub) {}
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * @brief     
+     * @note     
+     */
+    void push(T* item) { pushNode(item); }
+
+    /**
+     * @brief   
+     * @return nullptr -       
+     *  ;     
+     * @note   -
+     */
+    T* pop() {
+        MpscNode* tail = m_tail;
+        MpscNode* next = tail->next.load(std::memory_order_acquire);
+        if (tail == &m_stub) {
+            if (!next) return nullptr;
+            m_tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            m_tail = next;
+            return static_cast<T*>(tail);
+        }
+        // tail -   :    ,
+        //   ,     
+        if (tail != m_head.load(std::memory_order_acquire)) return nullptr;
+        pushNode(&m_stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            m_tail = next;
+            return static_cast<T*>(tail);
+        }
+        return nullptr;
+    }
+private:
+    void pushNode(MpscNode* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        MpscNode* previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    alignas(64) std::atomic<MpscNode*> m_head; //   ( )
+    alignas(64) MpscNode* m_tail; //    ( )
+    MpscNode m_stub; // :      
+};
+#endif
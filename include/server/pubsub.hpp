@@ -0,0 +1,156 @@
+#ifndef PUBSUB_HPP
+#define PUBSUB_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "../include/common/buffer_pool.hpp"
+#include "../include/server/mpsc_queue.hpp"
+
+struct Connection;
+class Reactor;
+
+/**
+ * @brief    ,     .
+ */
+enum class SlowSubscriberPolicy {
+    DropOldest, //     
+    Disconnect, //  
+    Coalesce //        
+};
+
+/**
+ * @struct PubSubOptions
+ * @brief     .
+ */
+struct PubSubOptions {
+    SlowSubscriberPolicy policy = SlowSubscriberPolicy::DropOldest;
+    size_t maxQueued = 1024; //     
+    size_t writeHighWater = 64 * 1024; //    ,       
+    size_t maxTopicsPerConnection = 64; //   
+    size_t maxTopicLength = 256; //   
+};
+
+/**
+ * @struct Broadcast
+ * @brief ,    .
+ * @details    :     
+ *       
+ */
+struct Broadcast : MpscNode {
+    buffers::Buffer frame; //  Publish  (  )
+    std::string_view topic; //    frame
+};
+
+/**
+ * @struct Subscriber
+ * @brief      .
+ * @details    ,   
+ *     
+ */
+struct Subscriber {
+    struct Topic;
+
+    /**
+     * @struct Membership
+     * @brief :       .
+     */
+    struct Membership {
+        Topic* topic;
+        size_t index;
+    };
+
+    /**
+     * @struct Queued
+     * @brief ,     .
+     */
+    struct Queued {
+        std::string_view topic; //  frame
+        buffers::Buffer frame;
+    };
+
+    std::vector<Membership> topics;
+    std::deque<Queued> outbox; //    
+    uint64_t outboxBase = 0; //   outbox.front():      
+};
+
+/**
+ * @struct Subscriber::Topic
+ * @brief     .
+ */
+struct Subscriber::Topic {
+    static constexpr uint64_t NO_SLOT = UINT64_MAX;
+
+    std::string name;
+    std::vector<Connection*> subscribers;
+    //  Coalesce:      outbox   
+    //  ;   (  )   
+    std::vector<uint64_t> queued;
+};
+
+/**
+ * @class TopicTable
+ * @brief     ;     .
+ *
+ *         :  
+ *    ,    .   
+ *   writeHighWater,     
+ *  ( ),    maxQueued  
+ *   ;      
+ *  .
+ */
+class TopicTable {
+public:
+    void setOptions(const PubSubOptions& options) { m_options = options; }
+    const PubSubOptions& options() const { return m_options; }
+
+    /**
+     * @return false -    
+     */
+    bool subscribe(Connection& conn, std::string_view topic);
+    /**
+     * @return false -    
+     */
+    bool unsubscribe(Connection& conn, std::string_view topic);
+    /**
+     * @brief        
+     */
+    void remove(Connection& conn);
+    /**
+     * @brief       
+     * @param current ,     (),  nullptr
+     * @return   current  nullptr
+     * @details ,    ( Disconnect 
+     *  ),    ; current 
+     * ,   ,    
+     */
+    const char* fanOut(Reactor& loop, std::string_view topic, const buffers::Buffer& frame, Connection* current = nullptr);
+    /**
+     * @brief     ,  
+     *   writeHighWater
+     * @return true -   , false - 
+     * @note  ,     
+     */
+    bool drain(Reactor& loop, Connection& conn);
+    size_t topicCount() const { return m_topics.size(); }
+private:
+    /**
+     * @brief        
+     * @param slot        (Subscriber::Topic::queued)
+     * @return     nullptr
+     */
+    const char* deliver(Reactor& loop, Connection& conn, std::string_view topic, const buffers::Buffer& frame, uint64_t& slot);
+    /**
+     * @brief       O(1)
+     */
+    void detach(Subscriber::Topic& topic, size_t index);
+
+    PubSubOptions m_options;
+    std::unordered_map<std::string, Subscriber::Topic> m_topics;
+    std::vector<std::pair<Connection*, const char*>> m_closing; // ,    
+};
+#endif
@@ -0,0 +1,191 @@
+#ifndef ROUTER_HPP
+#define ROUTER_HPP
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#include "../include/common/buffer_pool.hpp"
+#include "../include/common/net.hpp"
+#include "../include/common/protocol.hpp"
+#include "../include/server/mpsc_queue.hpp"
+#include "../include/server/worker_pool.hpp"
+
+class Reactor;
+
+/**
+ * @class Response
+ * @brief   :  , ,   .
+ * @details      ,  
+ *  . send()    , 
+ *    :   ,   
+ *   (storage);    write(),  .
+ */
+class Response {
+public:
+    /**
+     * @struct Part
+     * @brief   .
+     */
+    struct Part {
+        protocol::MessageType type;
+        uint8_t flags;
+        const char* payload;
+        size_t size;
+        const buffers::Buffer* storage; //     (  )
+        buffers::Buffer owned; //      storage  own()
+    };
+
+    /**
+     * @brief     
+     */
+    void send(protocol::MessageType type, const char* payload, size_t size,
+        const buffers::Buffer* storage = nullptr, uint8_t flags = protocol::FLAG_NONE);
+    /**
+     * @brief :   ,    
+     */
+    void send(const protocol::FrameView& frame) {
+        send(frame.type, frame.payload, frame.size, frame.storage, frame.flags);
+    }
+    /**
+     * @brief  ,     
+     */
+    void write(protocol::MessageType type, const char* payload, size_t size);
+    void write(protocol::MessageType type, const std::string& payload) { write(type, payload.data(), payload.size()); }
+    /**
+     * @brief     
+     */
+    void close(std::string reason) {
+        m_close = true;
+        m_closeReason = std::move(reason);
+    }
+    /**
+     * @brief     :  
+     *  ,    
+     */
+    void own();
+    void clear();
+    /**
+     * @brief      (FLAG_CORRELATED):  
+     *      ,    
+     *   
+     * @note     
+     */
+    void correlate(uint64_t correlation) {
+        m_correlated = true;
+        m_correlation = correlation;
+    }
+
+    const std::vector<Part>& parts() const { return m_parts; }
+    bool closeRequested() const { return m_close; }
+    const std::string& closeReason() const { return m_closeReason; }
+    bool correlated() const { return m_correlated; }
+    uint64_t correlation() const { return m_correlation; }
+private:
+    std::vector<Part> m_parts;
+    bool m_close = false;
+    std::string m_closeReason;
+    bool m_correlated = false;
+    uint64_t m_correlation = 0;
+};
+
+/**
+ * @class Router
+ * @brief     .
+ *
+ *   (Inline)     , 
+ *   .  (Pool)    
+ * :        
+ * ,        .
+ * @code
+ * Router router = Router::echo();
+ * router.handle(protocol::MessageType::Text, [](const protocol::FrameView& request, Response& response) {
+ *     response.write(protocol::MessageType::Text, expensiveTransform(request));
+ * }, Router::Dispatch::Pool);
+ * @endcode
+ *    InputValidator  .
+ */
+class Router {
+public:
+    /**
+     * @brief ;      ,  
+     *      
+     */
+    using Handler = std::function<void(const protocol::FrameView& request, Response& response)>;
+
+    /**
+     * @brief   
+     */
+    enum class Dispatch {
+        Inline, //   
+        Pool //     (  -   )
+    };
+
+    /**
+     * @struct Route
+     * @brief    .
+     */
+    struct Route {
+        Handler handler;
+        Dispatch dispatch = Dispatch::Inline;
+    };
+
+    /**
+     * @brief   :      
+     */
+    static Router echo();
+
+    /**
+     * @brief  ( )   type
+     */
+    void handle(protocol::MessageType type, Handler handler, Dispatch dispatch = Dispatch::Inline);
+    /**
+     * @brief   type  nullptr
+     */
+    const Route* find(protocol::MessageType type) const {
+        const Route& route = m_routes[static_cast<uint8_t>(type)];
+        return route.handler ? &route : nullptr;
+    }
+    /**
+     * @brief  ,   
+     */
+    bool usesPool() const;
+private:
+    std::array<Route, 256> m_routes;
+};
+
+/**
+ * @struct RouteJob
+ * @brief ,   ,   .
+ * @details     (   
+ * ),      - 
+ * Reactor::post.      
+ *  ,      .
+ */
+struct RouteJob : WorkItem, MpscNode {
+    Reactor* loop = nullptr; //  
+    SOCKET socket = INVALID_SOCKET; // - (  
+    uint64_t connectionId = 0; // :     )
+    uint64_t seq = 0; //    
+    const Router::Route* route = nullptr;
+    protocol::FrameView request; //   requestStorage
+    buffers::Buffer requestStorage;
+    Response response;
+    std::chrono::steady_clock::time_point receivedAt; //   
+
+    /**
+     * @brief  ;      
+     */
+    void capture(const protocol::FrameView& frame);
+    /**
+     * @brief      
+     */
+    void run() override;
+};
+
+/**
+ * @brief  ;      
+ */
+void runRoute(const Router::Route& route, const protocol::FrameView& request, Response& response);
+#endif
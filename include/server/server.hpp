@@ -6,14 +6,98 @@
 #include <vector>
 #include <future>
 #include <atomic>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
 #include <csignal>
 #include <regex>
 #include <locale>
-#include <winsock2.h>
-#include <ws2tcpip.h>
-#include <windows.h>
+#include "../include/common/net.hpp"
+#include "../include/common/protocol.hpp"
+#include "../include/common/compression.hpp"
+#include "../include/server/input_validator.hpp"
+#include "../include/server/logger.hpp"
+#include "../include/server/metrics.hpp"
+#include "../include/server/admin_server.hpp"
+#include "../include/server/timer_wheel.hpp"
+#include "../include/server/admission.hpp"
+#include "../include/server/session.hpp"
+#include "../include/server/router.hpp"
+#include "../include/server/worker_pool.hpp"
+#include "../include/server/pubsub.hpp"
+#include "../include/server/connection_registry.hpp"
+#ifdef __linux__
+#include "../include/server/event_loop.hpp"
+#include "../include/server/uring_loop.hpp"
+#include "../include/server/shm_loop.hpp"
+#endif
+/**
+ * @brief  -  (   Linux).
+ */
+enum class IoEngine {
+    Epoll, // Edge-triggered epoll-
+    IoUring // io_uring  multishot accept/recv;    - Epoll
+};
+
+/**
+ * @struct ServerOptions
+ * @brief  ;       Linux.
+ */
+struct ServerOptions {
+    uint16_t port = 8080; // TCP- 
+    IoEngine engine = IoEngine::Epoll; //  -
+    unsigned reactorThreads = 1; //  : , SO_REUSEPORT-   
+    bool pinThreads = false; //     
+    std::vector<int> cpus; //    ;  -  i   i
+    bool numaLocal = false; //    -   NUMA   ( Linux)
+    TimeoutPolicies timeouts = defaultTimeouts(); //    
+    size_t zeroCopyThreshold = 0; //         (MSG_ZEROCOPY/SEND_ZC), 0 - 
+    uint16_t adminPort = 0; //   (/metrics, /stats), 0 - 
+    std::string adminAddress = "127.0.0.1"; //   
+    std::string adminToken; //   send/close   (X-Admin-Token),  -  
+    AdmissionOptions admission; //     ,  
+    Session::Handler sessionHandler; // - ;  - 
+    Router router = Router::echo(); //     
+    unsigned workerThreads = 0; //     Dispatch::Pool, 0 -   
+    size_t workerQueueDepth = 4096; //     ;   -  "Server is busy"
+    PubSubOptions pubsub; //       ( Linux)
+    compression::Options compression; //   ,  Hello
+    std::string upgradeSocket; // Unix-,       ( Linux),  - 
+    std::string takeoverSocket; // Unix-  ,       ( Linux)
+    uint32_t handoffTimeoutMs = 30000; //     ;   
+    std::string unixSocket; //  Unix-     ( Linux),  - 
+    std::string shmSocket; //  Unix-      ( Linux),  - 
+    int listenBacklog = SOMAXCONN; //   listen (    net.core.somaxconn)
+    int deferAcceptSec = 1; // TCP_DEFER_ACCEPT:  accept    ,    N  ( Linux), 0 - 
+    int fastOpenQueue = 256; //  TCP Fast Open:   SYN   RTT ( Linux), 0 - 
+    size_t maxMessageSize = protocol::MAX_PAYLOAD_SIZE; //     (  MAX_PAYLOAD_SIZE)
+    bool noDelay = false; // TCP_NODELAY:   ,    
+    bool quickAck = false; // TCP_QUICKACK,     :    ( Linux)
+    int sendBuffer = 0; // SO_SNDBUF , 0 -  
+    int receiveBuffer = 0; // SO_RCVBUF , 0 -  
+    int busyPollUs = 0; // SO_BUSY_POLL:       N  ( Linux), 0 - 
+    uint32_t spinUs = 0; //  epoll     N    , 0 -  
+    int eventBatch = 256; //    epoll_wait
+    size_t readBufferSize = 64 * 1024; //   recv  epoll (  )
+    std::string captureFile; //      ( Linux),  - 
+    size_t captureLimit = size_t(1) << 30; //   ;     
+};
+
+/**
+ * @brief     
+ * @details low-latency:        
+ * NUMA, TCP_NODELAY  TCP_QUICKACK,   , 
+ *       . throughput:  
+ *  ,     ,  
+ *       .
+ * default:   
+ * @return false -  ,   
+ */
+bool applyProfile(const std::string& name, ServerOptions& options);
 
-#pragma comment (lib, "ws2_32.lib")
 /**
  * @class Server     ,
  * @brief       
@@ -24,29 +108,218 @@
 
 class Server {
 private:
-    DWORD timeout = 100000; //    
-    DWORD recvTimeout = 10000; //  recv  
-    const size_t MAX_MESSAGE_SIZE = 4096; //   
+#ifdef __linux__
+    static constexpr int MAX_CLIENTS = 65536; //   :      
+#else
     static constexpr int MAX_CLIENTS = 100; //   
-    std::atomic<int> m_activeClients{ 0 }; //    
+#endif
     SOCKET m_serverSocket = INVALID_SOCKET; //  
     uint16_t m_port; // ,     
     std::atomic<bool> m_running{ false }; //  , ,   
-    std::mutex m_futuresMutex;    //       m_clientFutures
-    std::mutex m_clientsMutex;
-    std::vector<std::future<void>> m_clientFutures; //    futures,    
+    ServerOptions m_options; //  
+    AdmissionController m_admission; //   ,    
+    ConnectionRegistry m_registry; //      
+    std::unique_ptr<AdminServer> m_admin; //  ,   adminPort
+    std::unique_ptr<WorkerPool> m_pool; //    Dispatch::Pool,   
+    std::atomic<bool> m_upgraded{ false }; //    
     /**
-    * @brief     .
-    *          .
-    *    ,     .
-    * @param clientSocket   .
+    * @brief  ,         
+    * @param reusePort      (SO_REUSEPORT)
+    * @return    INVALID_SOCKET  
+    */
+    SOCKET openListener(bool reusePort);
+#ifdef __linux__
+    friend class EventLoop;
+    friend class UringLoop;
+    friend class ShmLoop;
+    /**
+    * @brief     (       )
+    */
+    enum class ShardKind : uint8_t {
+        Tcp = 'T',
+        Unix = 'U', // Unix-:   ,   TCP-
+        SharedMemory = 'S' //  :  ShmLoop
+    };
+    std::vector<SOCKET> m_shardSockets; //   ,  m_serverSocket
+    SOCKET m_unixSocket = INVALID_SOCKET; //  Unix- (unixSocket)
+    SOCKET m_shmSocket = INVALID_SOCKET; //     (shmSocket)
+    size_t m_socketShards = 0; // ,     (,  ShmLoop)
+    std::vector<std::unique_ptr<Reactor>> m_loops; // :    
+    std::unique_ptr<CaptureWriter> m_capture; //   ,   captureFile
+    //  ,   : m_loops  
+    // start(),   m_shardCount      
+    std::atomic<size_t> m_shardCount{ 0 };
+    /**
+    * @brief     
+    * @param listenSocket   
+    * @param shard  
+    * @param kind  :  SharedMemory  ShmLoop
+    * @return    nullptr  
+    */
+    std::unique_ptr<Reactor> startShard(SOCKET listenSocket, unsigned shard, ShardKind kind = ShardKind::Tcp);
+    /**
+    * @brief   Unix-   path,   
+    * @return   INVALID_SOCKET  
     */
-    void handleClient(SOCKET clientSocket);
+    SOCKET openLocalListener(const std::string& path);
+    /**
+    * @brief     (m_unixSocket  m_shmSocket)
+    * @param path   ;  -   
+    * @return false -  
+    */
+    bool startLocalShard(SOCKET& listenSocket, const std::string& path, ShardKind kind);
+    /**
+    * @brief  -  ,   
+    * @note   ,    
+    */
+    void onConnect(Reactor& loop, Connection& conn);
+    /**
+    * @brief   ,  ,  .
+    *       onMessage;  
+    *        InputValidator::validateBatch.
+    * @param loop ,   
+    * @param conn -
+    * @param data  
+    * @param size  
+    * @return true -   , false - 
+    */
+    bool onData(Reactor& loop, Connection& conn, const char* data, size_t size);
+    /**
+    * @brief   .
+    *      -,   handleClient.
+    * @param received ;         
+    * @param validated  (  )  
+    * validateBatch  ;     
+    * @return true -   , false - 
+    */
+    bool onMessage(Reactor& loop, Connection& conn, const protocol::FrameView& received, bool validated = false);
+    /**
+    * @brief ,   
+    * @details      ;   
+    *  ,     post()
+    * @param response   ( ,     )
+    * @return true -   , false - 
+    */
+    bool onPubSub(Reactor& loop, Connection& conn, const protocol::FrameView& frame, Response& response);
+    /**
+    * @brief    ,   
+    *     ,     post()
+    * @details       
+    */
+    void onPosted(Reactor& loop);
+    /**
+    * @brief         
+    * @details       ,     
+    * @return true -   , false - 
+    */
+    bool replyInline(Reactor& loop, Connection& conn, Response& response);
+    /**
+    * @brief   ,    ,  
+    *   ,  ;   
+    * @details     deferredReplies  
+    * seq - replySeq,   ,    - O(1); 
+    *       . 
+    *      MAX_REPLY_BACKLOG, 
+    *  .  Client    : 
+    *   ,  Publish,      
+    * @return true -   , false - 
+    */
+    bool replyInOrder(Reactor& loop, Connection& conn, std::unique_ptr<RouteJob> job);
+    /**
+    * @brief       ,   
+    * @return true -   , false - 
+    */
+    bool sendResponse(Reactor& loop, Connection& conn, const Response& response);
+
+    //     ,   
+    // .     , 
+    //         
+    static constexpr uint64_t MAX_REPLY_BACKLOG = 1024;
+    static constexpr int HANDOFF_POLL_MS = 200; //     
+    static constexpr int HANDOFF_READY_MS = 10000; //  Ready   
+    int m_upgradeListener = -1; // Unix-   
+    int m_handoffChannel = -1; //     ( Ready)
+    int m_takeoverChannel = -1; //    
+    std::thread m_upgradeThread;
+    std::thread m_takeoverThread;
+    std::mutex m_handoffMutex; //      Done
+    bool m_handoffClosed = false; // Done ,    
+    /**
+    * @brief       (takeoverSocket)
+    * @param[out] listeners TCP-   ; 
+    *     m_unixSocket  m_shmSocket
+    * @return false -      
+    */
+    bool takeOverListeners(std::vector<SOCKET>& listeners);
+    /**
+    * @brief   :   ,  
+    *          
+    *  handoffTimeoutMs
+    */
+    void awaitUpgrade();
+    /**
+    * @brief   :    
+    *    Done
+    */
+    void receiveConnections();
+    /**
+    * @brief   :  ,  ,
+    *  ,  ,     
+    */
+    bool canHandOff(const Reactor& loop, const Connection& conn) const;
+    /**
+    * @brief        
+    * @details       :   
+    * ,    ,   
+    * @return true -  ,    
+    */
+    bool handOff(Reactor& loop, Connection& conn);
+    /**
+    * @brief         
+    *     
+    */
+    void adopt(Reactor& loop, const handoff::Adoption& adoption);
+#endif
     /**
     * @brief   ,   .
     *        .
     */
     void cleanup();
+    /**
+    * @brief   :  ,   MAX_CLIENTS
+    * @details    ( Linux)    MAX_CLIENTS
+    */
+    int connectionLimit() const;
+    /**
+    * @brief   Hello:  ,    
+    * @param[out] dictionary   :  , 
+    *    ,  None
+    * @return   
+    */
+    bool negotiate(const protocol::FrameView& hello, Response& response, compression::Dictionary& dictionary) const;
+    /**
+    * @brief     FLAG_COMPRESSED     
+    * @return false -  
+    */
+    static bool inflateFrame(protocol::FrameView& frame, buffers::Buffer& storage);
+    /**
+    * @brief    ,  
+    * @param request ,     
+    * @return   -      : 
+    *   
+    */
+    buffers::Buffer compressReply(protocol::MessageType type, uint8_t flags, const char* payload, size_t size,
+        const Response& request, compression::Dictionary dictionary) const;
+#ifndef __linux__
+    static constexpr int STOP_POLL_MS = 10; //       
+    /**
+    * @brief     .
+    *          .
+    *    ,     .
+    * @param clientSocket   .
+    * @param id    m_registry
+    */
+    void handleClient(SOCKET clientSocket, ConnectionRegistry::Id id);
     /**
      * @brief       .
      *
@@ -54,12 +327,14 @@ private:
      *         .
      */
     void acceptConnections();
+#endif
 public:
     /**
      * @brief  
      * @param port    (1-65535)
+     * @param options   - ( Windows )
      */
-    explicit Server(uint16_t port = 8080);
+    explicit Server(uint16_t port = 8080, const ServerOptions& options = ServerOptions());
     /**
      * @brief  
      * @note     
@@ -67,9 +342,14 @@ public:
     ~Server();
     /**
    * @brief    
-   * @return    
+   * @return     (   )
    */
-    int getActiveClients() const { return m_activeClients; }
+    int getActiveClients() const;
+    /**
+    * @brief   :    
+    * ,       
+    */
+    ConnectionRegistry& connections() { return m_registry; }
     /**
     * @brief  
     * @return true -  , false -  
@@ -86,45 +366,13 @@ public:
     * @return true -  , false - 
     */
     bool isRunning() const { return m_running; }
-};
-/**
- * @class InputValidator
- * @brief   
- */
-class InputValidator {
-public:
     /**
-    * @brief   
-    * @param message   
-    * @return true -  , false -  
-    *
-    *   :
-    * -   
-    * -  ? MAX_MESSAGE_LENGTH
-    * -   
-    */
-    static bool validateMessage(const std::string& message) {
-        return !message.empty() &&
-            message.length() <= MAX_MESSAGE_LENGTH &&
-            !containsInvalidChars(message);
-    }
-private:
-    static constexpr size_t MAX_MESSAGE_LENGTH = 1024;//    .
+    * @brief    :   
+    */
+    bool upgraded() const { return m_upgraded; }
     /**
-     * @brief ,     .
-     *
-     *     ASCII   0  8,
-     *  11  12,  14  31,    DEL (127).
-     *
-     * @param message   .
-     * @return true,    , false   .
-     */
-    static bool containsInvalidChars(const std::string& message) {
-        for (unsigned char c : message) {
-            if (c < 32 && c != 0x09 && c != 0x0A) return true;
-            if (c == 0x7F) return true;
-        }
-        return false;
-    }
+    * @brief    (  -   PID),  -  
+    */
+    const std::string& captureFile() const { return m_options.captureFile; }
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,139 @@
+#ifndef SESSION_HPP
+#define SESSION_HPP
+
+#include <coroutine>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include "../include/common/buffer_pool.hpp"
+#include "../include/common/protocol.hpp"
+#include "../include/common/task.hpp"
+
+/**
+ * @class Session
+ * @brief     -.
+ *
+ *    :
+ * @code
+ * coro::Task<void> echo(Session& session) {
+ *     while (auto frame = co_await session.readFrame()) {
+ *         const bool written = co_await session.write(*frame);
+ *         if (!written) break;
+ *     }
+ * }
+ * @endcode
+ *        , 
+ *  ,      .
+ * ,    ,     
+ * ; ,  ,    ,  
+ *  ( ,       ).
+ */
+class Session {
+public:
+    /**
+     * @brief    
+     * @return false -  
+     */
+    using SendFunction = std::function<bool(protocol::MessageType type, uint8_t flags,
+        const char* payload, size_t size, const buffers::Buffer* storage)>;
+    using Handler = std::function<coro::Task<void>(Session& session)>;
+
+    explicit Session(SendFunction send) : m_send(std::move(send)) {}
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
+    /**
+     * @brief     
+     */
+    void start(const Handler& handler);
+    /**
+     * @brief    ( )
+     * @details         
+     * @return false -      
+     */
+    bool deliver(const protocol::FrameView& frame);
+    /**
+     * @brief    :  readFrame 
+     *  , write    
+     */
+    void close();
+    /**
+     * @brief  ,      
+     */
+    bool finished() const { return m_closing || m_task.done(); }
+
+    /**
+     * @class ReadAwaiter
+     * @brief co_await readFrame():    std::nullopt  .
+     * @details     co_await   
+     */
+    class ReadAwaiter {
+    public:
+        explicit ReadAwaiter(Session& session) : m_session(session) {}
+        bool await_ready();
+        void await_suspend(std::coroutine_handle<> handle);
+        std::optional<protocol::FrameView> await_resume() { return m_session.m_current; }
+    private:
+        Session& m_session;
+    };
+
+    /**
+     * @class WriteAwaiter
+     * @brief co_await write(): true -   .
+     * @details        , 
+     *    ;    
+     */
+    class WriteAwaiter {
+    public:
+        explicit WriteAwaiter(bool result) : m_result(result) {}
+        bool await_ready() const noexcept { return true; }
+        void await_suspend(std::coroutine_handle<>) const noexcept {}
+        bool await_resume() const noexcept { return m_result; }
+    private:
+        bool m_result;
+    };
+
+    [[nodiscard]] ReadAwaiter readFrame() { return ReadAwaiter(*this); }
+    /**
+     * @brief  ;       
+     */
+    [[nodiscard]] WriteAwaiter write(const protocol::FrameView& frame);
+    [[nodiscard]] WriteAwaiter write(protocol::MessageType type, const char* payload, size_t size);
+    [[nodiscard]] WriteAwaiter write(const std::string& text) {
+        return write(protocol::MessageType::Text, text.data(), text.size());
+    }
+    /**
+     * @brief    ,   
+     */
+    void requestClose() { m_closing = true; }
+private:
+    /**
+     * @struct QueuedFrame
+     * @brief ,  ,   .
+     */
+    struct QueuedFrame {
+        protocol::MessageType type;
+        uint8_t flags;
+        buffers::Buffer payload;
+    };
+
+    /**
+     * @brief     
+     */
+    void takeQueued();
+    /**
+     * @brief   
+     */
+    void settle();
+
+    SendFunction m_send;
+    coro::Task<void> m_task; //   
+    std::coroutine_handle<> m_reader; // ,  
+    std::deque<QueuedFrame> m_inbox; // ,    
+    buffers::Buffer m_currentStorage; //     
+    std::optional<protocol::FrameView> m_current; //   readFrame
+    bool m_closed = false; //  
+    bool m_closing = false; //      
+};
+#endif
@@ -0,0 +1,136 @@
+#ifndef SHM_LOOP_HPP
+#define SHM_LOOP_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include <sys/epoll.h>
+#include "../include/common/shm_ring.hpp"
+#include "../include/server/event_loop.hpp"
+
+/**
+ * @struct ShmConnection
+ * @brief    :     .
+ *   - Unix- :    
+ *   .
+ */
+struct ShmConnection : Connection {
+    std::unique_ptr<shm::Channel> channel; //   eventfd
+    bool notifyClient = false; //  toClient  ,   ,   
+    size_t slot = 0; //   ShmLoop::m_list
+};
+
+/**
+ * @class ShmLoop
+ * @brief        (shm::Channel).
+ *   ,       
+ *  ;  shm::SPIN      
+ *   epoll_wait  eventfd , Unix-   eventfd.
+ *       Server::onData,    .
+ */
+class ShmLoop : public Reactor {
+public:
+    /**
+     * @param server ,    
+     * @param listenSocket  Unix- 
+     */
+    ShmLoop(Server& server, SOCKET listenSocket);
+    ~ShmLoop() override;
+    ShmLoop(const ShmLoop&) = delete;
+    ShmLoop& operator=(const ShmLoop&) = delete;
+    bool start() override;
+    void stop() override;
+    /**
+     * @brief       ; ,  
+     * ,   pending
+     */
+    bool sendFrame(Connection& conn, protocol::MessageType type, uint8_t flags,
+        const char* payload, size_t size, const buffers::Buffer* storage = nullptr) override;
+    void closeConnection(Connection& conn, const std::string& reason) override;
+    Connection* findConnection(SOCKET socket, uint64_t id) override;
+    bool sendEncoded(Connection& conn, const buffers::Buffer& frame) override;
+    size_t queuedBytes(const Connection& conn) const override { return conn.pending.size(); }
+    /**
+     * @brief   :     
+     */
+    void resumeRead(Connection& conn) override { (void)conn; }
+    /**
+     * @brief       (. Server::receiveConnections)
+     * @return nullptr,  
+     */
+    Connection* adoptSocket(SOCKET socket, ConnectionClass connectionClass) override;
+private:
+    static constexpr int MAX_EVENTS = 64; //    epoll_wait
+    static constexpr size_t MAX_PENDING = 1 << 20; //   
+    static constexpr unsigned POLL_EVERY = 64; //      epoll  
+    static constexpr size_t READ_BUFFER_SIZE = 64 * 1024; //     
+
+    /**
+     * @brief   epoll    data.u64 ( - id )
+     */
+    enum class Tag : uint64_t {
+        Listener = 0,
+        Wake = 1,
+        Socket = 2, // Unix- :  
+        Event = 3 // eventfd :     
+    };
+
+    void run();
+    /**
+     * @brief     
+     * @return true -    
+     */
+    bool pollRings();
+    /**
+     * @brief      pending
+     * @return true -   (  )
+     */
+    bool service(ShmConnection& conn);
+    /**
+     * @brief       
+     * @return false -  ,   :  
+     */
+    bool prepareSleep();
+    /**
+     * @brief     ,    
+     *    
+     */
+    void finishSleep();
+    void handleEvents(const epoll_event* events, int count);
+    void acceptAll();
+    /**
+     * @brief        SCM_RIGHTS
+     * @return false -  
+     */
+    bool handshake(ShmConnection& conn);
+    bool write(ShmConnection& conn, const char* data, size_t size);
+    /**
+     * @brief  pending  ,    
+     * @return false,    
+     */
+    bool flush(ShmConnection& conn);
+    void notifyClients();
+    /**
+     * @brief   m_list   
+     */
+    void compactList();
+    void handOffConnections() override;
+    void enableAccept(bool enable) override;
+    void wake() override;
+
+    Server& m_server;
+    SOCKET m_listenSocket;
+    int m_epollFd = -1;
+    int m_wakeFd = -1; // eventfd  ,     (  )
+    std::atomic<bool> m_running{ false };
+    std::thread m_thread;
+    uint64_t m_nextConnId = 1;
+    std::unordered_map<uint64_t, std::unique_ptr<ShmConnection>> m_connections;
+    std::vector<ShmConnection*> m_list; //    ; nullptr - 
+    size_t m_listHoles = 0; //     m_list
+    std::vector<char> m_readBuffer; //       (  )
+};
+#endif
@@ -0,0 +1,307 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief  :     .
+ */
+enum class ConnectionClass : uint8_t {
+    New, //       
+    Active, //   
+    Count
+};
+
+constexpr size_t CONNECTION_CLASS_COUNT = static_cast<size_t>(ConnectionClass::Count);
+
+/**
+ * @brief  .
+ */
+enum class TimerKind : uint8_t {
+    Idle, //    idleMs
+    Read, //      readMs
+    Write, //      writeMs
+    Count
+};
+
+constexpr size_t TIMER_KIND_COUNT = static_cast<size_t>(TimerKind::Count);
+
+/**
+ * @struct TimeoutPolicy
+ * @brief       (0 - ).
+ */
+struct TimeoutPolicy {
+    uint32_t idleMs = 0;
+    uint32_t readMs = 0;
+    uint32_t writeMs = 0;
+};
+
+using TimeoutPolicies = std::array<TimeoutPolicy, CONNECTION_CLASS_COUNT>;
+
+/**
+ * @brief   :    10  
+ *  ,  - 100  
+ */
+inline TimeoutPolicies defaultTimeouts() {
+    TimeoutPolicies policies;
+    policies[static_cast<size_t>(ConnectionClass::New)] = { 10000, 10000, 30000 };
+    policies[static_cast<size_t>(ConnectionClass::Active)] = { 100000, 30000, 30000 };
+    return policies;
+}
+
+/**
+ * @struct TimerNode
+ * @brief ,   - (  ).
+ *      .
+ */
+struct TimerNode {
+    TimerNode* prev = nullptr;
+    TimerNode* next = nullptr;
+    uint64_t expiry = 0; //  
+    uint8_t level = 0; //    ,   
+    uint8_t slot = 0;
+    uint8_t kind = 0; //    
+    void* owner = nullptr; // ,   
+
+    bool armed() const { return next != nullptr; }
+};
+
+/**
+ * @class TimerWheel
+ * @brief   : ,     O(1).
+ *
+ *    64 ;   l  64^l .
+ *     ,     64  
+ *  ,   ,     .
+ *         
+ *   ,        
+ *  ,    .
+ * @note  :    .
+ */
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr unsigned SLOT_BITS = 6;
+    static constexpr unsigned SLOTS = 1u << SLOT_BITS; //   
+    static constexpr unsigned LEVELS = 4; // 64^4 :  46    10 
+    static constexpr uint8_t DETACHED = 0xFF; //       
+
+    /**
+     * @param resolution   ( )
+     */
+    explicit TimerWheel(Clock::duration resolution = std::chrono::milliseconds(10), Clock::time_point origin = Clock::now())
+        : m_resolution(resolution), m_origin(origin) {
+        for (auto& level : m_slots) {
+            for (TimerNode& head : level) {
+                head.prev = head.next = &head;
+            }
+        }
+        m_expired.prev = m_expired.next = &m_expired;
+    }
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * @brief  ( ) 
+     * @details    deadline        
+     */
+    void arm(TimerNode& node, Clock::time_point deadline) {
+        if (node.armed()) cancel(node);
+        const auto offset = deadline - m_origin;
+        uint64_t expiry = offset <= Clock::duration::zero() ? 0
+            : static_cast<uint64_t>((offset + m_resolution - Clock::duration(1)) / m_resolution);
+        node.expiry = expiry > m_tick ? expiry : m_tick + 1;
+        insert(node);
+        ++m_size;
+    }
+
+    /**
+     * @brief  ;     
+     */
+    void cancel(TimerNode& node) {
+        if (!node.armed()) return;
+        unlink(node);
+        --m_size;
+    }
+
+    /**
+     * @brief     now   expire(TimerNode&)
+     *    
+     * @details      ,   
+     *      ,       
+     * @return   
+     */
+    template <typename Expire>
+    size_t advance(Clock::time_point now, Expire&& expire) {
+        const uint64_t target = tickOf(now);
+        if (m_size == 0) {
+            if (target > m_tick) m_tick = target;
+            return 0;
+        }
+        size_t fired = 0;
+        while (m_tick < target) {
+            ++m_tick;
+            for (unsigned level = LEVELS - 1; level > 0; --level) {
+                if ((m_tick & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) == 0) cascade(level);
+            }
+            fired += fire(expire);
+            if (m_size == 0) {
+                m_tick = target;
+                break;
+            }
+            //       
+            const uint64_t next = nextEventTick();
+            if (next > m_tick + 1) m_tick = next <= target ? next - 1 : target;
+        }
+        return fired;
+    }
+
+    /**
+     * @brief        
+     * @return -1,   
+     */
+    int timeoutMs(Clock::time_point now) const {
+        const uint64_t tick = nextEventTick();
+        if (tick == UINT64_MAX) return -1;
+        const Clock::time_point at = m_origin + m_resolution * static_cast<Clock::rep>(tick);
+        if (at <= now) return 0;
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(at - now + std::chrono::milliseconds(1) - Clock::duration(1));
+        return ms.count() > INT32_MAX ? INT32_MAX : static_cast<int>(ms.count());
+    }
+
+    /**
+     * @brief   
+     */
+    size_t size() const { return m_size; }
+private:
+    uint64_t tickOf(Clock::time_point time) const {
+        return time <= m_origin ? 0 : static_cast<uint64_t>((time - m_origin) / m_resolution);
+    }
+
+    /**
+     * @brief       
+     * @details  - ,       
+     *    64;       
+     *       
+     */
+    void insert(TimerNode& node) {
+        unsigned level = 0;
+        while (level < LEVELS - 1 && (node.expiry >> (SLOT_BITS * level)) - (m_tick >> (SLOT_BITS * level)) >= SLOTS) {
+            ++level;
+        }
+        uint64_t position = node.expiry >> (SLOT_BITS * level);
+        const uint64_t current = m_tick >> (SLOT_BITS * level);
+        if (position - current >= SLOTS) position = current + SLOTS - 1;
+
+        node.level = static_cast<uint8_t>(level);
+        node.slot = static_cast<uint8_t>(position & (SLOTS - 1));
+        TimerNode& head = m_slots[level][node.slot];
+        node.prev = head.prev;
+        node.next = &head;
+        head.prev->next = &node;
+        head.prev = &node;
+        m_occupied[level] |= uint64_t(1) << node.slot;
+    }
+
+    void unlink(TimerNode& node) {
+        node.prev->next = node.next;
+        node.next->prev = node.prev;
+        if (node.level != DETACHED) {
+            const TimerNode& head = m_slots[node.level][node.slot];
+            if (head.next == &head) m_occupied[node.level] &= ~(uint64_t(1) << node.slot);
+        }
+        node.prev = node.next = nullptr;
+    }
+
+    /**
+     * @brief    level,     
+     */
+    void cascade(unsigned level) {
+        const unsigned slot = static_cast<unsigned>((m_tick >> (SLOT_BITS * level)) & (SLOTS - 1));
+        TimerNode& head = m_slots[level][slot];
+        if (head.next == &head) return;
+        TimerNode list;
+        list.prev = head.prev;
+        list.next = head.next;
+        list.prev->next = list.next->prev = &list;
+        head.prev = head.next = &head;
+        m_occupied[level] &= ~(uint64_t(1) << slot);
+        while (list.next != &list) {
+            TimerNode& node = *list.next;
+            list.next = node.next;
+            node.next->prev = &list;
+            insert(node);
+        }
+    }
+
+    /**
+     * @brief       
+     */
+    template <typename Expire>
+    size_t fire(Expire& expire) {
+        const unsigned slot = static_cast<unsigned>(m_tick & (SLOTS - 1));
+        TimerNode& head = m_slots[0][slot];
+        if (head.next == &head) return 0;
+        //     :   
+        //          
+        m_expired.prev = head.prev;
+        m_expired.next = head.next;
+        m_expired.prev->next = m_expired.next->prev = &m_expired;
+        head.prev = head.next = &head;
+        m_occupied[0] &= ~(uint64_t(1) << slot);
+        for (TimerNode* node = m_expired.next; node != &m_expired; node = node->next) {
+            node->level = DETACHED;
+        }
+
+        size_t fired = 0;
+        while (m_expired.next != &m_expired) {
+            TimerNode& node = *m_expired.next;
+            unlink(node);
+            --m_size;
+            ++fired;
+            expire(node);
+        }
+        return fired;
+    }
+
+    /**
+     * @brief  ,      : 
+     *       
+     */
+    uint64_t nextEventTick() const {
+        uint64_t best = UINT64_MAX;
+        for (unsigned level = 0; level < LEVELS; ++level) {
+            if (m_occupied[level] == 0) continue;
+            const unsigned shift = SLOT_BITS * level;
+            const uint64_t current = m_tick >> shift;
+            const unsigned from = static_cast<unsigned>((current + 1) & (SLOTS - 1));
+            const uint64_t rotated = (m_occupied[level] >> from) | (from ? m_occupied[level] << (SLOTS - from) : 0);
+            const uint64_t tick = (current + 1 + countTrailingZeros(rotated)) << shift;
+            if (tick < best) best = tick;
+        }
+        return best;
+    }
+
+    static unsigned countTrailingZeros(uint64_t value) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+    }
+
+    Clock::duration m_resolution;
+    Clock::time_point m_origin; //   0
+    uint64_t m_tick = 0; //   
+    size_t m_size = 0;
+    std::array<uint64_t, LEVELS> m_occupied{}; //   
+    std::array<std::array<TimerNode, SLOTS>, LEVELS> m_slots; //    
+    TimerNode m_expired; // ,   fire()
+};
+#endif
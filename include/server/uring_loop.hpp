@@ -0,0 +1,190 @@
+#ifndef URING_LOOP_HPP
+#define URING_LOOP_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include <linux/io_uring.h>
+#include "../include/server/event_loop.hpp"
+
+/**
+ * @struct UringSend
+ * @brief   ,     CQE.
+ *        (  ), 
+ *       .
+ */
+struct UringSend {
+    uint64_t connId = 0; //  (   )
+    int bufferId = -1; //     -1
+    const char* data = nullptr;
+    size_t size = 0;
+    size_t offset = 0; //     
+    bool inFlight = false; // SQE , CQE   
+    bool zeroCopy = false; //   IORING_OP_SEND_ZC
+    bool retired = false; //   ,    SEND_ZC
+    unsigned notifications = 0; //   SEND_ZC (   )
+    char header[protocol::MAX_HEADER_SIZE]; //   (  )
+    buffers::Buffer storage; //  ,      
+};
+
+/**
+ * @struct UringConnection
+ * @brief   io_uring:     .
+ */
+struct UringConnection : Connection {
+    std::deque<UringSend*> sendQueue; //    
+    unsigned inFlight = 0; //      
+    bool flushScheduled = false; //      
+    bool zeroCopy = true; // SEND_ZC       
+    size_t queuedBytes = 0; //   sendQueue,    
+    bool handingOff = false; //  ,     
+    bool recvCancelling = false; // Multishot recv      (replyBacklog)
+    bool recvStopped = false; // Multishot recv  :   (replyBacklog)
+};
+
+/**
+ * @class UringLoop
+ * @brief    io_uring.
+ *  multishot accept, multishot recv    
+ *     (IOSQE_IO_LINK) 
+ * ,  accept/recv/send    
+ * :  SQE     io_uring_enter.
+ */
+class UringLoop : public Reactor {
+public:
+    /**
+     * @brief  
+     * @param server ,    
+     * @param listenSocket  
+     */
+    UringLoop(Server& server, SOCKET listenSocket);
+    ~UringLoop() override;
+    UringLoop(const UringLoop&) = delete;
+    UringLoop& operator=(const UringLoop&) = delete;
+    /**
+     * @brief  ,     
+     * multishot recv;     false   
+     */
+    bool start() override;
+    void stop() override;
+    /**
+     * @brief       ;  
+     *          
+     * @details       IORING_OP_SEND_ZC,
+     *    
+     */
+    bool sendFrame(Connection& conn, protocol::MessageType type, uint8_t flags,
+        const char* payload, size_t size, const buffers::Buffer* storage = nullptr) override;
+    void closeConnection(Connection& conn, const std::string& reason) override;
+    Connection* findConnection(SOCKET socket, uint64_t id) override;
+    /**
+     * @brief        ,  
+     */
+    bool sendEncoded(Connection& conn, const buffers::Buffer& frame) override;
+    size_t queuedBytes(const Connection& conn) const override {
+        return static_cast<const UringConnection&>(conn).queuedBytes;
+    }
+    /**
+     * @brief   multishot recv,       
+     */
+    void resumeRead(Connection& conn) override;
+    Connection* adoptSocket(SOCKET socket, ConnectionClass connectionClass) override;
+private:
+    static constexpr unsigned RING_ENTRIES = 1024; //  SQ
+    static constexpr unsigned BUFFER_COUNT = 1024; //     ( )
+    static constexpr size_t BUFFER_SIZE = 16 * 1024; //    
+    static constexpr uint16_t BUFFER_GROUP = 0; //   
+    static constexpr unsigned MAX_LINKED = 16; //     
+    static constexpr size_t MAX_PENDING_ACCEPTS = 1024; //      accept
+
+    //      user_data
+    enum OpType : uint64_t { OP_CANCEL = 0, OP_ACCEPT = 1, OP_RECV = 2, OP_SEND = 3, OP_WAKE = 4 };
+    static constexpr uint64_t OP_MASK = 7;
+
+    bool setupRing();
+    bool setupBuffers();
+    bool probeMultishotRecv();
+    bool probeOpcode(uint8_t opcode);
+    void run();
+    io_uring_sqe* getSqe();
+    /**
+     * @brief   SQ   count SQE,  
+     * @return  SQE ( count,     )
+     */
+    unsigned reserveSqes(unsigned count);
+    int submitAndWait(unsigned waitNr, int timeoutMs = -1);
+    void armAccept();
+    void enableAccept(bool enable) override;
+    void wake() override;
+    void armRecv(UringConnection& conn);
+    void armWake();
+    void queueSend(UringConnection& conn, const char* data, size_t size, const buffers::Buffer* storage);
+    UringSend* newSend(UringConnection& conn);
+    void scheduleFlush(UringConnection& conn);
+    void flushSends(UringConnection& conn);
+    void onAccept(const io_uring_cqe& cqe);
+    void admitSocket(SOCKET clientSocket);
+    UringConnection& addConnection(std::unique_ptr<UringConnection> conn);
+    void forget(UringConnection& conn);
+    void handOffConnections() override;
+    void restartRecv(UringConnection& conn);
+    /**
+     * @brief  multishot recv ,    
+     */
+    void pauseRecv(UringConnection& conn);
+    void onRecv(uint64_t connId, const io_uring_cqe& cqe);
+    void onSend(UringSend* op, const io_uring_cqe& cqe);
+    void retireSend(UringSend* op);
+    void recycleBuffer(int bufferId);
+    void releaseBuffer(int bufferId);
+    UringSend* acquireSend();
+    void releaseSend(UringSend* op);
+    UringConnection* find(uint64_t connId);
+
+    Server& m_server;
+    SOCKET m_listenSocket;
+    std::atomic<bool> m_running{ false };
+    std::thread m_thread;
+    int m_wakeFd = -1; // eventfd    ,     (  )
+    uint64_t m_wakeValue = 0; //   m_wakeFd
+    bool m_acceptArmed = false; // Multishot accept   
+    std::deque<SOCKET> m_pendingAccepts; //    ,  
+
+    int m_ringFd = -1; //  io_uring
+    void* m_sqRing = nullptr; //  SQ-
+    void* m_cqRing = nullptr; //  CQ- (   SQ)
+    size_t m_sqRingSize = 0;
+    size_t m_cqRingSize = 0;
+    io_uring_sqe* m_sqes = nullptr; //  SQE
+    size_t m_sqesSize = 0;
+    unsigned* m_sqHead = nullptr;
+    unsigned* m_sqTail = nullptr;
+    unsigned m_sqMask = 0;
+    unsigned* m_sqArray = nullptr;
+    unsigned* m_cqHead = nullptr;
+    unsigned* m_cqTail = nullptr;
+    unsigned m_cqMask = 0;
+    io_uring_cqe* m_cqes = nullptr;
+    unsigned m_sqLocalTail = 0; //  SQ    
+    unsigned m_toSubmit = 0; //  SQE   io_uring_enter
+
+    io_uring_buf* m_bufRing = nullptr; //    
+    size_t m_bufRingSize = 0;
+    uint16_t m_bufTail = 0;
+    std::vector<char> m_buffers; //    
+    size_t m_bufferSize = 0;
+    std::vector<uint16_t> m_bufferRefs; //      
+    int m_currentBuffer = -1; // ,    Server::onData
+    bool m_sendZeroCopy = false; //   IORING_OP_SEND_ZC
+
+    uint64_t m_nextConnId = 1;
+    std::unordered_map<uint64_t, std::unique_ptr<UringConnection>> m_connections;
+    std::vector<std::unique_ptr<UringSend>> m_sendOps; //    
+    std::vector<UringSend*> m_freeSends; //     
+    std::vector<uint64_t> m_flushList; // ,     
+};
+#endif
@@ -0,0 +1,97 @@
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkItem
+ * @brief  ;  run()     .
+ * @details ,     ,  
+ */
+class WorkItem {
+public:
+    virtual ~WorkItem() = default;
+    /**
+     * @brief    
+     * @note       
+     */
+    virtual void run() = 0;
+};
+
+/**
+ * @class WorkerPool
+ * @brief      .
+ *
+ *     :     
+ *   ,       , 
+ *  ,    .   
+ *    -    . 
+ *   ,       ;
+ *      .
+ */
+class WorkerPool {
+public:
+    /**
+     * @param workers   (0 -   )
+     * @param queueDepth     
+     */
+    WorkerPool(unsigned workers, size_t queueDepth);
+    /**
+     * @note  ;   
+     */
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void start();
+    /**
+     * @brief        
+     */
+    void stop();
+    /**
+     * @brief    
+     * @return false -     ; 
+     *   
+     * @note     
+     */
+    bool submit(WorkItem* item);
+    unsigned workers() const { return static_cast<unsigned>(m_workers.size()); }
+    size_t queueDepth() const { return m_queueDepth; }
+private:
+    /**
+     * @struct Worker
+     * @brief     ;  -.
+     */
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        std::deque<WorkItem*> queue;
+        std::thread thread;
+    };
+
+    void run(size_t index);
+    /**
+     * @brief    
+     */
+    WorkItem* popLocal(Worker& worker);
+    /**
+     * @brief      
+     */
+    WorkItem* steal(size_t thief);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    size_t m_queueDepth;
+    std::atomic<bool> m_running{ false };
+    alignas(64) std::atomic<size_t> m_queued{ 0 }; //     (   )
+    alignas(64) std::atomic<size_t> m_nextQueue{ 0 }; //    
+    std::atomic<unsigned> m_sleeping{ 0 }; // ,   m_wakeup
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeup;
+};
+#endif
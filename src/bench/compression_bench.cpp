@@ -0,0 +1,269 @@
+#include "../include/common/compression.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    const compression::Dictionary DICTIONARIES[] = {
+        compression::Dictionary::None,
+        compression::Dictionary::Chat
+    };
+
+    const char* dictionaryName(compression::Dictionary dictionary) {
+        return dictionary == compression::Dictionary::Chat ? "chat" : "none";
+    }
+
+    /**
+     * @brief      ,   
+     */
+    std::vector<std::string> chatCorpus(size_t count) {
+        static const char* const PHRASES[] = {
+            "hi", "hello everyone", "good morning", "how are you doing today?", "i'm fine, thank you",
+            "see you later", "let me know what you think", "sounds good to me", "no problem",
+            "can you please send me the link", "meeting tomorrow at 12:30", "on my way", "be right back",
+            "did you see the new version?", "thanks a lot", "happy birthday!", "lol", "ok",
+            "i don't know, maybe next week", "sorry for the delay", "the build is broken again",
+            "who is working on the release?", "just a moment please", "what time is the call?"
+        };
+        static const char* const NAMES[] = { "alice", "bob", "carol", "dave", "erin", "frank" };
+        std::mt19937 rng(7);
+        std::vector<std::string> messages(count);
+        for (std::string& message : messages) {
+            message = NAMES[rng() % std::size(NAMES)];
+            message += ": ";
+            const size_t phrases = 1 + rng() % 3;
+            for (size_t i = 0; i < phrases; ++i) {
+                if (i) message += ' ';
+                message += PHRASES[rng() % std::size(PHRASES)];
+            }
+            if (rng() % 4 == 0) message += " #" + std::to_string(rng() % 10000);
+        }
+        return messages;
+    }
+
+    /**
+     * @brief    JSON:   
+     */
+    std::vector<std::string> jsonCorpus(size_t count) {
+        std::mt19937 rng(11);
+        std::vector<std::string> messages(count);
+        for (std::string& message : messages) {
+            const size_t records = 4 + rng() % 8;
+            for (size_t i = 0; i < records; ++i) {
+                message += "{\"type\":\"message\",\"user\":\"user" + std::to_string(rng() % 100)
+                    + "\",\"time\":\"2026-10-16 12:" + std::to_string(10 + rng() % 50)
+                    + "\",\"id\":" + std::to_string(rng()) + ",\"text\":\"status update\"}";
+            }
+        }
+        return messages;
+    }
+
+    /**
+     * @brief  :   
+     */
+    std::vector<std::string> randomCorpus(size_t count) {
+        std::mt19937 rng(13);
+        std::vector<std::string> messages(count);
+        for (std::string& message : messages) {
+            message.resize(64 + rng() % 1024);
+            for (char& c : message) c = static_cast<char>(rng());
+        }
+        return messages;
+    }
+
+    /**
+     * @brief    ,    
+     * @return true -  (    )
+     */
+    bool roundTrip(const std::string& data, compression::Dictionary dictionary) {
+        std::vector<char> block(data.size() + data.size() / 255 + 16);
+        const size_t size = compression::compress(data.data(), data.size(), block.data(), block.size(), dictionary);
+        if (size == 0) return false; //       
+        std::vector<char> restored(data.size() + 1);
+        return compression::decompress(block.data(), size, restored.data(), data.size(), dictionary)
+            && std::equal(data.begin(), data.end(), restored.begin());
+    }
+
+    /**
+     * @brief         
+     * @details     LZ4- (15  255+15),
+     *    ,    
+     *       
+     * @return  
+     */
+    int crossCheck() {
+        std::mt19937 rng(12345);
+        int mismatches = 0;
+        auto check = [&](const std::string& data) {
+            for (compression::Dictionary dictionary : DICTIONARIES) {
+                if (!roundTrip(data, dictionary)) {
+                    std::printf("MISMATCH %s: size %zu\n", dictionaryName(dictionary), data.size());
+                    ++mismatches;
+                }
+            }
+        };
+
+        for (size_t size = 0; size <= 600; ++size) {
+            std::string data(size, '\0');
+            for (char& c : data) c = static_cast<char>('a' + rng() % 3); //   
+            check(data);
+            for (char& c : data) c = static_cast<char>(rng());
+            check(data);
+            std::fill(data.begin(), data.end(), 'x'); //  
+            check(data);
+        }
+        for (const std::string& message : chatCorpus(2000)) check(message);
+        for (const std::string& message : jsonCorpus(200)) check(message);
+        std::string large(protocol::MAX_PAYLOAD_SIZE, '\0');
+        for (size_t i = 0; i < large.size(); ++i) large[i] = static_cast<char>(i % 251 < 100 ? rng() : 'a' + i % 7);
+        check(large);
+
+        //  :  ,  , 
+        const std::string message = "good morning everyone, let me know what you think about the meeting tomorrow";
+        buffers::Buffer frame = compression::makeCorrelatedFrame(protocol::MessageType::Text, 300, message.data(),
+            message.size(), compression::Dictionary::Chat);
+        protocol::FrameView view;
+        size_t headerSize = 0;
+        uint64_t correlation = 0;
+        buffers::Buffer storage;
+        const bool parsed = frame
+            && protocol::parseHeader(frame.data(), frame.size(), view, headerSize) == protocol::ParseStatus::Complete;
+        if (parsed) view.payload = frame.data() + headerSize;
+        if (!parsed || !(view.flags & protocol::FLAG_COMPRESSED) || !protocol::takeCorrelation(view, correlation)
+            || correlation != 300 || !compression::inflate(view, storage)
+            || std::string(view.payload, view.size) != message || (view.flags & protocol::FLAG_COMPRESSED)) {
+            std::printf("MISMATCH: compressed correlated frame\n");
+            ++mismatches;
+        }
+
+        //  :      
+        const std::vector<std::string> samples = chatCorpus(200);
+        for (const std::string& sample : samples) {
+            std::vector<char> block(sample.size() + 16);
+            const size_t size = compression::compress(sample.data(), sample.size(), block.data(), block.size(),
+                compression::Dictionary::Chat);
+            std::vector<char> out(sample.size());
+            for (int trial = 0; trial < 50; ++trial) {
+                std::vector<char> corrupt(block.begin(), block.begin() + static_cast<std::ptrdiff_t>(size));
+                corrupt[rng() % corrupt.size()] = static_cast<char>(rng());
+                compression::decompress(corrupt.data(), corrupt.size(), out.data(), out.size(),
+                    compression::Dictionary::Chat);
+            }
+        }
+        return mismatches;
+    }
+
+    /**
+     * @struct Result
+     * @brief   :      .
+     */
+    struct Result {
+        size_t original = 0; //   
+        size_t sent = 0; //     (  )
+        size_t compressed = 0; // ,  
+        size_t inflated = 0; // ,  
+        double compressNs = 0; //    ( )
+        double decompressNs = 0; //   
+    };
+
+    /**
+     * @brief         threshold
+     */
+    Result measure(const std::vector<std::string>& corpus, compression::Dictionary dictionary, size_t threshold) {
+        Result result;
+        std::vector<buffers::Buffer> frames(corpus.size());
+        for (int round = 0; round < 5; ++round) {
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < corpus.size(); ++i) {
+                frames[i] = corpus[i].size() >= threshold
+                    ? compression::makeFrame(protocol::MessageType::Text, corpus[i].data(), corpus[i].size(), dictionary)
+                    : buffers::Buffer();
+            }
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            result.compressNs = round ? std::min(result.compressNs, elapsed.count()) : elapsed.count();
+        }
+
+        std::vector<protocol::FrameView> views;
+        for (size_t i = 0; i < corpus.size(); ++i) {
+            result.original += corpus[i].size();
+            if (!frames[i]) {
+                result.sent += corpus[i].size();
+                continue;
+            }
+            protocol::FrameView view;
+            size_t headerSize = 0;
+            protocol::parseHeader(frames[i].data(), frames[i].size(), view, headerSize);
+            view.payload = frames[i].data() + headerSize;
+            views.push_back(view);
+            result.sent += view.size;
+            result.inflated += corpus[i].size();
+            ++result.compressed;
+        }
+
+        buffers::Buffer storage;
+        for (int round = 0; round < 5; ++round) {
+            auto start = std::chrono::steady_clock::now();
+            for (const protocol::FrameView& compressed : views) {
+                protocol::FrameView view = compressed;
+                compression::inflate(view, storage);
+            }
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            result.decompressNs = round ? std::min(result.decompressNs, elapsed.count()) : elapsed.count();
+        }
+        return result;
+    }
+}
+
+int main() {
+    const int mismatches = crossCheck();
+    if (mismatches > 0) {
+        std::printf("%d round-trip mismatches\n", mismatches);
+        return 1;
+    }
+    std::printf("All round trips match.\n\n");
+
+    struct Corpus {
+        const char* name;
+        std::vector<std::string> messages;
+    };
+    const Corpus corpora[] = {
+        { "chat", chatCorpus(20000) },
+        { "json", jsonCorpus(2000) },
+        { "random", randomCorpus(2000) }
+    };
+
+    //   -  ,   ;  0
+    std::printf("%-7s %-5s %9s %8s %8s %12s %14s\n", "corpus", "dict", "avg size", "ratio", "framed",
+        "compress MB/s", "decompress MB/s");
+    for (const Corpus& corpus : corpora) {
+        for (compression::Dictionary dictionary : DICTIONARIES) {
+            const Result result = measure(corpus.messages, dictionary, 0);
+            std::printf("%-7s %-5s %9zu %7.2fx %7.1f%% %12.1f %14.1f\n", corpus.name, dictionaryName(dictionary),
+                result.original / corpus.messages.size(),
+                static_cast<double>(result.original) / static_cast<double>(result.sent),
+                100.0 * static_cast<double>(result.compressed) / static_cast<double>(corpus.messages.size()),
+                static_cast<double>(result.original) * 1e3 / result.compressNs,
+                result.inflated > 0 ? static_cast<double>(result.inflated) * 1e3 / result.decompressNs : 0.0);
+        }
+    }
+
+    //      :  
+    //           
+    const std::vector<std::string>& chat = corpora[0].messages;
+    std::printf("\nchat corpus, chat dictionary: bandwidth saved vs CPU spent per message\n");
+    std::printf("%9s %9s %10s %14s %14s %12s\n", "threshold", "wire", "saved B", "saved 10Mb us",
+        "saved 1Gb us", "CPU us");
+    for (size_t threshold : { size_t(0), size_t(16), size_t(32), size_t(64), size_t(128) }) {
+        const Result result = measure(chat, compression::Dictionary::Chat, threshold);
+        const double count = static_cast<double>(chat.size());
+        const double saved = static_cast<double>(result.original - result.sent) / count;
+        const double cpuUs = (result.compressNs + result.decompressNs) / count / 1e3;
+        std::printf("%9zu %8.1f%% %10.1f %14.2f %14.3f %12.3f\n", threshold,
+            100.0 * static_cast<double>(result.sent) / static_cast<double>(result.original),
+            saved, saved * 8.0 / 10.0, saved * 8.0 / 1000.0, cpuUs);
+    }
+    return 0;
+}
@@ -0,0 +1,189 @@
+#include "../include/common/net.hpp"
+#include "../include/common/protocol.hpp"
+#include "../include/loadgen/latency_histogram.hpp"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * @file connect_bench.cpp
+ * @brief     ( Linux):  
+ * ,   ,    .
+ *
+ *    socket()    ,  
+ *   TCP,      . 
+ *   --concurrency ,      poll.
+ *  --fastopen    TCP_FASTOPEN_CONNECT: 
+ *   SYN,     cookie  (  
+ *   --fastopen,  net.ipv4.tcp_fastopen -  
+ * ).
+ */
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct BenchOptions {
+        std::string host = "127.0.0.1";
+        uint16_t port = 8080;
+        size_t connections = 20000; //  
+        size_t concurrency = 64; //    
+        size_t size = 32; //   
+        bool fastOpen = false; // TCP_FASTOPEN_CONNECT   
+    };
+
+    /**
+     * @brief   
+     */
+    struct Attempt {
+        SOCKET socket = INVALID_SOCKET;
+        Clock::time_point started;
+        bool sent = false; //  ,  
+        size_t received = 0; //  
+    };
+
+    void usage() {
+        std::fprintf(stderr,
+            "Usage: ConnectBench [--host ADDR] [--port N] [--connections N] [--concurrency N] [--size N] [--fastopen]\n");
+    }
+
+    /**
+     * @brief   
+     * @return false -     ( POLLOUT)   (errno != 0)
+     */
+    bool sendFrame(Attempt& attempt, const std::string& frame) {
+        errno = 0;
+        const ssize_t sent = send(attempt.socket, frame.data(), frame.size(), MSG_NOSIGNAL);
+        if (sent == static_cast<ssize_t>(frame.size())) {
+            attempt.sent = true;
+            return true;
+        }
+        //           
+        if (sent >= 0 || errno == EINPROGRESS || errno == EAGAIN || errno == ENOTCONN) errno = 0;
+        return false;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--host" && hasValue) options.host = argv[++i];
+        else if (arg == "--port" && hasValue) options.port = static_cast<uint16_t>(std::stoul(argv[++i]));
+        else if (arg == "--connections" && hasValue) options.connections = std::stoul(argv[++i]);
+        else if (arg == "--concurrency" && hasValue) options.concurrency = std::stoul(argv[++i]);
+        else if (arg == "--size" && hasValue) options.size = std::stoul(argv[++i]);
+        else if (arg == "--fastopen") options.fastOpen = true;
+        else {
+            usage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (options.concurrency == 0) options.concurrency = 1;
+    if (options.size == 0) options.size = 1;
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(options.port);
+    if (inet_pton(AF_INET, options.host.c_str(), &address.sin_addr) != 1) {
+        std::fprintf(stderr, "Invalid address %s\n", options.host.c_str());
+        return 1;
+    }
+    const std::string frame = protocol::encodeFrame(protocol::MessageType::Text, std::string(options.size, 'x'));
+
+    std::vector<Attempt> attempts(options.concurrency);
+    std::vector<pollfd> fds(options.concurrency);
+    std::vector<char> buffer(frame.size() + 4096);
+    LatencyHistogram histogram;
+    size_t started = 0;
+    size_t finished = 0;
+    size_t errors = 0;
+
+    //      slot
+    auto begin = [&](size_t slot) {
+        Attempt& attempt = attempts[slot];
+        attempt = Attempt{};
+        fds[slot] = pollfd{ -1, 0, 0 };
+        if (started == options.connections) return;
+        ++started;
+        attempt.started = Clock::now();
+        attempt.socket = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+        if (attempt.socket == INVALID_SOCKET) {
+            ++errors;
+            ++finished;
+            return;
+        }
+        int enable = 1;
+        setsockopt(attempt.socket, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+        if (options.fastOpen) {
+            setsockopt(attempt.socket, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, &enable, sizeof(enable));
+        }
+        const int result = connect(attempt.socket, (sockaddr*)&address, sizeof(address));
+        if (result < 0 && errno != EINPROGRESS) {
+            closesocket(attempt.socket);
+            attempt.socket = INVALID_SOCKET;
+            ++errors;
+            ++finished;
+            return;
+        }
+        //  TCP_FASTOPEN_CONNECT connect   0,  SYN    
+        if (result == 0) sendFrame(attempt, frame);
+        fds[slot] = pollfd{ attempt.socket, static_cast<short>(attempt.sent ? POLLIN : POLLOUT), 0 };
+    };
+    auto end = [&](size_t slot, bool ok) {
+        Attempt& attempt = attempts[slot];
+        if (ok) {
+            histogram.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - attempt.started).count()));
+        }
+        else {
+            ++errors;
+        }
+        closesocket(attempt.socket);
+        ++finished;
+        begin(slot);
+    };
+
+    const auto benchStarted = Clock::now();
+    for (size_t slot = 0; slot < attempts.size(); ++slot) begin(slot);
+    while (finished < options.connections) {
+        const int ready = net::poll(fds.data(), fds.size(), 1000);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            std::perror("poll");
+            return 1;
+        }
+        for (size_t slot = 0; slot < fds.size(); ++slot) {
+            if (fds[slot].fd < 0 || fds[slot].revents == 0) continue;
+            Attempt& attempt = attempts[slot];
+            if (!attempt.sent) {
+                if (!sendFrame(attempt, frame)) {
+                    if (errno != 0 || (fds[slot].revents & (POLLERR | POLLHUP))) end(slot, false);
+                    continue;
+                }
+                fds[slot].events = POLLIN;
+                fds[slot].revents = 0;
+                continue;
+            }
+            const ssize_t received = recv(attempt.socket, buffer.data(), buffer.size(), 0);
+            if (received <= 0) {
+                if (received < 0 && errno == EAGAIN) continue;
+                end(slot, false);
+                continue;
+            }
+            attempt.received += static_cast<size_t>(received);
+            if (attempt.received >= frame.size()) end(slot, true);
+        }
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - benchStarted).count();
+
+    auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+    std::printf("Connections: %llu (%llu errors), concurrency %zu%s\n",
+        static_cast<unsigned long long>(histogram.count()), static_cast<unsigned long long>(errors),
+        options.concurrency, options.fastOpen ? ", TCP Fast Open" : "");
+    std::printf("Rate:        %.0f connections/s\n", static_cast<double>(histogram.count()) / seconds);
+    std::printf("Connect to first echo, us: p50 %.1f p99 %.1f p99.9 %.1f max %.1f\n",
+        us(histogram.percentile(50)), us(histogram.percentile(99)), us(histogram.percentile(99.9)),
+        us(histogram.max()));
+    return errors == 0 ? 0 : 1;
+}
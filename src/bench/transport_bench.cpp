@@ -0,0 +1,116 @@
+#include "../include/client/client.hpp"
+#include "../include/loadgen/latency_histogram.hpp"
+#include <cstdio>
+
+/**
+ * @file transport_bench.cpp
+ * @brief       TCP loopback, Unix-
+ *      ( Linux).
+ *
+ *      --unix-socket  --shm-socket    .
+ *        :    ,
+ *     ,      
+ * (   -  futex).     -
+ *   ,    .
+ */
+namespace {
+    struct BenchOptions {
+        uint16_t port = 8080;
+        std::string unixPath; //  --unix-socket ,  - 
+        std::string shmPath; //  --shm-socket ,  - 
+        size_t roundTrips = 100000;
+        size_t warmup = 5000;
+        size_t size = 64; //   
+    };
+
+    void usage() {
+        std::fprintf(stderr,
+            "Usage: TransportBench [--port N] [--unix PATH] [--shm PATH] [--round-trips N] [--warmup N] [--size N]\n");
+    }
+
+    /**
+     * @brief      seen
+     * @details           
+     * ,    std::atomic::wait
+     */
+    void waitReply(const std::atomic<uint64_t>& replies, uint64_t seen) {
+        static const bool spin = std::thread::hardware_concurrency() > 1;
+        if (!spin) {
+            replies.wait(seen, std::memory_order_acquire);
+            return;
+        }
+        while (replies.load(std::memory_order_acquire) == seen) {
+            shm::cpuRelax();
+        }
+    }
+
+    /**
+     * @brief        address
+     * @return false -      
+     */
+    bool measure(const char* name, const std::string& address, const BenchOptions& options) {
+        Client client(address, options.port);
+        std::atomic<uint64_t> replies{ 0 };
+        client.setMessageCallback([&replies](const protocol::FrameView&) {
+            replies.fetch_add(1, std::memory_order_release);
+            replies.notify_one();
+        });
+        if (!client.connectToServer()) {
+            std::fprintf(stderr, "%s: cannot connect to %s\n", name, address.c_str());
+            return false;
+        }
+        client.startReceiving();
+
+        const std::string payload(options.size, 'x');
+        LatencyHistogram histogram;
+        for (size_t i = 0; i < options.warmup + options.roundTrips; ++i) {
+            const uint64_t seen = replies.load(std::memory_order_acquire);
+            const auto started = std::chrono::steady_clock::now();
+            if (!client.sendMessage(payload)) break;
+            waitReply(replies, seen);
+            const auto finished = std::chrono::steady_clock::now();
+            if (i >= options.warmup) {
+                histogram.record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(finished - started).count()));
+            }
+            if (!client.isConnected()) break;
+        }
+        client.disconnect();
+        if (histogram.count() < options.roundTrips) {
+            std::fprintf(stderr, "%s: connection lost after %llu round trips\n", name,
+                static_cast<unsigned long long>(histogram.count()));
+            return false;
+        }
+        auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+        std::printf("%-8s %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", name, us(histogram.min()),
+            us(histogram.percentile(50)), us(histogram.percentile(99)), us(histogram.percentile(99.9)),
+            us(histogram.max()), histogram.mean() / 1000.0);
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--port" && hasValue) options.port = static_cast<uint16_t>(std::stoul(argv[++i]));
+        else if (arg == "--unix" && hasValue) options.unixPath = argv[++i];
+        else if (arg == "--shm" && hasValue) options.shmPath = argv[++i];
+        else if (arg == "--round-trips" && hasValue) options.roundTrips = std::stoul(argv[++i]);
+        else if (arg == "--warmup" && hasValue) options.warmup = std::stoul(argv[++i]);
+        else if (arg == "--size" && hasValue) options.size = std::stoul(argv[++i]);
+        else {
+            usage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (options.size == 0) options.size = 1;
+
+    std::printf("%zu round trips of %zu bytes, microseconds\n", options.roundTrips, options.size);
+    std::printf("%-8s %10s %10s %10s %10s %10s %10s\n", "", "min", "p50", "p99", "p99.9", "max", "mean");
+    bool ok = measure("tcp", "127.0.0.1", options);
+    if (!options.unixPath.empty()) ok = measure("unix", "unix:" + options.unixPath, options) && ok;
+    if (!options.shmPath.empty()) ok = measure("shm", "shm:" + options.shmPath, options) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+#include "../include/server/input_validator.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+    const InputValidator::Kernel KERNELS[] = {
+        InputValidator::Kernel::Scalar,
+        InputValidator::Kernel::Sse2,
+        InputValidator::Kernel::Avx2
+    };
+
+    /**
+     * @brief        
+     * @details        
+     * ,     256  
+     * @return  
+     */
+    int crossCheck() {
+        std::mt19937 rng(12345);
+        std::uniform_int_distribution<int> printable(32, 126);
+        int mismatches = 0;
+        auto compare = [&](const std::vector<char>& data) {
+            const size_t expected = InputValidator::findInvalid(InputValidator::Kernel::Scalar, data.data(), data.size());
+            for (InputValidator::Kernel kernel : KERNELS) {
+                if (!InputValidator::isSupported(kernel)) continue;
+                const size_t actual = InputValidator::findInvalid(kernel, data.data(), data.size());
+                if (actual != expected) {
+                    std::printf("MISMATCH %s: size %zu expected %zu got %zu\n",
+                        InputValidator::kernelName(kernel), data.size(), expected, actual);
+                    ++mismatches;
+                }
+            }
+        };
+
+        for (size_t size = 0; size <= 200; ++size) {
+            std::vector<char> data(size);
+            for (char& c : data) c = static_cast<char>(printable(rng));
+            compare(data);
+            for (size_t pos = 0; pos < size; ++pos) {
+                const char saved = data[pos];
+                for (int value : { 0x00, 0x08, 0x09, 0x0A, 0x0B, 0x0D, 0x1F, 0x20, 0x7E, 0x7F, 0x80, 0xFF }) {
+                    data[pos] = static_cast<char>(value);
+                    compare(data);
+                }
+                data[pos] = saved;
+            }
+        }
+        std::vector<char> all(256);
+        for (int value = 0; value < 256; ++value) {
+            std::fill(all.begin(), all.end(), 'a');
+            all[static_cast<size_t>(value) % all.size()] = static_cast<char>(value);
+            compare(all);
+        }
+        return mismatches;
+    }
+
+    /**
+     * @brief       (   )
+     */
+    double measure(InputValidator::Kernel kernel, const std::vector<char>& data) {
+        const size_t iterations = std::max<size_t>(16, (64u << 20) / data.size());
+        double best = 1e300;
+        volatile size_t sink = 0;
+        for (int round = 0; round < 5; ++round) {
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                sink = sink + InputValidator::findInvalid(kernel, data.data(), data.size());
+            }
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count() / static_cast<double>(iterations));
+        }
+        return best;
+    }
+}
+
+int main() {
+    const int mismatches = crossCheck();
+    if (mismatches > 0) {
+        std::printf("%d mismatches against the scalar rules\n", mismatches);
+        return 1;
+    }
+    std::printf("All kernels match the scalar rules. Active kernel: %s\n\n",
+        InputValidator::kernelName(InputValidator::kernel()));
+
+    std::printf("%8s %-8s %12s %10s %9s\n", "size", "kernel", "ns/call", "GB/s", "speedup");
+    for (size_t size = 64; size <= 64 * 1024; size *= 4) {
+        std::vector<char> data(size);
+        for (size_t i = 0; i < size; ++i) data[i] = static_cast<char>('a' + i % 26);
+
+        double scalar = 0;
+        for (InputValidator::Kernel kernel : KERNELS) {
+            if (!InputValidator::isSupported(kernel)) continue;
+            const double ns = measure(kernel, data);
+            if (kernel == InputValidator::Kernel::Scalar) scalar = ns;
+            std::printf("%8zu %-8s %12.1f %10.2f %8.1fx\n", size, InputValidator::kernelName(kernel),
+                ns, static_cast<double>(size) / ns, scalar / ns);
+        }
+    }
+
+    //    recv: 64   1 
+    std::vector<char> payload(64 * 1024);
+    for (size_t i = 0; i < payload.size(); ++i) payload[i] = static_cast<char>('a' + i % 26);
+    std::vector<protocol::FrameView> frames(64);
+    for (size_t i = 0; i < frames.size(); ++i) {
+        frames[i].payload = payload.data() + i * 1024;
+        frames[i].size = 1024;
+    }
+    const size_t iterations = 20000;
+    volatile size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        sink = sink + InputValidator::validateBatch(frames.data(), frames.size()).frame;
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("\nvalidateBatch, 64 x 1 KB frames: %.1f ns/batch\n", elapsed.count() / iterations);
+    return 0;
+}
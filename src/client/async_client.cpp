@@ -0,0 +1,332 @@
+#include "../include/client/async_client.hpp"
+#include <algorithm>
+
+IoContext::IoContext() {
+	net::startup();
+}
+
+IoContext::~IoContext() {
+	net::shutdown();
+}
+
+void IoContext::spawn(coro::Task<void> task) {
+	++m_activeTasks;
+	runDetached(*this, std::move(task));
+}
+
+coro::Detached IoContext::runDetached(IoContext& context, coro::Task<void> task) {
+	co_await task;
+	--context.m_activeTasks;
+}
+
+void IoContext::attach(AsyncClient* client) {
+	m_clients.push_back(client);
+}
+
+/**
+ * @details    ,   :   
+ *     
+ */
+void IoContext::detach(AsyncClient* client) {
+	auto found = std::find(m_clients.begin(), m_clients.end(), client);
+	if (found != m_clients.end()) *found = nullptr;
+}
+
+bool IoContext::resumeReady() {
+	bool resumed = false;
+	std::vector<std::coroutine_handle<>> batch;
+	while (!m_ready.empty()) {
+		batch.swap(m_ready);
+		for (std::coroutine_handle<> handle : batch) {
+			handle.resume();
+		}
+		batch.clear();
+		resumed = true;
+	}
+	return resumed;
+}
+
+/**
+ * @details :   ,   
+ *    (,   ,  
+ * sendmsg),   poll.     
+ * ,       , 
+ *     ,    .
+ */
+void IoContext::run() {
+	m_stopped = false;
+	while (!m_stopped && m_activeTasks > 0) {
+		resumeReady();
+		if (m_stopped || m_activeTasks == 0) break;
+
+		m_clients.erase(std::remove(m_clients.begin(), m_clients.end(), nullptr), m_clients.end());
+		for (AsyncClient* client : m_clients) {
+			client->flush();
+		}
+		if (!m_ready.empty()) continue;
+
+		m_fds.clear();
+		m_owners.clear();
+		for (size_t i = 0; i < m_clients.size(); ++i) {
+			const short events = m_clients[i]->pollEvents();
+			if (events == 0) continue;
+			pollfd fd{};
+			fd.fd = m_clients[i]->m_socket;
+			fd.events = events;
+			m_fds.push_back(fd);
+			m_owners.push_back(i);
+		}
+		//  ,        
+		if (m_fds.empty()) break;
+
+		int ready = net::poll(m_fds.data(), m_fds.size(), -1);
+		if (ready == SOCKET_ERROR) {
+#ifndef _WIN32
+			if (errno == EINTR) continue;
+#endif
+			break;
+		}
+		for (size_t i = 0; i < m_fds.size() && ready > 0; ++i) {
+			if (m_fds[i].revents == 0) continue;
+			--ready;
+			if (AsyncClient* client = m_clients[m_owners[i]]) {
+				client->onEvents(m_fds[i].revents);
+			}
+		}
+	}
+}
+
+AsyncClient::AsyncClient(IoContext& context, const std::string& serverAddr, uint16_t port)
+	: m_context(context), m_serverAddr(serverAddr), m_port(port) {
+	m_context.attach(this);
+}
+
+AsyncClient::~AsyncClient() {
+	fail();
+	m_context.detach(this);
+}
+
+/**
+ * @details  connect;     , 
+ *  POLLOUT
+ */
+bool AsyncClient::ConnectAwaiter::await_ready() {
+	AsyncClient& client = m_client;
+	if (client.m_connected) {
+		m_result = true;
+		return true;
+	}
+	//      
+	if (client.m_socket != INVALID_SOCKET) return true;
+
+	sockaddr_in serverAddr{};
+	serverAddr.sin_family = AF_INET;
+	serverAddr.sin_port = htons(client.m_port);
+	if (inet_pton(AF_INET, client.m_serverAddr.c_str(), &serverAddr.sin_addr) != 1) return true;
+
+	client.m_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (client.m_socket == INVALID_SOCKET) return true;
+	net::setNonBlocking(client.m_socket);
+	//       , Nagle   
+	int enable = 1;
+	setsockopt(client.m_socket, IPPROTO_TCP, TCP_NODELAY, (const char*)&enable, sizeof(enable));
+	client.m_decoder.reset();
+	client.m_queuedTotal = client.m_writtenTotal = 0;
+
+	if (::connect(client.m_socket, (sockaddr*)&serverAddr, sizeof(serverAddr)) == 0) {
+		client.m_connected = true;
+		m_result = true;
+		return true;
+	}
+	if (!net::connectInProgress(WSAGetLastError())) {
+		closesocket(client.m_socket);
+		client.m_socket = INVALID_SOCKET;
+		return true;
+	}
+	return false;
+}
+
+void AsyncClient::ConnectAwaiter::await_suspend(std::coroutine_handle<> handle) {
+	m_handle = handle;
+	m_client.m_connecting = this;
+}
+
+bool AsyncClient::WriteAwaiter::await_ready() {
+	if (!m_client.m_connected) return true;
+	if (m_client.m_writtenTotal >= m_target) {
+		m_result = true;
+		return true;
+	}
+	return false;
+}
+
+void AsyncClient::WriteAwaiter::await_suspend(std::coroutine_handle<> handle) {
+	m_handle = handle;
+	m_client.m_writers.push_back(this);
+}
+
+bool AsyncClient::ReadAwaiter::await_ready() {
+	if (!m_client.m_inbox.empty()) {
+		m_result = std::move(m_client.m_inbox.front());
+		m_client.m_inbox.pop_front();
+		return true;
+	}
+	return !m_client.m_connected;
+}
+
+void AsyncClient::ReadAwaiter::await_suspend(std::coroutine_handle<> handle) {
+	m_handle = handle;
+	m_client.m_readers.push_back(this);
+}
+
+AsyncClient::WriteAwaiter AsyncClient::write(const char* data, size_t size) {
+	return WriteAwaiter(*this, enqueue(data, size));
+}
+
+AsyncClient::ReadAwaiter AsyncClient::request(const char* data, size_t size) {
+	enqueue(data, size);
+	return ReadAwaiter(*this);
+}
+
+void AsyncClient::close() {
+	fail();
+}
+
+uint64_t AsyncClient::enqueue(const char* data, size_t size) {
+	if (!m_connected) return 0;
+	buffers::Buffer frame = protocol::makeFrame(protocol::MessageType::Text, data, size);
+	m_queuedTotal += frame.size();
+	m_sendQueue.push_back(std::move(frame));
+	return m_queuedTotal;
+}
+
+/**
+ * @details      MAX_SEND_BATCH  ;
+ *      
+ */
+void AsyncClient::flush() {
+	net::IoVec vectors[MAX_SEND_BATCH];
+	while (m_connected && !m_sendQueue.empty()) {
+		size_t count = 0;
+		for (const buffers::Buffer& frame : m_sendQueue) {
+			if (count == MAX_SEND_BATCH) break;
+			net::setIoVec(vectors[count++], frame.data(), frame.size());
+		}
+		int result = net::sendVector(m_socket, vectors, count, true);
+		if (result == SOCKET_ERROR) {
+			if (!net::wouldBlock(WSAGetLastError())) fail();
+			return;
+		}
+
+		size_t bytes = static_cast<size_t>(result);
+		m_writtenTotal += bytes;
+		while (bytes > 0) {
+			buffers::Buffer& front = m_sendQueue.front();
+			if (bytes < front.size()) {
+				front.consume(bytes);
+				break;
+			}
+			bytes -= front.size();
+			m_sendQueue.pop_front();
+		}
+		while (!m_writers.empty() && m_writers.front()->m_target <= m_writtenTotal) {
+			m_writers.front()->m_result = true;
+			m_context.schedule(m_writers.front()->m_handle);
+			m_writers.pop_front();
+		}
+	}
+}
+
+short AsyncClient::pollEvents() const {
+	if (m_socket == INVALID_SOCKET) return 0;
+	if (m_connecting) return POLLOUT;
+	short events = 0;
+	if (!m_readers.empty()) events |= POLLIN;
+	if (!m_sendQueue.empty()) events |= POLLOUT;
+	return events;
+}
+
+void AsyncClient::onEvents(short revents) {
+	if (m_connecting) {
+		finishConnect();
+		return;
+	}
+	if (revents & POLLOUT) {
+		flush();
+	}
+	if (revents & (POLLIN | POLLERR | POLLHUP)) {
+		receive();
+	}
+}
+
+void AsyncClient::finishConnect() {
+	int error = 0;
+	socklen_t size = sizeof(error);
+	getsockopt(m_socket, SOL_SOCKET, SO_ERROR, (char*)&error, &size);
+	ConnectAwaiter* waiter = std::exchange(m_connecting, nullptr);
+	if (error != 0) {
+		closesocket(m_socket);
+		m_socket = INVALID_SOCKET;
+	}
+	else {
+		m_connected = true;
+		waiter->m_result = true;
+	}
+	m_context.schedule(waiter->m_handle);
+}
+
+/**
+ * @details    Reply    ; 
+ *   ,       readFrame()
+ */
+void AsyncClient::receive() {
+	if (!m_receiveBuffer) {
+		m_receiveBuffer = buffers::BufferPool::get(RECEIVE_BUFFER_SIZE);
+	}
+	int bytesReceived = recv(m_socket, m_receiveBuffer.data(), static_cast<int>(m_receiveBuffer.size()), 0);
+	if (bytesReceived > 0) {
+		protocol::DecodeStatus status = m_decoder.feed(m_receiveBuffer.data(), static_cast<size_t>(bytesReceived),
+			[this](const protocol::FrameView& frame) {
+				Reply reply;
+				reply.type = frame.type;
+				reply.payload.assign(frame.payload, frame.size);
+				if (m_readers.empty()) {
+					m_inbox.push_back(std::move(reply));
+					return true;
+				}
+				ReadAwaiter* reader = m_readers.front();
+				m_readers.pop_front();
+				reader->m_result = std::move(reply);
+				m_context.schedule(reader->m_handle);
+				return true;
+			});
+		if (status != protocol::DecodeStatus::Ok) fail();
+		return;
+	}
+	if (bytesReceived == 0 || !net::wouldBlock(WSAGetLastError())) {
+		fail();
+	}
+}
+
+/**
+ * @details ,   ,   readFrame()
+ */
+void AsyncClient::fail() {
+	if (m_socket != INVALID_SOCKET) {
+		closesocket(m_socket);
+		m_socket = INVALID_SOCKET;
+	}
+	m_connected = false;
+	m_sendQueue.clear();
+	if (m_connecting) {
+		m_context.schedule(std::exchange(m_connecting, nullptr)->m_handle);
+	}
+	for (WriteAwaiter* writer : m_writers) {
+		m_context.schedule(writer->m_handle);
+	}
+	m_writers.clear();
+	for (ReadAwaiter* reader : m_readers) {
+		m_context.schedule(reader->m_handle);
+	}
+	m_readers.clear();
+}
@@ -1,4 +1,48 @@
 #include "../include/client/client.hpp"
+#ifdef __linux__
+#include <sys/un.h>
+#endif
+
+/**
+ * @brief  ,    
+ * @details      disconnect() ( );
+ *     ,    
+ * disconnect()  
+ */
+static void joinThread(std::thread& thread) {
+	if (thread.joinable() && thread.get_id() != std::this_thread::get_id()) {
+		thread.join();
+	}
+}
+
+/**
+ * @brief   : IPv4, "unix:PATH"  "shm:PATH"
+ * @param[out] sharedMemory     
+ * @return false -       
+ */
+static bool resolveAddress(const std::string& server, uint16_t port, sockaddr_storage& address,
+	socklen_t& size, bool& sharedMemory) {
+	address = sockaddr_storage{};
+	sharedMemory = false;
+#ifdef __linux__
+	const bool local = server.rfind("unix:", 0) == 0;
+	sharedMemory = server.rfind("shm:", 0) == 0;
+	if (local || sharedMemory) {
+		const std::string path = server.substr(local ? 5 : 4);
+		sockaddr_un& unixAddress = reinterpret_cast<sockaddr_un&>(address);
+		if (path.empty() || path.size() >= sizeof(unixAddress.sun_path)) return false;
+		unixAddress.sun_family = AF_UNIX;
+		std::memcpy(unixAddress.sun_path, path.data(), path.size());
+		size = sizeof(sockaddr_un);
+		return true;
+	}
+#endif
+	sockaddr_in& inetAddress = reinterpret_cast<sockaddr_in&>(address);
+	inetAddress.sin_family = AF_INET;
+	inetAddress.sin_port = htons(port);
+	size = sizeof(sockaddr_in);
+	return inet_pton(AF_INET, server.c_str(), &inetAddress.sin_addr) == 1;
+}
 
 /**
  * @brief  Winsock   
@@ -7,116 +51,687 @@
  */
 Client::Client(const std::string& serverAddr, uint16_t port)
 	: m_serverAddr(serverAddr), m_port(port) {
-	WSADATA wsaData;
-	if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+	if (!net::startup()) {
 		std::cerr << "WSAStartup failed" << std::endl;
 	}
 }
 
 Client::~Client() {
 	disconnect();
+	net::shutdown();
 }
 
 /**
  * @brief    
- * @note   SO_RCVTIMEO/SO_SNDTIMEO (10 )
  * @return true   
  */
 bool Client::connectToServer() {
 	if (m_connected) return true;
+	//       (. tryReconnect)
+	if (m_receiving && m_autoReconnect) return tryReconnect();
+	m_closing = false;
+	return openConnection();
+}
+
+/**
+ * @details     :   
+ *    connectTimeout,  disconnect()   .
+ *     m_drainMutex  m_connectMutex,  
+ *      .   "shm:"   
+ *   
+ */
+bool Client::openConnection() {
+	sockaddr_storage serverAddr{};
+	socklen_t serverAddrSize = 0;
+	bool sharedMemory = false;
+	if (!resolveAddress(m_serverAddr, m_port, serverAddr, serverAddrSize, sharedMemory)) {
+		std::cerr << "Invalid server address: " << m_serverAddr << std::endl;
+		return false;
+	}
 	//  
-	m_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-	if (m_socket == INVALID_SOCKET) {
+	const bool tcp = serverAddr.ss_family == AF_INET;
+	SOCKET s = socket(serverAddr.ss_family, SOCK_STREAM, tcp ? IPPROTO_TCP : 0);
+	if (s == INVALID_SOCKET) {
 		std::cerr << "Socket creation failed: " << WSAGetLastError() << std::endl;
 		return false;
 	}
-	//  
-	setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeout, sizeof(timeout));
-	setsockopt(m_socket, SOL_SOCKET, SO_SNDTIMEO, (char*)&timeout, sizeof(timeout));
-	//  
-	sockaddr_in serverAddr{};
-	serverAddr.sin_family = AF_INET;
-	serverAddr.sin_port = htons(m_port);
-	inet_pton(AF_INET, m_serverAddr.c_str(), &serverAddr.sin_addr);
-	if (connect(m_socket, (sockaddr*)&serverAddr, sizeof(serverAddr)) == SOCKET_ERROR) {
-		std::cerr << "Connection Failed: " << WSAGetLastError() << std::endl;
-		closesocket(m_socket);
-		m_socket = INVALID_SOCKET;
+	const int connectTimeoutMs = static_cast<int>(m_reconnectPolicy.connectTimeout.count());
+	const int error = net::connectWithTimeout(s, (sockaddr*)&serverAddr, serverAddrSize, connectTimeoutMs, &m_closing);
+	if (error != 0) {
+		std::cerr << "Connection Failed: " << error << std::endl;
+		closesocket(s);
 		return false;
 	}
+#ifdef __linux__
+	std::shared_ptr<shm::Channel> channel;
+	if (sharedMemory) {
+		channel = shm::receiveChannel(s, connectTimeoutMs);
+		if (!channel) {
+			std::cerr << "Shared memory handshake failed" << std::endl;
+			closesocket(s);
+			return false;
+		}
+		//      receiveOnce():   
+		//   nativeHandle() 
+		channel->toClient().state().readerWaiting.store(1, std::memory_order_seq_cst);
+	}
+#endif
+	//  
+	net::setTimeout(s, SO_RCVTIMEO, timeout);
+	net::setTimeout(s, SO_SNDTIMEO, timeout);
+	{
+		std::lock_guard<std::mutex> drainLock(m_drainMutex);
+		std::lock_guard<std::mutex> lock(m_connectMutex);
+		if (m_closing) {
+			// disconnect()    :   
+			closesocket(s);
+			return false;
+		}
+		if (m_socket != INVALID_SOCKET) closesocket(m_socket);
+		m_socket = s;
+		m_pollHandle = s;
+#ifdef __linux__
+		m_shm = std::move(channel);
+		if (m_shm) m_pollHandle = m_shm->clientEvent();
+#endif
+	}
+	m_decoder.reset(); //      
+	{
+		std::lock_guard<std::mutex> lock(m_sendMutex);
+		m_sendFailed = false;
+		m_queuedTotal = m_writtenTotal = 0;
+		m_compressing = false; //    Hello  
+		if (replayEnabled()) {
+			replayFrames();
+		}
+		else if (m_compression.enabled) {
+			pushFrame(compression::makeHello(true, m_compression.dictionary));
+		}
+	}
 	m_connected = true;
 	return true;
 }
 
 /**
  * @brief      
- * @details   m_reconnectDelayMs  m_maxReconnectAttempts
+ * @details       
+ *  disconnect(). m_reconnectMutex    
+ * ,   ,  disconnect()   connectTimeout.
+ *    ,   : , 
+ *  ,    ;    
  */
 bool Client::tryReconnect() {
 	if (!m_autoReconnect) return false;
 
-	int attempts = 0;
-	while (attempts < m_maxReconnectAttempts && !m_connected) {
-		std::cerr << "Reconnecting (attempt " << attempts + 1 << ")...\n";
-		std::this_thread::sleep_for(std::chrono::milliseconds(m_reconnectDelayMs));
-		if (m_socket != INVALID_SOCKET) {
-			closesocket(m_socket);
-			m_socket = INVALID_SOCKET;
-		}
-		if (connectToServer()) {
-			std::cout << "Reconnected successfully!\n";
-			if (m_receiving) startReceiving();
-			return true;
+	std::unique_lock<std::mutex> lock(m_reconnectMutex);
+	const bool receiver = std::this_thread::get_id() == m_receiveThread.get_id();
+	if (!receiver && m_receiving) {
+		m_reconnectWake.wait(lock, [this] { return m_connected || m_closing || !m_receiving; });
+		return m_connected;
+	}
+	m_reconnectWake.wait(lock, [this] { return !m_reconnecting; });
+	m_reconnecting = true;
+	bool connected = false;
+	for (int attempt = 0; m_reconnectPolicy.maxAttempts == 0 || attempt < m_reconnectPolicy.maxAttempts; ++attempt) {
+		if (m_connected) break; //     
+		m_reconnectWake.wait_for(lock, backoffDelay(attempt), [this, receiver] {
+			return m_closing || (receiver && !m_receiving);
+			});
+		if (m_closing || (receiver && !m_receiving)) break;
+		std::cerr << "Reconnecting (attempt " << attempt + 1 << ")...\n";
+		lock.unlock();
+		connected = openConnection();
+		lock.lock();
+		if (connected) {
+			std::chrono::steady_clock::time_point lostAt;
+			{
+				std::lock_guard<std::mutex> connectLock(m_connectMutex);
+				lostAt = m_lostAt;
+			}
+			if (lostAt == std::chrono::steady_clock::time_point{}) {
+				std::cout << "Reconnected successfully!\n";
+				break;
+			}
+			const auto recovery = std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::steady_clock::now() - lostAt);
+			m_lastRecovery = recovery.count();
+			std::cout << "Reconnected successfully in " << recovery.count() << " ms\n";
+			break;
 		}
-		attempts++;
 	}
-	return false;
+	m_reconnecting = false;
+	m_reconnectWake.notify_all();
+	return m_connected;
+}
+
+std::chrono::milliseconds Client::backoffDelay(int attempt) {
+	const auto ceiling = std::min(m_reconnectPolicy.maxDelay,
+		m_reconnectPolicy.initialDelay * (int64_t(1) << std::min(attempt, 20)));
+	std::uniform_int_distribution<int64_t> delay(0, std::max<int64_t>(0, ceiling.count()));
+	return std::chrono::milliseconds(delay(m_random));
 }
 
 /**
  * @brief       
  */
 void Client::disconnect() {
-	if (!m_connected) return;
+	{
+		std::lock_guard<std::mutex> lock(m_reconnectMutex);
+		m_closing = true;
+		m_reconnectWake.notify_all();
+	}
 	stopReceiving();
-	closesocket(m_socket);
-	m_socket = INVALID_SOCKET;
-	m_connected = false;
+	stopSending();
+	dropConnection();
+	{
+		std::lock_guard<std::mutex> drainLock(m_drainMutex);
+		std::lock_guard<std::mutex> lock(m_connectMutex);
+		if (m_socket != INVALID_SOCKET) closesocket(m_socket);
+		m_socket = INVALID_SOCKET;
+		m_pollHandle = INVALID_SOCKET;
+#ifdef __linux__
+		m_shm.reset();
+#endif
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_sendMutex);
+		m_unacked.clear();
+		m_unackedBytes = 0;
+		m_droppedReplies = 0;
+		m_topics.clear();
+	}
+	//        
+	failRequests(RequestStatus::Disconnected);
+}
+
+/**
+ * @details   :     
+ *  (  ),      
+ */
+void Client::dropConnection() {
+	{
+		std::lock_guard<std::mutex> lock(m_connectMutex);
+		if (!m_connected) return;
+		m_connected = false;
+		::shutdown(m_socket, SD_BOTH);
+		m_lostAt = std::chrono::steady_clock::now();
+	}
+	{
+		std::lock_guard<std::mutex> drainLock(m_drainMutex);
+		failSendQueue();
+	}
+	if (!replayEnabled()) failRequests(RequestStatus::Disconnected);
+}
+
+size_t Client::unacknowledged() const {
+	std::lock_guard<std::mutex> lock(m_sendMutex);
+	return m_unacked.size();
+}
+
+void Client::rememberFrame(const buffers::Buffer& frame, protocol::MessageType type) {
+	m_unacked.push_back(Unacked{ frame, type });
+	m_unackedBytes += frame.size();
+	while (m_unackedBytes > m_reconnectPolicy.replayBytes && m_unacked.size() > 1) {
+		//           
+		if (m_unacked.front().type != protocol::MessageType::Publish) ++m_droppedReplies;
+		m_unackedBytes -= m_unacked.front().frame.size();
+		m_unacked.pop_front();
+	}
+}
+
+/**
+ * @details Publish  ,    , 
+ *   :     
+ */
+void Client::acknowledge() {
+	std::lock_guard<std::mutex> lock(m_sendMutex);
+	if (m_droppedReplies > 0) {
+		--m_droppedReplies;
+		return;
+	}
+	if (m_unacked.empty()) {
+		//  :   ,    
+		std::cerr << "Protocol error: reply without an unacknowledged frame\n";
+		return;
+	}
+	while (!m_unacked.empty()) {
+		const bool replied = m_unacked.front().type != protocol::MessageType::Publish;
+		m_unackedBytes -= m_unacked.front().frame.size();
+		m_unacked.pop_front();
+		if (replied) break;
+	}
+}
+
+/**
+ * @details   Hello,   ,   
+ *     ;  Hello, Subscribe  Unsubscribe 
+ *  -       m_topics.  
+ * :     ,    .
+ *      -      Hello
+ */
+void Client::replayFrames() {
+	m_droppedReplies = 0; //      
+	std::deque<Unacked> replay;
+	replay.swap(m_unacked);
+	m_unackedBytes = 0;
+	if (m_compression.enabled) {
+		buffers::Buffer hello = compression::makeHello(true, m_compression.dictionary);
+		m_unackedBytes += hello.size();
+		m_unacked.push_back(Unacked{ hello, protocol::MessageType::Hello });
+		pushFrame(std::move(hello));
+	}
+	for (const std::string& topic : m_topics) {
+		buffers::Buffer frame = protocol::makeFrame(protocol::MessageType::Subscribe, topic.data(), topic.size());
+		m_unackedBytes += frame.size();
+		m_unacked.push_back(Unacked{ frame, protocol::MessageType::Subscribe });
+		pushFrame(std::move(frame));
+	}
+	for (Unacked& entry : replay) {
+		if (entry.type == protocol::MessageType::Hello || entry.type == protocol::MessageType::Subscribe
+			|| entry.type == protocol::MessageType::Unsubscribe) {
+			continue;
+		}
+		m_unackedBytes += entry.frame.size();
+		pushFrame(entry.frame);
+		m_unacked.push_back(std::move(entry));
+	}
+	std::lock_guard<std::mutex> lock(m_requestsMutex);
+	for (const auto& entry : m_requests) {
+		if (entry.second.frame) pushFrame(entry.second.frame);
+	}
 }
 
 /**
  * @brief    
+ * @details    .     
+ *    (),   -  
+ *    ,     
  * @warning       ( true)
  */
 bool Client::sendMessage(const std::string& message) {
-	if (!m_connected) {
+	if (message.empty()) {
+		std::cerr << "Warning: Attempt to send empty message\n";
+		return true;
+	}
+	return sendFrame(encodeFrame(protocol::MessageType::Text, message.data(), message.size()),
+		protocol::MessageType::Text);
+}
+
+buffers::Buffer Client::encodeFrame(protocol::MessageType type, const char* data, size_t size,
+	bool correlated, uint64_t correlation) const {
+	if (m_compressing && size >= m_compression.threshold) {
+		buffers::Buffer frame = correlated
+			? compression::makeCorrelatedFrame(type, correlation, data, size, m_dictionary)
+			: compression::makeFrame(type, data, size, m_dictionary);
+		if (frame) return frame;
+	}
+	return correlated ? protocol::makeCorrelatedFrame(type, correlation, data, size) : protocol::makeFrame(type, data, size);
+}
+
+/**
+ * @details    :    ,
+ *   sendFrame
+ */
+uint64_t Client::request(const char* data, size_t size, ReplyCallback callback, std::chrono::milliseconds timeout) {
+	uint64_t id;
+	buffers::Buffer frame;
+	{
+		std::lock_guard<std::mutex> lock(m_requestsMutex);
+		id = m_nextRequestId++;
+		frame = encodeFrame(protocol::MessageType::Text, data, size, true, id);
+		auto deadline = m_deadlines.emplace(std::chrono::steady_clock::now() + timeout, id);
+		//       ,      
+		m_requests.emplace(id, PendingRequest{ std::move(callback), deadline, replayEnabled() ? frame : buffers::Buffer() });
+	}
+	if (sendFrame(std::move(frame), protocol::MessageType::Text, true)) {
+		return id;
+	}
+	Reply reply;
+	reply.status = RequestStatus::Disconnected;
+	completeRequest(id, std::move(reply));
+	return 0;
+}
+
+Client::Request Client::request(const std::string& message, std::chrono::milliseconds timeout) {
+	auto promise = std::make_shared<std::promise<Reply>>();
+	Request result;
+	result.reply = promise->get_future();
+	result.id = request(message.data(), message.size(), [promise](Reply&& reply) {
+		promise->set_value(std::move(reply));
+		}, timeout);
+	return result;
+}
+
+bool Client::cancel(uint64_t id) {
+	Reply reply;
+	reply.status = RequestStatus::Cancelled;
+	return completeRequest(id, std::move(reply));
+}
+
+size_t Client::outstandingRequests() const {
+	std::lock_guard<std::mutex> lock(m_requestsMutex);
+	return m_requests.size();
+}
+
+int Client::expireRequests() {
+	const auto now = std::chrono::steady_clock::now();
+	std::vector<uint64_t> expired;
+	{
+		std::lock_guard<std::mutex> lock(m_requestsMutex);
+		for (auto it = m_deadlines.begin(); it != m_deadlines.end() && it->first <= now; ++it) {
+			expired.push_back(it->second);
+		}
+	}
+	for (uint64_t id : expired) {
+		Reply reply;
+		reply.status = RequestStatus::Timeout;
+		completeRequest(id, std::move(reply));
+	}
+	std::lock_guard<std::mutex> lock(m_requestsMutex);
+	if (m_deadlines.empty()) return -1;
+	const auto wait = std::chrono::ceil<std::chrono::milliseconds>(m_deadlines.begin()->first - now);
+	return static_cast<int>(std::max<std::chrono::milliseconds::rep>(0, wait.count()));
+}
+
+/**
+ * @details    :    
+ *  
+ */
+bool Client::completeRequest(uint64_t id, Reply&& reply) {
+	ReplyCallback callback;
+	{
+		std::lock_guard<std::mutex> lock(m_requestsMutex);
+		auto it = m_requests.find(id);
+		if (it == m_requests.end()) return false;
+		callback = std::move(it->second.callback);
+		m_deadlines.erase(it->second.deadline);
+		m_requests.erase(it);
+	}
+	if (callback) callback(std::move(reply));
+	return true;
+}
+
+void Client::failRequests(RequestStatus status) {
+	std::unordered_map<uint64_t, PendingRequest> pending;
+	{
+		std::lock_guard<std::mutex> lock(m_requestsMutex);
+		pending.swap(m_requests);
+		m_deadlines.clear();
+	}
+	for (auto& entry : pending) {
+		Reply reply;
+		reply.status = status;
+		if (entry.second.callback) entry.second.callback(std::move(reply));
+	}
+}
+
+bool Client::subscribe(const std::string& topic) {
+	{
+		std::lock_guard<std::mutex> lock(m_sendMutex);
+		m_topics.insert(topic);
+	}
+	return sendFrame(protocol::makeFrame(protocol::MessageType::Subscribe, topic.data(), topic.size()),
+		protocol::MessageType::Subscribe);
+}
+
+bool Client::unsubscribe(const std::string& topic) {
+	{
+		std::lock_guard<std::mutex> lock(m_sendMutex);
+		m_topics.erase(topic);
+	}
+	return sendFrame(protocol::makeFrame(protocol::MessageType::Unsubscribe, topic.data(), topic.size()),
+		protocol::MessageType::Unsubscribe);
+}
+
+/**
+ * @details : , TOPIC_SEPARATOR   (": ",   )
+ */
+bool Client::publish(const std::string& topic, const std::string& message) {
+	std::string payload;
+	payload.reserve(topic.size() + 1 + m_username.size() + 2 + message.size());
+	payload += topic;
+	payload += protocol::TOPIC_SEPARATOR;
+	if (!m_username.empty()) {
+		payload += m_username;
+		payload += ": ";
+	}
+	payload += message;
+	return sendFrame(encodeFrame(protocol::MessageType::Publish, payload.data(), payload.size()),
+		protocol::MessageType::Publish);
+}
+
+/**
+ * @details     ,  
+ * :   .    
+ *  
+ */
+bool Client::sendFrame(buffers::Buffer frame, protocol::MessageType type, bool correlated) {
+	const bool replay = replayEnabled();
+	if (!m_connected && !(replay && m_receiving)) {
 		if (!tryReconnect()) {
 			std::cerr << "Cannot send - not connected to server\n";
 			return false;
 		}
 	}
-	if (message.empty()) {
-		std::cerr << "Warning: Attempt to send empty message\n";
+	bool queued;
+	{
+		std::unique_lock<std::mutex> lock(m_sendMutex);
+		if (m_sending) {
+			//  : ,     
+			m_sendSpace.wait(lock, [&] {
+				return m_sendFailed || m_sendHighWaterMark == 0 || m_queuedBytes == 0
+					|| m_queuedBytes + frame.size() <= m_sendHighWaterMark;
+			});
+		}
+		if (replay && !correlated) rememberFrame(frame, type);
+		queued = !m_sendFailed;
+		if (queued) {
+			pushFrame(std::move(frame));
+		}
+		else if (replay && m_receiving) {
+			return true;
+		}
+	}
+	if (queued && (m_sending || drainSendQueue(true))) {
 		return true;
 	}
-	int result = send(m_socket, message.c_str(), static_cast<int>(message.size()), 0);
-	if (result == SOCKET_ERROR) {
-		std::cerr << "Send failed: " << WSAGetLastError() << "\n";
-		disconnect();
+	dropConnection();
+	//    :   
+	if (replay) return m_receiving || tryReconnect();
+	return false;
+}
+
+bool Client::queueMessage(const char* data, size_t size) {
+	if (!m_connected || size == 0) return false;
+	return queueEncoded(encodeFrame(protocol::MessageType::Text, data, size), protocol::MessageType::Text);
+}
+
+bool Client::queueFrame(protocol::MessageType type, uint8_t flags, const char* data, size_t size) {
+	if (!m_connected) return false;
+	return queueEncoded(protocol::makeFrame(type, data, size, flags), type);
+}
+
+bool Client::queueEncoded(buffers::Buffer frame, protocol::MessageType type) {
+	std::lock_guard<std::mutex> lock(m_sendMutex);
+	if (m_sendFailed) return false;
+	if (m_sendHighWaterMark != 0 && m_queuedBytes != 0 && m_queuedBytes + frame.size() > m_sendHighWaterMark) {
 		return false;
 	}
-	if (result != static_cast<int>(message.size())) {
-		std::cerr << "Warning: Partial message sent (" << result << "/" << message.size() << " bytes)\n";
-	}
+	if (replayEnabled()) rememberFrame(frame, type);
+	pushFrame(std::move(frame));
 	return true;
 }
 
+void Client::pushFrame(buffers::Buffer frame) {
+	m_queuedBytes += frame.size();
+	m_queuedTotal += frame.size();
+	m_sendQueue.push_back(std::move(frame));
+	if (m_sending) m_sendReady.notify_one();
+}
+
+bool Client::writeQueued() {
+	return drainSendQueue(false);
+}
+
+std::future<bool> Client::flush() {
+	std::promise<bool> promise;
+	std::future<bool> result = promise.get_future();
+	{
+		std::lock_guard<std::mutex> lock(m_sendMutex);
+		if (m_sendFailed || m_writtenTotal >= m_queuedTotal) {
+			promise.set_value(!m_sendFailed);
+			return result;
+		}
+		m_flushWaiters.emplace_back(m_queuedTotal, std::move(promise));
+	}
+	if (!m_sending) {
+		drainSendQueue(true);
+	}
+	return result;
+}
+
+size_t Client::queuedBytes() const {
+	std::lock_guard<std::mutex> lock(m_sendMutex);
+	return m_queuedBytes;
+}
+
+void Client::setSendHighWaterMark(size_t bytes) {
+	std::lock_guard<std::mutex> lock(m_sendMutex);
+	m_sendHighWaterMark = bytes;
+	m_sendSpace.notify_all();
+}
+
+/**
+ * @details      ,   
+ *   :      , 
+ *      (m_drainMutex)
+ */
+bool Client::drainSendQueue(bool wait) {
+	std::lock_guard<std::mutex> drainLock(m_drainMutex);
+	net::IoVec vectors[MAX_SEND_BATCH];
+	while (true) {
+		size_t count = 0;
+		{
+			std::lock_guard<std::mutex> lock(m_sendMutex);
+			if (m_sendFailed) return false;
+			for (const buffers::Buffer& frame : m_sendQueue) {
+				if (count == MAX_SEND_BATCH) break;
+				net::setIoVec(vectors[count++], frame.data(), frame.size());
+			}
+		}
+		if (count == 0) return true;
+
+#ifdef __linux__
+		if (m_shm) {
+			const size_t written = writeRing(*m_shm, vectors, count, wait);
+			if (written == SIZE_MAX) {
+				std::cerr << "Send failed: shared memory channel closed\n";
+				failSendQueue();
+				return false;
+			}
+			if (written == 0) return true;
+			completeSend(written);
+			continue;
+		}
+#endif
+		int result = net::sendVector(m_socket, vectors, count, !wait);
+		if (result == SOCKET_ERROR) {
+			const int error = WSAGetLastError();
+			if (!wait && net::wouldBlock(error)) return true;
+			std::cerr << "Send failed: " << error << "\n";
+			failSendQueue();
+			return false;
+		}
+		completeSend(static_cast<size_t>(result));
+	}
+}
+
+void Client::completeSend(size_t bytes) {
+	std::lock_guard<std::mutex> lock(m_sendMutex);
+	m_queuedBytes -= bytes;
+	m_writtenTotal += bytes;
+	while (bytes > 0) {
+		buffers::Buffer& front = m_sendQueue.front();
+		if (bytes < front.size()) {
+			front.consume(bytes); //  :    
+			break;
+		}
+		bytes -= front.size();
+		m_sendQueue.pop_front();
+	}
+	for (auto it = m_flushWaiters.begin(); it != m_flushWaiters.end();) {
+		if (it->first <= m_writtenTotal) {
+			it->second.set_value(true);
+			it = m_flushWaiters.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+	m_sendSpace.notify_all();
+}
+
+void Client::failSendQueue() {
+	std::lock_guard<std::mutex> lock(m_sendMutex);
+	m_sendFailed = true;
+	m_sendQueue.clear();
+	m_queuedBytes = 0;
+	for (auto& waiter : m_flushWaiters) {
+		waiter.second.set_value(false);
+	}
+	m_flushWaiters.clear();
+	m_sendSpace.notify_all();
+}
+
+/**
+ * @brief  ,    
+ */
+void Client::startSending() {
+	if (!m_connected || m_sending) return;
+
+	m_sending = true;
+	m_sendThread = std::thread(&Client::sendLoop, this);
+}
+
+/**
+ * @brief      
+ */
+void Client::stopSending() {
+	{
+		std::lock_guard<std::mutex> lock(m_sendMutex);
+		if (!m_sending) return;
+		m_sending = false;
+		m_sendReady.notify_one();
+	}
+	joinThread(m_sendThread);
+	std::lock_guard<std::mutex> lock(m_sendMutex);
+	m_sendSpace.notify_all();
+}
+
+/**
+ * @brief   
+ * @details       , 
+ * ,    ,   . 
+ *  :     
+ */
+void Client::sendLoop() {
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(m_sendMutex);
+			m_sendReady.wait(lock, [this] { return !m_sending || (!m_sendQueue.empty() && !m_sendFailed); });
+			if (!m_sending && (m_sendQueue.empty() || m_sendFailed)) return;
+		}
+		if (!drainSendQueue(true)) dropConnection();
+	}
+}
+
 /**
  * @brief       
  */
 void Client::startReceiving() {
 	if (!m_connected || m_receiving) return;
 
+	joinThread(m_receiveThread); //      
 	m_receiving = true;
 	m_receiveThread = std::thread(&Client::receiveMessages, this);
 }
@@ -125,12 +740,12 @@ void Client::startReceiving() {
  * @brief     
  */
 void Client::stopReceiving() {
-	if (!m_receiving) return;
-
-	m_receiving = false;
-	if (m_receiveThread.joinable()) {
-		m_receiveThread.join();
+	{
+		std::lock_guard<std::mutex> lock(m_reconnectMutex);
+		m_receiving = false;
+		m_reconnectWake.notify_all();
 	}
+	joinThread(m_receiveThread);
 }
 /**
  * @brief    
@@ -140,32 +755,263 @@ void Client::stopReceiving() {
  * -  
  */
 void Client::receiveMessages() {
-	constexpr size_t BUFFER_SIZE = 4096;
-	std::vector<char> buffer(BUFFER_SIZE);
 	while (m_receiving) {
 		if (!m_connected) {
-			if (!tryReconnect()) break; //    
+			if (tryReconnect()) continue;
+			//    :   
+			if (m_autoReconnect && !m_closing) std::cerr << "Reconnect failed, giving up\n";
+			{
+				std::lock_guard<std::mutex> lock(m_sendMutex);
+				m_unacked.clear();
+				m_unackedBytes = 0;
+			}
+			failRequests(RequestStatus::Disconnected);
+			{
+				// ,     (tryReconnect),  
+				std::lock_guard<std::mutex> lock(m_reconnectMutex);
+				m_receiving = false;
+				m_reconnectWake.notify_all();
+			}
+			break;
+		}
+		//        
+		const int untilDeadline = expireRequests();
+#ifdef __linux__
+		if (std::shared_ptr<shm::Channel> channel = sharedChannel()) {
+			receiveShared(*channel, untilDeadline < 0 ? RECEIVE_POLL_MS : std::min(untilDeadline, RECEIVE_POLL_MS));
 			continue;
 		}
-		int bytesReceived = recv(m_socket, buffer.data(), buffer.size() - 1, 0);
+#endif
+		pollfd fd{};
+		fd.fd = m_socket;
+		fd.events = POLLIN;
+		const int waitMs = untilDeadline < 0 ? RECEIVE_POLL_MS : std::min(untilDeadline, RECEIVE_POLL_MS);
+		if (net::poll(&fd, 1, waitMs) <= 0) continue;
+		receiveOnce(); //      
+	}
+}
+
+/**
+ * @brief         
+ * @details  recv   
+ */
+bool Client::receiveOnce() {
+#ifdef __linux__
+	if (std::shared_ptr<shm::Channel> channel = sharedChannel()) {
+		shm::drainEvent(channel->clientEvent());
+		//    :   
+		//  nativeHandle() 
+		bool received = false;
+		do {
+			if (!receiveRing(*channel, received)) return false;
+		} while (!shm::prepareRead(channel->toClient()));
+		return true;
+	}
+#endif
+	constexpr size_t BUFFER_SIZE = 4096;
+	if (!m_receiveBuffer) {
+		m_receiveBuffer = buffers::BufferPool::get(BUFFER_SIZE);
+	}
+	int bytesReceived = recv(m_socket, m_receiveBuffer.data(), static_cast<int>(m_receiveBuffer.size()), 0);
 
-		//   recv
-		if (bytesReceived > 0) {
-			const size_t safe_size = bytesReceived < buffer.size() ? bytesReceived : buffer.size() - 1;
-			buffer[safe_size] = '\0';
-			std::cout << "Received: " << buffer.data() << "\n";
+	//   recv
+	if (bytesReceived > 0) {
+		//  recv       
+		protocol::DecodeStatus status = m_decoder.feed(m_receiveBuffer.data(), static_cast<size_t>(bytesReceived),
+			[this](const protocol::FrameView& frame) {
+				dispatch(frame);
+				return true;
+			});
+		if (status != protocol::DecodeStatus::Ok) {
+			std::cerr << "Protocol error: invalid frame from server\n";
+			dropConnection();
+			return false;
 		}
-		else if (bytesReceived == 0) {
-			std::cout << "Server disconnected\n";
-			disconnect();
-			break;
+		return true;
+	}
+	//    :      ,
+	//    ( )
+	if (bytesReceived == 0) {
+		std::cout << "Server disconnected\n";
+		dropConnection();
+		return false;
+	}
+	if (WSAGetLastError() != WSAETIMEDOUT) {
+		std::cerr << "Receive error: " << WSAGetLastError() << "\n";
+		dropConnection();
+		return false;
+	}
+	return true;
+}
+
+#ifdef __linux__
+std::shared_ptr<shm::Channel> Client::sharedChannel() {
+	std::lock_guard<std::mutex> lock(m_connectMutex);
+	return m_shm;
+}
+
+/**
+ * @details     :   
+ *    .     , 
+ * ,   ,   
+ */
+bool Client::receiveRing(shm::Channel& channel, bool& received) {
+	shm::Ring& ring = channel.toClient();
+	const bool closed = channel.layout().serverClosed.load(std::memory_order_acquire) != 0;
+	bool consumed = false;
+	while (true) {
+		size_t size = 0;
+		const char* data = ring.peek(size);
+		if (size == SIZE_MAX) {
+			std::cerr << "Protocol error: corrupt shared memory ring\n";
+			dropConnection();
+			return false;
 		}
-		else {
-			if (WSAGetLastError() != WSAETIMEDOUT) {
-				std::cerr << "Receive error: " << WSAGetLastError() << "\n";
-				disconnect();
-				break;
-			}
+		if (!data) break;
+		protocol::DecodeStatus status = m_decoder.feed(data, size,
+			[this](const protocol::FrameView& frame) {
+				dispatch(frame);
+				return true;
+			});
+		ring.consume(size);
+		consumed = true;
+		if (status != protocol::DecodeStatus::Ok) {
+			std::cerr << "Protocol error: invalid frame from server\n";
+			dropConnection();
+			return false;
 		}
 	}
-}
\ No newline at end of file
+	if (consumed) {
+		received = true;
+		if (shm::takeWriterWaiting(ring)) shm::notify(channel.serverEvent());
+	}
+	if (closed) {
+		std::cout << "Server disconnected\n";
+		dropConnection();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @details     eventfd:   
+ * ,    ,    
+ */
+void Client::receiveShared(shm::Channel& channel, int waitMs) {
+	using Clock = std::chrono::steady_clock;
+	const auto spin = shm::spinTime();
+	const Clock::time_point started = Clock::now();
+	Clock::time_point lastData = started;
+	while (m_receiving && m_connected) {
+		bool received = false;
+		if (!receiveRing(channel, received)) return;
+		const Clock::time_point now = Clock::now();
+		if (received) lastData = now;
+		else if (now - lastData >= spin) break;
+		if (now - started >= std::chrono::milliseconds(waitMs)) return;
+		shm::cpuRelax();
+	}
+	if (!m_receiving || !m_connected || !shm::prepareRead(channel.toClient())) return;
+
+	pollfd fds[2]{};
+	fds[0].fd = channel.clientEvent();
+	fds[0].events = POLLIN;
+	fds[1].fd = m_socket;
+	fds[1].events = POLLIN;
+	const int ready = net::poll(fds, 2, waitMs);
+	channel.toClient().state().readerWaiting.store(0, std::memory_order_relaxed);
+	shm::drainEvent(channel.clientEvent());
+	if (ready > 0 && fds[1].revents != 0) {
+		bool received = false;
+		if (!receiveRing(channel, received)) return;
+		std::cout << "Server disconnected\n";
+		dropConnection();
+	}
+}
+
+/**
+ * @details       (takeReaderWaiting); 
+ *   futex,    ,   
+ */
+size_t Client::writeRing(shm::Channel& channel, const net::IoVec* vectors, size_t count, bool wait) {
+	shm::Ring& ring = channel.toServer();
+	while (true) {
+		size_t written = 0;
+		for (size_t i = 0; i < count; ++i) {
+			const size_t part = ring.write(static_cast<const char*>(vectors[i].iov_base), vectors[i].iov_len);
+			if (part == SIZE_MAX) return SIZE_MAX;
+			written += part;
+			if (part < vectors[i].iov_len) break;
+		}
+		if (written > 0) {
+			if (shm::takeReaderWaiting(ring)) shm::notify(channel.serverEvent());
+			return written;
+		}
+		if (!wait) return 0;
+		if (!m_connected || channel.layout().serverClosed.load(std::memory_order_acquire)) return SIZE_MAX;
+		const uint32_t seq = ring.state().spaceSeq.load(std::memory_order_acquire);
+		if (shm::prepareWrite(ring)) shm::waitSpace(ring.state(), seq, RECEIVE_POLL_MS);
+	}
+}
+#endif
+
+/**
+ * @details        
+ * .    , ,   , 
+ *     
+ */
+void Client::dispatch(const protocol::FrameView& received) {
+	protocol::FrameView frame = received;
+	const bool correlated = (frame.flags & protocol::FLAG_CORRELATED) != 0;
+	uint64_t id = 0;
+	if (correlated && !protocol::takeCorrelation(frame, id)) return;
+	buffers::Buffer inflated;
+	const bool intact = !(frame.flags & protocol::FLAG_COMPRESSED) || compression::inflate(frame, inflated);
+	if (!intact) std::cerr << "Protocol error: invalid compressed frame from server\n";
+	if (correlated) {
+		//   request():   (   ) 
+		if (!intact) return;
+		Reply reply;
+		reply.type = frame.type;
+		reply.payload.assign(frame.payload, frame.size);
+		completeRequest(id, std::move(reply));
+		return;
+	}
+	//    ,   -   
+	if (frame.type != protocol::MessageType::Publish && replayEnabled()) acknowledge();
+	if (!intact) return;
+	if (frame.type == protocol::MessageType::Hello) {
+		bool accepted = false;
+		compression::Dictionary dictionary = compression::Dictionary::None;
+		if (compression::parseHello(frame, accepted, dictionary)) {
+			m_dictionary = dictionary;
+			m_compressing = accepted;
+		}
+		return;
+	}
+	if (m_messageCallback) {
+		m_messageCallback(frame);
+		return;
+	}
+	//      ,  
+	const std::string_view payload(frame.payload, frame.size);
+	switch (frame.type) {
+	case protocol::MessageType::Publish: {
+		const size_t separator = payload.find(protocol::TOPIC_SEPARATOR);
+		if (separator == std::string_view::npos) break;
+		std::cout << "[" << payload.substr(0, separator) << "] " << payload.substr(separator + 1) << "\n";
+		return;
+	}
+	case protocol::MessageType::Subscribe:
+		std::cout << "Joined " << payload << "\n";
+		return;
+	case protocol::MessageType::Unsubscribe:
+		std::cout << "Left " << payload << "\n";
+		return;
+	default:
+		break;
+	}
+	std::ostream& out = frame.type == protocol::MessageType::Error ? std::cerr : std::cout;
+	out << (frame.type == protocol::MessageType::Error ? "Server error: " : "Received: ");
+	out.write(frame.payload, static_cast<std::streamsize>(frame.size)) << "\n";
+}
@@ -1,19 +1,32 @@
 #include "../include/client/client.hpp"
+#include <string_view>
 
-int main() {
+/**
+ * @param argv[1]  : IP (  127.0.0.1), "unix:PATH"  "shm:PATH"
+ */
+int main(int argc, char* argv[]) {
+#ifdef _WIN32
     setlocale(LC_ALL, "Russian");
     SetConsoleCP(1251);
     SetConsoleOutputCP(1251);
+#endif
 
-    Client client("127.0.0.1", 8080);
+    Client client(argc > 1 ? argv[1] : "127.0.0.1", 8080);
+    client.setAutoReconnect(true); //    :    
+    compression::Options compressionOptions;
+    compressionOptions.enabled = true; //   --compression ,     
+    client.setCompression(compressionOptions);
 
     if (!client.connectToServer()) {
         std::cerr << "Failed to connect to server\n";
         return 1;
     }
 
-    std::cout << "Connected to server. Type messages to send (type 'exit' to quit):\n";
+    std::cout << "Connected to server. Type messages to send (type 'exit' to quit):\n"
+        << "  /join TOPIC, /leave TOPIC - subscribe to or leave a topic\n"
+        << "  /say TOPIC TEXT - publish to a topic, /name NAME - sign your publications\n";
     client.startReceiving();
+    client.startSending(); //      
 
     std::string message;
     while (true) {
@@ -23,12 +36,37 @@ int main() {
             break;
         }
 
-        if (!client.sendMessage(message + "\n")) {
+        //  : "/  []"
+        bool sent;
+        const std::string_view line(message);
+        const size_t space = line.find(' ');
+        const std::string_view command = line.substr(0, space);
+        const std::string argument(space == std::string_view::npos ? std::string_view() : line.substr(space + 1));
+        if (command == "/join") {
+            sent = client.subscribe(argument);
+        }
+        else if (command == "/leave") {
+            sent = client.unsubscribe(argument);
+        }
+        else if (command == "/say") {
+            const size_t textStart = argument.find(' ');
+            sent = client.publish(argument.substr(0, textStart),
+                textStart == std::string::npos ? std::string() : argument.substr(textStart + 1));
+        }
+        else if (command == "/name") {
+            client.setUsername(argument);
+            sent = true;
+        }
+        else {
+            sent = client.sendMessage(message);
+        }
+        if (!sent) {
             std::cerr << "Message send failed\n";
             break;
         }
     }
 
+    client.flush().wait(); //    
     client.disconnect();
     return 0;
 }
@@ -0,0 +1,82 @@
+#include "../include/client/client_pool.hpp"
+
+ClientPool::ClientPool(const std::string& serverAddr, uint16_t port, size_t connections) {
+	if (connections == 0) connections = 1;
+	for (size_t i = 0; i < connections; ++i) {
+		m_clients.push_back(std::make_unique<Client>(serverAddr, port));
+	}
+}
+
+ClientPool::~ClientPool() {
+	disconnect();
+}
+
+size_t ClientPool::connect() {
+	size_t connected = 0;
+	for (auto& client : m_clients) {
+		if (!client->connectToServer()) continue;
+		client->startReceiving();
+		client->startSending();
+		++connected;
+	}
+	return connected;
+}
+
+void ClientPool::disconnect() {
+	for (auto& client : m_clients) {
+		client->disconnect();
+	}
+}
+
+Client* ClientPool::request(const char* data, size_t size, Client::ReplyCallback callback, std::chrono::milliseconds timeout) {
+	Client* client = pick();
+	if (!client) {
+		Client::Reply reply;
+		reply.status = Client::RequestStatus::Disconnected;
+		if (callback) callback(std::move(reply));
+		return nullptr;
+	}
+	return client->request(data, size, std::move(callback), timeout) != 0 ? client : nullptr;
+}
+
+Client::Request ClientPool::request(const std::string& message, std::chrono::milliseconds timeout) {
+	Client* client = pick();
+	if (client) return client->request(message, timeout);
+
+	std::promise<Client::Reply> promise;
+	Client::Request result;
+	result.reply = promise.get_future();
+	Client::Reply reply;
+	reply.status = Client::RequestStatus::Disconnected;
+	promise.set_value(std::move(reply));
+	return result;
+}
+
+size_t ClientPool::outstandingRequests() const {
+	size_t total = 0;
+	for (const auto& client : m_clients) {
+		total += client->outstandingRequests();
+	}
+	return total;
+}
+
+/**
+ * @details     :  ,
+ *    
+ */
+Client* ClientPool::pick() {
+	const size_t start = m_next.fetch_add(1, std::memory_order_relaxed);
+	Client* best = nullptr;
+	size_t bestLoad = 0;
+	for (size_t i = 0; i < m_clients.size(); ++i) {
+		Client& candidate = *m_clients[(start + i) % m_clients.size()];
+		if (!candidate.isConnected()) continue;
+		const size_t load = candidate.outstandingRequests();
+		if (!best || load < bestLoad) {
+			best = &candidate;
+			bestLoad = load;
+			if (load == 0) break;
+		}
+	}
+	return best;
+}
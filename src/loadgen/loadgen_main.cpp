@@ -0,0 +1,717 @@
+#include "../include/client/client.hpp"
+#include "../include/client/async_client.hpp"
+#include "../include/client/client_pool.hpp"
+#include "../include/loadgen/latency_histogram.hpp"
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief  .
+     */
+    enum class LoadMode {
+        Open, //      
+        Closed, //      depth   
+        FanOut //     ,        rate
+    };
+
+    constexpr char FANOUT_TOPIC[] = "loadgen";
+
+    /**
+     * @struct LoadOptions
+     * @brief  .
+     */
+    struct LoadOptions {
+        std::string host = "127.0.0.1";
+        uint16_t port = 8080;
+        unsigned connections = 100;
+        unsigned threads = 1;
+        double duration = 10; //  
+        double warmup = 1; //   (  )
+        LoadMode mode = LoadMode::Closed;
+        double rate = 10000; //       ( ,   fanout)
+        unsigned depth = 1; //      ( )
+        size_t minSize = 64; //  , 
+        size_t maxSize = 64;
+        std::string csvPath; //     CSV
+        std::string jsonPath; //    JSON
+        bool coroutines = false; //     AsyncClient
+        bool pool = false; //       ClientPool
+    };
+
+    /**
+     * @struct WorkerResult
+     * @brief   ;    .
+     */
+    struct WorkerResult {
+        LatencyHistogram latency; //    ( )     
+        unsigned connected = 0; //  
+        uint64_t sent = 0; //    
+        uint64_t received = 0; //     
+        uint64_t bytes = 0; //     
+        uint64_t errors = 0; //  ,    
+    };
+
+    /**
+     * @struct LoadConnection
+     * @brief        .
+     * @details       , 
+     *      
+     */
+    struct LoadConnection {
+        std::unique_ptr<Client> client;
+        std::deque<Clock::time_point> inFlight;
+        unsigned replies = 0; //   receiveOnce (    )
+        bool alive = true;
+        bool dirty = false; //     ,    writeQueued()
+    };
+
+    /**
+     * @brief     
+     * @details   ,    
+     *    
+     */
+    std::vector<std::string> makePayloads(const LoadOptions& options, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<size_t> sizes(options.minSize, options.maxSize);
+        std::vector<std::string> payloads(options.minSize == options.maxSize ? 1 : 256);
+        for (std::string& payload : payloads) {
+            payload.resize(sizes(rng));
+            for (size_t i = 0; i < payload.size(); ++i) {
+                payload[i] = static_cast<char>('a' + (i + seed) % 26);
+            }
+        }
+        return payloads;
+    }
+
+    /**
+     * @struct MeasureWindow
+     * @brief   ; ,    .
+     */
+    struct MeasureWindow {
+        Clock::time_point start;
+        Clock::time_point end;
+    };
+
+    /**
+     * @brief  :  ,  poll  
+     * @param connected  ,  
+     * @param window   (  )
+     */
+    void runWorker(const LoadOptions& options, unsigned index, unsigned connectionCount,
+        std::atomic<unsigned>& connected, std::shared_future<MeasureWindow> window, WorkerResult& result) {
+        const std::vector<std::string> payloads = makePayloads(options, index + 1);
+        size_t nextPayload = 0;
+
+        Clock::time_point measureStart;
+        Clock::time_point measureEnd;
+        std::vector<LoadConnection> connections(connectionCount);
+        std::vector<pollfd> fds(connectionCount);
+        for (unsigned i = 0; i < connectionCount; ++i) {
+            LoadConnection& connection = connections[i];
+            connection.client = std::make_unique<Client>(options.host, options.port);
+            //      :  
+            //       
+            if (options.mode == LoadMode::Open) connection.client->setSendHighWaterMark(0);
+            connection.alive = connection.client->connectToServer();
+            if (connection.alive) ++result.connected;
+            fds[i].fd = connection.alive ? connection.client->nativeHandle() : INVALID_SOCKET;
+            fds[i].events = POLLIN;
+
+            connection.client->setMessageCallback([&connection, &result, &measureStart, &measureEnd](const protocol::FrameView& frame) {
+                const Clock::time_point now = Clock::now();
+                if (frame.type != protocol::MessageType::Text || connection.inFlight.empty()) {
+                    ++result.errors;
+                    return;
+                }
+                const Clock::time_point sentAt = connection.inFlight.front();
+                connection.inFlight.pop_front();
+                ++connection.replies;
+                if (now >= measureStart && now < measureEnd) {
+                    result.latency.record(static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(now - sentAt).count()));
+                    ++result.received;
+                    result.bytes += frame.size;
+                }
+            });
+        }
+
+        connected.fetch_add(1);
+        measureStart = window.get().start;
+        measureEnd = window.get().end;
+
+        auto fail = [&](unsigned i) {
+            connections[i].alive = false;
+            fds[i].fd = INVALID_SOCKET;
+            ++result.errors;
+        };
+
+        //         sendmsg 
+        //    
+        std::vector<unsigned> dirty;
+        auto send = [&](unsigned i, Clock::time_point stamp) {
+            LoadConnection& connection = connections[i];
+            if (!connection.alive) return;
+            const std::string& payload = payloads[nextPayload];
+            if (!connection.client->queueMessage(payload.data(), payload.size())) {
+                fail(i);
+                return;
+            }
+            connection.inFlight.push_back(stamp);
+            nextPayload = (nextPayload + 1) % payloads.size();
+            if (stamp >= measureStart) ++result.sent;
+            if (!connection.dirty) {
+                connection.dirty = true;
+                dirty.push_back(i);
+            }
+        };
+
+        // ,   ,   POLLOUT
+        auto write = [&](unsigned i) {
+            LoadConnection& connection = connections[i];
+            connection.dirty = false;
+            if (!connection.alive) return;
+            if (!connection.client->writeQueued()) {
+                fail(i);
+                return;
+            }
+            fds[i].events = connection.client->queuedBytes() > 0 ? POLLIN | POLLOUT : POLLIN;
+        };
+        auto writeDirty = [&]() {
+            for (unsigned i : dirty) write(i);
+            dirty.clear();
+        };
+
+        //  :   ,   
+        const double threadRate = options.rate * connectionCount / std::max(1u, options.connections);
+        const auto interval = std::chrono::nanoseconds(
+            static_cast<int64_t>(threadRate > 0 ? 1e9 / threadRate : 1e18));
+        Clock::time_point nextSend = Clock::now();
+        unsigned nextConnection = 0;
+
+        if (options.mode == LoadMode::Closed) {
+            const Clock::time_point now = Clock::now();
+            for (unsigned i = 0; i < connectionCount; ++i) {
+                for (unsigned d = 0; d < options.depth; ++d) send(i, now);
+            }
+            writeDirty();
+        }
+
+        while (Clock::now() < measureEnd) {
+            int timeoutMs = 10;
+            if (options.mode == LoadMode::Open && connectionCount > 0) {
+                //     : 
+                //  ,    
+                // ( coordinated omission)
+                Clock::time_point now = Clock::now();
+                while (nextSend <= now) {
+                    send(nextConnection, nextSend);
+                    nextConnection = (nextConnection + 1) % connectionCount;
+                    nextSend += interval;
+                }
+                writeDirty();
+                timeoutMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(nextSend - now).count());
+            }
+
+            int ready = net::poll(fds.data(), fds.size(), std::min(timeoutMs, 10));
+            if (ready <= 0) continue;
+            for (unsigned i = 0; i < connectionCount && ready > 0; ++i) {
+                if (fds[i].fd == INVALID_SOCKET || fds[i].revents == 0) continue;
+                --ready;
+                LoadConnection& connection = connections[i];
+                if (fds[i].revents & POLLOUT) {
+                    write(i);
+                    if (!connection.alive) continue;
+                }
+                if ((fds[i].revents & ~POLLOUT) == 0) continue;
+                connection.replies = 0;
+                if (!connection.client->receiveOnce()) {
+                    fail(i);
+                    continue;
+                }
+                if (options.mode == LoadMode::Closed) {
+                    const Clock::time_point now = Clock::now();
+                    for (unsigned r = 0; r < connection.replies; ++r) send(i, now);
+                }
+            }
+            writeDirty();
+        }
+
+        for (LoadConnection& connection : connections) {
+            connection.client->disconnect();
+        }
+    }
+
+    /**
+     * @brief     :    
+     *  ,     
+     */
+    uint64_t stampOf(Clock::time_point time) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count());
+    }
+
+    /**
+     * @brief   (--mode fanout):   
+     *       
+     */
+    void runFanOutWorker(const LoadOptions& options, unsigned index, unsigned connectionCount,
+        std::atomic<unsigned>& connected, std::shared_future<MeasureWindow> window, WorkerResult& result) {
+        (void)index;
+        Clock::time_point measureStart = Clock::time_point::max();
+        Clock::time_point measureEnd = Clock::time_point::max();
+        unsigned joined = 0;
+        std::vector<std::unique_ptr<Client>> clients(connectionCount);
+        std::vector<pollfd> fds(connectionCount);
+        auto onFrame = [&](const protocol::FrameView& frame) {
+            const Clock::time_point now = Clock::now();
+            if (frame.type == protocol::MessageType::Subscribe) {
+                ++joined;
+                return;
+            }
+            if (frame.type != protocol::MessageType::Publish) {
+                ++result.errors;
+                return;
+            }
+            const std::string_view payload(frame.payload, frame.size);
+            size_t at = payload.find(protocol::TOPIC_SEPARATOR);
+            uint64_t stamp = 0;
+            for (++at; at < payload.size() && payload[at] >= '0' && payload[at] <= '9'; ++at) {
+                stamp = stamp * 10 + static_cast<uint64_t>(payload[at] - '0');
+            }
+            if (now >= measureStart && now < measureEnd) {
+                const uint64_t received = stampOf(now);
+                result.latency.record(received > stamp ? received - stamp : 0);
+                ++result.received;
+                result.bytes += frame.size;
+            }
+        };
+        for (unsigned i = 0; i < connectionCount; ++i) {
+            clients[i] = std::make_unique<Client>(options.host, options.port);
+            const bool alive = clients[i]->connectToServer() && clients[i]->subscribe(FANOUT_TOPIC);
+            if (alive) ++result.connected;
+            else ++result.errors;
+            fds[i].fd = alive ? clients[i]->nativeHandle() : INVALID_SOCKET;
+            fds[i].events = POLLIN;
+            clients[i]->setMessageCallback(onFrame);
+        }
+
+        auto pump = [&]() {
+            int ready = net::poll(fds.data(), fds.size(), 10);
+            for (unsigned i = 0; i < connectionCount && ready > 0; ++i) {
+                if (fds[i].fd == INVALID_SOCKET || fds[i].revents == 0) continue;
+                --ready;
+                if (!clients[i]->receiveOnce()) {
+                    fds[i].fd = INVALID_SOCKET;
+                    ++result.errors;
+                }
+            }
+        };
+        //   ,    
+        const Clock::time_point joinDeadline = Clock::now() + std::chrono::seconds(10);
+        while (joined < result.connected && Clock::now() < joinDeadline) pump();
+
+        connected.fetch_add(1);
+        measureStart = window.get().start;
+        measureEnd = window.get().end;
+        while (Clock::now() < measureEnd) pump();
+
+        for (const auto& client : clients) {
+            client->disconnect();
+        }
+    }
+
+    /**
+     * @brief   fanout:    rate, 
+     *  -   
+     */
+    void runPublisher(const LoadOptions& options, std::atomic<unsigned>& connected,
+        std::shared_future<MeasureWindow> window, WorkerResult& result) {
+        Client client(options.host, options.port);
+        const bool alive = client.connectToServer();
+        if (!alive) ++result.errors;
+        connected.fetch_add(1);
+        const MeasureWindow measure = window.get();
+        if (!alive) return;
+
+        const std::string filler = makePayloads(options, 0).front();
+        const auto interval = std::chrono::nanoseconds(
+            static_cast<int64_t>(options.rate > 0 ? 1e9 / options.rate : 1e18));
+        std::string message;
+        for (Clock::time_point next = Clock::now(); next < measure.end; next += interval) {
+            std::this_thread::sleep_until(next);
+            message = std::to_string(stampOf(next));
+            message += ' ';
+            if (message.size() < filler.size()) message.append(filler, message.size(), std::string::npos);
+            if (!client.publish(FANOUT_TOPIC, message)) {
+                ++result.errors;
+                break;
+            }
+            if (next >= measure.start) ++result.sent;
+        }
+        client.disconnect();
+    }
+
+    coro::Task<void> connectClient(AsyncClient& client, WorkerResult& result) {
+        const bool connected = co_await client.connect();
+        if (connected) ++result.connected;
+    }
+
+    /**
+     * @brief   :    
+     *   
+     * @param first    (     )
+     */
+    coro::Task<void> requestLoop(AsyncClient& client, const std::vector<std::string>& payloads, size_t first,
+        MeasureWindow measure, WorkerResult& result) {
+        for (size_t next = first; Clock::now() < measure.end; next = (next + 1) % payloads.size()) {
+            const std::string& payload = payloads[next];
+            const Clock::time_point sentAt = Clock::now();
+            if (sentAt >= measure.start) ++result.sent;
+            std::optional<AsyncClient::Reply> reply = co_await client.request(payload);
+            if (!reply) {
+                ++result.errors;
+                co_return;
+            }
+            const Clock::time_point now = Clock::now();
+            if (reply->type != protocol::MessageType::Text) {
+                ++result.errors;
+                continue;
+            }
+            if (now >= measure.start && now < measure.end) {
+                result.latency.record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(now - sentAt).count()));
+                ++result.received;
+                result.bytes += reply->payload.size();
+            }
+        }
+    }
+
+    /**
+     * @brief     (--coroutines):  
+     *  depth ,       IoContext
+     */
+    void runCoroutineWorker(const LoadOptions& options, unsigned index, unsigned connectionCount,
+        std::atomic<unsigned>& connected, std::shared_future<MeasureWindow> window, WorkerResult& result) {
+        const std::vector<std::string> payloads = makePayloads(options, index + 1);
+        IoContext context;
+        std::vector<std::unique_ptr<AsyncClient>> clients;
+        for (unsigned i = 0; i < connectionCount; ++i) {
+            clients.push_back(std::make_unique<AsyncClient>(context, options.host, options.port));
+            context.spawn(connectClient(*clients.back(), result));
+        }
+        context.run();
+
+        connected.fetch_add(1);
+        const MeasureWindow measure = window.get();
+        size_t nextPayload = 0;
+        for (const auto& client : clients) {
+            if (!client->isConnected()) continue;
+            for (unsigned d = 0; d < options.depth; ++d) {
+                context.spawn(requestLoop(*client, payloads, nextPayload, measure, result));
+                nextPayload = (nextPayload + 1) % payloads.size();
+            }
+        }
+        context.run();
+    }
+
+    /**
+     * @struct PoolLoad
+     * @brief     ClientPool;  
+     *    ,    .
+     */
+    struct PoolLoad {
+        ClientPool* pool = nullptr;
+        const std::vector<std::string>* payloads = nullptr;
+        MeasureWindow measure;
+        std::mutex mutex;
+        WorkerResult* result = nullptr;
+        std::atomic<size_t> nextPayload{ 0 };
+    };
+
+    /**
+     * @brief  ;     ,  
+     *   
+     */
+    void poolRequest(PoolLoad& load) {
+        const std::string& payload = (*load.payloads)[load.nextPayload.fetch_add(1) % load.payloads->size()];
+        const Clock::time_point sentAt = Clock::now();
+        if (sentAt >= load.measure.end) return;
+        {
+            std::lock_guard<std::mutex> lock(load.mutex);
+            if (sentAt >= load.measure.start) ++load.result->sent;
+        }
+        load.pool->request(payload.data(), payload.size(), [&load, sentAt](Client::Reply&& reply) {
+            const Clock::time_point now = Clock::now();
+            if (now >= load.measure.end) return;
+            {
+                std::lock_guard<std::mutex> lock(load.mutex);
+                if (reply.status != Client::RequestStatus::Ok || reply.type != protocol::MessageType::Text) {
+                    ++load.result->errors;
+                    if (reply.status == Client::RequestStatus::Disconnected) return;
+                }
+                else if (now >= load.measure.start) {
+                    load.result->latency.record(static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(now - sentAt).count()));
+                    ++load.result->received;
+                    load.result->bytes += reply.payload.size();
+                }
+            }
+            poolRequest(load);
+            });
+    }
+
+    /**
+     * @brief    ClientPool (--pool): depth   
+     *  ,      
+     *    
+     */
+    void runPoolWorker(const LoadOptions& options, unsigned index, unsigned connectionCount,
+        std::atomic<unsigned>& connected, std::shared_future<MeasureWindow> window, WorkerResult& result) {
+        const std::vector<std::string> payloads = makePayloads(options, index + 1);
+        ClientPool pool(options.host, options.port, connectionCount);
+        result.connected = static_cast<unsigned>(pool.connect());
+
+        connected.fetch_add(1);
+        PoolLoad load;
+        load.pool = &pool;
+        load.payloads = &payloads;
+        load.measure = window.get();
+        load.result = &result;
+        if (result.connected > 0) {
+            for (unsigned i = 0; i < options.depth * connectionCount; ++i) poolRequest(load);
+        }
+        std::this_thread::sleep_until(load.measure.end);
+        pool.disconnect();
+    }
+
+    /**
+     * @brief      :  
+     *     1024
+     */
+    void raiseFileLimit(unsigned connections) {
+#ifdef __linux__
+        rlimit limit{};
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < connections + 64) {
+            limit.rlim_cur = limit.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &limit);
+        }
+#else
+        (void)connections;
+#endif
+    }
+
+    bool parseSize(const std::string& text, size_t& minSize, size_t& maxSize) {
+        const size_t dash = text.find('-');
+        minSize = std::stoul(text.substr(0, dash));
+        maxSize = dash == std::string::npos ? minSize : std::stoul(text.substr(dash + 1));
+        return minSize > 0 && minSize <= maxSize && maxSize <= protocol::MAX_PAYLOAD_SIZE;
+    }
+
+    double micros(uint64_t nanoseconds) {
+        return static_cast<double>(nanoseconds) / 1000.0;
+    }
+
+    const char* modeName(LoadMode mode) {
+        return mode == LoadMode::Open ? "open" : mode == LoadMode::FanOut ? "fanout" : "closed";
+    }
+
+    /**
+     * @brief    CSV;     
+     */
+    void writeCsv(const LoadOptions& options, const WorkerResult& total, double throughput) {
+        std::ifstream existing(options.csvPath);
+        const bool needHeader = !existing.good() || existing.peek() == std::ifstream::traits_type::eof();
+        existing.close();
+
+        std::ofstream out(options.csvPath, std::ios::app);
+        if (!out) {
+            std::fprintf(stderr, "Cannot open %s\n", options.csvPath.c_str());
+            return;
+        }
+        if (needHeader) {
+            out << "mode,connections,threads,rate,depth,min_size,max_size,duration_s,sent,received,errors,"
+                "throughput_msg_s,mean_us,p50_us,p90_us,p99_us,p999_us,max_us\n";
+        }
+        const LatencyHistogram& h = total.latency;
+        out << modeName(options.mode) << ',' << options.connections << ',' << options.threads << ','
+            << (options.mode != LoadMode::Closed ? options.rate : 0) << ',' << options.depth << ','
+            << options.minSize << ',' << options.maxSize << ',' << options.duration << ','
+            << total.sent << ',' << total.received << ',' << total.errors << ',' << throughput << ','
+            << h.mean() / 1000.0 << ',' << micros(h.percentile(50)) << ',' << micros(h.percentile(90)) << ','
+            << micros(h.percentile(99)) << ',' << micros(h.percentile(99.9)) << ',' << micros(h.max()) << '\n';
+    }
+
+    void writeJson(const LoadOptions& options, const WorkerResult& total, double throughput) {
+        std::ofstream out(options.jsonPath, std::ios::trunc);
+        if (!out) {
+            std::fprintf(stderr, "Cannot open %s\n", options.jsonPath.c_str());
+            return;
+        }
+        const LatencyHistogram& h = total.latency;
+        out << "{\n"
+            << "  \"mode\": \"" << modeName(options.mode) << "\",\n"
+            << "  \"connections\": " << options.connections << ",\n"
+            << "  \"connected\": " << total.connected << ",\n"
+            << "  \"threads\": " << options.threads << ",\n"
+            << "  \"rate\": " << (options.mode != LoadMode::Closed ? options.rate : 0) << ",\n"
+            << "  \"depth\": " << options.depth << ",\n"
+            << "  \"min_size\": " << options.minSize << ",\n"
+            << "  \"max_size\": " << options.maxSize << ",\n"
+            << "  \"duration_s\": " << options.duration << ",\n"
+            << "  \"sent\": " << total.sent << ",\n"
+            << "  \"received\": " << total.received << ",\n"
+            << "  \"errors\": " << total.errors << ",\n"
+            << "  \"throughput_msg_s\": " << throughput << ",\n"
+            << "  \"latency_us\": {\n"
+            << "    \"mean\": " << h.mean() / 1000.0 << ",\n"
+            << "    \"min\": " << micros(h.min()) << ",\n"
+            << "    \"p50\": " << micros(h.percentile(50)) << ",\n"
+            << "    \"p90\": " << micros(h.percentile(90)) << ",\n"
+            << "    \"p99\": " << micros(h.percentile(99)) << ",\n"
+            << "    \"p999\": " << micros(h.percentile(99.9)) << ",\n"
+            << "    \"max\": " << micros(h.max()) << "\n"
+            << "  }\n"
+            << "}\n";
+    }
+
+    void printUsage() {
+        std::printf("Usage: LoadGen [--host ADDR] [--port N] [--connections N] [--threads N]\n"
+            "               [--duration SEC] [--warmup SEC] [--mode open|closed|fanout]\n"
+            "               [--rate MSG_PER_SEC] [--depth N] [--size BYTES|MIN-MAX]\n"
+            "               [--csv FILE] [--json FILE] [--coroutines | --pool]\n");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    LoadOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--host" && hasValue) options.host = argv[++i];
+        else if (arg == "--port" && hasValue) options.port = static_cast<uint16_t>(std::stoul(argv[++i]));
+        else if (arg == "--connections" && hasValue) options.connections = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (arg == "--threads" && hasValue) options.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (arg == "--duration" && hasValue) options.duration = std::stod(argv[++i]);
+        else if (arg == "--warmup" && hasValue) options.warmup = std::stod(argv[++i]);
+        else if (arg == "--rate" && hasValue) options.rate = std::stod(argv[++i]);
+        else if (arg == "--depth" && hasValue) options.depth = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (arg == "--csv" && hasValue) options.csvPath = argv[++i];
+        else if (arg == "--json" && hasValue) options.jsonPath = argv[++i];
+        else if (arg == "--coroutines") options.coroutines = true;
+        else if (arg == "--pool") options.pool = true;
+        else if (arg == "--mode" && hasValue) {
+            std::string mode = argv[++i];
+            if (mode == "open") options.mode = LoadMode::Open;
+            else if (mode == "closed") options.mode = LoadMode::Closed;
+            else if (mode == "fanout") options.mode = LoadMode::FanOut;
+            else {
+                std::fprintf(stderr, "Unknown mode: %s\n", mode.c_str());
+                return 1;
+            }
+        }
+        else if (arg == "--size" && hasValue) {
+            if (!parseSize(argv[++i], options.minSize, options.maxSize)) {
+                std::fprintf(stderr, "Invalid size: %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (options.connections == 0 || options.duration <= 0) {
+        printUsage();
+        return 1;
+    }
+    if ((options.coroutines || options.pool) && options.mode != LoadMode::Closed) {
+        std::fprintf(stderr, "--coroutines and --pool support only the closed loop\n");
+        return 1;
+    }
+    options.threads = std::max(1u, std::min(options.threads, options.connections));
+    options.depth = std::max(1u, options.depth);
+    raiseFileLimit(options.connections);
+
+    std::printf("LoadGen: %u connections, %u threads, %s loop", options.connections, options.threads, modeName(options.mode));
+    if (options.mode == LoadMode::FanOut) std::printf(", %.0f publishes/s", options.rate);
+    else if (options.mode == LoadMode::Open) std::printf(", %.0f msg/s", options.rate);
+    else std::printf(", depth %u", options.depth);
+    if (options.coroutines) std::printf(", coroutines");
+    if (options.pool) std::printf(", client pool");
+    std::printf(", %zu-%zu bytes, %.1fs warmup + %.1fs\n", options.minSize, options.maxSize, options.warmup, options.duration);
+
+    std::vector<WorkerResult> results(options.threads);
+    std::vector<std::thread> workers;
+    std::atomic<unsigned> connected{ 0 };
+    std::promise<MeasureWindow> window;
+    std::shared_future<MeasureWindow> windowFuture = window.get_future().share();
+    for (unsigned t = 0; t < options.threads; ++t) {
+        const unsigned count = options.connections / options.threads + (t < options.connections % options.threads ? 1 : 0);
+        workers.emplace_back(options.mode == LoadMode::FanOut ? runFanOutWorker : options.pool ? runPoolWorker : options.coroutines ? runCoroutineWorker : runWorker, std::cref(options), t, count, std::ref(connected), windowFuture, std::ref(results[t]));
+    }
+    //  fanout -  ;   -  
+    WorkerResult published;
+    const unsigned threadCount = options.threads + (options.mode == LoadMode::FanOut ? 1 : 0);
+    if (options.mode == LoadMode::FanOut) {
+        workers.emplace_back(runPublisher, std::cref(options), std::ref(connected), windowFuture, std::ref(published));
+    }
+
+    //       :
+    //        
+    while (connected.load() < threadCount) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const auto toDuration = [](double seconds) {
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    };
+    MeasureWindow measure;
+    measure.start = Clock::now() + toDuration(options.warmup);
+    measure.end = measure.start + toDuration(options.duration);
+    window.set_value(measure);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    WorkerResult total;
+    total.sent = published.sent;
+    total.errors = published.errors;
+    for (const WorkerResult& result : results) {
+        total.latency.merge(result.latency);
+        total.connected += result.connected;
+        total.sent += result.sent;
+        total.received += result.received;
+        total.bytes += result.bytes;
+        total.errors += result.errors;
+    }
+    const double throughput = static_cast<double>(total.received) / options.duration;
+    const LatencyHistogram& h = total.latency;
+
+    std::printf("Connected:  %u of %u\n", total.connected, options.connections);
+    std::printf("Sent:       %llu\n", static_cast<unsigned long long>(total.sent));
+    std::printf("Received:   %llu\n", static_cast<unsigned long long>(total.received));
+    std::printf("Errors:     %llu\n", static_cast<unsigned long long>(total.errors));
+    std::printf("Throughput: %.0f msg/s, %.2f MB/s\n", throughput,
+        static_cast<double>(total.bytes) / options.duration / (1024.0 * 1024.0));
+    if (options.mode == LoadMode::FanOut && total.sent > 0) {
+        std::printf("Fan-out:    %.1f of %u subscribers per publish\n",
+            static_cast<double>(total.received) / static_cast<double>(total.sent), total.connected);
+    }
+    std::printf("Latency (us): mean %.1f  p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+        h.mean() / 1000.0, micros(h.percentile(50)), micros(h.percentile(90)), micros(h.percentile(99)),
+        micros(h.percentile(99.9)), micros(h.max()));
+
+    if (!options.csvPath.empty()) writeCsv(options, total, throughput);
+    if (!options.jsonPath.empty()) writeJson(options, total, throughput);
+    return total.connected == 0 ? 1 : 0;
+}
@@ -0,0 +1,393 @@
+#include "../include/client/client.hpp"
+#include "../include/common/capture.hpp"
+#include "../include/loadgen/latency_histogram.hpp"
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @struct ReplayOptions
+     * @brief  .
+     */
+    struct ReplayOptions {
+        std::string capturePath;
+        std::string host = "127.0.0.1";
+        uint16_t port = 8080;
+        unsigned threads = 1;
+        double speed = 1; //     
+        double drain = 5; //      
+        std::string jsonPath; //    JSON
+    };
+
+    /**
+     * @struct ReplayResult
+     * @brief   ;    .
+     */
+    struct ReplayResult {
+        LatencyHistogram latency; //       Text
+        unsigned connected = 0; //  
+        uint64_t sent = 0; //  
+        uint64_t received = 0; //  
+        uint64_t published = 0; //    
+        uint64_t errors = 0; //  ,    
+        Clock::time_point lastReply; //   
+    };
+
+    /**
+     * @struct ReplayConnection
+     * @brief        .
+     * @details   LoadGen,      
+     */
+    struct ReplayConnection {
+        std::unique_ptr<Client> client;
+        std::deque<Clock::time_point> inFlight;
+        bool alive = true;
+        bool dirty = false; //     ,    writeQueued()
+    };
+
+    /**
+     * @struct Schedule
+     * @brief     :       .
+     */
+    struct Schedule {
+        std::vector<std::pair<size_t, unsigned>> frames;
+        unsigned connections = 0;
+    };
+
+    /**
+     * @brief  :  ,  poll  
+     * @param connected  ,  
+     * @param startFuture ,   
+     */
+    void runReplay(const ReplayOptions& options, const std::vector<capture::Record>& records, const Schedule& schedule,
+        std::atomic<unsigned>& connected, std::shared_future<Clock::time_point> startFuture, ReplayResult& result) {
+        std::vector<ReplayConnection> connections(schedule.connections);
+        std::vector<pollfd> fds(schedule.connections);
+        for (unsigned i = 0; i < schedule.connections; ++i) {
+            ReplayConnection& connection = connections[i];
+            connection.client = std::make_unique<Client>(options.host, options.port);
+            //         
+            connection.client->setSendHighWaterMark(0);
+            connection.alive = connection.client->connectToServer();
+            if (connection.alive) ++result.connected;
+            fds[i].fd = connection.alive ? connection.client->nativeHandle() : INVALID_SOCKET;
+            fds[i].events = POLLIN;
+
+            //  Hello       ,
+            //  Hello     
+            connection.client->setMessageCallback([&connection, &result](const protocol::FrameView& frame) {
+                if (frame.type == protocol::MessageType::Publish) {
+                    ++result.published;
+                    return;
+                }
+                const Clock::time_point now = Clock::now();
+                if (connection.inFlight.empty()) {
+                    ++result.errors;
+                    return;
+                }
+                const Clock::time_point sentAt = connection.inFlight.front();
+                connection.inFlight.pop_front();
+                ++result.received;
+                result.lastReply = now;
+                if (frame.type == protocol::MessageType::Error) {
+                    ++result.errors;
+                    return;
+                }
+                if (frame.type == protocol::MessageType::Text) {
+                    result.latency.record(static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(now - sentAt).count()));
+                }
+            });
+        }
+
+        connected.fetch_add(1);
+        const Clock::time_point start = startFuture.get();
+        auto dueAt = [&](size_t record) {
+            return start + std::chrono::nanoseconds(static_cast<int64_t>(
+                static_cast<double>(records[record].timeNs) / options.speed));
+        };
+
+        auto fail = [&](unsigned i) {
+            connections[i].alive = false;
+            fds[i].fd = INVALID_SOCKET;
+            ++result.errors;
+        };
+
+        //   :     
+        //     .    
+        //  -      Hello
+        std::vector<unsigned> dirty;
+        auto send = [&](size_t record, unsigned i, Clock::time_point stamp) {
+            ReplayConnection& connection = connections[i];
+            if (!connection.alive) return;
+            const capture::Record& source = records[record];
+            protocol::FrameView frame{ source.type, source.flags, source.payload, source.size };
+            uint64_t correlation = 0;
+            if ((frame.flags & protocol::FLAG_CORRELATED) && !protocol::takeCorrelation(frame, correlation)) return;
+            if (!connection.client->queueFrame(frame.type, frame.flags, frame.payload, frame.size)) {
+                fail(i);
+                return;
+            }
+            if (frame.type != protocol::MessageType::Publish && frame.type != protocol::MessageType::Hello) {
+                connection.inFlight.push_back(stamp);
+            }
+            ++result.sent;
+            if (!connection.dirty) {
+                connection.dirty = true;
+                dirty.push_back(i);
+            }
+        };
+
+        auto write = [&](unsigned i) {
+            ReplayConnection& connection = connections[i];
+            connection.dirty = false;
+            if (!connection.alive) return;
+            if (!connection.client->writeQueued()) {
+                fail(i);
+                return;
+            }
+            fds[i].events = connection.client->queuedBytes() > 0 ? POLLIN | POLLOUT : POLLIN;
+        };
+        auto waiting = [&]() {
+            for (const ReplayConnection& connection : connections) {
+                if (connection.alive && !connection.inFlight.empty()) return true;
+            }
+            return false;
+        };
+
+        size_t next = 0;
+        Clock::time_point drainEnd = Clock::time_point::max();
+        while (true) {
+            const Clock::time_point now = Clock::now();
+            //      ( coordinated omission)
+            for (; next < schedule.frames.size(); ++next) {
+                const Clock::time_point due = dueAt(schedule.frames[next].first);
+                if (due > now) break;
+                send(schedule.frames[next].first, schedule.frames[next].second, due);
+            }
+            for (unsigned i : dirty) write(i);
+            dirty.clear();
+
+            int timeoutMs = 10;
+            if (next < schedule.frames.size()) {
+                const auto untilNext = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    dueAt(schedule.frames[next].first) - now).count();
+                timeoutMs = static_cast<int>(std::min<int64_t>(untilNext, timeoutMs));
+            }
+            else {
+                if (drainEnd == Clock::time_point::max()) {
+                    drainEnd = now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.drain));
+                }
+                if (!waiting() || now >= drainEnd) break;
+            }
+
+            int ready = net::poll(fds.data(), fds.size(), timeoutMs);
+            if (ready <= 0) continue;
+            for (unsigned i = 0; i < schedule.connections && ready > 0; ++i) {
+                if (fds[i].fd == INVALID_SOCKET || fds[i].revents == 0) continue;
+                --ready;
+                if (fds[i].revents & POLLOUT) {
+                    write(i);
+                    if (!connections[i].alive) continue;
+                }
+                if ((fds[i].revents & ~POLLOUT) == 0) continue;
+                if (!connections[i].client->receiveOnce()) fail(i);
+            }
+        }
+
+        // ,     , - 
+        for (ReplayConnection& connection : connections) {
+            result.errors += connection.inFlight.size();
+            connection.client->disconnect();
+        }
+    }
+
+    void raiseFileLimit(unsigned connections) {
+#ifdef __linux__
+        rlimit limit{};
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < connections + 64) {
+            limit.rlim_cur = limit.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &limit);
+        }
+#else
+        (void)connections;
+#endif
+    }
+
+    double micros(uint64_t nanoseconds) {
+        return static_cast<double>(nanoseconds) / 1000.0;
+    }
+
+    void writeJson(const ReplayOptions& options, size_t connections, double captureSeconds, const ReplayResult& total,
+        double elapsed, double throughput) {
+        std::ofstream out(options.jsonPath, std::ios::trunc);
+        if (!out) {
+            std::fprintf(stderr, "Cannot open %s\n", options.jsonPath.c_str());
+            return;
+        }
+        const LatencyHistogram& h = total.latency;
+        out << "{\n"
+            << "  \"capture\": \"" << options.capturePath << "\",\n"
+            << "  \"capture_s\": " << captureSeconds << ",\n"
+            << "  \"speed\": " << options.speed << ",\n"
+            << "  \"connections\": " << connections << ",\n"
+            << "  \"connected\": " << total.connected << ",\n"
+            << "  \"threads\": " << options.threads << ",\n"
+            << "  \"elapsed_s\": " << elapsed << ",\n"
+            << "  \"sent\": " << total.sent << ",\n"
+            << "  \"received\": " << total.received << ",\n"
+            << "  \"published\": " << total.published << ",\n"
+            << "  \"errors\": " << total.errors << ",\n"
+            << "  \"throughput_msg_s\": " << throughput << ",\n"
+            << "  \"latency_us\": {\n"
+            << "    \"mean\": " << h.mean() / 1000.0 << ",\n"
+            << "    \"min\": " << micros(h.min()) << ",\n"
+            << "    \"p50\": " << micros(h.percentile(50)) << ",\n"
+            << "    \"p90\": " << micros(h.percentile(90)) << ",\n"
+            << "    \"p99\": " << micros(h.percentile(99)) << ",\n"
+            << "    \"p999\": " << micros(h.percentile(99.9)) << ",\n"
+            << "    \"max\": " << micros(h.max()) << "\n"
+            << "  }\n"
+            << "}\n";
+    }
+
+    void printUsage() {
+        std::printf("Usage: Replay CAPTURE_FILE [--host ADDR] [--port N] [--threads N]\n"
+            "              [--speed X] [--drain SEC] [--json FILE]\n");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    ReplayOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--host" && hasValue) options.host = argv[++i];
+        else if (arg == "--port" && hasValue) options.port = static_cast<uint16_t>(std::stoul(argv[++i]));
+        else if (arg == "--threads" && hasValue) options.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (arg == "--speed" && hasValue) options.speed = std::stod(argv[++i]);
+        else if (arg == "--drain" && hasValue) options.drain = std::stod(argv[++i]);
+        else if (arg == "--json" && hasValue) options.jsonPath = argv[++i];
+        else if (arg.compare(0, 2, "--") != 0 && options.capturePath.empty()) options.capturePath = arg;
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (options.capturePath.empty() || options.speed <= 0) {
+        printUsage();
+        return 1;
+    }
+
+    capture::Reader reader;
+    std::string error;
+    if (!reader.open(options.capturePath, error)) {
+        std::fprintf(stderr, "Cannot read %s: %s\n", options.capturePath.c_str(), error.c_str());
+        return 1;
+    }
+    const std::vector<capture::Record>& records = reader.records();
+    if (records.empty()) {
+        std::fprintf(stderr, "%s has no frames\n", options.capturePath.c_str());
+        return 1;
+    }
+
+    //          .
+    //      (NO_CONNECTION)   
+    // ,   ,     
+    std::unordered_map<uint64_t, std::pair<unsigned, unsigned>> owners; //   ->     
+    std::vector<uint64_t> order;
+    size_t skipped = 0;
+    for (const capture::Record& record : records) {
+        if (record.connection == capture::NO_CONNECTION) {
+            ++skipped;
+            continue;
+        }
+        if (owners.count(record.connection) == 0) {
+            owners.emplace(record.connection, std::make_pair(0u, 0u));
+            order.push_back(record.connection);
+        }
+    }
+    options.threads = std::max(1u, std::min<unsigned>(options.threads, static_cast<unsigned>(order.size())));
+    std::vector<Schedule> schedules(options.threads);
+    for (size_t i = 0; i < order.size(); ++i) {
+        const unsigned thread = static_cast<unsigned>(i % options.threads);
+        owners[order[i]] = { thread, schedules[thread].connections++ };
+    }
+    if (skipped > 0) {
+        std::fprintf(stderr, "Skipped %zu frames of connections without a registry id\n", skipped);
+    }
+    if (order.empty()) {
+        std::fprintf(stderr, "%s has no frames of registered connections\n", options.capturePath.c_str());
+        return 1;
+    }
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (records[i].connection == capture::NO_CONNECTION) continue;
+        const auto& owner = owners[records[i].connection];
+        schedules[owner.first].frames.emplace_back(i, owner.second);
+    }
+    raiseFileLimit(static_cast<unsigned>(order.size()));
+
+    const double captureSeconds = static_cast<double>(records.back().timeNs) / 1e9;
+    std::printf("Replay: %zu frames over %.2fs from %zu connections, %u threads, speed %.2fx\n",
+        records.size() - skipped, captureSeconds, order.size(), options.threads, options.speed);
+
+    std::vector<ReplayResult> results(options.threads);
+    std::vector<std::thread> workers;
+    std::atomic<unsigned> connected{ 0 };
+    std::promise<Clock::time_point> start;
+    std::shared_future<Clock::time_point> startFuture = start.get_future().share();
+    for (unsigned t = 0; t < options.threads; ++t) {
+        workers.emplace_back(runReplay, std::cref(options), std::cref(records), std::cref(schedules[t]),
+            std::ref(connected), startFuture, std::ref(results[t]));
+    }
+
+    //  ,     
+    while (connected.load() < options.threads) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const Clock::time_point startedAt = Clock::now() + std::chrono::milliseconds(10);
+    start.set_value(startedAt);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    ReplayResult total;
+    total.lastReply = startedAt;
+    for (const ReplayResult& result : results) {
+        total.latency.merge(result.latency);
+        total.connected += result.connected;
+        total.sent += result.sent;
+        total.received += result.received;
+        total.published += result.published;
+        total.errors += result.errors;
+        total.lastReply = std::max(total.lastReply, result.lastReply);
+    }
+    //   -        
+    const double elapsed = std::max(std::chrono::duration<double>(total.lastReply - startedAt).count(), 1e-9);
+    const double throughput = static_cast<double>(total.received) / elapsed;
+    const LatencyHistogram& h = total.latency;
+
+    std::printf("Connected:  %u of %zu\n", total.connected, order.size());
+    std::printf("Sent:       %llu\n", static_cast<unsigned long long>(total.sent));
+    std::printf("Received:   %llu (+%llu publications)\n", static_cast<unsigned long long>(total.received),
+        static_cast<unsigned long long>(total.published));
+    std::printf("Errors:     %llu\n", static_cast<unsigned long long>(total.errors));
+    std::printf("Elapsed:    %.2fs (capture %.2fs at %.2fx)\n", elapsed, captureSeconds / options.speed, options.speed);
+    std::printf("Throughput: %.0f msg/s\n", throughput);
+    std::printf("Latency (us): mean %.1f  p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+        h.mean() / 1000.0, micros(h.percentile(50)), micros(h.percentile(90)), micros(h.percentile(99)),
+        micros(h.percentile(99.9)), micros(h.max()));
+
+    if (!options.jsonPath.empty()) writeJson(options, order.size(), captureSeconds, total, elapsed, throughput);
+    return total.connected == 0 ? 1 : 0;
+}
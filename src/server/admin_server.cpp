@@ -0,0 +1,240 @@
+#include "../include/server/admin_server.hpp"
+#include "../include/server/logger.hpp"
+#include "../include/server/metrics.hpp"
+#include "../include/server/connection_registry.hpp"
+#include <cstdlib>
+#include <cstring>
+
+AdminServer::AdminServer(uint16_t port, const std::string& address, ConnectionRegistry* connections,
+    const std::string& controlToken)
+    : m_port(port), m_address(address), m_connections(connections), m_controlToken(controlToken) {}
+
+AdminServer::~AdminServer() {
+    stop();
+}
+
+bool AdminServer::start() {
+    if (m_running) return true;
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(m_port);
+    if (inet_pton(AF_INET, m_address.c_str(), &addr.sin_addr) != 1) {
+        logging::error("Invalid admin address: " + m_address);
+        return false;
+    }
+
+    m_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (m_socket == INVALID_SOCKET) return false;
+#ifndef _WIN32
+    int enable = 1;
+    setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    //      ,    
+    setsockopt(m_socket, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+#endif
+    if (bind(m_socket, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR || listen(m_socket, 16) == SOCKET_ERROR) {
+        logging::error("Admin port " + std::to_string(m_port) + " is unavailable");
+        closesocket(m_socket);
+        m_socket = INVALID_SOCKET;
+        return false;
+    }
+
+    m_running = true;
+    m_thread = std::thread(&AdminServer::run, this);
+    return true;
+}
+
+/**
+ * @details    accept  ;   stop()
+ *    
+ */
+void AdminServer::stop() {
+    if (!m_running.exchange(false)) return;
+
+    sockaddr_in addr{};
+    socklen_t size = sizeof(addr);
+    if (getsockname(m_socket, (sockaddr*)&addr, &size) == 0) {
+        if (addr.sin_addr.s_addr == htonl(INADDR_ANY)) addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        SOCKET wake = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (wake != INVALID_SOCKET) {
+            connect(wake, (sockaddr*)&addr, sizeof(addr));
+            closesocket(wake);
+        }
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    closesocket(m_socket);
+    m_socket = INVALID_SOCKET;
+}
+
+void AdminServer::run() {
+    while (m_running) {
+        SOCKET client = accept(m_socket, nullptr, nullptr);
+        if (client == INVALID_SOCKET) continue;
+        if (m_running) {
+            handle(client);
+        }
+        closesocket(client);
+    }
+}
+
+/**
+ * @brief      ( Content-Length)    send
+ * @details     (Connection: close)
+ */
+void AdminServer::handle(SOCKET client) {
+    net::setTimeout(client, SO_RCVTIMEO, REQUEST_TIMEOUT_MS);
+    net::setTimeout(client, SO_SNDTIMEO, REQUEST_TIMEOUT_MS);
+
+    std::string request;
+    char chunk[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_SIZE) {
+        int received = recv(client, chunk, sizeof(chunk), 0);
+        if (received <= 0) return;
+        request.append(chunk, static_cast<size_t>(received));
+    }
+
+    const size_t headerEnd = request.find("\r\n\r\n");
+    if (headerEnd == std::string::npos) return;
+    size_t bodySize = 0;
+    const size_t lengthField = request.find("\r\nContent-Length:");
+    if (lengthField != std::string::npos && lengthField < headerEnd) {
+        bodySize = std::strtoul(request.c_str() + lengthField + std::strlen("\r\nContent-Length:"), nullptr, 10);
+    }
+    if (headerEnd + 4 + bodySize > MAX_REQUEST_SIZE) return;
+    while (request.size() < headerEnd + 4 + bodySize) {
+        int received = recv(client, chunk, sizeof(chunk), 0);
+        if (received <= 0) return;
+        request.append(chunk, static_cast<size_t>(received));
+    }
+    const std::string body = request.substr(headerEnd + 4, bodySize);
+    std::string token;
+    const std::string tokenName = std::string("\r\n") + TOKEN_HEADER + ":";
+    const size_t tokenField = request.find(tokenName);
+    if (tokenField != std::string::npos && tokenField < headerEnd) {
+        const size_t valueStart = request.find_first_not_of(' ', tokenField + tokenName.size());
+        const size_t valueEnd = request.find("\r\n", tokenField + tokenName.size());
+        if (valueStart < valueEnd) token = request.substr(valueStart, valueEnd - valueStart);
+    }
+
+    std::string response;
+    const size_t methodEnd = request.find(' ');
+    const size_t pathEnd = methodEnd == std::string::npos ? std::string::npos : request.find(' ', methodEnd + 1);
+    if (pathEnd == std::string::npos) {
+        response = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    }
+    else {
+        response = respond(request.substr(0, methodEnd), request.substr(methodEnd + 1, pathEnd - methodEnd - 1), body, token);
+    }
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        int result = send(client, response.data() + sent, static_cast<int>(response.size() - sent), MSG_NOSIGNAL);
+        if (result <= 0) return;
+        sent += static_cast<size_t>(result);
+    }
+}
+
+std::string AdminServer::respond(const std::string& method, const std::string& path, const std::string& request,
+    const std::string& token) {
+    std::string status = "200 OK";
+    std::string contentType;
+    std::string body;
+    const std::string route = path.substr(0, path.find('?'));
+    if (m_connections && route.compare(0, 12, "/connections") == 0) {
+        contentType = "application/json";
+        body = respondConnections(method, route, request, token, status);
+    }
+    else if (method != "GET") {
+        status = "405 Method Not Allowed";
+    }
+    else if (route == "/metrics") {
+        contentType = "text/plain; version=0.0.4";
+        body = metrics::formatPrometheus(metrics::snapshot());
+    }
+    else if (route == "/stats") {
+        contentType = "application/json";
+        body = metrics::formatJson(metrics::snapshot());
+    }
+    else {
+        status = "404 Not Found";
+    }
+
+    std::string response = "HTTP/1.1 " + status + "\r\n";
+    if (!contentType.empty()) {
+        response += "Content-Type: " + contentType + "\r\n";
+    }
+    response += "Content-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+    response += body;
+    return response;
+}
+
+/**
+ * @details      : ,
+ *      ,     
+ */
+std::string AdminServer::respondConnections(const std::string& method, const std::string& route,
+    const std::string& body, const std::string& token, std::string& status) {
+    if (route == "/connections") {
+        if (method != "GET") {
+            status = "405 Method Not Allowed";
+            return std::string();
+        }
+        const auto now = std::chrono::steady_clock::now();
+        std::string list;
+        size_t count = 0;
+        m_connections->forEach([&](ConnectionRegistry::Id id, const ConnectionRegistry::Slot& slot) {
+            if (count++ > 0) list += ",";
+            list += "{\"id\":" + std::to_string(id)
+                + ",\"socket\":" + std::to_string(slot.socket)
+                + ",\"age_ms\":" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(now - slot.connectedAt).count())
+                + ",\"bytes_in\":" + std::to_string(slot.bytesIn.load(std::memory_order_relaxed))
+                + ",\"messages\":" + std::to_string(slot.messages.load(std::memory_order_relaxed)) + "}";
+        });
+        return "{\"count\":" + std::to_string(count) + ",\"connections\":[" + list + "]}";
+    }
+
+    // /connections/ID/send  /connections/ID/close
+    const size_t idStart = std::strlen("/connections/");
+    const size_t idEnd = route.find('/', idStart);
+    const std::string action = idEnd == std::string::npos ? std::string() : route.substr(idEnd + 1);
+    if (route.compare(0, idStart, "/connections/") != 0 || (action != "send" && action != "close")) {
+        status = "404 Not Found";
+        return std::string();
+    }
+    if (method != "POST") {
+        status = "405 Method Not Allowed";
+        return std::string();
+    }
+    if (m_controlToken.empty()) {
+        status = "403 Forbidden";
+        return "{\"error\":\"connection control is disabled\"}";
+    }
+    if (!authorized(token)) {
+        status = "401 Unauthorized";
+        return "{\"error\":\"missing or invalid admin token\"}";
+    }
+    const ConnectionRegistry::Id id = std::strtoull(route.c_str() + idStart, nullptr, 10);
+    const bool done = action == "send"
+        ? m_connections->send(id, protocol::MessageType::Text, body.data(), body.size())
+        : m_connections->close(id, "closed by the admin port");
+    if (!done) {
+        status = "404 Not Found";
+        return "{\"error\":\"no such connection\"}";
+    }
+    return "{\"ok\":true}";
+}
+
+/**
+ * @details       , 
+ *       
+ */
+bool AdminServer::authorized(const std::string& token) const {
+    if (m_controlToken.empty() || token.size() != m_controlToken.size()) return false;
+    unsigned char difference = 0;
+    for (size_t i = 0; i < token.size(); ++i) {
+        difference |= static_cast<unsigned char>(token[i] ^ m_controlToken[i]);
+    }
+    return difference == 0;
+}
@@ -0,0 +1,111 @@
+#include "../include/server/capture_writer.hpp"
+#include "../include/server/logger.hpp"
+#include "../include/server/metrics.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+CaptureWriter::~CaptureWriter() {
+    close();
+}
+
+/**
+ * @details    :    
+ *   (   ),    
+ *   SIGBUS,        .
+ *    limit     :
+ *     reserve(),     
+ *   ,    SIGBUS    
+ */
+bool CaptureWriter::open(const std::string& path, size_t limit) {
+    close();
+    m_limit = capture::FILE_HEADER_SIZE
+        + (limit > capture::FILE_HEADER_SIZE ? limit - capture::FILE_HEADER_SIZE : 0) / capture::BLOCK_SIZE * capture::BLOCK_SIZE;
+    if (m_limit == capture::FILE_HEADER_SIZE) {
+        logging::error("Capture limit is smaller than one block");
+        return false;
+    }
+    m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        logging::error(errno == EEXIST ? "Capture file " + path + " already exists"
+            : "Cannot create capture file " + path + ": " + std::to_string(errno));
+        return false;
+    }
+    if (ftruncate(m_fd, static_cast<off_t>(m_limit)) != 0) {
+        logging::error("Cannot size capture file " + path + ": " + std::to_string(errno));
+        close();
+        return false;
+    }
+    void* base = mmap(nullptr, m_limit, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (base == MAP_FAILED) {
+        logging::error("Cannot map capture file " + path + ": " + std::to_string(errno));
+        base = nullptr;
+        close();
+        return false;
+    }
+    m_base = static_cast<char*>(base);
+    m_used.store(capture::FILE_HEADER_SIZE, std::memory_order_relaxed);
+    m_start = std::chrono::steady_clock::now();
+
+    capture::FileHeader header{};
+    std::memcpy(header.magic, capture::MAGIC, sizeof(capture::MAGIC));
+    header.version = capture::VERSION;
+    header.blockSize = static_cast<uint32_t>(capture::BLOCK_SIZE);
+    header.startedAtNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    std::memcpy(m_base, &header, sizeof(header));
+    return true;
+}
+
+void CaptureWriter::close() {
+    if (m_base) {
+        munmap(m_base, m_limit);
+        m_base = nullptr;
+    }
+    if (m_fd >= 0) {
+        const size_t used = std::min(m_used.load(std::memory_order_relaxed), m_limit);
+        if (ftruncate(m_fd, static_cast<off_t>(used)) != 0) {
+            logging::warning("Cannot trim capture file: " + std::to_string(errno));
+        }
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+/**
+ * @details     :  
+ *      
+ */
+bool CaptureWriter::reserve(Cursor& cursor) {
+    if (m_used.load(std::memory_order_relaxed) >= m_limit) return false;
+    const size_t offset = m_used.fetch_add(capture::BLOCK_SIZE, std::memory_order_relaxed);
+    if (offset + capture::BLOCK_SIZE > m_limit) return false;
+    if (posix_fallocate(m_fd, static_cast<off_t>(offset), static_cast<off_t>(capture::BLOCK_SIZE)) != 0) {
+        m_used.store(m_limit, std::memory_order_relaxed);
+        logging::warning("Capture stopped: no space for the next block");
+        return false;
+    }
+    cursor.position = m_base + offset;
+    cursor.end = cursor.position + capture::BLOCK_SIZE;
+    return true;
+}
+
+void CaptureWriter::record(Cursor& cursor, uint64_t connection, std::chrono::steady_clock::time_point time,
+    const protocol::FrameView& frame) {
+    const size_t size = capture::recordSize(frame.size);
+    if (static_cast<size_t>(cursor.end - cursor.position) < size && !reserve(cursor)) {
+        metrics::add(metrics::Counter::CaptureDropped);
+        return;
+    }
+    capture::RecordHeader header{};
+    header.size = static_cast<uint32_t>(frame.size);
+    header.kind = capture::RecordKind::Frame;
+    header.type = frame.type;
+    header.flags = frame.flags;
+    header.connection = connection;
+    header.timeNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time - m_start).count());
+    std::memcpy(cursor.position, &header, sizeof(header));
+    if (frame.size > 0) std::memcpy(cursor.position + sizeof(header), frame.payload, frame.size);
+    cursor.position += size;
+    metrics::add(metrics::Counter::CaptureFrames);
+}
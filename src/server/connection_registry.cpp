@@ -0,0 +1,146 @@
+#include "../include/server/connection_registry.hpp"
+#include <algorithm>
+#include <thread>
+#ifdef __linux__
+#include "../include/server/event_loop.hpp"
+#endif
+
+ConnectionRegistry::ConnectionRegistry(size_t capacity)
+    : m_capacity(std::min(capacity, MAX_CAPACITY)),
+      m_chunks(new std::atomic<Slot*>[(m_capacity + CHUNK_SIZE - 1) / CHUNK_SIZE]()) {
+}
+
+/**
+ * @details        :  
+ *    ,  forEach    .
+ *      ,      
+ */
+bool ConnectionRegistry::grow() {
+    std::lock_guard<std::mutex> lock(m_growMutex);
+    //    ,     
+    if (static_cast<uint32_t>(m_freeHead.load(std::memory_order_acquire)) != NO_SLOT) return true;
+    if (m_allocated >= m_capacity) return false;
+    const size_t count = std::min(CHUNK_SIZE, m_capacity - m_allocated);
+    m_chunkStorage.emplace_back(new Slot[count]);
+    m_chunks[m_allocated / CHUNK_SIZE].store(m_chunkStorage.back().get(), std::memory_order_release);
+    const size_t first = m_allocated;
+    m_allocated += count;
+    for (size_t index = m_allocated; index-- > first;) {
+        pushFree(static_cast<uint32_t>(index));
+    }
+    return true;
+}
+
+void ConnectionRegistry::pushFree(uint32_t index) {
+    uint64_t head = m_freeHead.load(std::memory_order_relaxed);
+    uint64_t next;
+    do {
+        slotAt(index).nextFree.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        next = ((head >> 32) + 1) << 32 | index;
+    } while (!m_freeHead.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed));
+}
+
+uint32_t ConnectionRegistry::popFree() {
+    uint64_t head = m_freeHead.load(std::memory_order_acquire);
+    uint64_t next;
+    do {
+        const uint32_t index = static_cast<uint32_t>(head);
+        if (index == NO_SLOT) return NO_SLOT;
+        next = ((head >> 32) + 1) << 32 | slotAt(index).nextFree.load(std::memory_order_relaxed);
+    } while (!m_freeHead.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire));
+    return static_cast<uint32_t>(head);
+}
+
+/**
+ * @details      LIVE (release),  
+ *      (acquire)
+ */
+ConnectionRegistry::Id ConnectionRegistry::add(SOCKET socket, Reactor* owner, uint64_t engineId) {
+    uint32_t index = popFree();
+    while (index == NO_SLOT) {
+        if (!grow()) return INVALID_ID;
+        index = popFree();
+    }
+    Slot& slot = slotAt(index);
+    slot.socket = socket;
+    slot.owner = owner;
+    slot.engineId = engineId;
+    slot.connectedAt = std::chrono::steady_clock::now();
+    slot.bytesIn.store(0, std::memory_order_relaxed);
+    slot.messages.store(0, std::memory_order_relaxed);
+    const uint64_t state = slot.state.load(std::memory_order_relaxed) | LIVE;
+    slot.state.store(state, std::memory_order_release);
+
+    size_t used = m_used.load(std::memory_order_relaxed);
+    while (used <= index && !m_used.compare_exchange_weak(used, index + 1, std::memory_order_release)) {}
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    return makeId(index, state);
+}
+
+void ConnectionRegistry::remove(Id id) {
+    Slot* slot = slotOf(id);
+    if (!slot) return;
+    //    LIVE:  ,    
+    uint64_t state = slot->state.load(std::memory_order_relaxed);
+    uint64_t next;
+    do {
+        if ((state >> 32) != (id >> 32) || !(state & LIVE)) return;
+        next = ((state >> 32) + 1) << 32 | (state & REF_MASK);
+    } while (!slot->state.compare_exchange_weak(state, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+    //      (, , )
+    while (slot->state.load(std::memory_order_acquire) & REF_MASK) {
+        std::this_thread::yield();
+    }
+    m_count.fetch_sub(1, std::memory_order_relaxed);
+    pushFree(static_cast<uint32_t>(indexOf(id)));
+}
+
+ConnectionRegistry::Ref ConnectionRegistry::find(Id id) {
+    Slot* slot = slotOf(id);
+    if (!slot) return Ref();
+    uint64_t state = slot->state.load(std::memory_order_acquire);
+    do {
+        if ((state >> 32) != (id >> 32) || !(state & LIVE)) return Ref();
+    } while (!slot->state.compare_exchange_weak(state, state + REF, std::memory_order_acquire, std::memory_order_acquire));
+    return Ref(slot);
+}
+
+void ConnectionRegistry::Ref::release() {
+    if (!m_slot) return;
+    m_slot->state.fetch_sub(REF, std::memory_order_release);
+    m_slot = nullptr;
+}
+
+bool ConnectionRegistry::send(Id id, protocol::MessageType type, const char* payload, size_t size) {
+    Ref ref = find(id);
+    if (!ref) return false;
+#ifdef __linux__
+    auto command = new ConnectionCommand();
+    command->socket = ref->socket;
+    command->connectionId = ref->engineId;
+    command->frame = protocol::makeFrame(type, payload, size);
+    ref->owner->post(command);
+    return true;
+#else
+    const buffers::Buffer frame = protocol::makeFrame(type, payload, size);
+    std::lock_guard<std::mutex> lock(slotAt(indexOf(id)).sendMutex);
+    return ::send(ref->socket, frame.data(), static_cast<int>(frame.size()), 0) == static_cast<int>(frame.size());
+#endif
+}
+
+bool ConnectionRegistry::close(Id id, const std::string& reason) {
+    Ref ref = find(id);
+    if (!ref) return false;
+#ifdef __linux__
+    auto command = new ConnectionCommand();
+    command->socket = ref->socket;
+    command->connectionId = ref->engineId;
+    command->close = true;
+    command->reason = reason;
+    ref->owner->post(command);
+#else
+    (void)reason;
+    ::shutdown(ref->socket, SD_BOTH);
+#endif
+    return true;
+}
@@ -0,0 +1,777 @@
+#include "../include/server/server.hpp"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <linux/errqueue.h>
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * @details      ,   
+ */
+void RouteJob::run() {
+    runRoute(*route, request, response);
+    loop->post(this);
+}
+
+Reactor::~Reactor() {
+    while (RouteJob* job = m_completions.pop()) {
+        delete job;
+    }
+    while (Broadcast* broadcast = m_broadcasts.pop()) {
+        delete broadcast;
+    }
+    while (handoff::Adoption* adoption = m_adoptions.pop()) {
+        closesocket(adoption->socket);
+        delete adoption;
+    }
+    while (ConnectionCommand* command = m_commands.pop()) {
+        delete command;
+    }
+}
+
+/**
+ * @brief       pthread_setaffinity_np
+ * @details  MPOL_LOCAL     (
+ * libnuma):       , 
+ *  ,  numactl
+ */
+void Reactor::pinThread() {
+    if (m_tuning.cpu < 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(m_tuning.cpu, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        logging::warning("Failed to pin reactor thread to CPU " + std::to_string(m_tuning.cpu));
+        return;
+    }
+    if (m_tuning.numaLocal && syscall(SYS_set_mempolicy, MPOL_LOCAL, nullptr, 0) != 0) {
+        logging::warning("Failed to set the local NUMA memory policy: " + std::to_string(errno));
+    }
+}
+
+/**
+ * @details mbind    :    
+ *    
+ */
+void Reactor::moveToLocalNode(void* data, size_t size) {
+    if (!m_tuning.numaLocal || m_tuning.cpu < 0) return;
+    const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(data) + page - 1) & ~(page - 1);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(data) + size) & ~(page - 1);
+    if (end <= begin) return;
+    if (syscall(SYS_mbind, begin, end - begin, MPOL_LOCAL, nullptr, 0, MPOL_MF_MOVE) != 0) {
+        logging::warning("Failed to move reactor buffers to the local NUMA node: " + std::to_string(errno));
+    }
+}
+
+void Reactor::initTimers(Connection& conn) {
+    for (size_t kind = 0; kind < TIMER_KIND_COUNT; ++kind) {
+        conn.timers[kind].owner = &conn;
+        conn.timers[kind].kind = static_cast<uint8_t>(kind);
+    }
+    conn.lastActivity = m_now;
+    const uint32_t idleMs = policy(conn).idleMs;
+    if (idleMs) m_timers.arm(conn.timers[static_cast<size_t>(TimerKind::Idle)], m_now + std::chrono::milliseconds(idleMs));
+}
+
+void Reactor::cancelTimers(Connection& conn) {
+    for (TimerNode& timer : conn.timers) {
+        m_timers.cancel(timer);
+    }
+}
+
+void Reactor::updateReadDeadline(Connection& conn) {
+    TimerNode& timer = conn.timers[static_cast<size_t>(TimerKind::Read)];
+    if (!conn.decoder.hasPartial()) {
+        m_timers.cancel(timer);
+        return;
+    }
+    const uint32_t readMs = policy(conn).readMs;
+    if (readMs && !timer.armed()) m_timers.arm(timer, m_now + std::chrono::milliseconds(readMs));
+}
+
+void Reactor::activate(Connection& conn) {
+    if (conn.connectionClass == ConnectionClass::Active) return;
+    conn.connectionClass = ConnectionClass::Active;
+    TimerNode& timer = conn.timers[static_cast<size_t>(TimerKind::Idle)];
+    const uint32_t idleMs = policy(conn).idleMs;
+    if (idleMs) m_timers.arm(timer, conn.lastActivity + std::chrono::milliseconds(idleMs));
+    else m_timers.cancel(timer);
+}
+
+void Reactor::armWriteDeadline(Connection& conn) {
+    TimerNode& timer = conn.timers[static_cast<size_t>(TimerKind::Write)];
+    if (timer.armed()) return;
+    const uint32_t writeMs = policy(conn).writeMs;
+    if (writeMs == 0) return;
+    conn.lastWrite = m_now;
+    m_timers.arm(timer, m_now + std::chrono::milliseconds(writeMs));
+}
+
+void Reactor::cancelWriteDeadline(Connection& conn) {
+    m_timers.cancel(conn.timers[static_cast<size_t>(TimerKind::Write)]);
+}
+
+/**
+ * @details    : closeConnection  
+ *   ,        
+ */
+void Reactor::expireTimers() {
+    m_timers.advance(m_now, [this](TimerNode& timer) {
+        Connection& conn = *static_cast<Connection*>(timer.owner);
+        const TimeoutPolicy& limits = policy(conn);
+        switch (static_cast<TimerKind>(timer.kind)) {
+        case TimerKind::Idle: {
+            if (limits.idleMs == 0) return;
+            const Clock::time_point deadline = conn.lastActivity + std::chrono::milliseconds(limits.idleMs);
+            if (deadline > m_now) {
+                m_timers.arm(timer, deadline);
+                return;
+            }
+            metrics::add(metrics::Counter::Timeouts);
+            closeConnection(conn, "timeout");
+            return;
+        }
+        case TimerKind::Read:
+            metrics::add(metrics::Counter::Timeouts);
+            closeConnection(conn, "read timeout");
+            return;
+        case TimerKind::Write: {
+            const Clock::time_point deadline = conn.lastWrite + std::chrono::milliseconds(limits.writeMs);
+            if (deadline > m_now) {
+                m_timers.arm(timer, deadline);
+                return;
+            }
+            metrics::add(metrics::Counter::Timeouts);
+            closeConnection(conn, "write timeout");
+            return;
+        }
+        default:
+            return;
+        }
+    });
+}
+
+bool Reactor::admitSource(Connection& conn, uint32_t address) {
+    if (!m_admission) return true;
+    const int64_t source = m_admission->admitSource(address);
+    if (source < 0) return false;
+    conn.source = static_cast<uint32_t>(source);
+    return true;
+}
+
+uint32_t Reactor::sourceAddress(const sockaddr_storage& address) {
+    if (address.ss_family == AF_INET) return reinterpret_cast<const sockaddr_in&>(address).sin_addr.s_addr;
+    return htonl(INADDR_LOOPBACK);
+}
+
+void Reactor::releaseSource(Connection& conn) {
+    if (m_admission) m_admission->releaseSource(conn.source);
+    conn.source = AdmissionController::NO_SOURCE;
+}
+
+void Reactor::rejectSocket(SOCKET socket, const char* reason) {
+    logging::warning(std::string("Client rejected: ") + reason);
+    metrics::add(metrics::Counter::Rejects);
+    const std::string msg = protocol::encodeFrame(protocol::MessageType::Error, "Server is busy. Try again later.\n");
+    ::send(socket, msg.data(), msg.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+    closesocket(socket);
+}
+
+void Reactor::pauseForCapacity() {
+    if (!m_accepting) return;
+    metrics::add(metrics::Counter::CapacityPauses);
+    metrics::adjust(metrics::Gauge::AcceptPaused, 1);
+    m_accepting = false;
+    enableAccept(false);
+}
+
+void Reactor::updateAdmission(size_t events) {
+    const AdmissionOptions options = m_admission ? m_admission->options() : AdmissionOptions();
+    const double iterationUs = std::chrono::duration<double, std::micro>(Clock::now() - m_now).count();
+    m_iterationUs += (iterationUs - m_iterationUs) / 8;
+    m_eventDepth += (static_cast<double>(events) - m_eventDepth) / 8;
+
+    const bool slow = options.shedLatencyUs > 0 && m_iterationUs > options.shedLatencyUs;
+    const bool deep = options.shedQueueDepth > 0 && m_eventDepth > options.shedQueueDepth;
+    if (!m_overloaded && (slow || deep)) {
+        m_overloaded = true;
+        if (m_accepting) {
+            metrics::add(metrics::Counter::OverloadPauses);
+            metrics::adjust(metrics::Gauge::AcceptPaused, 1);
+            m_accepting = false;
+            enableAccept(false);
+        }
+        logging::warning("Reactor overloaded, accepting paused");
+        return;
+    }
+    if (m_overloaded && (options.shedLatencyUs == 0 || m_iterationUs < options.shedLatencyUs / 2.0)
+        && (options.shedQueueDepth == 0 || m_eventDepth < options.shedQueueDepth / 2.0)) {
+        m_overloaded = false;
+    }
+
+    const int resumeBelow = m_maxConnections - std::max(1, m_maxConnections / 20);
+    const int count = m_connectionCount.load(std::memory_order_relaxed);
+    if (!m_accepting && !m_overloaded && !m_handingOff && count <= resumeBelow) {
+        metrics::adjust(metrics::Gauge::AcceptPaused, -1);
+        m_accepting = true;
+        enableAccept(true);
+    }
+}
+
+/**
+ * @details    :   listen 
+ *  
+ */
+void Reactor::updateHandoff() {
+    if (!m_handoffRequested.load(std::memory_order_acquire)) return;
+    if (!m_handingOff) {
+        m_handingOff = true;
+        if (m_accepting) {
+            m_accepting = false;
+            enableAccept(false);
+        }
+    }
+    handOffConnections();
+}
+
+/**
+ * @brief     
+ */
+EventLoop::EventLoop(Server& server, SOCKET listenSocket)
+    : m_server(server), m_listenSocket(listenSocket) {
+}
+
+/**
+ * @details eventfd  ,    stop():   
+ *     
+ */
+EventLoop::~EventLoop() {
+    stop();
+    if (m_wakeFd >= 0) {
+        close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+}
+
+/**
+ * @brief     eventfd  epoll   
+ * @return true   
+ */
+bool EventLoop::start() {
+    if (m_running) return true;
+
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epollFd < 0) {
+        std::cerr << "epoll_create1 failed: " << errno << "\n";
+        return false;
+    }
+    if (m_wakeFd < 0) m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wakeFd < 0) {
+        std::cerr << "eventfd failed: " << errno << "\n";
+        stop();
+        return false;
+    }
+
+    net::setNonBlocking(m_listenSocket);
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.fd = m_listenSocket;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_listenSocket, &ev) < 0) {
+        std::cerr << "epoll_ctl failed: " << errno << "\n";
+        stop();
+        return false;
+    }
+    ev.events = EPOLLIN;
+    ev.data.fd = m_wakeFd;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &ev);
+
+    m_running = true;
+    m_thread = std::thread(&EventLoop::run, this);
+    return true;
+}
+
+/**
+ * @brief       
+ */
+void EventLoop::stop() {
+    if (m_running.exchange(false)) {
+        wake();
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    for (auto& entry : m_connections) {
+        m_topics.remove(*entry.second);
+        cancelTimers(*entry.second);
+        releaseSource(*entry.second);
+        unregisterConnection(*entry.second);
+        closesocket(entry.first);
+        m_connectionCount--;
+        metrics::adjust(metrics::Gauge::Connections, -1);
+    }
+    m_connections.clear();
+    if (m_epollFd >= 0) {
+        close(m_epollFd);
+        m_epollFd = -1;
+    }
+}
+
+/**
+ * @brief   
+ * @details      EPOLLET,  
+ *    EAGAIN. epoll_wait   
+ *  ;   eventfd.  spinUs  
+ *      epoll  : 
+ *     ,      .
+ *       ,    NUMA
+ */
+void EventLoop::run() {
+    pinThread();
+    std::vector<epoll_event> events(static_cast<size_t>(m_tuning.eventBatch));
+    m_readBuffer.assign(m_tuning.readBufferSize, 0);
+    const auto spin = std::chrono::microseconds(m_tuning.spinUs);
+    Clock::time_point lastEvent = Clock::now();
+
+    while (m_running) {
+        const bool spinning = m_tuning.spinUs > 0 && m_now - lastEvent < spin;
+        int count = epoll_wait(m_epollFd, events.data(), m_tuning.eventBatch, spinning ? 0 : timerTimeoutMs());
+        m_now = Clock::now();
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            logging::error("epoll_wait failed: " + std::to_string(errno));
+            break;
+        }
+        if (count == 0 && spinning) {
+            //         
+            expireTimers();
+            continue;
+        }
+        if (count > 0) lastEvent = m_now;
+
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == m_listenSocket) {
+                acceptAll();
+                continue;
+            }
+            if (fd == m_wakeFd) {
+                uint64_t value;
+                ssize_t readBytes = read(m_wakeFd, &value, sizeof(value));
+                (void)readBytes;
+                continue;
+            }
+
+            //       
+            auto it = m_connections.find(fd);
+            if (it == m_connections.end()) continue;
+            EpollConnection& conn = *it->second;
+
+            uint32_t flags = events[i].events;
+            //  MSG_ZEROCOPY     (EPOLLERR)
+            if ((flags & EPOLLERR) && !conn.zeroCopyHolds.empty()) reapZeroCopy(conn);
+            if ((flags & EPOLLOUT) && !onWritable(conn)) continue;
+            if (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) onReadable(conn);
+        }
+        if (takeCompletionsPending()) m_server.onPosted(*this);
+        expireTimers();
+        if (!m_zeroCopyOrphans.empty()) releaseOrphans();
+        updateAdmission(static_cast<size_t>(count));
+        updateHandoff();
+    }
+}
+
+/**
+ * @brief      listen
+ * @details    EAGAIN; accept4   
+ * ,   fcntl.    
+ * ,  
+ *     listen.     
+ *  .
+ */
+void EventLoop::acceptAll() {
+    while (m_accepting) {
+        if (m_connectionCount >= m_maxConnections) {
+            pauseForCapacity();
+            return;
+        }
+        sockaddr_storage address{};
+        socklen_t addressSize = sizeof(address);
+        SOCKET clientSocket = accept4(m_listenSocket, (sockaddr*)&address, &addressSize, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (clientSocket == INVALID_SOCKET) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                logging::error("Accept failed: " + std::to_string(errno));
+            }
+            return;
+        }
+
+        auto conn = std::make_unique<EpollConnection>();
+        conn->socket = clientSocket;
+        if (!admitSource(*conn, sourceAddress(address))) {
+            rejectSocket(clientSocket, "too many connections from one address");
+            continue;
+        }
+        EpollConnection* added = addConnection(std::move(conn));
+        if (!added) continue;
+        metrics::add(metrics::Counter::Accepts);
+        logging::connected(clientSocket);
+        m_server.onConnect(*this, *added);
+    }
+}
+
+/**
+ * @brief      epoll     
+ * @return nullptr -  epoll_ctl,  
+ */
+EpollConnection* EventLoop::addConnection(std::unique_ptr<EpollConnection> conn) {
+    const SOCKET clientSocket = conn->socket;
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    ev.data.fd = clientSocket;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, clientSocket, &ev) < 0) {
+        logging::error("epoll_ctl failed: " + std::to_string(errno));
+        releaseSource(*conn);
+        closesocket(clientSocket);
+        return nullptr;
+    }
+    if (m_zeroCopyThreshold > 0) {
+        int enable = 1;
+        conn->zeroCopy = setsockopt(clientSocket, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) == 0;
+    }
+    conn->id = m_nextConnId++;
+    initTimers(*conn);
+    registerConnection(*conn);
+    EpollConnection* added = conn.get();
+    m_connections.emplace(clientSocket, std::move(conn));
+    m_connectionCount++;
+    metrics::adjust(metrics::Gauge::Connections, 1);
+    return added;
+}
+
+/**
+ * @details        , 
+ *        . , 
+ *   ,   :   epoll    
+ */
+Connection* EventLoop::adoptSocket(SOCKET socket, ConnectionClass connectionClass) {
+    net::setNonBlocking(socket);
+    auto conn = std::make_unique<EpollConnection>();
+    conn->socket = socket;
+    conn->connectionClass = connectionClass;
+    sockaddr_storage address{};
+    socklen_t addressSize = sizeof(address);
+    if (getpeername(socket, (sockaddr*)&address, &addressSize) == 0) admitSource(*conn, sourceAddress(address));
+    EpollConnection* added = addConnection(std::move(conn));
+    if (!added) return nullptr;
+    added->zeroCopy = false;
+    if (m_connectionCount >= m_maxConnections) pauseForCapacity();
+    metrics::add(metrics::Counter::Adopted);
+    logging::connected(socket);
+    return added;
+}
+
+/**
+ * @details    epoll :     
+ *        epoll
+ */
+void EventLoop::handOffConnections() {
+    for (auto it = m_connections.begin(); it != m_connections.end();) {
+        EpollConnection& conn = *(it++)->second;
+        if (!m_server.handOff(*this, conn)) continue;
+        epoll_ctl(m_epollFd, EPOLL_CTL_DEL, conn.socket, nullptr);
+        logging::disconnected(conn.socket, "handed off to the new process");
+        forget(conn);
+    }
+}
+
+/**
+ * @brief        
+ * @details     ,  
+ * listen  ,     
+ */
+void EventLoop::enableAccept(bool enable) {
+    epoll_event ev{};
+    ev.events = enable ? EPOLLIN | EPOLLET : 0;
+    ev.data.fd = m_listenSocket;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_MOD, m_listenSocket, &ev) < 0) {
+        logging::error("epoll_ctl failed: " + std::to_string(errno));
+    }
+}
+
+void EventLoop::wake() {
+    uint64_t one = 1;
+    ssize_t written = ::write(m_wakeFd, &one, sizeof(one));
+    (void)written;
+}
+
+void EventLoop::resumeRead(Connection& conn) {
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    ev.data.fd = conn.socket;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_MOD, conn.socket, &ev) < 0) {
+        logging::error("epoll_ctl failed: " + std::to_string(errno));
+    }
+}
+
+Connection* EventLoop::findConnection(SOCKET socket, uint64_t id) {
+    auto it = m_connections.find(socket);
+    return it != m_connections.end() && it->second->id == id ? it->second.get() : nullptr;
+}
+
+/**
+ * @brief    EAGAIN,    
+ * @return false,    
+ */
+bool EventLoop::onReadable(Connection& conn) {
+    while (!conn.readStopped()) {
+        ssize_t bytesReceived = recv(conn.socket, m_readBuffer.data(), m_readBuffer.size(), 0);
+        if (bytesReceived > 0) {
+            conn.lastActivity = m_now;
+            metrics::add(metrics::Counter::BytesIn, static_cast<uint64_t>(bytesReceived));
+            if (!m_server.onData(*this, conn, m_readBuffer.data(), static_cast<size_t>(bytesReceived))) {
+                return false;
+            }
+            continue;
+        }
+        if (bytesReceived == 0) {
+            closeConnection(conn, "graceful disconnect");
+            return false;
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            rearmQuickAck(conn);
+            return true;
+        }
+
+        closeConnection(conn, "socket error: " + std::to_string(errno));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief    
+ * @return false,    
+ */
+bool EventLoop::onWritable(Connection& conn) {
+    while (!conn.pending.empty()) {
+        ssize_t sent = ::send(conn.socket, conn.pending.data(), conn.pending.size(), MSG_NOSIGNAL);
+        if (sent > 0) {
+            conn.pending.consume(static_cast<size_t>(sent));
+            metrics::add(metrics::Counter::BytesOut, static_cast<uint64_t>(sent));
+            conn.lastWrite = m_now;
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+
+        closeConnection(conn, "socket error: " + std::to_string(errno));
+        return false;
+    }
+
+    //  :    ,     
+    conn.pending.reset();
+    cancelWriteDeadline(conn);
+    // ,    ,    
+    if (!m_topics.drain(*this, conn)) return false;
+    if (!conn.pending.empty()) return true;
+    if (conn.readPaused) {
+        conn.readPaused = false;
+        return onReadable(conn);
+    }
+    return true;
+}
+
+bool EventLoop::sendFrame(Connection& conn, protocol::MessageType type, uint8_t flags,
+    const char* payload, size_t size, const buffers::Buffer* storage) {
+    char header[protocol::MAX_HEADER_SIZE];
+    iovec parts[2];
+    parts[0].iov_base = header;
+    parts[0].iov_len = protocol::encodeHeader(header, type, flags, size);
+    parts[1].iov_base = const_cast<char*>(payload);
+    parts[1].iov_len = size;
+
+    auto& econn = static_cast<EpollConnection&>(conn);
+    if (storage && econn.zeroCopy && m_zeroCopyThreshold > 0 && size >= m_zeroCopyThreshold && conn.pending.empty()) {
+        return writeZeroCopy(econn, parts, 2, *storage);
+    }
+    return write(conn, parts, size > 0 ? 2 : 1);
+}
+
+bool EventLoop::sendEncoded(Connection& conn, const buffers::Buffer& frame) {
+    iovec part;
+    part.iov_base = const_cast<char*>(frame.data());
+    part.iov_len = frame.size();
+    return write(conn, &part, 1);
+}
+
+/**
+ * @brief    MSG_ZEROCOPY     
+ *  ;      
+ * @details ENOBUFS ( optmem) ,     
+ *  :     
+ */
+bool EventLoop::writeZeroCopy(EpollConnection& conn, iovec* parts, int count, const buffers::Buffer& storage) {
+    msghdr msg{};
+    msg.msg_iov = parts;
+    msg.msg_iovlen = static_cast<size_t>(count);
+    ssize_t result;
+    do {
+        result = sendmsg(conn.socket, &msg, MSG_NOSIGNAL | MSG_ZEROCOPY);
+    } while (result < 0 && errno == EINTR);
+
+    if (result < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS) {
+            conn.sendError = errno;
+            return false;
+        }
+        return write(conn, parts, count);
+    }
+
+    conn.zeroCopyHolds.push_back({ conn.zeroCopySeq++, storage });
+    metrics::add(metrics::Counter::ZeroCopySends);
+    metrics::add(metrics::Counter::BytesOut, static_cast<uint64_t>(result));
+    size_t sent = static_cast<size_t>(result);
+    int first = 0;
+    while (first < count && sent >= parts[first].iov_len) {
+        sent -= parts[first].iov_len;
+        ++first;
+    }
+    if (first == count) return true;
+    parts[first].iov_base = static_cast<char*>(parts[first].iov_base) + sent;
+    parts[first].iov_len -= sent;
+    return write(conn, parts + first, count - first);
+}
+
+/**
+ * @brief   MSG_ZEROCOPY     
+ *    
+ * @details      [ee_info, ee_data].
+ *  SO_EE_CODE_ZEROCOPY_COPIED ,     
+ *  (,  loopback);     
+ * ,     
+ */
+void EventLoop::reapZeroCopy(EpollConnection& conn) {
+    char control[CMSG_SPACE(sizeof(sock_extended_err)) * 4];
+    while (!conn.zeroCopyHolds.empty()) {
+        msghdr msg{};
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(conn.socket, &msg, MSG_ERRQUEUE) < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            const bool recvErr = (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR)
+                || (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR);
+            if (!recvErr) continue;
+            sock_extended_err err;
+            std::memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+            if (err.ee_errno != 0 || err.ee_origin != SO_EE_ORIGIN_ZEROCOPY) continue;
+
+            const uint32_t first = err.ee_info;
+            const uint32_t span = err.ee_data - first;
+            if (err.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                metrics::add(metrics::Counter::ZeroCopyCopied, uint64_t(span) + 1);
+                conn.zeroCopy = false;
+            }
+            auto& holds = conn.zeroCopyHolds;
+            holds.erase(std::remove_if(holds.begin(), holds.end(),
+                [first, span](const EpollConnection::ZeroCopyHold& hold) { return hold.seq - first <= span; }),
+                holds.end());
+        }
+    }
+}
+
+/**
+ * @brief    ,    
+ */
+void EventLoop::releaseOrphans() {
+    auto expired = std::remove_if(m_zeroCopyOrphans.begin(), m_zeroCopyOrphans.end(),
+        [this](const std::pair<Clock::time_point, buffers::Buffer>& orphan) { return orphan.first <= m_now; });
+    m_zeroCopyOrphans.erase(expired, m_zeroCopyOrphans.end());
+}
+
+/**
+ * @brief   ,    EPOLLOUT
+ * @param count   MAX_IOV 
+ */
+bool EventLoop::write(Connection& conn, const iovec* parts, int count) {
+    iovec rest[MAX_IOV];
+    std::copy(parts, parts + count, rest);
+    int first = 0;
+    auto advance = [&](size_t bytes) {
+        while (first < count && bytes >= rest[first].iov_len) {
+            bytes -= rest[first].iov_len;
+            ++first;
+        }
+        if (first < count) {
+            rest[first].iov_base = static_cast<char*>(rest[first].iov_base) + bytes;
+            rest[first].iov_len -= bytes;
+        }
+    };
+    advance(0);
+
+    //           
+    while (conn.pending.empty() && first < count) {
+        msghdr msg{};
+        msg.msg_iov = rest + first;
+        msg.msg_iovlen = static_cast<size_t>(count - first);
+        ssize_t result = sendmsg(conn.socket, &msg, MSG_NOSIGNAL);
+        if (result > 0) {
+            metrics::add(metrics::Counter::BytesOut, static_cast<uint64_t>(result));
+            advance(static_cast<size_t>(result));
+            continue;
+        }
+        if (result < 0 && errno == EINTR) continue;
+        if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        conn.sendError = errno;
+        return false;
+    }
+
+    for (int i = first; i < count; ++i) {
+        conn.pending.append(static_cast<const char*>(rest[i].iov_base), rest[i].iov_len);
+    }
+    if (!conn.pending.empty()) armWriteDeadline(conn);
+    //  :  ,     
+    if (conn.pending.size() > MAX_PENDING) {
+        conn.readPaused = true;
+    }
+    return true;
+}
+
+/**
+ * @brief       
+ * @warning    conn 
+ */
+void EventLoop::closeConnection(Connection& conn, const std::string& reason) {
+    logging::disconnected(conn.socket, reason);
+    if (conn.session) conn.session->close();
+    forget(static_cast<EpollConnection&>(conn));
+}
+
+/**
+ * @brief         
+ * @warning    econn 
+ */
+void EventLoop::forget(EpollConnection& econn) {
+    Connection& conn = econn;
+    SOCKET clientSocket = conn.socket;
+    m_topics.remove(conn);
+    cancelTimers(conn);
+    releaseSource(conn);
+    unregisterConnection(conn);
+    //         close
+    reapZeroCopy(econn);
+    for (auto& hold : econn.zeroCopyHolds) {
+        m_zeroCopyOrphans.emplace_back(m_now + ZERO_COPY_LINGER, std::move(hold.buffer));
+    }
+    closesocket(clientSocket);
+    m_connections.erase(clientSocket);
+    m_connectionCount--;
+    metrics::adjust(metrics::Gauge::Connections, -1);
+}
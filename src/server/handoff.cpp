@@ -0,0 +1,203 @@
+#include "../include/server/handoff.hpp"
+#include <cstring>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+namespace handoff {
+    namespace {
+        void putU16(std::string& out, size_t value) {
+            out.push_back(static_cast<char>(value & 0xFF));
+            out.push_back(static_cast<char>((value >> 8) & 0xFF));
+        }
+
+        bool getU16(const std::string& in, size_t& offset, size_t& value) {
+            if (in.size() - offset < 2) return false;
+            value = static_cast<uint8_t>(in[offset]) | static_cast<size_t>(static_cast<uint8_t>(in[offset + 1])) << 8;
+            offset += 2;
+            return true;
+        }
+
+        /**
+         * @return false -     sun_path
+         */
+        bool makeAddress(const std::string& path, sockaddr_un& address) {
+            address = sockaddr_un{};
+            address.sun_family = AF_UNIX;
+            if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+                errno = ENAMETOOLONG;
+                return false;
+            }
+            std::memcpy(address.sun_path, path.data(), path.size());
+            return true;
+        }
+
+        /**
+         * @return true -    , false -    
+         */
+        bool waitReadable(int fd, int timeoutMs) {
+            pollfd entry{ fd, POLLIN, 0 };
+            int result;
+            do {
+                result = ::poll(&entry, 1, timeoutMs);
+            } while (result < 0 && errno == EINTR);
+            if (result == 0) errno = ETIMEDOUT;
+            return result > 0;
+        }
+    }
+
+    /**
+     * @details : ,  , ,   (2 ) 
+     *    (2 )  
+     */
+    std::string encode(const ConnectionState& state) {
+        std::string out;
+        out.push_back(static_cast<char>(state.connectionClass));
+        out.push_back(static_cast<char>(state.compressReplies ? 1 : 0));
+        out.push_back(static_cast<char>(state.replyDictionary));
+        putU16(out, state.topics.size());
+        for (const std::string& topic : state.topics) {
+            putU16(out, topic.size());
+            out += topic;
+        }
+        return out;
+    }
+
+    bool decode(const std::string& data, ConnectionState& state) {
+        if (data.size() < 3) return false;
+        state.connectionClass = static_cast<uint8_t>(data[0]);
+        state.compressReplies = data[1] != 0;
+        state.replyDictionary = static_cast<uint8_t>(data[2]);
+        size_t offset = 3;
+        size_t count = 0;
+        if (!getU16(data, offset, count)) return false;
+        state.topics.clear();
+        for (size_t i = 0; i < count; ++i) {
+            size_t size = 0;
+            if (!getU16(data, offset, size) || data.size() - offset < size) return false;
+            state.topics.emplace_back(data, offset, size);
+            offset += size;
+        }
+        return offset == data.size();
+    }
+
+    int listen(const std::string& path) {
+        sockaddr_un address;
+        if (!makeAddress(path, address)) return -1;
+        const int listener = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (listener < 0) return -1;
+        ::unlink(path.c_str());
+        //       : 
+        //    (     accept)
+        if (::bind(listener, (sockaddr*)&address, sizeof(address)) < 0 || ::chmod(path.c_str(), S_IRUSR | S_IWUSR) < 0
+            || ::listen(listener, 1) < 0) {
+            const int error = errno;
+            ::close(listener);
+            errno = error;
+            return -1;
+        }
+        return listener;
+    }
+
+    int accept(int listener, int timeoutMs) {
+        if (!waitReadable(listener, timeoutMs)) return -1;
+        const int channel = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (channel < 0) return -1;
+        ucred peer{};
+        socklen_t size = sizeof(peer);
+        if (::getsockopt(channel, SOL_SOCKET, SO_PEERCRED, &peer, &size) < 0 || peer.uid != ::geteuid()) {
+            ::close(channel);
+            errno = EPERM;
+            return -1;
+        }
+        return channel;
+    }
+
+    int connect(const std::string& path) {
+        sockaddr_un address;
+        if (!makeAddress(path, address)) return -1;
+        const int channel = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (channel < 0) return -1;
+        if (::connect(channel, (sockaddr*)&address, sizeof(address)) < 0) {
+            const int error = errno;
+            ::close(channel);
+            errno = error;
+            return -1;
+        }
+        return channel;
+    }
+
+    bool send(int channel, Kind kind, const std::string& data, const int* fds, size_t count, bool wait) {
+        if (count > MAX_FDS || data.size() + 1 > MAX_MESSAGE) {
+            errno = EMSGSIZE;
+            return false;
+        }
+        const char type = static_cast<char>(kind);
+        iovec parts[2];
+        parts[0].iov_base = const_cast<char*>(&type);
+        parts[0].iov_len = 1;
+        parts[1].iov_base = const_cast<char*>(data.data());
+        parts[1].iov_len = data.size();
+
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_FDS)];
+        msghdr msg{};
+        msg.msg_iov = parts;
+        msg.msg_iovlen = data.empty() ? 1 : 2;
+        if (count > 0) {
+            msg.msg_control = control;
+            msg.msg_controllen = CMSG_SPACE(sizeof(int) * count);
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(int) * count);
+            std::memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * count);
+        }
+        ssize_t sent;
+        do {
+            sent = ::sendmsg(channel, &msg, MSG_NOSIGNAL | (wait ? 0 : MSG_DONTWAIT));
+        } while (sent < 0 && errno == EINTR);
+        return sent >= 0;
+    }
+
+    /**
+     * @details      
+     */
+    bool receive(int channel, Kind& kind, std::string& data, std::vector<int>& fds, int timeoutMs) {
+        fds.clear();
+        if (!waitReadable(channel, timeoutMs)) return false;
+
+        data.resize(MAX_MESSAGE);
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_FDS)];
+        iovec part{ data.data(), data.size() };
+        msghdr msg{};
+        msg.msg_iov = &part;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        ssize_t received;
+        do {
+            received = ::recvmsg(channel, &msg, MSG_CMSG_CLOEXEC);
+        } while (received < 0 && errno == EINTR);
+        if (received <= 0) {
+            if (received == 0) errno = ECONNRESET;
+            return false;
+        }
+
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) continue;
+            const size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            const size_t first = fds.size();
+            fds.resize(first + count);
+            std::memcpy(fds.data() + first, CMSG_DATA(cmsg), sizeof(int) * count);
+        }
+        if (msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) {
+            for (int fd : fds) ::close(fd);
+            fds.clear();
+            errno = EMSGSIZE;
+            return false;
+        }
+        kind = static_cast<Kind>(data[0]);
+        data.resize(static_cast<size_t>(received));
+        data.erase(0, 1);
+        return true;
+    }
+}
@@ -0,0 +1,224 @@
+#include "../include/server/input_validator.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define VALIDATOR_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(VALIDATOR_X86) && (defined(__GNUC__) || defined(__clang__))
+#define VALIDATOR_TARGET_AVX2 __attribute__((target("avx2")))
+#define VALIDATOR_TARGET_SSE2 __attribute__((target("sse2")))
+#else
+#define VALIDATOR_TARGET_AVX2
+#define VALIDATOR_TARGET_SSE2
+#endif
+
+namespace {
+    /**
+     * @brief  :  ,  TAB  LF,  DEL
+     */
+    inline bool isInvalid(unsigned char c) {
+        return (c < 32 && c != 0x09 && c != 0x0A) || c == 0x7F;
+    }
+
+    size_t findScalar(const char* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            if (isInvalid(static_cast<unsigned char>(data[i]))) return i;
+        }
+        return InputValidator::npos;
+    }
+
+    inline int lowestBit(unsigned mask) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+#ifdef VALIDATOR_X86
+    /**
+     * @brief    16- 
+     * @details  ,  min(c, 31) == c ( c <= 31),
+     *    TAB/LF,   c == DEL.    AVX2-, 
+     *   VEX-      SSE/AVX
+     */
+    VALIDATOR_TARGET_SSE2 inline unsigned badMask16(__m128i v) {
+        const __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(31)), v);
+        const __m128i allowed = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(0x09)), _mm_cmpeq_epi8(v, _mm_set1_epi8(0x0A)));
+        const __m128i bad = _mm_or_si128(_mm_andnot_si128(allowed, control), _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7F)));
+        return static_cast<unsigned>(_mm_movemask_epi8(bad));
+    }
+
+    VALIDATOR_TARGET_AVX2 inline __m256i badBytes32(__m256i v) {
+        const __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(31)), v);
+        const __m256i allowed = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x09)), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x0A)));
+        return _mm256_or_si256(_mm256_andnot_si256(allowed, control), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7F)));
+    }
+
+    /**
+     * @details      
+     *  16 :   i  ,  
+     *        i
+     */
+    VALIDATOR_TARGET_SSE2 size_t findSse2(const char* data, size_t size) {
+        if (size < 16) return findScalar(data, size);
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16) {
+            const unsigned mask = badMask16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+            if (mask) return i + lowestBit(mask);
+        }
+        if (i < size) {
+            const size_t last = size - 16;
+            const unsigned mask = badMask16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + last)));
+            if (mask) return last + lowestBit(mask);
+        }
+        return InputValidator::npos;
+    }
+
+    VALIDATOR_TARGET_AVX2 size_t findAvx2(const char* data, size_t size) {
+        if (size < 32) {
+            if (size < 16) return findScalar(data, size);
+            unsigned mask = badMask16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+            if (mask) return lowestBit(mask);
+            mask = badMask16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + size - 16)));
+            return mask ? size - 16 + lowestBit(mask) : InputValidator::npos;
+        }
+        size_t i = 0;
+        //    :    64 
+        for (; i + 64 <= size; i += 64) {
+            const __m256i badA = badBytes32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+            const __m256i badB = badBytes32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32)));
+            const __m256i any = _mm256_or_si256(badA, badB);
+            if (!_mm256_testz_si256(any, any)) {
+                const unsigned maskA = static_cast<unsigned>(_mm256_movemask_epi8(badA));
+                if (maskA) return i + lowestBit(maskA);
+                return i + 32 + lowestBit(static_cast<unsigned>(_mm256_movemask_epi8(badB)));
+            }
+        }
+        for (; i + 32 <= size; i += 32) {
+            const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+                badBytes32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)))));
+            if (mask) return i + lowestBit(mask);
+        }
+        if (i < size) {
+            const size_t last = size - 32;
+            const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+                badBytes32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + last)))));
+            if (mask) return last + lowestBit(mask);
+        }
+        return InputValidator::npos;
+    }
+
+    bool cpuHasAvx2() {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return false;
+#endif
+    }
+
+    bool cpuHasSse2() {
+#if defined(__x86_64__) || defined(_M_X64)
+        return true; //     x86-64
+#elif defined(__GNUC__) || defined(__clang__)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+#else
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+#endif
+    }
+#endif
+}
+
+bool InputValidator::isSupported(Kernel kernel) {
+    switch (kernel) {
+    case Kernel::Scalar:
+        return true;
+#ifdef VALIDATOR_X86
+    case Kernel::Sse2:
+        return cpuHasSse2();
+    case Kernel::Avx2:
+        return cpuHasAvx2();
+#endif
+    default:
+        return false;
+    }
+}
+
+size_t InputValidator::findInvalid(Kernel kernel, const char* data, size_t size) {
+    switch (kernel) {
+#ifdef VALIDATOR_X86
+    case Kernel::Sse2:
+        return findSse2(data, size);
+    case Kernel::Avx2:
+        return findAvx2(data, size);
+#endif
+    default:
+        return findScalar(data, size);
+    }
+}
+
+const char* InputValidator::kernelName(Kernel kernel) {
+    switch (kernel) {
+    case Kernel::Sse2:
+        return "sse2";
+    case Kernel::Avx2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+/**
+ * @details     
+ *   
+ */
+const InputValidator::ActiveKernel& InputValidator::activeKernel() {
+    static const ActiveKernel active = []() -> ActiveKernel {
+#ifdef VALIDATOR_X86
+        if (cpuHasAvx2()) return { Kernel::Avx2, &findAvx2 };
+        if (cpuHasSse2()) return { Kernel::Sse2, &findSse2 };
+#endif
+        return { Kernel::Scalar, &findScalar };
+    }();
+    return active;
+}
+
+/**
+ * @details       ,  
+ *    
+ */
+InputValidator::BatchResult InputValidator::validateBatch(const protocol::FrameView* frames, size_t count) {
+    const FindFunction find = activeKernel().find;
+    BatchResult result;
+    for (result.frame = 0; result.frame < count; ++result.frame) {
+        const protocol::FrameView& frame = frames[result.frame];
+        if (frame.size == 0 || frame.size > MAX_MESSAGE_LENGTH) {
+            result.offset = npos;
+            return result;
+        }
+        result.offset = find(frame.payload, frame.size);
+        if (result.offset != npos) return result;
+    }
+    result.offset = npos;
+    return result;
+}
@@ -0,0 +1,314 @@
+#include "../include/server/logger.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+
+namespace logging {
+    /**
+     * @struct Logger::Ring
+     * @brief SPSC-  :  -,   .
+     */
+    struct Logger::Ring {
+        alignas(64) std::atomic<uint64_t> head{ 0 }; //    
+        alignas(64) std::atomic<uint64_t> tail{ 0 }; //    
+        uint64_t cachedHead = 0; //  head  :    -
+        unsigned sampleCounter = 0; //    
+        std::atomic<uint64_t> dropped{ 0 }; //   
+        std::atomic<uint64_t> sampledOut{ 0 };
+        std::atomic<bool> retired{ false }; //  ,    
+        std::unique_ptr<LogRecord[]> records{ new LogRecord[RING_CAPACITY] };
+    };
+
+    /**
+     * @struct Logger::RingHandle
+     * @brief       
+     *       .
+     */
+    struct Logger::RingHandle {
+        Ring* ring = nullptr;
+
+        explicit RingHandle(Logger& logger) {
+            auto owned = std::make_unique<Ring>();
+            ring = owned.get();
+            std::lock_guard<std::mutex> lock(logger.m_ringsMutex);
+            logger.m_rings.push_back(std::move(owned));
+        }
+        ~RingHandle() { ring->retired.store(true, std::memory_order_release); }
+    };
+
+    namespace {
+        //     ,    RMW
+        void bump(std::atomic<uint64_t>& counter) {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        void appendNumber(std::string& out, uint64_t value) {
+            char digits[24];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            out.append(digits, result.ptr);
+        }
+
+        void appendTwo(std::string& out, int value) {
+            out.push_back(static_cast<char>('0' + value / 10));
+            out.push_back(static_cast<char>('0' + value % 10));
+        }
+
+        /**
+         * @brief      "[::.] \n"
+         * @details       
+         */
+        void format(std::string& out, const LogRecord& record) {
+            const std::time_t seconds = static_cast<std::time_t>(record.timestamp / 1000000000);
+            const int millis = static_cast<int>(record.timestamp / 1000000 % 1000);
+            std::tm local{};
+#ifdef _WIN32
+            localtime_s(&local, &seconds);
+#else
+            localtime_r(&seconds, &local);
+#endif
+            out.push_back('[');
+            appendTwo(out, local.tm_hour);
+            out.push_back(':');
+            appendTwo(out, local.tm_min);
+            out.push_back(':');
+            appendTwo(out, local.tm_sec);
+            out.push_back('.');
+            out.push_back(static_cast<char>('0' + millis / 100));
+            appendTwo(out, millis % 100);
+            out.append("] ");
+
+            switch (record.event) {
+            case LogEvent::Connected:
+                out.append("New client connected. Socket: ");
+                appendNumber(out, record.connection);
+                break;
+            case LogEvent::Disconnected:
+                out.append("Client [");
+                appendNumber(out, record.connection);
+                out.append("] disconnected. Reason: ");
+                out.append(record.text, record.textSize);
+                break;
+            case LogEvent::Message:
+                out.append("Client [");
+                appendNumber(out, record.connection);
+                out.append("]: ");
+                out.append(record.text, record.textSize);
+                if (record.size > record.textSize) {
+                    out.append("... (");
+                    appendNumber(out, record.size);
+                    out.append(" bytes)");
+                }
+                break;
+            default:
+                out.append(record.text, record.textSize);
+                break;
+            }
+            out.push_back('\n');
+        }
+
+        void fill(LogRecord& record, LogLevel level, LogEvent event, uint64_t connection, uint64_t size,
+            const char* text, size_t textSize) {
+            record.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            record.connection = connection;
+            record.size = size;
+            record.level = level;
+            record.event = event;
+            record.textSize = static_cast<uint16_t>(std::min(textSize, LogRecord::TEXT_SIZE));
+            if (record.textSize) std::memcpy(record.text, text, record.textSize);
+        }
+
+        void output(const std::string& text, bool error) {
+            if (text.empty()) return;
+            FILE* stream = error ? stderr : stdout;
+            std::fwrite(text.data(), 1, text.size(), stream);
+            std::fflush(stream);
+        }
+    }
+
+    /**
+     * @details   :    
+     *   
+     */
+    Logger& Logger::instance() {
+        static Logger* logger = new Logger();
+        return *logger;
+    }
+
+    void Logger::start() {
+        if (m_running.exchange(true)) return;
+        m_thread = std::thread(&Logger::run, this);
+    }
+
+    void Logger::stop() {
+        if (!m_running.exchange(false)) return;
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    Logger::Ring& Logger::localRing() {
+        thread_local RingHandle handle(*this);
+        return *handle.ring;
+    }
+
+    /**
+     * @details        
+     */
+    bool Logger::write(LogLevel level, LogEvent event, uint64_t connection, uint64_t size,
+        const char* text, size_t textSize) {
+        if (!m_running.load(std::memory_order_acquire)) {
+            LogRecord record;
+            fill(record, level, event, connection, size, text, textSize);
+            std::string line;
+            format(line, record);
+            output(line, level >= LogLevel::Warning);
+            m_written.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        Ring& ring = localRing();
+        const uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+        if (tail - ring.cachedHead >= RING_CAPACITY) {
+            ring.cachedHead = ring.head.load(std::memory_order_acquire);
+            if (tail - ring.cachedHead >= RING_CAPACITY) {
+                bump(ring.dropped);
+                return false;
+            }
+        }
+        fill(ring.records[tail & (RING_CAPACITY - 1)], level, event, connection, size, text, textSize);
+        ring.tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Logger::sampleMessage() {
+        const unsigned rate = m_sampleRate.load(std::memory_order_relaxed);
+        if (rate == 1) return true;
+        Ring& ring = localRing();
+        if (rate != 0 && ++ring.sampleCounter >= rate) {
+            ring.sampleCounter = 0;
+            return true;
+        }
+        bump(ring.sampledOut);
+        return false;
+    }
+
+    LoggerStats Logger::stats() const {
+        LoggerStats result;
+        result.written = m_written.load(std::memory_order_relaxed);
+        result.dropped = m_retiredDropped.load(std::memory_order_relaxed);
+        result.sampledOut = m_retiredSampled.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        for (const auto& ring : m_rings) {
+            result.dropped += ring->dropped.load(std::memory_order_relaxed);
+            result.sampledOut += ring->sampledOut.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    /**
+     * @brief   : , ,  
+     * @details   ,    1-10 , 
+     *     
+     */
+    void Logger::run() {
+        std::vector<LogRecord> batch;
+        batch.reserve(RING_CAPACITY);
+        auto lastReport = std::chrono::steady_clock::now();
+        int idleMs = 1;
+
+        while (m_running.load(std::memory_order_acquire)) {
+            if (drain(batch) > 0) {
+                flush(batch);
+                idleMs = 1;
+            }
+            else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(idleMs));
+                idleMs = std::min(idleMs * 2, 10);
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (now - lastReport >= std::chrono::seconds(1)) {
+                lastReport = now;
+                reportDrops();
+            }
+        }
+        while (drain(batch) > 0) {
+            flush(batch);
+        }
+        reportDrops();
+    }
+
+    /**
+     * @brief      batch    
+     *  
+     */
+    size_t Logger::drain(std::vector<LogRecord>& batch) {
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        for (auto it = m_rings.begin(); it != m_rings.end();) {
+            Ring& ring = **it;
+            const bool retired = ring.retired.load(std::memory_order_acquire);
+            uint64_t head = ring.head.load(std::memory_order_relaxed);
+            const uint64_t tail = ring.tail.load(std::memory_order_acquire);
+            for (; head != tail; ++head) {
+                batch.push_back(ring.records[head & (RING_CAPACITY - 1)]);
+            }
+            ring.head.store(head, std::memory_order_release);
+
+            if (retired) {
+                m_retiredDropped.fetch_add(ring.dropped.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                m_retiredSampled.fetch_add(ring.sampledOut.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                it = m_rings.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        return batch.size();
+    }
+
+    /**
+     * @brief       :   write
+     *  stdout  stderr
+     */
+    void Logger::flush(std::vector<LogRecord>& batch) {
+        std::stable_sort(batch.begin(), batch.end(),
+            [](const LogRecord& a, const LogRecord& b) { return a.timestamp < b.timestamp; });
+        std::string out;
+        std::string err;
+        out.reserve(batch.size() * 64);
+        for (const LogRecord& record : batch) {
+            format(record.level >= LogLevel::Warning ? err : out, record);
+        }
+        output(out, false);
+        output(err, true);
+        m_written.fetch_add(batch.size(), std::memory_order_relaxed);
+        batch.clear();
+    }
+
+    void Logger::reportDrops() {
+        const uint64_t dropped = stats().dropped;
+        if (dropped > m_reportedDrops) {
+            std::string line = "Logger: ";
+            appendNumber(line, dropped - m_reportedDrops);
+            line.append(" records dropped (ring overflow)\n");
+            output(line, true);
+            m_reportedDrops = dropped;
+        }
+    }
+
+    bool parseLevel(const std::string& name, LogLevel& level) {
+        static const struct { const char* name; LogLevel level; } LEVELS[] = {
+            { "debug", LogLevel::Debug }, { "info", LogLevel::Info }, { "warning", LogLevel::Warning },
+            { "error", LogLevel::Error }, { "off", LogLevel::Off }
+        };
+        for (const auto& entry : LEVELS) {
+            if (name == entry.name) {
+                level = entry.level;
+                return true;
+            }
+        }
+        return false;
+    }
+}
@@ -0,0 +1,289 @@
+#include "../include/server/metrics.hpp"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#ifndef _WIN32
+#include <sys/resource.h>
+#else
+#include <windows.h>
+#endif
+
+namespace metrics {
+    namespace {
+        /**
+         * @struct Registry
+         * @brief       .
+         */
+        struct Registry {
+            std::mutex mutex; //    ,    
+            std::vector<std::unique_ptr<ThreadMetrics>> threads;
+            ThreadMetrics retired;
+            const std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+
+            static Registry& instance() {
+                static Registry* registry = new Registry(); //   thread_local-
+                return *registry;
+            }
+        };
+
+        struct MetricName {
+            const char* prometheus;
+            const char* json;
+            const char* help;
+        };
+
+        const MetricName COUNTER_NAMES[COUNTER_COUNT] = {
+            { "server_accepts_total", "accepts", "Accepted connections." },
+            { "server_rejects_total", "rejects", "Connections rejected by admission control." },
+            { "server_received_bytes_total", "bytes_in", "Bytes received from clients." },
+            { "server_sent_bytes_total", "bytes_out", "Bytes sent to clients." },
+            { "server_messages_total", "messages", "Messages processed." },
+            { "server_validation_failures_total", "validation_failures", "Messages rejected by the input validator." },
+            { "server_protocol_errors_total", "protocol_errors", "Malformed or oversized frames." },
+            { "server_timeouts_total", "timeouts", "Connections closed by a timeout." },
+            { "server_zerocopy_sends_total", "zerocopy_sends", "Sends submitted with MSG_ZEROCOPY or IORING_OP_SEND_ZC." },
+            { "server_zerocopy_copied_total", "zerocopy_copied", "Zero-copy sends the kernel completed by copying." },
+            { "server_rate_limited_total", "rate_limited", "Messages rejected by the per-connection rate limit." },
+            { "server_capacity_pauses_total", "capacity_pauses", "Times a reactor stopped accepting at the connection limit." },
+            { "server_overload_pauses_total", "overload_pauses", "Times a reactor stopped accepting because it was overloaded." },
+            { "server_pool_jobs_total", "pool_jobs", "Messages handed to the worker pool." },
+            { "server_pool_steals_total", "pool_steals", "Worker pool jobs stolen from another worker's queue." },
+            { "server_pool_rejected_total", "pool_rejected", "Messages rejected because the worker pool queues were full." },
+            { "server_pubsub_published_total", "pubsub_published", "Messages published to topics." },
+            { "server_pubsub_delivered_total", "pubsub_delivered", "Broadcast frames handed to reactors for subscribers." },
+            { "server_pubsub_dropped_total", "pubsub_dropped", "Broadcast messages dropped or coalesced for slow subscribers." },
+            { "server_pubsub_disconnects_total", "pubsub_disconnects", "Slow subscribers disconnected by the Disconnect policy." },
+            { "server_compressed_frames_in_total", "compressed_in", "Received frames with a compressed payload." },
+            { "server_decompress_input_bytes_total", "decompress_bytes_in", "Compressed payload bytes received." },
+            { "server_decompress_output_bytes_total", "decompress_bytes_out", "Payload bytes produced by decompression." },
+            { "server_decompress_nanoseconds_total", "decompress_ns", "Time spent decompressing payloads, in nanoseconds." },
+            { "server_compressed_frames_out_total", "compressed_out", "Sent frames with a compressed payload." },
+            { "server_compress_input_bytes_total", "compress_bytes_in", "Reply payload bytes passed to the compressor." },
+            { "server_compress_output_bytes_total", "compress_bytes_out", "Reply payload bytes sent for the compressor input, compressed or not." },
+            { "server_compress_nanoseconds_total", "compress_ns", "Time spent compressing replies, in nanoseconds." },
+            { "server_compress_skipped_total", "compress_skipped", "Replies sent uncompressed because compression did not shrink them." },
+            { "server_handed_off_total", "handed_off", "Connections passed to a new server process during an upgrade." },
+            { "server_adopted_total", "adopted", "Connections taken over from the previous server process." },
+            { "server_capture_frames_total", "capture_frames", "Received frames written to the capture file." },
+            { "server_capture_dropped_total", "capture_dropped", "Received frames not captured because the capture file was full." },
+        };
+
+        const MetricName GAUGE_NAMES[GAUGE_COUNT] = {
+            { "server_connections", "connections", "Open client connections." },
+            { "server_accept_paused", "accept_paused", "Reactors that are not accepting new connections." },
+            { "server_pool_workers", "pool_workers", "Worker pool threads." },
+            { "server_pool_queued", "pool_queued", "Jobs waiting in the worker pool queues." },
+            { "server_subscriptions", "subscriptions", "Topic subscriptions." },
+            { "server_pubsub_queued", "pubsub_queued", "Broadcast messages waiting in slow subscribers' queues." },
+        };
+
+        //  Prometheus-:    1   34 
+        constexpr unsigned FIRST_BOUND_BITS = 10;
+        constexpr unsigned LAST_BOUND_BITS = 35;
+
+        template <typename T>
+        void addRelaxed(std::atomic<T>& target, T value) {
+            target.store(target.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief      (user + system)
+         */
+        double processCpuSeconds() {
+#ifdef _WIN32
+            FILETIME creation, exit, kernel, user;
+            if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) return 0;
+            auto seconds = [](const FILETIME& time) {
+                return static_cast<double>((uint64_t(time.dwHighDateTime) << 32) | time.dwLowDateTime) * 1e-7;
+                };
+            return seconds(kernel) + seconds(user);
+#else
+            rusage usage{};
+            if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+            return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)
+                + static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+        }
+
+        void appendf(std::string& out, const char* format, ...) {
+            char line[256];
+            va_list args;
+            va_start(args, format);
+            const int size = std::vsnprintf(line, sizeof(line), format, args);
+            va_end(args);
+            if (size > 0) out.append(line, std::min(static_cast<size_t>(size), sizeof(line) - 1));
+        }
+    }
+
+    void Histogram::collect(HistogramSnapshot& out) const {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            out.buckets[i] += m_buckets[i].load(std::memory_order_relaxed);
+        }
+        out.count += m_count.load(std::memory_order_relaxed);
+        out.sum += m_sum.load(std::memory_order_relaxed);
+        out.max = std::max(out.max, m_max.load(std::memory_order_relaxed));
+    }
+
+    void Histogram::merge(const Histogram& other) {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            bump(m_buckets[i], other.m_buckets[i].load(std::memory_order_relaxed));
+        }
+        bump(m_count, other.m_count.load(std::memory_order_relaxed));
+        bump(m_sum, other.m_sum.load(std::memory_order_relaxed));
+        m_max.store(std::max(m_max.load(std::memory_order_relaxed), other.m_max.load(std::memory_order_relaxed)),
+            std::memory_order_relaxed);
+    }
+
+    void ThreadMetrics::merge(const ThreadMetrics& other) {
+        for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+            addRelaxed(counters[i], other.counters[i].load(std::memory_order_relaxed));
+        }
+        for (size_t i = 0; i < GAUGE_COUNT; ++i) {
+            addRelaxed(gauges[i], other.gauges[i].load(std::memory_order_relaxed));
+        }
+        echoLatency.merge(other.echoLatency);
+    }
+
+    namespace detail {
+        ThreadMetrics* attach() {
+            auto owned = std::make_unique<ThreadMetrics>();
+            ThreadMetrics* metrics = owned.get();
+            Registry& registry = Registry::instance();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.threads.push_back(std::move(owned));
+            return metrics;
+        }
+
+        /**
+         * @brief        
+         * @details    ,   ,  
+         *      
+         */
+        void detach(ThreadMetrics* metrics) {
+            Registry& registry = Registry::instance();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.retired.merge(*metrics);
+            auto found = std::find_if(registry.threads.begin(), registry.threads.end(),
+                [metrics](const std::unique_ptr<ThreadMetrics>& entry) { return entry.get() == metrics; });
+            if (found != registry.threads.end()) registry.threads.erase(found);
+        }
+    }
+
+    uint64_t HistogramSnapshot::percentile(double percentile) const {
+        if (count == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(count) + 0.5);
+        rank = std::max<uint64_t>(1, std::min(rank, count));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen >= rank) return std::min(Histogram::lowerBound(i + 1) - 1, max);
+        }
+        return max;
+    }
+
+    uint64_t HistogramSnapshot::countBelow(uint64_t bound) const {
+        uint64_t total = 0;
+        for (size_t i = 0; i < buckets.size() && Histogram::lowerBound(i + 1) - 1 <= bound; ++i) {
+            total += buckets[i];
+        }
+        return total;
+    }
+
+    /**
+     * @details       : ,
+     *   ,     
+     */
+    Snapshot snapshot() {
+        Snapshot result;
+        Registry& registry = Registry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto collect = [&result](const ThreadMetrics& metrics) {
+            for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+                result.counters[i] += metrics.counters[i].load(std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < GAUGE_COUNT; ++i) {
+                result.gauges[i] += metrics.gauges[i].load(std::memory_order_relaxed);
+            }
+            metrics.echoLatency.collect(result.echoLatency);
+            };
+        collect(registry.retired);
+        for (const auto& metrics : registry.threads) {
+            collect(*metrics);
+        }
+        result.uptimeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - registry.started).count();
+        result.cpuSeconds = processCpuSeconds();
+        return result;
+    }
+
+    std::string formatPrometheus(const Snapshot& snapshot) {
+        std::string out;
+        out.reserve(4096);
+        for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+            const MetricName& name = COUNTER_NAMES[i];
+            appendf(out, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n", name.prometheus, name.help,
+                name.prometheus, name.prometheus, static_cast<unsigned long long>(snapshot.counters[i]));
+        }
+        for (size_t i = 0; i < GAUGE_COUNT; ++i) {
+            const MetricName& name = GAUGE_NAMES[i];
+            appendf(out, "# HELP %s %s\n# TYPE %s gauge\n%s %lld\n", name.prometheus, name.help,
+                name.prometheus, name.prometheus, static_cast<long long>(snapshot.gauges[i]));
+        }
+
+        const HistogramSnapshot& latency = snapshot.echoLatency;
+        const char* histogram = "server_echo_latency_seconds";
+        appendf(out, "# HELP %s Time from receiving a frame to handing its echo to the kernel.\n# TYPE %s histogram\n",
+            histogram, histogram);
+        for (unsigned bits = FIRST_BOUND_BITS; bits <= LAST_BOUND_BITS; ++bits) {
+            const uint64_t bound = uint64_t(1) << bits;
+            appendf(out, "%s_bucket{le=\"%g\"} %llu\n", histogram, static_cast<double>(bound) * 1e-9,
+                static_cast<unsigned long long>(latency.countBelow(bound)));
+        }
+        appendf(out, "%s_bucket{le=\"+Inf\"} %llu\n%s_sum %.9f\n%s_count %llu\n", histogram,
+            static_cast<unsigned long long>(latency.count), histogram, static_cast<double>(latency.sum) * 1e-9,
+            histogram, static_cast<unsigned long long>(latency.count));
+        appendf(out, "# HELP server_uptime_seconds Seconds since the first metric was recorded.\n"
+            "# TYPE server_uptime_seconds gauge\nserver_uptime_seconds %.3f\n", snapshot.uptimeSeconds);
+        appendf(out, "# HELP process_cpu_seconds_total Total user and system CPU time spent in seconds.\n"
+            "# TYPE process_cpu_seconds_total counter\nprocess_cpu_seconds_total %.3f\n", snapshot.cpuSeconds);
+        return out;
+    }
+
+    std::string formatJson(const Snapshot& snapshot) {
+        std::string out;
+        out.reserve(1024);
+        appendf(out, "{\"uptime_seconds\":%.3f,\"cpu_seconds\":%.3f,\"counters\":{", snapshot.uptimeSeconds, snapshot.cpuSeconds);
+        for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+            appendf(out, "%s\"%s\":%llu", i ? "," : "", COUNTER_NAMES[i].json,
+                static_cast<unsigned long long>(snapshot.counters[i]));
+        }
+        out.append("},\"gauges\":{");
+        for (size_t i = 0; i < GAUGE_COUNT; ++i) {
+            appendf(out, "%s\"%s\":%lld", i ? "," : "", GAUGE_NAMES[i].json,
+                static_cast<long long>(snapshot.gauges[i]));
+        }
+        //   -    ;  -    
+        auto counter = [&snapshot](Counter counter) {
+            return static_cast<double>(snapshot.counters[static_cast<size_t>(counter)]);
+        };
+        auto ratio = [](double numerator, double denominator) { return denominator > 0 ? numerator / denominator : 0.0; };
+        appendf(out, "},\"compression\":{\"ratio_in\":%.3f,\"ratio_out\":%.3f,"
+            "\"decompress_ns_per_byte\":%.3f,\"compress_ns_per_byte\":%.3f",
+            ratio(counter(Counter::DecompressedBytesOut), counter(Counter::DecompressedBytesIn)),
+            ratio(counter(Counter::CompressBytesIn), counter(Counter::CompressBytesOut)),
+            ratio(counter(Counter::DecompressNanos), counter(Counter::DecompressedBytesOut)),
+            ratio(counter(Counter::CompressNanos), counter(Counter::CompressBytesIn)));
+        const HistogramSnapshot& latency = snapshot.echoLatency;
+        const double mean = latency.count ? static_cast<double>(latency.sum) / static_cast<double>(latency.count) : 0.0;
+        appendf(out, "},\"echo_latency_us\":{\"count\":%llu,\"mean\":%.3f,\"p50\":%.3f,\"p90\":%.3f,"
+            "\"p99\":%.3f,\"p999\":%.3f,\"max\":%.3f}}\n",
+            static_cast<unsigned long long>(latency.count), mean / 1000.0,
+            static_cast<double>(latency.percentile(50.0)) / 1000.0,
+            static_cast<double>(latency.percentile(90.0)) / 1000.0,
+            static_cast<double>(latency.percentile(99.0)) / 1000.0,
+            static_cast<double>(latency.percentile(99.9)) / 1000.0,
+            static_cast<double>(latency.max) / 1000.0);
+        return out;
+    }
+}
@@ -0,0 +1,161 @@
+#include "../include/server/pubsub.hpp"
+#include "../include/server/event_loop.hpp"
+#include "../include/server/metrics.hpp"
+
+bool TopicTable::subscribe(Connection& conn, std::string_view topic) {
+    if (!conn.subscriber) conn.subscriber = std::make_unique<Subscriber>();
+    Subscriber& subscriber = *conn.subscriber;
+    for (const Subscriber::Membership& membership : subscriber.topics) {
+        if (membership.topic->name == topic) return true;
+    }
+    if (subscriber.topics.size() >= m_options.maxTopicsPerConnection) return false;
+
+    //  unordered_map     , 
+    //     
+    auto found = m_topics.try_emplace(std::string(topic)).first;
+    Subscriber::Topic& entry = found->second;
+    if (entry.name.empty()) entry.name = found->first;
+    subscriber.topics.push_back({ &entry, entry.subscribers.size() });
+    entry.subscribers.push_back(&conn);
+    entry.queued.push_back(Subscriber::Topic::NO_SLOT);
+    metrics::adjust(metrics::Gauge::Subscriptions, 1);
+    return true;
+}
+
+bool TopicTable::unsubscribe(Connection& conn, std::string_view topic) {
+    if (!conn.subscriber) return false;
+    auto& topics = conn.subscriber->topics;
+    for (auto it = topics.begin(); it != topics.end(); ++it) {
+        if (it->topic->name != topic) continue;
+        Subscriber::Topic& entry = *it->topic;
+        const size_t index = it->index;
+        topics.erase(it);
+        detach(entry, index);
+        return true;
+    }
+    return false;
+}
+
+void TopicTable::remove(Connection& conn) {
+    if (!conn.subscriber) return;
+    Subscriber& subscriber = *conn.subscriber;
+    for (const Subscriber::Membership& membership : subscriber.topics) {
+        detach(*membership.topic, membership.index);
+    }
+    subscriber.topics.clear();
+    metrics::adjust(metrics::Gauge::PubSubQueued, -static_cast<int64_t>(subscriber.outbox.size()));
+    subscriber.outboxBase += subscriber.outbox.size();
+    subscriber.outbox.clear();
+}
+
+/**
+ * @details       ;
+ *           
+ */
+void TopicTable::detach(Subscriber::Topic& topic, size_t index) {
+    const size_t last = topic.subscribers.size() - 1;
+    if (index != last) {
+        Connection* moved = topic.subscribers[last];
+        topic.subscribers[index] = moved;
+        topic.queued[index] = topic.queued[last];
+        for (Subscriber::Membership& membership : moved->subscriber->topics) {
+            if (membership.topic == &topic) {
+                membership.index = index;
+                break;
+            }
+        }
+    }
+    topic.subscribers.pop_back();
+    topic.queued.pop_back();
+    metrics::adjust(metrics::Gauge::Subscriptions, -1);
+    if (topic.subscribers.empty()) {
+        //  : topic     
+        m_topics.erase(std::string(topic.name));
+    }
+}
+
+const char* TopicTable::fanOut(Reactor& loop, std::string_view topic, const buffers::Buffer& frame, Connection* current) {
+    auto found = m_topics.find(std::string(topic));
+    if (found == m_topics.end()) return nullptr;
+
+    const char* currentReason = nullptr;
+    m_closing.clear();
+    Subscriber::Topic& entry = found->second;
+    for (size_t i = 0; i < entry.subscribers.size(); ++i) {
+        Connection* conn = entry.subscribers[i];
+        const char* reason = deliver(loop, *conn, topic, frame, entry.queued[i]);
+        if (!reason) continue;
+        if (conn == current) {
+            currentReason = reason;
+        }
+        else {
+            m_closing.emplace_back(conn, reason);
+        }
+    }
+    //    ,    
+    for (const auto& closing : m_closing) {
+        loop.closeConnection(*closing.first, closing.second);
+    }
+    m_closing.clear();
+    return currentReason;
+}
+
+/**
+ * @details     ,    
+ * ,     .  Coalesce   
+ *    ,     
+ *  ,      
+ */
+const char* TopicTable::deliver(Reactor& loop, Connection& conn, std::string_view topic, const buffers::Buffer& frame, uint64_t& slot) {
+    Subscriber& subscriber = *conn.subscriber;
+    if (subscriber.outbox.empty() && loop.queuedBytes(conn) < m_options.writeHighWater) {
+        metrics::add(metrics::Counter::PubSubDelivered);
+        return loop.sendEncoded(conn, frame) ? nullptr : "socket error";
+    }
+
+    auto& outbox = subscriber.outbox;
+    if (m_options.policy == SlowSubscriberPolicy::Coalesce) {
+        const uint64_t position = slot - subscriber.outboxBase;
+        if (slot != Subscriber::Topic::NO_SLOT && slot >= subscriber.outboxBase && position < outbox.size()
+            && outbox[position].topic == topic) {
+            //     ,    
+            Subscriber::Queued& same = outbox[position];
+            same.frame = frame;
+            same.topic = topic;
+            metrics::add(metrics::Counter::PubSubDropped);
+            return nullptr;
+        }
+    }
+    if (outbox.size() >= m_options.maxQueued) {
+        if (m_options.policy == SlowSubscriberPolicy::Disconnect) {
+            metrics::add(metrics::Counter::PubSubDisconnects);
+            return "slow subscriber";
+        }
+        outbox.pop_front();
+        ++subscriber.outboxBase;
+        metrics::add(metrics::Counter::PubSubDropped);
+        metrics::adjust(metrics::Gauge::PubSubQueued, -1);
+    }
+    slot = subscriber.outboxBase + outbox.size();
+    outbox.push_back({ topic, frame });
+    metrics::adjust(metrics::Gauge::PubSubQueued, 1);
+    return nullptr;
+}
+
+bool TopicTable::drain(Reactor& loop, Connection& conn) {
+    if (!conn.subscriber) return true;
+    Subscriber& subscriber = *conn.subscriber;
+    auto& outbox = subscriber.outbox;
+    while (!outbox.empty() && loop.queuedBytes(conn) < m_options.writeHighWater) {
+        buffers::Buffer frame = std::move(outbox.front().frame);
+        outbox.pop_front();
+        ++subscriber.outboxBase;
+        metrics::adjust(metrics::Gauge::PubSubQueued, -1);
+        metrics::add(metrics::Counter::PubSubDelivered);
+        if (!loop.sendEncoded(conn, frame)) {
+            loop.closeConnection(conn, conn.sendFailure());
+            return false;
+        }
+    }
+    return true;
+}
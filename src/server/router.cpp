@@ -0,0 +1,97 @@
+#include "../include/server/router.hpp"
+#include "../include/server/logger.hpp"
+#include <cstring>
+
+void Response::send(protocol::MessageType type, const char* payload, size_t size,
+    const buffers::Buffer* storage, uint8_t flags) {
+    m_parts.push_back(Part{ type, flags, payload, size, storage, {} });
+}
+
+void Response::write(protocol::MessageType type, const char* payload, size_t size) {
+    buffers::Buffer copy = buffers::BufferPool::get(size);
+    if (size > 0) std::memcpy(copy.data(), payload, size);
+    Part part{ type, protocol::FLAG_NONE, copy.data(), size, nullptr, std::move(copy) };
+    m_parts.push_back(std::move(part));
+}
+
+/**
+ * @details      ,  
+ */
+void Response::own() {
+    for (Part& part : m_parts) {
+        if (part.owned) continue;
+        if (part.storage) {
+            part.owned = *part.storage;
+        }
+        else {
+            part.owned = buffers::BufferPool::get(part.size);
+            if (part.size > 0) std::memcpy(part.owned.data(), part.payload, part.size);
+            part.payload = part.owned.data();
+        }
+        part.storage = nullptr;
+    }
+}
+
+void Response::clear() {
+    m_parts.clear();
+    m_close = false;
+    m_closeReason.clear();
+    m_correlated = false;
+    m_correlation = 0;
+}
+
+Router Router::echo() {
+    Router router;
+    router.handle(protocol::MessageType::Text, [](const protocol::FrameView& request, Response& response) {
+        response.send(request);
+        });
+    return router;
+}
+
+void Router::handle(protocol::MessageType type, Handler handler, Dispatch dispatch) {
+    Route& route = m_routes[static_cast<uint8_t>(type)];
+    route.handler = std::move(handler);
+    route.dispatch = dispatch;
+}
+
+bool Router::usesPool() const {
+    for (const Route& route : m_routes) {
+        if (route.handler && route.dispatch == Dispatch::Pool) return true;
+    }
+    return false;
+}
+
+namespace {
+    void failRoute(Response& response) {
+        static const char msg[] = "Error: Internal server error\n";
+        response.clear();
+        response.send(protocol::MessageType::Error, msg, sizeof(msg) - 1);
+    }
+}
+
+void runRoute(const Router::Route& route, const protocol::FrameView& request, Response& response) {
+    try {
+        route.handler(request, response);
+    }
+    catch (const std::exception& e) {
+        logging::error(std::string("Message handler failed: ") + e.what());
+        failRoute(response);
+    }
+    catch (...) {
+        logging::error("Message handler failed");
+        failRoute(response);
+    }
+}
+
+void RouteJob::capture(const protocol::FrameView& frame) {
+    request = frame;
+    if (frame.storage) {
+        requestStorage = *frame.storage;
+    }
+    else {
+        requestStorage = buffers::BufferPool::get(frame.size);
+        if (frame.size > 0) std::memcpy(requestStorage.data(), frame.payload, frame.size);
+        request.payload = requestStorage.data();
+    }
+    request.storage = &requestStorage;
+}
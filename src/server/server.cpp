@@ -1,11 +1,18 @@
 #include "../include/server/server.hpp"
+#include <climits>
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/un.h>
+#endif
 
 /**
  * @brief     
  * @param port    (1-65535)
+ * @param options   -
  * @throw std::invalid_argument    
  */
-Server::Server(uint16_t port) : m_port(port) {
+Server::Server(uint16_t port, const ServerOptions& options)
+    : m_port(port), m_options(options), m_admission(options.admission), m_registry(static_cast<size_t>(connectionLimit())) {
     if (port == 0 || port > 65535) {
         throw std::invalid_argument("Port must be between 1 and 65535");
     }
@@ -26,40 +33,198 @@ bool Server::start() {
     if (m_running) return true;
 
     //  Winsock
-    WSADATA wsaData;
-    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+    if (!net::startup()) {
         std::cerr << "WSAStartup failed\n";
         return false;
     }
 
-    //  
-    m_serverSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+#ifdef __linux__
+    //        :  
+    // listen   ,    ,  
+    std::vector<SOCKET> inherited;
+    if (!m_options.takeoverSocket.empty()) {
+        if (!takeOverListeners(inherited)) {
+            cleanup();
+            return false;
+        }
+        if (inherited.size() != std::max(1u, m_options.reactorThreads)) {
+            logging::info("Taking over " + std::to_string(inherited.size()) + " listening sockets, running as many shards");
+        }
+        m_options.reactorThreads = static_cast<unsigned>(inherited.size());
+    }
+    const unsigned shards = std::max(1u, m_options.reactorThreads);
+    m_serverSocket = inherited.empty() ? openListener(shards > 1) : inherited[0];
+#else
+    const unsigned shards = 1;
+    m_serverSocket = openListener(shards > 1);
+#endif
     if (m_serverSocket == INVALID_SOCKET) {
-        std::cerr << "Socket creation failed\n";
+        cleanup();
         return false;
     }
 
+    m_running = true;
+    //    ,       
+    logging::Logger::instance().start();
+    if (m_options.adminPort != 0) {
+        m_admin = std::make_unique<AdminServer>(m_options.adminPort, m_options.adminAddress, &m_registry,
+            m_options.adminToken);
+        if (!m_admin->start()) {
+            stop();
+            return false;
+        }
+    }
+#ifdef __linux__
+    //      
+    if (m_options.router.usesPool()) {
+        m_pool = std::make_unique<WorkerPool>(m_options.workerThreads, m_options.workerQueueDepth);
+        m_pool->start();
+    }
+    //    :     . 
+    //        ,     
+    // --capture (,   --config)      PID
+    if (!m_options.captureFile.empty()) {
+        if (!m_options.takeoverSocket.empty()) {
+            m_options.captureFile += "." + std::to_string(getpid());
+            logging::info("Capturing to " + m_options.captureFile + " while the old process keeps its file");
+        }
+        m_capture = std::make_unique<CaptureWriter>();
+        if (!m_capture->open(m_options.captureFile, m_options.captureLimit)) {
+            stop();
+            return false;
+        }
+    }
+
+    //    ,     
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    //      SO_REUSEPORT- 
+    m_loops.reserve(shards + 2);
+    for (unsigned shard = 0; shard < shards; ++shard) {
+        SOCKET listenSocket = m_serverSocket;
+        if (shard > 0) {
+            listenSocket = inherited.empty() ? openListener(true) : inherited[shard];
+            if (listenSocket == INVALID_SOCKET) {
+                stop();
+                return false;
+            }
+            m_shardSockets.push_back(listenSocket);
+        }
+        auto loop = startShard(listenSocket, shard);
+        if (!loop) {
+            stop();
+            return false;
+        }
+        m_loops.push_back(std::move(loop));
+        m_shardCount.store(m_loops.size(), std::memory_order_release);
+    }
+    //    :   
+    //   m_socketShards ,  ShmLoop   
+    if (!startLocalShard(m_unixSocket, m_options.unixSocket, ShardKind::Unix)) {
+        stop();
+        return false;
+    }
+    m_socketShards = m_loops.size();
+    if (!startLocalShard(m_shmSocket, m_options.shmSocket, ShardKind::SharedMemory)) {
+        stop();
+        return false;
+    }
+
+    if (m_takeoverChannel >= 0) {
+        //   :     
+        if (!handoff::send(m_takeoverChannel, handoff::Kind::Ready, std::string(), nullptr, 0)) {
+            std::cerr << "Upgrade channel failed: " << errno << "\n";
+            stop();
+            return false;
+        }
+        m_takeoverThread = std::thread(&Server::receiveConnections, this);
+    }
+    if (!m_options.upgradeSocket.empty()) {
+        m_upgradeListener = handoff::listen(m_options.upgradeSocket);
+        if (m_upgradeListener < 0) {
+            std::cerr << "Upgrade socket " << m_options.upgradeSocket << " is unavailable: " << errno << "\n";
+            stop();
+            return false;
+        }
+        m_upgradeThread = std::thread(&Server::awaitUpgrade, this);
+    }
+#else
+    std::thread(&Server::acceptConnections, this).detach();
+#endif
+    return true;
+}
+
+/**
+ * @brief     m_port
+ * @return   INVALID_SOCKET  
+ */
+SOCKET Server::openListener(bool reusePort) {
+    //  
+    SOCKET listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listenSocket == INVALID_SOCKET) {
+        std::cerr << "Socket creation failed\n";
+        return INVALID_SOCKET;
+    }
+#ifdef __linux__
+    //     TIME_WAIT
+    int enable = 1;
+    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    if (reusePort) {
+        setsockopt(listenSocket, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+    }
+#else
+    (void)reusePort;
+#endif
+
     //   
     sockaddr_in serverAddr{};
     serverAddr.sin_family = AF_INET;
     serverAddr.sin_addr.s_addr = INADDR_ANY;
     serverAddr.sin_port = htons(m_port);
 
-    if (bind(m_serverSocket, (sockaddr*)&serverAddr, sizeof(serverAddr)) == SOCKET_ERROR) {
+    if (bind(listenSocket, (sockaddr*)&serverAddr, sizeof(serverAddr)) == SOCKET_ERROR) {
         std::cerr << "Bind failed\n";
-        cleanup();
-        return false;
+        closesocket(listenSocket);
+        return INVALID_SOCKET;
     }
 
-    if (listen(m_serverSocket, SOMAXCONN) == SOCKET_ERROR) {
-        std::cerr << "Listen failed\n";
-        cleanup();
-        return false;
+#ifdef __linux__
+    //       
+    //      
+    if (m_options.deferAcceptSec > 0) {
+        setsockopt(listenSocket, IPPROTO_TCP, TCP_DEFER_ACCEPT, &m_options.deferAcceptSec, sizeof(m_options.deferAcceptSec));
+    }
+    if (m_options.fastOpenQueue > 0
+        && setsockopt(listenSocket, IPPROTO_TCP, TCP_FASTOPEN, &m_options.fastOpenQueue, sizeof(m_options.fastOpenQueue)) < 0) {
+        std::cerr << "TCP Fast Open is unavailable: " << errno << "\n";
+    }
+    if (m_options.busyPollUs > 0
+        && setsockopt(listenSocket, SOL_SOCKET, SO_BUSY_POLL, &m_options.busyPollUs, sizeof(m_options.busyPollUs)) < 0) {
+        std::cerr << "SO_BUSY_POLL is unavailable: " << errno << "\n";
+    }
+#endif
+    if (m_options.noDelay) {
+        int enable = 1;
+        setsockopt(listenSocket, IPPROTO_TCP, TCP_NODELAY, (const char*)&enable, sizeof(enable));
+    }
+    //     listen:       SYN
+    if (m_options.sendBuffer > 0) {
+        setsockopt(listenSocket, SOL_SOCKET, SO_SNDBUF, (const char*)&m_options.sendBuffer, sizeof(m_options.sendBuffer));
+    }
+    if (m_options.receiveBuffer > 0) {
+        setsockopt(listenSocket, SOL_SOCKET, SO_RCVBUF, (const char*)&m_options.receiveBuffer, sizeof(m_options.receiveBuffer));
     }
 
-    m_running = true;
-    std::thread(&Server::acceptConnections, this).detach();
-    return true;
+    if (listen(listenSocket, m_options.listenBacklog) == SOCKET_ERROR) {
+        std::cerr << "Listen failed\n";
+        closesocket(listenSocket);
+        return INVALID_SOCKET;
+    }
+    return listenSocket;
 }
 
 /**
@@ -67,80 +232,113 @@ bool Server::start() {
  **/
 void Server::stop() {
     m_running = false;
-
-    //   futures
-    std::vector<std::future<void>> futures;
-    {
-        std::lock_guard<std::mutex> lock(m_futuresMutex);
-        futures = std::move(m_clientFutures);
+    if (m_admin) {
+        m_admin->stop();
+        m_admin.reset();
     }
-
-    //     
-    for (auto& future : futures) {
-        if (future.valid()) future.wait();
+#ifdef __linux__
+    //     ,    
+    if (m_upgradeThread.joinable()) m_upgradeThread.join();
+    if (m_takeoverThread.joinable()) m_takeoverThread.join();
+    //   :       
+    if (m_pool) m_pool->stop();
+    //      :     
+    m_shardCount.store(0, std::memory_order_release);
+    for (auto& loop : m_loops) {
+        loop->stop();
+    }
+    m_loops.clear();
+    m_pool.reset();
+    //   -  ,   
+    if (m_capture) {
+        m_capture->close();
+        m_capture.reset();
+    }
+#else
+    // shutdown   ,   recv;   
+    //        . 
+    // :      
+    while (m_registry.size() > 0) {
+        m_registry.forEach([](ConnectionRegistry::Id, const ConnectionRegistry::Slot& slot) {
+            shutdown(slot.socket, SD_BOTH);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(STOP_POLL_MS));
     }
+#endif
     cleanup();
+    logging::Logger::instance().stop();
 }
 
+#ifndef __linux__
 /**
  * @brief    
- * @details  select()    
+ * @details select()      (  
+ * m_running);     
+ *   WSAEWOULDBLOCK,     
+ *   .    accept  : 
+ *     listen,    
  */
 void Server::acceptConnections() {
+    net::setNonBlocking(m_serverSocket);
+    bool paused = false;
     while (m_running) {
+        if (getActiveClients() >= connectionLimit()) {
+            if (!paused) {
+                metrics::add(metrics::Counter::CapacityPauses);
+                metrics::adjust(metrics::Gauge::AcceptPaused, 1);
+                paused = true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        if (paused) {
+            metrics::adjust(metrics::Gauge::AcceptPaused, -1);
+            paused = false;
+        }
+
         fd_set readSet;
         FD_ZERO(&readSet);
         FD_SET(m_serverSocket, &readSet);
         timeval timeout{ 0, 100000 };
 
-        if (select(0, &readSet, nullptr, nullptr, &timeout) > 0) {
-            if (m_activeClients >= MAX_CLIENTS) {
-                //    
-                std::cerr << "Client rejected: server is full!\n";
-                SOCKET tempSocket = accept(m_serverSocket, nullptr, nullptr);
-                if (tempSocket != INVALID_SOCKET) {
-                    const char* msg = "Server is busy. Try again later.\n";
-                    send(tempSocket, msg, strlen(msg), 0);
-                    closesocket(tempSocket);
+        const bool ready = select(0, &readSet, nullptr, nullptr, &timeout) > 0;
+        while (ready && m_running && getActiveClients() < connectionLimit()) {
+            sockaddr_in address{};
+            int addressSize = sizeof(address);
+            SOCKET clientSocket = accept(m_serverSocket, (sockaddr*)&address, &addressSize);
+            if (clientSocket == INVALID_SOCKET) {
+                const int error = WSAGetLastError();
+                if (!net::wouldBlock(error)) {
+                    logging::error("Accept failed: " + std::to_string(error));
                 }
-                continue;
+                break;
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            SOCKET clientSocket = accept(m_serverSocket, nullptr, nullptr);
-            if (clientSocket == INVALID_SOCKET) {
-                std::cerr << "Accept failed: " << WSAGetLastError() << "\n";
+            //      ,  handleClient   recv
+            net::setBlocking(clientSocket);
+            const int64_t source = m_admission.admitSource(address.sin_addr.s_addr);
+            if (source < 0) {
+                //     
+                logging::warning("Client rejected: too many connections from one address");
+                metrics::add(metrics::Counter::Rejects);
+                const std::string msg = protocol::encodeFrame(protocol::MessageType::Error, "Server is busy. Try again later.\n");
+                send(clientSocket, msg.data(), static_cast<int>(msg.size()), 0);
+                closesocket(clientSocket);
                 continue;
             }
-            else {
-                //     
-                setsockopt(clientSocket, SOL_SOCKET, SO_RCVTIMEO, (char*)&recvTimeout, sizeof(recvTimeout));
-                {
-                    std::lock_guard<std::mutex> lock(m_clientsMutex);
-                    m_activeClients++;
-                }
-                {
-                    std::lock_guard<std::mutex> lock(m_futuresMutex);
-                    m_clientFutures.emplace_back(
-                        std::async(std::launch::async, [this, clientSocket]() {
-                            this->handleClient(clientSocket);
-                            std::lock_guard<std::mutex> lock(m_clientsMutex);
-                            m_activeClients--;
-                            })
-                    );
-
-                }
+            //   ;      
+            const ConnectionRegistry::Id id = m_registry.add(clientSocket, nullptr, 0);
+            if (id == ConnectionRegistry::INVALID_ID) {
+                m_admission.releaseSource(static_cast<uint32_t>(source));
+                closesocket(clientSocket);
+                continue;
             }
-        }
-        //    futures
-        {
-            std::lock_guard<std::mutex> lock(m_futuresMutex);
-            m_clientFutures.erase(
-                std::remove_if(m_clientFutures.begin(), m_clientFutures.end(),
-                    [](auto& future) {
-                        return !future.valid() ||
-                            (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready); }),
-                m_clientFutures.end()
-            );
+            std::thread([this, clientSocket, id, source]() {
+                this->handleClient(clientSocket, id);
+                m_admission.releaseSource(static_cast<uint32_t>(source));
+                //  remove stop()  :     
+                m_registry.remove(id);
+                closesocket(clientSocket);
+                }).detach();
         }
     }
 }
@@ -148,53 +346,190 @@ void Server::acceptConnections() {
 /**
  * @brief    
  * @param clientSocket   
+ * @param id    
+ * @note       id  
  **/
-void Server::handleClient(SOCKET clientSocket) {
+void Server::handleClient(SOCKET clientSocket, ConnectionRegistry::Id id) {
     auto logDisconnect = [clientSocket](const std::string& reason) {
-        std::cout << "Client [" << clientSocket << "] disconnected. Reason: " << reason << "\n";
+        logging::disconnected(clientSocket, reason);
         };
 
-    auto cleanup = [this, clientSocket, &logDisconnect]() {
-        closesocket(clientSocket);
-        std::lock_guard<std::mutex> lock(m_clientsMutex);
-        m_activeClients--;
+    std::unique_ptr<Session> session; // -,   
+    ConnectionRegistry::Slot& slot = m_registry.owned(id);
+    auto cleanup = [&session]() {
+        if (session) session->close();
+        metrics::adjust(metrics::Gauge::Connections, -1);
         };
 
     try {
-        //  
-        setsockopt(clientSocket, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeout, sizeof(timeout));
-        std::cout << "New client connected. Socket: " << clientSocket << std::endl;
+        logging::connected(clientSocket);
+        metrics::add(metrics::Counter::Accepts);
+        metrics::adjust(metrics::Gauge::Connections, 1);
 
-        std::vector<char> buffer(MAX_MESSAGE_SIZE);
-        int timeoutCount = 0;
+        buffers::Buffer buffer = buffers::BufferPool::get(m_options.readBufferSize);
+        protocol::FrameDecoder decoder;
+        decoder.setLimit(m_options.maxMessageSize);
+        TokenBucket messageBucket;
+        //      recv,    
+        //   SO_RCVTIMEO/SO_SNDTIMEO:  ,   
+        //   -  ,   
+        ConnectionClass connectionClass = ConnectionClass::New;
+        DWORD receiveTimeout = 0;
+        DWORD sendTimeout = 0;
+        auto applyTimeouts = [&]() {
+            const TimeoutPolicy& limits = m_options.timeouts[static_cast<size_t>(connectionClass)];
+            DWORD value = limits.idleMs;
+            if (decoder.hasPartial() && limits.readMs != 0 && (value == 0 || limits.readMs < value)) {
+                value = limits.readMs;
+            }
+            if (value != receiveTimeout) {
+                net::setTimeout(clientSocket, SO_RCVTIMEO, value);
+                receiveTimeout = value;
+            }
+            if (limits.writeMs != sendTimeout) {
+                net::setTimeout(clientSocket, SO_SNDTIMEO, limits.writeMs);
+                sendTimeout = limits.writeMs;
+            }
+            };
+        applyTimeouts();
+        //    Hello;   - 
+        bool compressReplies = false;
+        compression::Dictionary replyDictionary = compression::Dictionary::None;
+        auto sendFrame = [this, clientSocket, &slot, &compressReplies, &replyDictionary](protocol::MessageType type,
+            const char* payload, size_t size, const Response* request = nullptr) {
+            buffers::Buffer frame;
+            if (compressReplies && request) frame = compressReply(type, protocol::FLAG_NONE, payload, size, *request, replyDictionary);
+            if (!frame) {
+                frame = request && request->correlated()
+                    ? protocol::makeCorrelatedFrame(type, request->correlation(), payload, size)
+                    : protocol::makeFrame(type, payload, size);
+            }
+            std::lock_guard<std::mutex> lock(slot.sendMutex);
+            int sent = send(clientSocket, frame.data(), static_cast<int>(frame.size()), 0);
+            if (sent > 0) metrics::add(metrics::Counter::BytesOut, static_cast<uint64_t>(sent));
+            return sent != SOCKET_ERROR;
+            };
+        //         recv
+        bool sessionFinished = false;
+        Response response; //   
+        std::string closeReason; //    
+        if (m_options.sessionHandler) {
+            session = std::make_unique<Session>([&sendFrame](protocol::MessageType type, uint8_t,
+                const char* payload, size_t size, const buffers::Buffer*) {
+                    return sendFrame(type, payload, size);
+                });
+            session->start(m_options.sessionHandler);
+            if (session->finished()) {
+                logDisconnect("session finished");
+                cleanup();
+                return;
+            }
+        }
 
         while (m_running) {
-            int bytesReceived = recv(clientSocket, buffer.data(), buffer.size(), 0);
+            int bytesReceived = recv(clientSocket, buffer.data(), static_cast<int>(buffer.size()), 0);
 
             if (bytesReceived > 0) {
-                timeoutCount = 0;
+                const auto receivedAt = std::chrono::steady_clock::now();
+                metrics::add(metrics::Counter::BytesIn, static_cast<uint64_t>(bytesReceived));
+                ConnectionRegistry::Slot::bump(slot.bytesIn, static_cast<uint64_t>(bytesReceived));
+                bool valid = true;
+                size_t badOffset = InputValidator::npos;
+                protocol::DecodeStatus status = decoder.feed(buffer.data(), static_cast<size_t>(bytesReceived),
+                    [&](const protocol::FrameView& received) {
+                        //     ;    
+                        response.clear();
+                        protocol::FrameView frame = received;
+                        if (frame.flags & protocol::FLAG_CORRELATED) {
+                            uint64_t correlation = 0;
+                            if (session || !protocol::takeCorrelation(frame, correlation)) {
+                                valid = false;
+                                return false;
+                            }
+                            response.correlate(correlation);
+                        }
+                        buffers::Buffer inflated;
+                        if ((frame.flags & protocol::FLAG_COMPRESSED) && !inflateFrame(frame, inflated)) {
+                            metrics::add(metrics::Counter::ProtocolErrors);
+                            valid = false;
+                            return false;
+                        }
+                        if (frame.type == protocol::MessageType::Hello) {
+                            compressReplies = negotiate(frame, response, replyDictionary);
+                            for (const Response::Part& part : response.parts()) {
+                                sendFrame(part.type, part.payload, part.size, &response);
+                            }
+                            return true;
+                        }
+                        if (m_admission.limitsMessages()
+                            && !messageBucket.take(m_admission.options().messageRate, m_admission.messageBurst(), receivedAt)) {
+                            metrics::add(metrics::Counter::RateLimited);
+                            const char* msg = "Error: Rate limit exceeded\n";
+                            sendFrame(protocol::MessageType::Error, msg, strlen(msg), &response);
+                            return true;
+                        }
+                        //      ;    
+                        const Router::Route* route = session ? nullptr : m_options.router.find(frame.type);
+                        const bool routed = session ? frame.type == protocol::MessageType::Text : route != nullptr;
+                        if (!routed || (frame.type == protocol::MessageType::Text
+                            && !InputValidator::validateMessage(frame.payload, frame.size, &badOffset))) {
+                            metrics::add(metrics::Counter::ValidationFailures);
+                            valid = false;
+                            return false;
+                        }
+                        connectionClass = ConnectionClass::Active;
+                        metrics::add(metrics::Counter::Messages);
+                        ConnectionRegistry::Slot::bump(slot.messages, 1);
+                        logging::message(clientSocket, frame.payload, frame.size);
+                        if (session) {
+                            sessionFinished = !session->deliver(frame);
+                            return !sessionFinished;
+                        }
+                        //       Dispatch::Pool
+                        runRoute(*route, frame, response);
+                        for (const Response::Part& part : response.parts()) {
+                            sendFrame(part.type, part.payload, part.size, &response);
+                        }
+                        metrics::recordEchoLatency(std::chrono::steady_clock::now() - receivedAt);
+                        if (response.closeRequested()) {
+                            closeReason = response.closeReason();
+                            return false;
+                        }
+                        return true;
+                    });
 
                 //    
-                if (bytesReceived >= MAX_MESSAGE_SIZE) {
+                if (status == protocol::DecodeStatus::TooLarge) {
+                    metrics::add(metrics::Counter::ProtocolErrors);
                     logDisconnect("buffer overflow protection");
                     const char* msg = "Error: Message too large\n";
-                    send(clientSocket, msg, strlen(msg), 0);
+                    sendFrame(protocol::MessageType::Error, msg, strlen(msg));
                     cleanup();
                     return;
                 }
-
-                //  
-                std::string message(buffer.data(), bytesReceived);
-                if (!InputValidator::validateMessage(message)) {
-                    logDisconnect("invalid message format");
-                    const char* errorMsg = "Error: Invalid message format\n";
-                    send(clientSocket, errorMsg, strlen(errorMsg), 0);
+                if (!closeReason.empty()) {
+                    logDisconnect(closeReason);
                     cleanup();
                     return;
                 }
-
-                std::cout << "Client [" << clientSocket << "]: " << message << std::endl;
-                send(clientSocket, message.c_str(), message.size(), 0);
+                if (status == protocol::DecodeStatus::Malformed || !valid) {
+                    if (valid) metrics::add(metrics::Counter::ProtocolErrors);
+                    logDisconnect(valid ? "invalid frame header" : "invalid message format");
+                    std::string errorMsg = "Error: Invalid message format";
+                    if (badOffset != InputValidator::npos) {
+                        errorMsg += " (invalid character at byte " + std::to_string(badOffset) + ")";
+                    }
+                    errorMsg += "\n";
+                    sendFrame(protocol::MessageType::Error, errorMsg.data(), errorMsg.size());
+                    cleanup();
+                    return;
+                }
+                if (sessionFinished) {
+                    logDisconnect("session finished");
+                    cleanup();
+                    return;
+                }
+                applyTimeouts();
             }
             else if (bytesReceived == 0) {
                 logDisconnect("graceful disconnect");
@@ -205,12 +540,10 @@ void Server::handleClient(SOCKET clientSocket) {
                 //  
                 int error = WSAGetLastError();
                 if (error == WSAETIMEDOUT) {
-                    if (++timeoutCount > 3) {
-                        logDisconnect("timeout");
-                        cleanup();
-                        return;
-                    }
-                    continue;
+                    metrics::add(metrics::Counter::Timeouts);
+                    logDisconnect(decoder.hasPartial() ? "read timeout" : "timeout");
+                    cleanup();
+                    return;
                 }
 
                 logDisconnect("socket error: " + std::to_string(error));
@@ -220,18 +553,806 @@ void Server::handleClient(SOCKET clientSocket) {
         }
     }
     catch (...) {
-        std::cerr << "Exception in client handler for socket " << clientSocket << std::endl;
+        logging::error("Exception in client handler for socket " + std::to_string(clientSocket));
         cleanup();
     }
 }
 
+int Server::getActiveClients() const {
+    return static_cast<int>(m_registry.size());
+}
+#else
+/**
+ * @brief     
+ */
+int Server::getActiveClients() const {
+    int total = 0;
+    for (const auto& loop : m_loops) {
+        total += loop->connectionCount();
+    }
+    return total;
+}
+
+/**
+ * @brief   ; io_uring     epoll
+ * @details     Unix-   ,
+ *     TCP-
+ */
+std::unique_ptr<Reactor> Server::startShard(SOCKET listenSocket, unsigned shard, ShardKind kind) {
+    const unsigned shards = std::max(1u, m_options.reactorThreads);
+    const unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+    ReactorTuning tuning;
+    if (m_options.pinThreads || !m_options.cpus.empty()) {
+        tuning.cpu = m_options.cpus.empty() ? static_cast<int>(shard % cpus) : m_options.cpus[shard % m_options.cpus.size()];
+        tuning.numaLocal = m_options.numaLocal;
+    }
+    tuning.quickAck = kind == ShardKind::Tcp && m_options.quickAck;
+    tuning.spinUs = m_options.spinUs;
+    tuning.eventBatch = std::max(1, m_options.eventBatch);
+    tuning.readBufferSize = std::max<size_t>(protocol::MAX_HEADER_SIZE, m_options.readBufferSize);
+
+    std::unique_ptr<Reactor> loop;
+    if (kind == ShardKind::SharedMemory) {
+        loop = std::make_unique<ShmLoop>(*this, listenSocket);
+    }
+    else if (m_options.engine == IoEngine::IoUring) {
+        loop = std::make_unique<UringLoop>(*this, listenSocket);
+    }
+    else {
+        loop = std::make_unique<EventLoop>(*this, listenSocket);
+    }
+    loop->setMaxConnections(std::max(1, connectionLimit() / static_cast<int>(shards)));
+    loop->setAdmission(&m_admission);
+    loop->setRegistry(&m_registry);
+    loop->setTimeouts(m_options.timeouts);
+    loop->setZeroCopyThreshold(kind == ShardKind::Tcp ? m_options.zeroCopyThreshold : 0);
+    loop->setPubSub(m_options.pubsub);
+    loop->setTuning(tuning);
+    if (loop->start()) {
+        return loop;
+    }
+
+    if (kind != ShardKind::SharedMemory && m_options.engine == IoEngine::IoUring) {
+        logging::warning("io_uring is not supported by the kernel, falling back to epoll");
+        m_options.engine = IoEngine::Epoll;
+        return startShard(listenSocket, shard, kind);
+    }
+    return nullptr;
+}
+
+SOCKET Server::openLocalListener(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Unix socket path is too long: " << path << "\n";
+        return INVALID_SOCKET;
+    }
+    std::memcpy(address.sun_path, path.data(), path.size());
+    SOCKET listenSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenSocket == INVALID_SOCKET) {
+        std::cerr << "Socket creation failed\n";
+        return INVALID_SOCKET;
+    }
+    // ,    ,     
+    ::unlink(path.c_str());
+    if (bind(listenSocket, (sockaddr*)&address, sizeof(address)) == SOCKET_ERROR
+        || listen(listenSocket, m_options.listenBacklog) == SOCKET_ERROR) {
+        std::cerr << "Cannot listen on " << path << ": " << errno << "\n";
+        closesocket(listenSocket);
+        return INVALID_SOCKET;
+    }
+    return listenSocket;
+}
+
+/**
+ * @details       : 
+ *  listen    
+ */
+bool Server::startLocalShard(SOCKET& listenSocket, const std::string& path, ShardKind kind) {
+    if (path.empty()) {
+        if (listenSocket != INVALID_SOCKET) closesocket(listenSocket);
+        listenSocket = INVALID_SOCKET;
+        return true;
+    }
+    if (listenSocket == INVALID_SOCKET) listenSocket = openLocalListener(path);
+    if (listenSocket == INVALID_SOCKET) return false;
+    auto loop = startShard(listenSocket, static_cast<unsigned>(m_loops.size()), kind);
+    if (!loop) return false;
+    m_loops.push_back(std::move(loop));
+    m_shardCount.store(m_loops.size(), std::memory_order_release);
+    return true;
+}
+
+/**
+ * @details      : 
+ *    ,      
+ */
+void Server::onConnect(Reactor& loop, Connection& conn) {
+    conn.decoder.setLimit(m_options.maxMessageSize);
+    if (!m_options.sessionHandler) return;
+    Connection* target = &conn;
+    conn.session = std::make_unique<Session>([&loop, target](protocol::MessageType type, uint8_t flags,
+        const char* payload, size_t size, const buffers::Buffer* storage) {
+            return loop.sendFrame(*target, type, flags, payload, size, storage);
+        });
+    conn.session->start(m_options.sessionHandler);
+    if (conn.session->finished()) {
+        loop.closeConnection(conn, "session finished");
+    }
+}
+
+/**
+ * @brief     
+ * @details      ,
+ *    handleClient
+ */
+bool Server::onData(Reactor& loop, Connection& conn, const char* data, size_t size) {
+    if (conn.registryId != ConnectionRegistry::INVALID_ID) {
+        ConnectionRegistry::Slot::bump(m_registry.owned(conn.registryId).bytesIn, size);
+    }
+    //     . ,   
+    // ,    :    
+    //  .    ;    
+    //      
+    thread_local std::vector<protocol::FrameView> frames;
+    thread_local std::vector<protocol::FrameView> texts;
+    thread_local std::vector<size_t> textFrames; //    frames    texts
+    const size_t first = frames.size();
+    const size_t firstText = texts.size();
+    buffers::Buffer assembled;
+    const protocol::DecodeStatus status = conn.decoder.feed(data, size, [&](const protocol::FrameView& frame) {
+        frames.push_back(frame);
+        if (frame.storage) {
+            assembled = *frame.storage;
+            frames.back().storage = &assembled;
+        }
+        return true;
+        });
+
+    //         ;  -
+    //  onMessage  .    onMessage
+    //  ,   ,   
+    for (size_t i = first; i < frames.size(); ++i) {
+        protocol::FrameView text = frames[i];
+        if ((text.type != protocol::MessageType::Text && !protocol::isPubSub(text.type))
+            || (text.flags & protocol::FLAG_COMPRESSED)) {
+            continue;
+        }
+        uint64_t correlation = 0;
+        if ((text.flags & protocol::FLAG_CORRELATED) && !protocol::takeCorrelation(text, correlation)) continue;
+        texts.push_back(text);
+        textFrames.push_back(i);
+    }
+    const InputValidator::BatchResult checked = InputValidator::validateBatch(texts.data() + firstText, texts.size() - firstText);
+    const size_t firstInvalid = firstText + checked.frame < texts.size() ? textFrames[firstText + checked.frame] : frames.size();
+
+    bool open = true;
+    for (size_t i = first; open && i < frames.size(); ++i) {
+        const protocol::FrameView frame = frames[i];
+        if (m_capture) m_capture->record(loop.captureCursor(), conn.registryId, loop.now(), frame);
+        open = onMessage(loop, conn, frame, i < firstInvalid && !(frame.flags & protocol::FLAG_COMPRESSED));
+    }
+    frames.resize(first);
+    texts.resize(firstText);
+    textFrames.resize(firstText);
+    if (!open) return false;
+
+    switch (status) {
+    case protocol::DecodeStatus::Ok:
+        loop.updateReadDeadline(conn);
+        //        
+        // :   ,    
+        if (conn.requestSeq - conn.replySeq >= MAX_REPLY_BACKLOG) conn.replyBacklog = true;
+        return true;
+    case protocol::DecodeStatus::Stopped:
+        return false;
+    case protocol::DecodeStatus::TooLarge: {
+        metrics::add(metrics::Counter::ProtocolErrors);
+        //    
+        const char* msg = "Error: Message too large\n";
+        loop.sendFrame(conn, protocol::MessageType::Error, protocol::FLAG_NONE, msg, strlen(msg));
+        loop.closeConnection(conn, "buffer overflow protection");
+        return false;
+    }
+    default: {
+        metrics::add(metrics::Counter::ProtocolErrors);
+        const char* msg = "Error: Invalid message format\n";
+        loop.sendFrame(conn, protocol::MessageType::Error, protocol::FLAG_NONE, msg, strlen(msg));
+        loop.closeConnection(conn, "invalid frame header");
+        return false;
+    }
+    }
+}
+
+/**
+ * @brief       
+ * @details  Inline     ,    
+ *   ;    Pool   
+ * .        ,    handleClient.
+ *   (FLAG_CORRELATED)   : 
+ *   ,      
+ */
+bool Server::onMessage(Reactor& loop, Connection& conn, const protocol::FrameView& received, bool validated) {
+    //         ,
+    //      
+    thread_local Response response;
+    response.clear();
+    protocol::FrameView frame = received;
+    const bool correlated = (frame.flags & protocol::FLAG_CORRELATED) != 0;
+    uint64_t correlation = 0;
+    if (correlated) {
+        //         
+        if (conn.session || !protocol::takeCorrelation(frame, correlation)) {
+            metrics::add(metrics::Counter::ProtocolErrors);
+            static const char msg[] = "Error: Invalid message format\n";
+            loop.sendFrame(conn, protocol::MessageType::Error, protocol::FLAG_NONE, msg, sizeof(msg) - 1);
+            loop.closeConnection(conn, "invalid correlation id");
+            return false;
+        }
+        response.correlate(correlation);
+    }
+    //    ,   Hello   
+    buffers::Buffer inflated;
+    if ((frame.flags & protocol::FLAG_COMPRESSED) && !inflateFrame(frame, inflated)) {
+        metrics::add(metrics::Counter::ProtocolErrors);
+        static const char msg[] = "Error: Invalid message format\n";
+        loop.sendFrame(conn, protocol::MessageType::Error, protocol::FLAG_NONE, msg, sizeof(msg) - 1);
+        loop.closeConnection(conn, "invalid compressed payload");
+        return false;
+    }
+    if (frame.type == protocol::MessageType::Hello) {
+        conn.compressReplies = negotiate(frame, response, conn.replyDictionary);
+        return replyInline(loop, conn, response);
+    }
+
+    //     ,   
+    if (m_admission.limitsMessages()
+        && !conn.messageBucket.take(m_admission.options().messageRate, m_admission.messageBurst(), loop.now())) {
+        metrics::add(metrics::Counter::RateLimited);
+        static const char msg[] = "Error: Rate limit exceeded\n";
+        response.send(protocol::MessageType::Error, msg, sizeof(msg) - 1);
+        return replyInline(loop, conn, response);
+    }
+
+    //      ;    
+    const bool pubsub = protocol::isPubSub(frame.type);
+    const Router::Route* route = conn.session || pubsub ? nullptr : m_options.router.find(frame.type);
+    const bool routed = pubsub || (conn.session ? frame.type == protocol::MessageType::Text : route != nullptr);
+    size_t badOffset = InputValidator::npos;
+    if (!routed || ((frame.type == protocol::MessageType::Text || pubsub) && !validated
+        && !InputValidator::validateMessage(frame.payload, frame.size, &badOffset))) {
+        metrics::add(metrics::Counter::ValidationFailures);
+        std::string errorMsg = "Error: Invalid message format";
+        if (badOffset != InputValidator::npos) {
+            errorMsg += " (invalid character at byte " + std::to_string(badOffset) + ")";
+        }
+        errorMsg += "\n";
+        loop.sendFrame(conn, protocol::MessageType::Error, protocol::FLAG_NONE, errorMsg.data(), errorMsg.size());
+        loop.closeConnection(conn, "invalid message format");
+        return false;
+    }
+
+    loop.activate(conn);
+    metrics::add(metrics::Counter::Messages);
+    if (conn.registryId != ConnectionRegistry::INVALID_ID) {
+        ConnectionRegistry::Slot::bump(m_registry.owned(conn.registryId).messages, 1);
+    }
+    logging::message(conn.socket, frame.payload, frame.size);
+    if (pubsub) return onPubSub(loop, conn, frame, response);
+    if (conn.session) {
+        //          
+        if (!conn.session->deliver(frame)) {
+            loop.closeConnection(conn, "session finished");
+            return false;
+        }
+        metrics::recordEchoLatency(std::chrono::steady_clock::now() - loop.now());
+        return true;
+    }
+
+    if (route->dispatch == Router::Dispatch::Pool && m_pool) {
+        auto job = std::make_unique<RouteJob>();
+        job->loop = &loop;
+        job->socket = conn.socket;
+        job->connectionId = conn.id;
+        if (!correlated) job->seq = conn.requestSeq++;
+        if (correlated) job->response.correlate(correlation);
+        job->route = route;
+        job->receivedAt = loop.now();
+        job->capture(frame);
+        if (m_pool->submit(job.get())) {
+            metrics::add(metrics::Counter::PoolJobs);
+            ++conn.poolJobs;
+            job.release();
+            return true;
+        }
+        //   :       
+        metrics::add(metrics::Counter::PoolRejected);
+        static const char msg[] = "Error: Server is busy\n";
+        job->response.send(protocol::MessageType::Error, msg, sizeof(msg) - 1);
+        return correlated ? sendResponse(loop, conn, job->response) : replyInOrder(loop, conn, std::move(job));
+    }
+
+    runRoute(*route, frame, response);
+    if (!replyInline(loop, conn, response)) return false;
+    //    :      
+    metrics::recordEchoLatency(std::chrono::steady_clock::now() - loop.now());
+    return true;
+}
+
+/**
+ * @details      onMessage;    
+ *       
+ */
+bool Server::onPubSub(Reactor& loop, Connection& conn, const protocol::FrameView& frame, Response& response) {
+    const PubSubOptions& options = loop.topics().options();
+    auto validTopic = [&options](std::string_view topic) {
+        return !topic.empty() && topic.size() <= options.maxTopicLength
+            && topic.find(protocol::TOPIC_SEPARATOR) == std::string_view::npos;
+    };
+    static const char invalidTopic[] = "Error: Invalid topic\n";
+
+    if (frame.type != protocol::MessageType::Publish) {
+        const std::string_view topic(frame.payload, frame.size);
+        if (!validTopic(topic)) {
+            response.send(protocol::MessageType::Error, invalidTopic, sizeof(invalidTopic) - 1);
+        }
+        else if (frame.type == protocol::MessageType::Unsubscribe) {
+            loop.topics().unsubscribe(conn, topic);
+            response.send(frame);
+        }
+        else if (loop.topics().subscribe(conn, topic)) {
+            response.send(frame);
+        }
+        else {
+            static const char msg[] = "Error: Too many subscriptions\n";
+            response.send(protocol::MessageType::Error, msg, sizeof(msg) - 1);
+        }
+        return replyInline(loop, conn, response);
+    }
+
+    const std::string_view payload(frame.payload, frame.size);
+    const size_t separator = payload.find(protocol::TOPIC_SEPARATOR);
+    if (separator == std::string_view::npos || !validTopic(payload.substr(0, separator))) {
+        response.send(protocol::MessageType::Error, invalidTopic, sizeof(invalidTopic) - 1);
+        return replyInline(loop, conn, response);
+    }
+
+    //      :    ,
+    //        
+    metrics::add(metrics::Counter::PubSubPublished);
+    buffers::Buffer encoded = protocol::makeFrame(protocol::MessageType::Publish, frame.payload, frame.size);
+    const std::string_view topic(encoded.data() + (encoded.size() - frame.size), separator);
+
+    const size_t shards = m_shardCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < shards; ++i) {
+        Reactor& shard = *m_loops[i];
+        if (&shard == &loop) continue;
+        auto* broadcast = new Broadcast();
+        broadcast->frame = encoded;
+        broadcast->topic = topic;
+        shard.post(broadcast);
+    }
+    if (const char* reason = loop.topics().fanOut(loop, topic, encoded, &conn)) {
+        loop.closeConnection(conn, reason);
+        return false;
+    }
+    return true;
+}
+
+void Server::onPosted(Reactor& loop) {
+    while (handoff::Adoption* posted = loop.takeAdoption()) {
+        std::unique_ptr<handoff::Adoption> adoption(posted);
+        adopt(loop, *adoption);
+    }
+    while (Broadcast* posted = loop.takeBroadcast()) {
+        std::unique_ptr<Broadcast> broadcast(posted);
+        loop.topics().fanOut(loop, broadcast->topic, broadcast->frame);
+    }
+    while (ConnectionCommand* posted = loop.takeCommand()) {
+        std::unique_ptr<ConnectionCommand> command(posted);
+        Connection* conn = loop.findConnection(command->socket, command->connectionId);
+        if (!conn) continue;
+        if (command->close) {
+            loop.closeConnection(*conn, command->reason);
+        }
+        else if (!loop.sendEncoded(*conn, command->frame)) {
+            loop.closeConnection(*conn, conn->sendFailure());
+        }
+    }
+    while (RouteJob* completed = loop.takeCompletion()) {
+        std::unique_ptr<RouteJob> job(completed);
+        Connection* conn = loop.findConnection(job->socket, job->connectionId);
+        if (!conn) continue;
+        --conn->poolJobs;
+        const auto receivedAt = job->receivedAt;
+        const bool sent = job->response.correlated()
+            ? sendResponse(loop, *conn, job->response)
+            : replyInOrder(loop, *conn, std::move(job));
+        if (sent) {
+            metrics::recordEchoLatency(std::chrono::steady_clock::now() - receivedAt);
+        }
+    }
+}
+
+/**
+ * @details     ( )   ,
+ *   
+ */
+bool Server::replyInline(Reactor& loop, Connection& conn, Response& response) {
+    if (response.correlated()) return sendResponse(loop, conn, response);
+    const uint64_t seq = conn.requestSeq++;
+    if (seq == conn.replySeq) {
+        ++conn.replySeq;
+        return sendResponse(loop, conn, response);
+    }
+    auto job = std::make_unique<RouteJob>();
+    job->seq = seq;
+    job->response = std::move(response);
+    job->response.own();
+    response.clear();
+    return replyInOrder(loop, conn, std::move(job));
+}
+
+bool Server::replyInOrder(Reactor& loop, Connection& conn, std::unique_ptr<RouteJob> job) {
+    const size_t index = static_cast<size_t>(job->seq - conn.replySeq);
+    if (index > 0) {
+        //     ,    
+        if (!conn.deferredReplies) conn.deferredReplies = std::make_unique<std::deque<std::unique_ptr<RouteJob>>>();
+        auto& deferred = *conn.deferredReplies;
+        if (deferred.size() <= index) deferred.resize(index + 1);
+        deferred[index] = std::move(job);
+        return true;
+    }
+    //    ()   
+    if (conn.deferredReplies && !conn.deferredReplies->empty()) conn.deferredReplies->pop_front();
+    ++conn.replySeq;
+    if (!sendResponse(loop, conn, job->response)) return false;
+
+    //   ,   
+    if (conn.deferredReplies) {
+        auto& deferred = *conn.deferredReplies;
+        while (!deferred.empty() && deferred.front()) {
+            std::unique_ptr<RouteJob> ready = std::move(deferred.front());
+            deferred.pop_front();
+            ++conn.replySeq;
+            if (!sendResponse(loop, conn, ready->response)) return false;
+        }
+    }
+    if (conn.replyBacklog && conn.requestSeq - conn.replySeq <= MAX_REPLY_BACKLOG / 2) {
+        conn.replyBacklog = false;
+        loop.resumeRead(conn);
+    }
+    return true;
+}
+
+/**
+ * @details        : 
+ *   ,     .  
+ *   
+ */
+bool Server::sendResponse(Reactor& loop, Connection& conn, const Response& response) {
+    for (const Response::Part& part : response.parts()) {
+        const buffers::Buffer* storage = part.owned ? &part.owned : part.storage;
+        buffers::Buffer compressed;
+        if (conn.compressReplies) {
+            compressed = compressReply(part.type, part.flags, part.payload, part.size, response, conn.replyDictionary);
+        }
+        const bool sent = compressed ? loop.sendEncoded(conn, compressed)
+            : response.correlated()
+            ? loop.sendEncoded(conn, protocol::makeCorrelatedFrame(part.type, response.correlation(), part.payload, part.size, part.flags))
+            : loop.sendFrame(conn, part.type, part.flags, part.payload, part.size, storage);
+        if (!sent) {
+            loop.closeConnection(conn, conn.sendFailure());
+            return false;
+        }
+    }
+    if (response.closeRequested()) {
+        loop.closeConnection(conn, response.closeReason());
+        return false;
+    }
+    return true;
+}
+
+bool Server::takeOverListeners(std::vector<SOCKET>& listeners) {
+    m_takeoverChannel = handoff::connect(m_options.takeoverSocket);
+    if (m_takeoverChannel < 0) {
+        std::cerr << "Cannot reach the running server at " << m_options.takeoverSocket << ": " << errno << "\n";
+        return false;
+    }
+    handoff::Kind kind;
+    std::string data;
+    std::vector<int> fds;
+    if (!handoff::receive(m_takeoverChannel, kind, data, fds, HANDOFF_READY_MS)
+        || kind != handoff::Kind::Listeners || fds.empty()) {
+        for (int fd : fds) closesocket(fd);
+        std::cerr << "The running server did not pass its listening sockets\n";
+        return false;
+    }
+    //    -  ShardKind;     - TCP
+    for (size_t i = 0; i < fds.size(); ++i) {
+        const ShardKind kind = data.size() == fds.size() ? static_cast<ShardKind>(data[i]) : ShardKind::Tcp;
+        if (kind == ShardKind::Unix) m_unixSocket = fds[i];
+        else if (kind == ShardKind::SharedMemory) m_shmSocket = fds[i];
+        else listeners.push_back(fds[i]);
+    }
+    if (listeners.empty()) {
+        std::cerr << "The running server did not pass its listening sockets\n";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @details      Ready,   
+ * ,        .
+ *  Ready     ,  
+ *  . Ready   HANDOFF_POLL_MS,  stop()  
+ *  HANDOFF_READY_MS
+ */
+void Server::awaitUpgrade() {
+    while (m_running) {
+        const int channel = handoff::accept(m_upgradeListener, HANDOFF_POLL_MS);
+        if (channel < 0) {
+            if (errno == EPERM) logging::warning("Upgrade refused: the connecting process belongs to another user");
+            continue;
+        }
+
+        std::vector<int> listeners{ m_serverSocket };
+        listeners.insert(listeners.end(), m_shardSockets.begin(), m_shardSockets.end());
+        std::string roles(listeners.size(), static_cast<char>(ShardKind::Tcp));
+        for (const auto& [socket, role] : { std::pair{ m_unixSocket, ShardKind::Unix }, std::pair{ m_shmSocket, ShardKind::SharedMemory } }) {
+            if (socket == INVALID_SOCKET) continue;
+            listeners.push_back(socket);
+            roles.push_back(static_cast<char>(role));
+        }
+        handoff::Kind kind;
+        std::string data;
+        std::vector<int> fds;
+        bool ready = handoff::send(channel, handoff::Kind::Listeners, roles, listeners.data(), listeners.size());
+        const auto readyDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(HANDOFF_READY_MS);
+        while (ready) {
+            if (handoff::receive(channel, kind, data, fds, HANDOFF_POLL_MS)) {
+                ready = kind == handoff::Kind::Ready;
+                break;
+            }
+            ready = errno == ETIMEDOUT && m_running && std::chrono::steady_clock::now() < readyDeadline;
+        }
+        if (!ready) {
+            for (int fd : fds) close(fd);
+            close(channel);
+            if (m_running) logging::error("Upgrade aborted: the new process did not start accepting");
+            continue;
+        }
+
+        logging::info("Upgrade: the new process is accepting, handing off connections");
+        m_handoffChannel = channel;
+        for (auto& loop : m_loops) {
+            loop->beginHandoff();
+        }
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_options.handoffTimeoutMs);
+        while (m_running && getActiveClients() > 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_handoffMutex);
+            m_handoffClosed = true;
+            handoff::send(channel, handoff::Kind::Done, std::string(), nullptr, 0);
+        }
+        const int remaining = getActiveClients();
+        logging::info("Upgrade: handoff finished, " + std::to_string(remaining) + " connections left to close");
+        m_upgraded = true;
+        return;
+    }
+}
+
+/**
+ * @details     ;  
+ *     (onPosted)
+ */
+void Server::receiveConnections() {
+    size_t next = 0;
+    handoff::Kind kind;
+    std::string data;
+    std::vector<int> fds;
+    while (m_running) {
+        if (!handoff::receive(m_takeoverChannel, kind, data, fds, HANDOFF_POLL_MS)) {
+            if (errno == ETIMEDOUT) continue;
+            logging::warning("Upgrade channel closed before the handoff finished");
+            return;
+        }
+        if (kind == handoff::Kind::Done) {
+            logging::info("Upgrade: the previous process finished the handoff");
+            return;
+        }
+        auto adoption = std::make_unique<handoff::Adoption>();
+        if (kind != handoff::Kind::Connection || fds.size() != 1 || !handoff::decode(data, adoption->state)) {
+            for (int fd : fds) closesocket(fd);
+            continue;
+        }
+        adoption->socket = fds[0];
+        m_loops[next++ % m_socketShards]->post(adoption.release());
+    }
+}
+
+bool Server::canHandOff(const Reactor& loop, const Connection& conn) const {
+    return !conn.session && !conn.decoder.hasPartial() && !conn.readPaused && loop.queuedBytes(conn) == 0
+        && (!conn.deferredReplies || conn.deferredReplies->empty()) && conn.requestSeq == conn.replySeq && conn.poolJobs == 0
+        && (!conn.subscriber || conn.subscriber->outbox.empty());
+}
+
+bool Server::handOff(Reactor& loop, Connection& conn) {
+    if (!canHandOff(loop, conn)) return false;
+    handoff::ConnectionState state;
+    state.connectionClass = static_cast<uint8_t>(conn.connectionClass);
+    state.compressReplies = conn.compressReplies;
+    state.replyDictionary = static_cast<uint8_t>(conn.replyDictionary);
+    if (conn.subscriber) {
+        for (const Subscriber::Membership& membership : conn.subscriber->topics) {
+            state.topics.push_back(membership.topic->name);
+        }
+    }
+    std::lock_guard<std::mutex> lock(m_handoffMutex);
+    if (m_handoffClosed) return false;
+    if (!handoff::send(m_handoffChannel, handoff::Kind::Connection, handoff::encode(state), &conn.socket, 1, false)) {
+        return false;
+    }
+    metrics::add(metrics::Counter::HandedOff);
+    return true;
+}
+
+/**
+ * @details  ,       
+ * ;        
+ */
+void Server::adopt(Reactor& loop, const handoff::Adoption& adoption) {
+    const handoff::ConnectionState& state = adoption.state;
+    const ConnectionClass connectionClass = state.connectionClass == static_cast<uint8_t>(ConnectionClass::Active)
+        ? ConnectionClass::Active : ConnectionClass::New;
+    Connection* conn = loop.adoptSocket(adoption.socket, connectionClass);
+    if (!conn) return;
+    if (state.compressReplies && m_options.compression.enabled && compression::knownDictionary(state.replyDictionary)) {
+        conn->compressReplies = true;
+        conn->replyDictionary = static_cast<compression::Dictionary>(state.replyDictionary);
+    }
+    for (const std::string& topic : state.topics) {
+        loop.topics().subscribe(*conn, topic);
+    }
+    onConnect(loop, *conn);
+}
+#endif
+
+int Server::connectionLimit() const {
+    const unsigned limit = m_options.admission.maxConnections;
+#ifdef __linux__
+    return limit == 0 ? MAX_CLIENTS : static_cast<int>(std::min<unsigned>(limit, INT_MAX));
+#else
+    return limit == 0 ? MAX_CLIENTS : static_cast<int>(std::min<unsigned>(limit, MAX_CLIENTS));
+#endif
+}
+
+bool applyProfile(const std::string& name, ServerOptions& options) {
+    if (name == "default") {
+        const ServerOptions defaults;
+        options.pinThreads = defaults.pinThreads;
+        options.numaLocal = defaults.numaLocal;
+        options.noDelay = defaults.noDelay;
+        options.quickAck = defaults.quickAck;
+        options.sendBuffer = defaults.sendBuffer;
+        options.receiveBuffer = defaults.receiveBuffer;
+        options.busyPollUs = defaults.busyPollUs;
+        options.spinUs = defaults.spinUs;
+        options.eventBatch = defaults.eventBatch;
+        options.readBufferSize = defaults.readBufferSize;
+        return true;
+    }
+    if (name == "low-latency") {
+        options.pinThreads = true;
+        options.numaLocal = true;
+        options.noDelay = true;
+        options.quickAck = true;
+        //    ,    
+        options.sendBuffer = 256 * 1024;
+        options.receiveBuffer = 256 * 1024;
+        options.busyPollUs = 50;
+        //          
+        options.spinUs = std::thread::hardware_concurrency() > 1 ? 50 : 0;
+        options.eventBatch = 64;
+        options.readBufferSize = 64 * 1024;
+        return true;
+    }
+    if (name == "throughput") {
+        options.pinThreads = false;
+        options.numaLocal = false;
+        options.noDelay = false;
+        options.quickAck = false;
+        //  SO_RCVBUF  ,    
+        options.sendBuffer = 0;
+        options.receiveBuffer = 0;
+        options.busyPollUs = 0;
+        options.spinUs = 0;
+        options.eventBatch = 1024;
+        options.readBufferSize = 256 * 1024;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @details    Hello -   , 
+ *  
+ */
+bool Server::negotiate(const protocol::FrameView& hello, Response& response, compression::Dictionary& dictionary) const {
+    const compression::Options& options = m_options.compression;
+    bool offered = false;
+    compression::Dictionary proposed = compression::Dictionary::None;
+    const bool accepted = options.enabled && compression::parseHello(hello, offered, proposed) && offered;
+    dictionary = accepted && proposed == options.dictionary ? proposed : compression::Dictionary::None;
+    char payload[compression::HELLO_SIZE];
+    compression::encodeHello(payload, accepted, dictionary);
+    response.write(protocol::MessageType::Hello, payload, sizeof(payload));
+    return accepted;
+}
+
+bool Server::inflateFrame(protocol::FrameView& frame, buffers::Buffer& storage) {
+    const size_t compressedSize = frame.size;
+    const auto started = std::chrono::steady_clock::now();
+    if (!compression::inflate(frame, storage)) return false;
+    metrics::add(metrics::Counter::DecompressNanos, static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count()));
+    metrics::add(metrics::Counter::CompressedIn);
+    metrics::add(metrics::Counter::DecompressedBytesIn, compressedSize);
+    metrics::add(metrics::Counter::DecompressedBytesOut, frame.size);
+    return true;
+}
+
+/**
+ * @details  Hello  :    ,   
+ */
+buffers::Buffer Server::compressReply(protocol::MessageType type, uint8_t flags, const char* payload, size_t size,
+    const Response& request, compression::Dictionary dictionary) const {
+    if (size < m_options.compression.threshold || type == protocol::MessageType::Hello) return buffers::Buffer();
+    const auto started = std::chrono::steady_clock::now();
+    buffers::Buffer frame = request.correlated()
+        ? compression::makeCorrelatedFrame(type, request.correlation(), payload, size, dictionary, flags)
+        : compression::makeFrame(type, payload, size, dictionary, flags);
+    metrics::add(metrics::Counter::CompressNanos, static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count()));
+    metrics::add(metrics::Counter::CompressBytesIn, size);
+    protocol::FrameView view;
+    size_t headerSize = 0;
+    if (!frame || protocol::parseHeader(frame.data(), frame.size(), view, headerSize) != protocol::ParseStatus::Complete) {
+        metrics::add(metrics::Counter::CompressSkipped);
+        metrics::add(metrics::Counter::CompressBytesOut, size);
+        return buffers::Buffer();
+    }
+    metrics::add(metrics::Counter::CompressedOut);
+    metrics::add(metrics::Counter::CompressBytesOut, view.size);
+    return frame;
+}
+
 /**
  * @brief   
  */
 void Server::cleanup() {
+#ifdef __linux__
+    //  upgradeSocket  :      
+    for (int* fd : { &m_upgradeListener, &m_handoffChannel, &m_takeoverChannel }) {
+        if (*fd >= 0) close(*fd);
+        *fd = -1;
+    }
+    for (SOCKET s : m_shardSockets) {
+        closesocket(s);
+    }
+    m_shardSockets.clear();
+    //        ,   upgradeSocket
+    for (SOCKET* s : { &m_unixSocket, &m_shmSocket }) {
+        if (*s != INVALID_SOCKET) closesocket(*s);
+        *s = INVALID_SOCKET;
+    }
+#endif
     if (m_serverSocket != INVALID_SOCKET) {
         closesocket(m_serverSocket);
         m_serverSocket = INVALID_SOCKET;
     }
-    WSACleanup();
+    net::shutdown();
 }
\ No newline at end of file
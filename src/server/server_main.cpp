@@ -1,4 +1,7 @@
 #include "../include/server/server.hpp"
+#include <fstream>
+#include <set>
+#include <sstream>
 
 std::atomic<bool> g_running{ true };
 
@@ -6,22 +9,401 @@ void signalHandler(int) {
     g_running = false;
 }
 
-int main() {
+/**
+ * @brief ,  - (--coroutine-echo)
+ */
+coro::Task<void> echoSession(Session& session) {
+    while (auto frame = co_await session.readFrame()) {
+        const bool written = co_await session.write(*frame);
+        if (!written) break;
+    }
+}
+
+/**
+ * @brief :   
+ */
+const std::set<std::string> SWITCHES = { "--io-uring", "--pin", "--numa-local", "--no-delay", "--quick-ack",
+    "--coroutine-echo", "--pool-echo", "--compression" };
+
+/**
+ * @brief       args
+ * @details   - " = "  " ",   -
+ *      "--";   
+ *    true/false.      # 
+ * @return false -   
+ */
+bool readConfig(const std::string& path, std::vector<std::string>& args) {
+    std::ifstream file(path);
+    if (!file) return false;
+    std::string line;
+    while (std::getline(file, line)) {
+        line = line.substr(0, line.find('#'));
+        std::replace(line.begin(), line.end(), '=', ' ');
+        std::istringstream fields(line);
+        std::string key;
+        std::string value;
+        if (!(fields >> key)) continue;
+        std::getline(fields >> std::ws, value);
+        value.erase(value.find_last_not_of(" \t\r") + 1);
+        key = "--" + key;
+        if (SWITCHES.count(key)) {
+            if (value == "false" || value == "off" || value == "0") continue;
+            args.push_back(key);
+        }
+        else {
+            args.push_back(key);
+            args.push_back(value);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief     "2,4-7"
+ */
+std::vector<int> parseCpuList(const std::string& text) {
+    std::vector<int> cpus;
+    std::istringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        const size_t dash = item.find('-');
+        const int first = std::stoi(item.substr(0, dash));
+        const int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+        if (first < 0 || last < first) throw std::invalid_argument(item);
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    if (cpus.empty()) throw std::invalid_argument(text);
+    return cpus;
+}
+
+int main(int argc, char* argv[]) {
+#ifdef _WIN32
     setlocale(LC_ALL, "Russian");
     SetConsoleCP(1251);
     SetConsoleOutputCP(1251);
+#endif
     std::signal(SIGINT, signalHandler);
 
-    Server server(8080);
+    // --config FILE:    ( " = ");      
+    // --profile default|low-latency|throughput:   ,    
+    // --port N: TCP-  (  8080)
+    // --io-uring:  io_uring (    - epoll)
+    // --threads N:   (0 -   )
+    // --pin:     
+    // --cpus LIST:  ,  2,4-7 (   ,  )
+    // --numa-local:      NUMA  
+    // --log-level L: debug, info, warning, error, off
+    // --log-sample N:   N-   (0 -  )
+    // --handshake-timeout MS:      
+    // --idle-timeout MS:   
+    // --read-timeout MS:   
+    // --write-timeout MS:   
+    // (0 -  )
+    // --zero-copy N:   N     (MSG_ZEROCOPY/SEND_ZC)
+    // --admin-port N:   (GET /metrics - Prometheus, GET /stats - JSON)
+    // --admin-address A:    (  127.0.0.1)
+    // --admin-control FILE:  POST /connections/ID/send|close      FILE   X-Admin-Token
+    // --max-connections N:   ;    
+    // --max-per-source N:     IP-
+    // --message-rate R:     , --message-burst N:   R
+    // --shed-latency-us US:    ,    
+    // --shed-queue-depth N:     ,    
+    // --coroutine-echo:  -   
+    // --pool-echo:      ,     
+    // --workers N:   (0 -   ), --worker-queue N:     
+    // --slow-subscriber drop-oldest|disconnect|coalesce:    ,    
+    // --subscriber-queue N:      
+    // --compression:   ,    Hello
+    // --compression-threshold N:     N 
+    // --compression-dict chat|none:   
+    // --upgrade-socket PATH: Unix-,       
+    // --takeover PATH:       ,   --upgrade-socket PATH
+    // --handoff-timeout MS:     ,    
+    // --unix-socket PATH:       Unix- (  unix:PATH)
+    // --shm-socket PATH:         (  shm:PATH)
+    // --backlog N:   listen (  SOMAXCONN)
+    // --defer-accept S: TCP_DEFER_ACCEPT,      ,    S  (0 - )
+    // --fastopen N:  TCP Fast Open    (0 - )
+    // --max-message-size N:      
+    // --no-delay: TCP_NODELAY, --quick-ack: TCP_QUICKACK,     
+    // --send-buffer N, --receive-buffer N: SO_SNDBUF/SO_RCVBUF  (0 -  )
+    // --busy-poll US: SO_BUSY_POLL,      
+    // --spin US:  epoll     US    
+    // --event-batch N:    epoll_wait, --read-buffer N:   recv
+    // --capture FILE:      (Replay), --capture-limit MB:   
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--config" && i + 1 < argc) {
+            if (!readConfig(argv[++i], args)) {
+                std::cerr << "Cannot read config file: " << argv[i] << "\n";
+                return 1;
+            }
+            continue;
+        }
+        args.push_back(arg);
+    }
+
+    ServerOptions options;
+    //        ,     
+    for (size_t i = 0; i + 1 < args.size(); ++i) {
+        if (args[i] == "--profile" && !applyProfile(args[i + 1], options)) {
+            std::cerr << "Unknown profile: " << args[i + 1] << "\n";
+            return 1;
+        }
+    }
+    TimeoutPolicy& handshake = options.timeouts[static_cast<size_t>(ConnectionClass::New)];
+    TimeoutPolicy& active = options.timeouts[static_cast<size_t>(ConnectionClass::Active)];
+    logging::Logger& logger = logging::Logger::instance();
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        const bool hasValue = !SWITCHES.count(arg) && i + 1 < args.size();
+        try {
+            if (arg == "--profile" && hasValue) {
+                ++i;
+            }
+            else if (arg == "--port" && hasValue) {
+                const unsigned long port = std::stoul(args[++i]);
+                if (port == 0 || port > 65535) throw std::out_of_range(args[i]);
+                options.port = static_cast<uint16_t>(port);
+            }
+            else if (arg == "--io-uring") {
+                options.engine = IoEngine::IoUring;
+            }
+            else if (arg == "--threads" && hasValue) {
+                options.reactorThreads = static_cast<unsigned>(std::stoul(args[++i]));
+                if (options.reactorThreads == 0) {
+                    options.reactorThreads = std::max(1u, std::thread::hardware_concurrency());
+                }
+            }
+            else if (arg == "--pin") {
+                options.pinThreads = true;
+            }
+            else if (arg == "--log-level" && hasValue) {
+                logging::LogLevel level;
+                if (!logging::parseLevel(args[++i], level)) {
+                    std::cerr << "Unknown log level: " << args[i] << "\n";
+                    return 1;
+                }
+                logger.setLevel(level);
+            }
+            else if (arg == "--log-sample" && hasValue) {
+                logger.setSampleRate(static_cast<unsigned>(std::stoul(args[++i])));
+            }
+            else if (arg == "--handshake-timeout" && hasValue) {
+                handshake.idleMs = static_cast<uint32_t>(std::stoul(args[++i]));
+            }
+            else if (arg == "--idle-timeout" && hasValue) {
+                active.idleMs = static_cast<uint32_t>(std::stoul(args[++i]));
+            }
+            else if (arg == "--read-timeout" && hasValue) {
+                handshake.readMs = active.readMs = static_cast<uint32_t>(std::stoul(args[++i]));
+            }
+            else if (arg == "--write-timeout" && hasValue) {
+                handshake.writeMs = active.writeMs = static_cast<uint32_t>(std::stoul(args[++i]));
+            }
+            else if (arg == "--zero-copy" && hasValue) {
+                options.zeroCopyThreshold = static_cast<size_t>(std::stoul(args[++i]));
+            }
+            else if (arg == "--admin-port" && hasValue) {
+                options.adminPort = static_cast<uint16_t>(std::stoul(args[++i]));
+            }
+            else if (arg == "--admin-address" && hasValue) {
+                options.adminAddress = args[++i];
+            }
+            else if (arg == "--admin-control" && hasValue) {
+                //   ,     :      ps
+                std::ifstream file(args[++i]);
+                if (!file || !std::getline(file, options.adminToken)) {
+                    std::cerr << "Cannot read admin token file: " << args[i] << "\n";
+                    return 1;
+                }
+                options.adminToken.erase(options.adminToken.find_last_not_of(" \t\r") + 1);
+                if (options.adminToken.empty()) {
+                    std::cerr << "Admin token file is empty: " << args[i] << "\n";
+                    return 1;
+                }
+            }
+            else if (arg == "--max-connections" && hasValue) {
+                options.admission.maxConnections = static_cast<unsigned>(std::stoul(args[++i]));
+            }
+            else if (arg == "--max-per-source" && hasValue) {
+                options.admission.maxPerSource = static_cast<unsigned>(std::stoul(args[++i]));
+            }
+            else if (arg == "--message-rate" && hasValue) {
+                options.admission.messageRate = std::stod(args[++i]);
+            }
+            else if (arg == "--message-burst" && hasValue) {
+                options.admission.messageBurst = static_cast<unsigned>(std::stoul(args[++i]));
+            }
+            else if (arg == "--shed-latency-us" && hasValue) {
+                options.admission.shedLatencyUs = static_cast<uint32_t>(std::stoul(args[++i]));
+            }
+            else if (arg == "--shed-queue-depth" && hasValue) {
+                options.admission.shedQueueDepth = static_cast<unsigned>(std::stoul(args[++i]));
+            }
+            else if (arg == "--coroutine-echo") {
+                options.sessionHandler = echoSession;
+            }
+            else if (arg == "--pool-echo") {
+                options.router.handle(protocol::MessageType::Text, [](const protocol::FrameView& request, Response& response) {
+                    response.send(request);
+                    }, Router::Dispatch::Pool);
+            }
+            else if (arg == "--workers" && hasValue) {
+                options.workerThreads = static_cast<unsigned>(std::stoul(args[++i]));
+            }
+            else if (arg == "--worker-queue" && hasValue) {
+                options.workerQueueDepth = static_cast<size_t>(std::stoul(args[++i]));
+            }
+            else if (arg == "--slow-subscriber" && hasValue) {
+                const std::string policy = args[++i];
+                if (policy == "drop-oldest") options.pubsub.policy = SlowSubscriberPolicy::DropOldest;
+                else if (policy == "disconnect") options.pubsub.policy = SlowSubscriberPolicy::Disconnect;
+                else if (policy == "coalesce") options.pubsub.policy = SlowSubscriberPolicy::Coalesce;
+                else {
+                    std::cerr << "Unknown option or missing value: " << arg << " " << policy << "\n";
+                    return 1;
+                }
+            }
+            else if (arg == "--subscriber-queue" && hasValue) {
+                options.pubsub.maxQueued = static_cast<size_t>(std::stoul(args[++i]));
+            }
+            else if (arg == "--compression") {
+                options.compression.enabled = true;
+            }
+            else if (arg == "--compression-threshold" && hasValue) {
+                options.compression.threshold = static_cast<size_t>(std::stoul(args[++i]));
+            }
+            else if (arg == "--compression-dict" && hasValue) {
+                const std::string dictionary = args[++i];
+                if (dictionary == "chat") options.compression.dictionary = compression::Dictionary::Chat;
+                else if (dictionary == "none") options.compression.dictionary = compression::Dictionary::None;
+                else {
+                    std::cerr << "Unknown option or missing value: " << arg << " " << dictionary << "\n";
+                    return 1;
+                }
+            }
+            else if (arg == "--upgrade-socket" && hasValue) {
+                options.upgradeSocket = args[++i];
+            }
+            else if (arg == "--takeover" && hasValue) {
+                options.takeoverSocket = args[++i];
+            }
+            else if (arg == "--handoff-timeout" && hasValue) {
+                options.handoffTimeoutMs = static_cast<uint32_t>(std::stoul(args[++i]));
+            }
+            else if (arg == "--unix-socket" && hasValue) {
+                options.unixSocket = args[++i];
+            }
+            else if (arg == "--shm-socket" && hasValue) {
+                options.shmSocket = args[++i];
+            }
+            else if (arg == "--backlog" && hasValue) {
+                options.listenBacklog = std::stoi(args[++i]);
+            }
+            else if (arg == "--defer-accept" && hasValue) {
+                options.deferAcceptSec = std::stoi(args[++i]);
+            }
+            else if (arg == "--fastopen" && hasValue) {
+                options.fastOpenQueue = std::stoi(args[++i]);
+            }
+            else if (arg == "--max-message-size" && hasValue) {
+                options.maxMessageSize = static_cast<size_t>(std::stoul(args[++i]));
+            }
+            else if (arg == "--cpus" && hasValue) {
+                options.cpus = parseCpuList(args[++i]);
+            }
+            else if (arg == "--numa-local") {
+                options.numaLocal = true;
+            }
+            else if (arg == "--no-delay") {
+                options.noDelay = true;
+            }
+            else if (arg == "--quick-ack") {
+                options.quickAck = true;
+            }
+            else if (arg == "--send-buffer" && hasValue) {
+                options.sendBuffer = std::stoi(args[++i]);
+            }
+            else if (arg == "--receive-buffer" && hasValue) {
+                options.receiveBuffer = std::stoi(args[++i]);
+            }
+            else if (arg == "--busy-poll" && hasValue) {
+                options.busyPollUs = std::stoi(args[++i]);
+            }
+            else if (arg == "--spin" && hasValue) {
+                options.spinUs = static_cast<uint32_t>(std::stoul(args[++i]));
+            }
+            else if (arg == "--event-batch" && hasValue) {
+                options.eventBatch = std::stoi(args[++i]);
+            }
+            else if (arg == "--read-buffer" && hasValue) {
+                options.readBufferSize = static_cast<size_t>(std::stoul(args[++i]));
+            }
+            else if (arg == "--capture" && hasValue) {
+                options.captureFile = args[++i];
+            }
+            else if (arg == "--capture-limit" && hasValue) {
+                options.captureLimit = static_cast<size_t>(std::stoull(args[++i])) << 20;
+            }
+            else {
+                std::cerr << "Unknown option or missing value: " << arg << "\n";
+                return 1;
+            }
+        }
+        catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << args[i] << "\n";
+            return 1;
+        }
+    }
+
+    Server server(options.port, options);
     if (!server.start()) {
         return 1;
     }
 
     std::cout << "Server running. Press Ctrl+C to stop.\n";
-    while (g_running) {
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+    //       :  
+    while (g_running && !server.upgraded()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    if (server.upgraded()) {
+        std::cout << "Upgrade finished, the new process serves the clients.\n";
     }
 
     server.stop();
+
+    const buffers::PoolStats pool = buffers::BufferPool::totalStats();
+    std::cout << "Buffer pool: " << pool.acquired << " buffers acquired, hit rate "
+        << pool.hitRate() * 100.0 << "%, high-water " << pool.highWater << " buffers\n";
+    const logging::LoggerStats log = logger.stats();
+    const metrics::Snapshot stats = metrics::snapshot();
+    const double sentGb = static_cast<double>(stats.counter(metrics::Counter::BytesOut)) / 1e9;
+    std::cout << "Transmit: " << stats.counter(metrics::Counter::BytesOut) << " bytes, "
+        << stats.counter(metrics::Counter::ZeroCopySends) << " zero-copy sends ("
+        << stats.counter(metrics::Counter::ZeroCopyCopied) << " copied by the kernel), CPU "
+        << stats.cpuSeconds << " s";
+    if (sentGb > 0) std::cout << " (" << stats.cpuSeconds / sentGb << " s/GB)";
+    std::cout << "\n";
+    const uint64_t compressIn = stats.counter(metrics::Counter::CompressBytesIn);
+    const uint64_t decompressOut = stats.counter(metrics::Counter::DecompressedBytesOut);
+    if (compressIn > 0 || decompressOut > 0) {
+        auto ratio = [](uint64_t numerator, uint64_t denominator) {
+            return denominator ? static_cast<double>(numerator) / static_cast<double>(denominator) : 0.0;
+        };
+        std::cout << "Compression: replies " << ratio(compressIn, stats.counter(metrics::Counter::CompressBytesOut))
+            << "x at " << ratio(stats.counter(metrics::Counter::CompressNanos), compressIn) << " ns/byte, requests "
+            << ratio(decompressOut, stats.counter(metrics::Counter::DecompressedBytesIn)) << "x at "
+            << ratio(stats.counter(metrics::Counter::DecompressNanos), decompressOut) << " ns/byte\n";
+    }
+    if (!server.captureFile().empty()) {
+        std::cout << "Capture: " << stats.counter(metrics::Counter::CaptureFrames) << " frames written to "
+            << server.captureFile() << ", " << stats.counter(metrics::Counter::CaptureDropped) << " dropped\n";
+    }
+    std::cout << "Logger: " << log.written << " records written, " << log.dropped << " dropped, "
+        << log.sampledOut << " sampled out\n";
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "../include/server/session.hpp"
+#include "../include/server/logger.hpp"
+#include <cstring>
+
+void Session::start(const Handler& handler) {
+    m_task = handler(*this);
+    m_task.start();
+    settle();
+}
+
+/**
+ * @details        
+ *   ;       readFrame
+ */
+bool Session::deliver(const protocol::FrameView& frame) {
+    if (m_closed || finished()) return false;
+    if (m_reader) {
+        m_currentStorage.reset();
+        m_current = frame;
+        std::exchange(m_reader, {}).resume();
+        settle();
+        return !finished();
+    }
+
+    QueuedFrame queued{ frame.type, frame.flags, {} };
+    if (frame.storage) {
+        queued.payload = *frame.storage;
+    }
+    else {
+        queued.payload = buffers::BufferPool::get(frame.size);
+        if (frame.size > 0) std::memcpy(queued.payload.data(), frame.payload, frame.size);
+    }
+    m_inbox.push_back(std::move(queued));
+    return true;
+}
+
+void Session::close() {
+    if (m_closed) return;
+    m_closed = true;
+    m_inbox.clear();
+    if (m_reader) {
+        m_currentStorage.reset();
+        m_current.reset();
+        std::exchange(m_reader, {}).resume();
+        settle();
+    }
+}
+
+bool Session::ReadAwaiter::await_ready() {
+    if (!m_session.m_inbox.empty()) {
+        m_session.takeQueued();
+        return true;
+    }
+    if (m_session.m_closed) {
+        m_session.m_currentStorage.reset();
+        m_session.m_current.reset();
+        return true;
+    }
+    return false;
+}
+
+void Session::ReadAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    m_session.m_reader = handle;
+}
+
+Session::WriteAwaiter Session::write(const protocol::FrameView& frame) {
+    if (m_closed || m_closing) return WriteAwaiter(false);
+    if (!m_send(frame.type, frame.flags, frame.payload, frame.size, frame.storage)) {
+        m_closing = true;
+        return WriteAwaiter(false);
+    }
+    return WriteAwaiter(true);
+}
+
+Session::WriteAwaiter Session::write(protocol::MessageType type, const char* payload, size_t size) {
+    protocol::FrameView frame;
+    frame.type = type;
+    frame.payload = payload;
+    frame.size = size;
+    return write(frame);
+}
+
+void Session::takeQueued() {
+    QueuedFrame& queued = m_inbox.front();
+    m_currentStorage = std::move(queued.payload);
+    protocol::FrameView frame;
+    frame.type = queued.type;
+    frame.flags = queued.flags;
+    frame.payload = m_currentStorage.data();
+    frame.size = m_currentStorage.size();
+    frame.storage = &m_currentStorage;
+    m_current = frame;
+    m_inbox.pop_front();
+}
+
+/**
+ * @brief  ,   
+ */
+void Session::settle() {
+    if (!m_task.valid() || !m_task.done()) return;
+    try {
+        m_task.result();
+    }
+    catch (const std::exception& e) {
+        logging::error(std::string("Session handler failed: ") + e.what());
+    }
+    catch (...) {
+        logging::error("Session handler failed");
+    }
+    m_task = {};
+    m_closing = true;
+}
@@ -0,0 +1,459 @@
+#include "../include/server/server.hpp"
+#include <sys/epoll.h>
+
+namespace {
+    constexpr uint64_t TAG_BITS = 2;
+    constexpr uint64_t TAG_MASK = (uint64_t(1) << TAG_BITS) - 1;
+}
+
+ShmLoop::ShmLoop(Server& server, SOCKET listenSocket)
+    : m_server(server), m_listenSocket(listenSocket) {
+}
+
+ShmLoop::~ShmLoop() {
+    stop();
+    if (m_wakeFd >= 0) {
+        close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+}
+
+bool ShmLoop::start() {
+    if (m_running) return true;
+
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epollFd < 0) {
+        std::cerr << "epoll_create1 failed: " << errno << "\n";
+        return false;
+    }
+    if (m_wakeFd < 0) m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wakeFd < 0) {
+        std::cerr << "eventfd failed: " << errno << "\n";
+        stop();
+        return false;
+    }
+
+    net::setNonBlocking(m_listenSocket);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = static_cast<uint64_t>(Tag::Listener);
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_listenSocket, &ev) < 0) {
+        std::cerr << "epoll_ctl failed: " << errno << "\n";
+        stop();
+        return false;
+    }
+    ev.data.u64 = static_cast<uint64_t>(Tag::Wake);
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &ev);
+
+    m_running = true;
+    m_thread = std::thread(&ShmLoop::run, this);
+    return true;
+}
+
+/**
+ * @details      serverClosed ( eventfd )
+ *    Unix-
+ */
+void ShmLoop::stop() {
+    if (m_running.exchange(false)) {
+        wake();
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    for (auto& entry : m_connections) {
+        ShmConnection& conn = *entry.second;
+        m_topics.remove(conn);
+        cancelTimers(conn);
+        releaseSource(conn);
+        unregisterConnection(conn);
+        conn.channel->layout().serverClosed.store(1, std::memory_order_release);
+        shm::notify(conn.channel->clientEvent());
+        closesocket(conn.socket);
+        m_connectionCount--;
+        metrics::adjust(metrics::Gauge::Connections, -1);
+    }
+    m_connections.clear();
+    m_list.clear();
+    if (m_epollFd >= 0) {
+        close(m_epollFd);
+        m_epollFd = -1;
+    }
+}
+
+/**
+ * @brief   
+ * @details     shm::SPIN,   
+ *     POLL_EVERY    epoll   (
+ * , ).         
+ * epoll_wait  , eventfd    
+ */
+void ShmLoop::run() {
+    pinThread();
+    std::vector<epoll_event> events(MAX_EVENTS);
+    m_readBuffer.assign(READ_BUFFER_SIZE, 0);
+    const auto spin = shm::spinTime();
+    Clock::time_point lastWork = Clock::now();
+    unsigned passes = 0;
+
+    while (m_running) {
+        m_now = Clock::now();
+        size_t work = 0;
+        if (pollRings()) ++work;
+        if (takeCompletionsPending()) {
+            m_server.onPosted(*this);
+            ++work;
+        }
+        notifyClients();
+        if (work > 0) lastWork = m_now;
+
+        int timeout = -1;
+        bool sleeping = false;
+        if (work == 0 && m_now - lastWork >= spin) {
+            sleeping = prepareSleep();
+            timeout = sleeping ? timerTimeoutMs() : 0;
+        }
+        else if (++passes % POLL_EVERY == 0) {
+            timeout = 0;
+        }
+        else {
+            shm::cpuRelax();
+            expireTimers();
+            continue;
+        }
+
+        const int count = epoll_wait(m_epollFd, events.data(), MAX_EVENTS, timeout);
+        if (sleeping) finishSleep();
+        m_now = Clock::now();
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            logging::error("epoll_wait failed: " + std::to_string(errno));
+            break;
+        }
+        if (count > 0) {
+            lastWork = m_now;
+            handleEvents(events.data(), count);
+        }
+        expireTimers();
+        updateAdmission(work + static_cast<size_t>(count));
+        updateHandoff();
+    }
+}
+
+bool ShmLoop::pollRings() {
+    bool worked = false;
+    // ,   :     
+    // (  )   
+    for (size_t i = 0; i < m_list.size(); ++i) {
+        if (m_list[i] && service(*m_list[i])) worked = true;
+    }
+    if (m_listHoles > 0) compactList();
+    return worked;
+}
+
+/**
+ * @details      m_readBuffer   
+ * :        , 
+ *          .
+ *    onData -     ,
+ *   ,    
+ */
+bool ShmLoop::service(ShmConnection& conn) {
+    bool worked = false;
+    if (!conn.pending.empty()) {
+        const size_t before = conn.pending.size();
+        if (!flush(conn)) return true;
+        worked = conn.pending.size() != before;
+    }
+    if (conn.readStopped()) return worked;
+
+    shm::Ring& ring = conn.channel->toServer();
+    bool consumed = false;
+    //     (       ),
+    //      
+    for (int part = 0; part < 2 && !conn.readStopped(); ++part) {
+        size_t size = 0;
+        const char* data = ring.peek(size);
+        if (size == SIZE_MAX) {
+            closeConnection(conn, "corrupt shared ring");
+            return true;
+        }
+        if (!data) break;
+        if (size > m_readBuffer.size()) size = m_readBuffer.size();
+        std::memcpy(m_readBuffer.data(), data, size);
+        ring.consume(size);
+        if (shm::takeWriterWaiting(ring)) shm::wakeSpace(ring.state());
+        consumed = true;
+        conn.lastActivity = m_now;
+        metrics::add(metrics::Counter::BytesIn, size);
+        if (!m_server.onData(*this, conn, m_readBuffer.data(), size)) return true;
+    }
+    return worked || consumed;
+}
+
+/**
+ * @details      : , 
+ *  ,       eventfd
+ */
+bool ShmLoop::prepareSleep() {
+    for (ShmConnection* conn : m_list) {
+        if (!conn) continue;
+        const bool ready = (!conn->readStopped() && !shm::prepareRead(conn->channel->toServer()))
+            || (!conn->pending.empty() && !shm::prepareWrite(conn->channel->toClient()));
+        if (ready) {
+            finishSleep();
+            return false;
+        }
+    }
+    return true;
+}
+
+void ShmLoop::finishSleep() {
+    for (ShmConnection* conn : m_list) {
+        if (!conn) continue;
+        conn->channel->toServer().state().readerWaiting.store(0, std::memory_order_relaxed);
+        conn->channel->toClient().state().writerWaiting.store(0, std::memory_order_relaxed);
+    }
+}
+
+void ShmLoop::handleEvents(const epoll_event* events, int count) {
+    for (int i = 0; i < count; ++i) {
+        const uint64_t data = events[i].data.u64;
+        const Tag tag = static_cast<Tag>(data & TAG_MASK);
+        if (tag == Tag::Listener) {
+            acceptAll();
+            continue;
+        }
+        if (tag == Tag::Wake) {
+            shm::drainEvent(m_wakeFd);
+            continue;
+        }
+
+        //       
+        auto it = m_connections.find(data >> TAG_BITS);
+        if (it == m_connections.end()) continue;
+        ShmConnection& conn = *it->second;
+        if (tag == Tag::Event) {
+            shm::drainEvent(conn.channel->serverEvent());
+            continue;
+        }
+        //      :    - 
+        char byte;
+        const ssize_t received = recv(conn.socket, &byte, sizeof(byte), 0);
+        if (received == 0) {
+            // ,   ,  
+            service(conn);
+            if (m_connections.count(data >> TAG_BITS)) closeConnection(conn, "graceful disconnect");
+        }
+        else if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            closeConnection(conn, "socket error: " + std::to_string(errno));
+        }
+    }
+}
+
+/**
+ * @brief       
+ * @details        ,   
+ *       127.0.0.1
+ */
+void ShmLoop::acceptAll() {
+    while (m_accepting) {
+        if (m_connectionCount >= m_maxConnections) {
+            pauseForCapacity();
+            return;
+        }
+        SOCKET clientSocket = accept4(m_listenSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (clientSocket == INVALID_SOCKET) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                logging::error("Accept failed: " + std::to_string(errno));
+            }
+            return;
+        }
+
+        auto conn = std::make_unique<ShmConnection>();
+        conn->socket = clientSocket;
+        if (!admitSource(*conn, htonl(INADDR_LOOPBACK))) {
+            rejectSocket(clientSocket, "too many connections from one address");
+            continue;
+        }
+        conn->id = m_nextConnId++;
+        if (!handshake(*conn)) {
+            releaseSource(*conn);
+            closesocket(clientSocket);
+            continue;
+        }
+        initTimers(*conn);
+        registerConnection(*conn);
+        ShmConnection& added = *conn;
+        added.slot = m_list.size();
+        m_list.push_back(&added);
+        m_connections.emplace(added.id, std::move(conn));
+        m_connectionCount++;
+        metrics::adjust(metrics::Gauge::Connections, 1);
+        metrics::add(metrics::Counter::Accepts);
+        logging::connected(clientSocket);
+        m_server.onConnect(*this, added);
+    }
+}
+
+bool ShmLoop::handshake(ShmConnection& conn) {
+    conn.channel = shm::Channel::create();
+    if (!conn.channel) {
+        logging::error("Shared memory channel failed: " + std::to_string(errno));
+        return false;
+    }
+    if (!shm::sendChannel(conn.socket, *conn.channel)) {
+        logging::warning("Shared memory handshake failed: " + std::to_string(errno));
+        return false;
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    ev.data.u64 = conn.id << TAG_BITS | static_cast<uint64_t>(Tag::Socket);
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, conn.socket, &ev) < 0) {
+        logging::error("epoll_ctl failed: " + std::to_string(errno));
+        return false;
+    }
+    ev.events = EPOLLIN;
+    ev.data.u64 = conn.id << TAG_BITS | static_cast<uint64_t>(Tag::Event);
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, conn.channel->serverEvent(), &ev) < 0) {
+        logging::error("epoll_ctl failed: " + std::to_string(errno));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief    ,    pending
+ * @return false -  
+ */
+bool ShmLoop::write(ShmConnection& conn, const char* data, size_t size) {
+    size_t written = 0;
+    //           
+    if (conn.pending.empty()) {
+        written = conn.channel->toClient().write(data, size);
+        if (written == SIZE_MAX) return false;
+        if (written > 0) {
+            metrics::add(metrics::Counter::BytesOut, written);
+            conn.notifyClient = true;
+        }
+    }
+    if (written == size) return true;
+    conn.pending.append(data + written, size - written);
+    armWriteDeadline(conn);
+    //  :  ,     
+    if (conn.pending.size() > MAX_PENDING) conn.readPaused = true;
+    return true;
+}
+
+bool ShmLoop::flush(ShmConnection& conn) {
+    while (!conn.pending.empty()) {
+        const size_t written = conn.channel->toClient().write(conn.pending.data(), conn.pending.size());
+        if (written == SIZE_MAX) {
+            closeConnection(conn, "corrupt shared ring");
+            return false;
+        }
+        if (written == 0) return true;
+        conn.pending.consume(written);
+        metrics::add(metrics::Counter::BytesOut, written);
+        conn.lastWrite = m_now;
+        conn.notifyClient = true;
+    }
+
+    //  :    ,     
+    conn.pending.reset();
+    cancelWriteDeadline(conn);
+    // ,    ,    
+    if (!m_topics.drain(*this, conn)) return false;
+    if (conn.pending.empty()) conn.readPaused = false;
+    return true;
+}
+
+/**
+ * @details  eventfd    ,     
+ */
+void ShmLoop::notifyClients() {
+    for (ShmConnection* conn : m_list) {
+        if (!conn || !conn->notifyClient) continue;
+        conn->notifyClient = false;
+        if (shm::takeReaderWaiting(conn->channel->toClient())) shm::notify(conn->channel->clientEvent());
+    }
+}
+
+bool ShmLoop::sendFrame(Connection& conn, protocol::MessageType type, uint8_t flags,
+    const char* payload, size_t size, const buffers::Buffer* storage) {
+    (void)storage;
+    auto& sconn = static_cast<ShmConnection&>(conn);
+    char header[protocol::MAX_HEADER_SIZE];
+    const size_t headerSize = protocol::encodeHeader(header, type, flags, size);
+    return write(sconn, header, headerSize) && (size == 0 || write(sconn, payload, size));
+}
+
+bool ShmLoop::sendEncoded(Connection& conn, const buffers::Buffer& frame) {
+    return write(static_cast<ShmConnection&>(conn), frame.data(), frame.size());
+}
+
+Connection* ShmLoop::findConnection(SOCKET socket, uint64_t id) {
+    auto it = m_connections.find(id);
+    return it != m_connections.end() && it->second->socket == socket ? it->second.get() : nullptr;
+}
+
+Connection* ShmLoop::adoptSocket(SOCKET socket, ConnectionClass connectionClass) {
+    (void)connectionClass;
+    closesocket(socket);
+    return nullptr;
+}
+
+/**
+ * @details   :     , 
+ *    (  )     
+ */
+void ShmLoop::handOffConnections() {
+}
+
+void ShmLoop::enableAccept(bool enable) {
+    epoll_event ev{};
+    ev.events = enable ? static_cast<uint32_t>(EPOLLIN) : 0u;
+    ev.data.u64 = static_cast<uint64_t>(Tag::Listener);
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_MOD, m_listenSocket, &ev) < 0) {
+        logging::error("epoll_ctl failed: " + std::to_string(errno));
+    }
+}
+
+void ShmLoop::wake() {
+    shm::notify(m_wakeFd);
+}
+
+/**
+ * @details eventfd    epoll :    
+ *   ,       close
+ */
+void ShmLoop::closeConnection(Connection& conn, const std::string& reason) {
+    auto& sconn = static_cast<ShmConnection&>(conn);
+    logging::disconnected(conn.socket, reason);
+    if (conn.session) conn.session->close();
+    m_topics.remove(conn);
+    cancelTimers(conn);
+    releaseSource(conn);
+    unregisterConnection(conn);
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, sconn.channel->serverEvent(), nullptr);
+    sconn.channel->layout().serverClosed.store(1, std::memory_order_release);
+    shm::notify(sconn.channel->clientEvent());
+    closesocket(conn.socket);
+    m_list[sconn.slot] = nullptr;
+    ++m_listHoles;
+    m_connections.erase(sconn.id);
+    m_connectionCount--;
+    metrics::adjust(metrics::Gauge::Connections, -1);
+}
+
+void ShmLoop::compactList() {
+    size_t next = 0;
+    for (ShmConnection* conn : m_list) {
+        if (!conn) continue;
+        conn->slot = next;
+        m_list[next++] = conn;
+    }
+    m_list.resize(next);
+    m_listHoles = 0;
+}
@@ -0,0 +1,881 @@
+#include "../include/server/server.hpp"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+
+namespace {
+    int uringSetup(unsigned entries, io_uring_params* params) {
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    int uringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, const void* arg = nullptr, size_t argSize = 0) {
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize));
+    }
+
+    int uringRegister(int fd, unsigned opcode, void* arg, unsigned count) {
+        return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+    }
+}
+
+/**
+ * @brief     ;    start()
+ */
+UringLoop::UringLoop(Server& server, SOCKET listenSocket)
+    : m_server(server), m_listenSocket(listenSocket) {
+}
+
+/**
+ * @details eventfd  ,    stop():   
+ *     
+ */
+UringLoop::~UringLoop() {
+    stop();
+    if (m_wakeFd >= 0) {
+        close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+}
+
+/**
+ * @brief    ,      
+ * @return false,     io_uring,  
+ *  multishot recv (     epoll)
+ */
+bool UringLoop::start() {
+    if (m_running) return true;
+
+    if (!setupRing() || !setupBuffers() || !probeMultishotRecv()) {
+        stop();
+        return false;
+    }
+    if (m_zeroCopyThreshold > 0) {
+        m_sendZeroCopy = probeOpcode(IORING_OP_SEND_ZC);
+        if (!m_sendZeroCopy) {
+            logging::warning("IORING_OP_SEND_ZC is not supported by the kernel, sending with copies");
+        }
+    }
+    if (m_wakeFd < 0) m_wakeFd = eventfd(0, EFD_CLOEXEC);
+    if (m_wakeFd < 0) {
+        stop();
+        return false;
+    }
+
+    m_running = true;
+    m_thread = std::thread(&UringLoop::run, this);
+    return true;
+}
+
+/**
+ * @brief  ,     
+ */
+void UringLoop::stop() {
+    if (m_running.exchange(false) && m_wakeFd >= 0) {
+        wake();
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    for (auto& entry : m_connections) {
+        m_topics.remove(*entry.second);
+        cancelTimers(*entry.second);
+        releaseSource(*entry.second);
+        unregisterConnection(*entry.second);
+        closesocket(entry.second->socket);
+        m_connectionCount--;
+        metrics::adjust(metrics::Gauge::Connections, -1);
+    }
+    m_connections.clear();
+    m_flushList.clear();
+    for (SOCKET clientSocket : m_pendingAccepts) {
+        closesocket(clientSocket);
+    }
+    m_pendingAccepts.clear();
+
+    //      
+    if (m_ringFd >= 0) {
+        close(m_ringFd);
+        m_ringFd = -1;
+    }
+    if (m_sqes) munmap(m_sqes, m_sqesSize);
+    if (m_cqRing && m_cqRing != m_sqRing) munmap(m_cqRing, m_cqRingSize);
+    if (m_sqRing) munmap(m_sqRing, m_sqRingSize);
+    if (m_bufRing) munmap(m_bufRing, m_bufRingSize);
+    m_sqes = nullptr;
+    m_sqRing = m_cqRing = nullptr;
+    m_bufRing = nullptr;
+    m_sendOps.clear();
+    m_freeSends.clear();
+}
+
+/**
+ * @brief  io_uring   SQ/CQ    
+ */
+bool UringLoop::setupRing() {
+    io_uring_params params{};
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN;
+    params.cq_entries = RING_ENTRIES * 4;
+    m_ringFd = uringSetup(RING_ENTRIES, &params);
+    if (m_ringFd < 0 && errno == EINVAL) {
+        //     SUBMIT_ALL/COOP_TASKRUN
+        params = io_uring_params{};
+        params.flags = IORING_SETUP_CQSIZE;
+        params.cq_entries = RING_ENTRIES * 4;
+        m_ringFd = uringSetup(RING_ENTRIES, &params);
+    }
+    if (m_ringFd < 0) return false;
+    //      io_uring_enter (IORING_ENTER_EXT_ARG)
+    if (!(params.features & IORING_FEAT_EXT_ARG)) return false;
+
+    m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMmap) {
+        m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+    }
+
+    m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+        m_ringFd, IORING_OFF_SQ_RING);
+    if (m_sqRing == MAP_FAILED) {
+        m_sqRing = nullptr;
+        return false;
+    }
+    if (singleMmap) {
+        m_cqRing = m_sqRing;
+    }
+    else {
+        m_cqRing = mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+            m_ringFd, IORING_OFF_CQ_RING);
+        if (m_cqRing == MAP_FAILED) {
+            m_cqRing = nullptr;
+            return false;
+        }
+    }
+    m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+        m_ringFd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) return false;
+    m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+    char* sq = static_cast<char*>(m_sqRing);
+    m_sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    m_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    m_sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    m_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    char* cq = static_cast<char*>(m_cqRing);
+    m_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    m_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    m_cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    //  SQE     
+    for (unsigned i = 0; i < params.sq_entries; ++i) {
+        m_sqArray[i] = i;
+    }
+    m_sqLocalTail = *m_sqTail;
+    return true;
+}
+
+/**
+ * @brief     (IORING_REGISTER_PBUF_RING)
+ * @details ,    ,    ;
+ *    FrameDecoder 
+ */
+bool UringLoop::setupBuffers() {
+    m_bufferSize = BUFFER_SIZE;
+    m_buffers.assign(static_cast<size_t>(BUFFER_COUNT) * m_bufferSize, 0);
+    m_bufferRefs.assign(BUFFER_COUNT, 0);
+
+    m_bufRingSize = BUFFER_COUNT * sizeof(io_uring_buf);
+    void* ring = mmap(nullptr, m_bufRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED) return false;
+    m_bufRing = static_cast<io_uring_buf*>(ring);
+
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<uint64_t>(m_bufRing);
+    reg.ring_entries = BUFFER_COUNT;
+    reg.bgid = BUFFER_GROUP;
+    if (uringRegister(m_ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) return false;
+
+    m_bufTail = 0;
+    for (unsigned i = 0; i < BUFFER_COUNT; ++i) {
+        recycleBuffer(static_cast<int>(i));
+    }
+    return true;
+}
+
+/**
+ * @brief  multishot recv    
+ * @details  IORING_RECV_MULTISHOT    ,
+ *       -EINVAL    
+ */
+bool UringLoop::probeMultishotRecv() {
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, pair) < 0) return false;
+
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = pair[0];
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->user_data = OP_RECV; //  0  ,   
+    submitAndWait(0);
+
+    char byte = 'x';
+    bool supported = false;
+    if (write(pair[1], &byte, 1) == 1 && submitAndWait(1) >= 0) {
+        unsigned head = *m_cqHead;
+        if (head != __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE)) {
+            const io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+            supported = cqe.res > 0;
+            if (cqe.flags & IORING_CQE_F_BUFFER) {
+                recycleBuffer(static_cast<int>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+            }
+            __atomic_store_n(m_cqHead, head + 1, __ATOMIC_RELEASE);
+        }
+    }
+    ::shutdown(pair[0], SHUT_RDWR);
+    close(pair[0]);
+    close(pair[1]);
+    return supported;
+}
+
+/**
+ * @brief ,     (IORING_REGISTER_PROBE)
+ */
+bool UringLoop::probeOpcode(uint8_t opcode) {
+    constexpr unsigned OPS = 256;
+    std::vector<char> storage(sizeof(io_uring_probe) + OPS * sizeof(io_uring_probe_op));
+    auto* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+    if (syscall(__NR_io_uring_register, m_ringFd, IORING_REGISTER_PROBE, probe, OPS) < 0) return false;
+    return opcode <= probe->last_op && (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED);
+}
+
+/**
+ * @brief  :   SQE   CQE  
+ * @details     ; 
+ *   eventfd.  ,   start(),
+ *    NUMA  
+ */
+void UringLoop::run() {
+    pinThread();
+    moveToLocalNode(m_buffers.data(), m_buffers.size());
+    armAccept();
+    armWake();
+
+    while (m_running) {
+        if (submitAndWait(1, timerTimeoutMs()) < 0 && errno != EINTR && errno != EBUSY && errno != ETIME) {
+            logging::error("io_uring_enter failed: " + std::to_string(errno));
+            break;
+        }
+        m_now = Clock::now();
+
+        unsigned head = *m_cqHead;
+        unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+        const size_t events = tail - head;
+        for (; head != tail; ++head) {
+            const io_uring_cqe cqe = m_cqes[head & m_cqMask];
+            switch (cqe.user_data & OP_MASK) {
+            case OP_ACCEPT:
+                onAccept(cqe);
+                break;
+            case OP_RECV:
+                onRecv(cqe.user_data >> 3, cqe);
+                break;
+            case OP_SEND:
+                onSend(reinterpret_cast<UringSend*>(cqe.user_data & ~OP_MASK), cqe);
+                break;
+            case OP_WAKE:
+                if (m_running) armWake();
+                break;
+            }
+        }
+        __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+        //          
+        if (takeCompletionsPending()) m_server.onPosted(*this);
+        expireTimers();
+
+        //        
+        for (uint64_t connId : m_flushList) {
+            if (UringConnection* conn = find(connId)) {
+                conn->flushScheduled = false;
+                flushSends(*conn);
+            }
+        }
+        m_flushList.clear();
+        updateAdmission(events);
+        updateHandoff();
+    }
+}
+
+/**
+ * @brief   SQE,   SQ   
+ */
+io_uring_sqe* UringLoop::getSqe() {
+    if (m_sqLocalTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) > m_sqMask) {
+        submitAndWait(0);
+    }
+    io_uring_sqe* sqe = &m_sqes[m_sqLocalTail & m_sqMask];
+    std::memset(sqe, 0, sizeof(*sqe));
+    ++m_sqLocalTail;
+    ++m_toSubmit;
+    return sqe;
+}
+
+unsigned UringLoop::reserveSqes(unsigned count) {
+    unsigned free = m_sqMask + 1 - (m_sqLocalTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE));
+    if (free < count) {
+        submitAndWait(0);
+        free = m_sqMask + 1 - (m_sqLocalTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE));
+    }
+    return free;
+}
+
+/**
+ * @brief   SQE   waitNr 
+ * @param timeoutMs   (-1 -  );  
+ *   ETIME
+ */
+int UringLoop::submitAndWait(unsigned waitNr, int timeoutMs) {
+    __atomic_store_n(m_sqTail, m_sqLocalTail, __ATOMIC_RELEASE);
+    unsigned flags = waitNr > 0 ? IORING_ENTER_GETEVENTS : 0;
+    int result;
+    if (waitNr > 0 && timeoutMs >= 0) {
+        __kernel_timespec timeout{};
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000000;
+        io_uring_getevents_arg arg{};
+        arg.ts = reinterpret_cast<uint64_t>(&timeout);
+        result = uringEnter(m_ringFd, m_toSubmit, waitNr, flags | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    }
+    else {
+        result = uringEnter(m_ringFd, m_toSubmit, waitNr, flags);
+    }
+    if (result >= 0) {
+        m_toSubmit -= std::min(m_toSubmit, static_cast<unsigned>(result));
+    }
+    return result;
+}
+
+void UringLoop::armAccept() {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = m_listenSocket;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = OP_ACCEPT;
+    m_acceptArmed = true;
+}
+
+/**
+ * @details   multishot accept  IORING_OP_ASYNC_CANCEL:
+ *      listen;  
+ *  accept,      
+ */
+void UringLoop::enableAccept(bool enable) {
+    if (!enable) {
+        if (!m_acceptArmed) return;
+        io_uring_sqe* sqe = getSqe();
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = OP_ACCEPT;
+        sqe->user_data = OP_CANCEL;
+        return;
+    }
+    while (m_accepting && !m_pendingAccepts.empty()) {
+        SOCKET clientSocket = m_pendingAccepts.front();
+        m_pendingAccepts.pop_front();
+        admitSocket(clientSocket);
+    }
+    if (m_accepting && !m_acceptArmed) {
+        armAccept();
+    }
+}
+
+void UringLoop::armRecv(UringConnection& conn) {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = conn.socket;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->user_data = (conn.id << 3) | OP_RECV;
+}
+
+/**
+ * @brief   eventfd,  stop()  Reactor::post  
+ */
+void UringLoop::armWake() {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = m_wakeFd;
+    sqe->addr = reinterpret_cast<uint64_t>(&m_wakeValue);
+    sqe->len = sizeof(m_wakeValue);
+    sqe->user_data = OP_WAKE;
+}
+
+/**
+ * @brief   
+ * @details Multishot accept    , 
+ *     :     ,    listen
+ */
+void UringLoop::onAccept(const io_uring_cqe& cqe) {
+    if (!(cqe.flags & IORING_CQE_F_MORE)) {
+        m_acceptArmed = false;
+        if (m_running && m_accepting) armAccept();
+    }
+    if (cqe.res < 0) {
+        if (cqe.res != -ECANCELED) {
+            logging::error("Accept failed: " + std::to_string(-cqe.res));
+        }
+        return;
+    }
+
+    SOCKET clientSocket = cqe.res;
+    if (!m_accepting || m_connectionCount >= m_maxConnections) {
+        pauseForCapacity();
+        if (m_pendingAccepts.size() >= MAX_PENDING_ACCEPTS) {
+            rejectSocket(clientSocket, "server is full");
+            return;
+        }
+        m_pendingAccepts.push_back(clientSocket);
+        return;
+    }
+    admitSocket(clientSocket);
+}
+
+/**
+ * @brief        multishot recv
+ */
+void UringLoop::admitSocket(SOCKET clientSocket) {
+    auto conn = std::make_unique<UringConnection>();
+    conn->socket = clientSocket;
+    if (m_admission && m_admission->limitsSources()) {
+        sockaddr_storage address{};
+        socklen_t size = sizeof(address);
+        getpeername(clientSocket, (sockaddr*)&address, &size);
+        if (!admitSource(*conn, sourceAddress(address))) {
+            rejectSocket(clientSocket, "too many connections from one address");
+            return;
+        }
+    }
+    UringConnection& added = addConnection(std::move(conn));
+    metrics::add(metrics::Counter::Accepts);
+    logging::connected(clientSocket);
+    m_server.onConnect(*this, added);
+}
+
+/**
+ * @brief    multishot recv     
+ */
+UringConnection& UringLoop::addConnection(std::unique_ptr<UringConnection> conn) {
+    conn->id = m_nextConnId++;
+    initTimers(*conn);
+    registerConnection(*conn);
+    armRecv(*conn);
+    UringConnection& added = *conn;
+    m_connections.emplace(conn->id, std::move(conn));
+    m_connectionCount++;
+    if (m_connectionCount >= m_maxConnections) pauseForCapacity();
+    metrics::adjust(metrics::Gauge::Connections, 1);
+    return added;
+}
+
+/**
+ * @details    epoll-,    
+ *  
+ */
+Connection* UringLoop::adoptSocket(SOCKET socket, ConnectionClass connectionClass) {
+    auto conn = std::make_unique<UringConnection>();
+    conn->socket = socket;
+    conn->connectionClass = connectionClass;
+    sockaddr_storage address{};
+    socklen_t size = sizeof(address);
+    if (getpeername(socket, (sockaddr*)&address, &size) == 0) admitSource(*conn, sourceAddress(address));
+    UringConnection& added = addConnection(std::move(conn));
+    metrics::add(metrics::Counter::Adopted);
+    logging::connected(socket);
+    return &added;
+}
+
+/**
+ * @details Multishot recv    :    ,
+ *   .     
+ *  ,       CQE
+ * (finishHandoff). ,    , 
+ *        
+ */
+void UringLoop::handOffConnections() {
+    while (!m_pendingAccepts.empty()) {
+        SOCKET clientSocket = m_pendingAccepts.front();
+        m_pendingAccepts.pop_front();
+        admitSocket(clientSocket);
+    }
+    for (auto& entry : m_connections) {
+        UringConnection& conn = *entry.second;
+        if (conn.handingOff || conn.inFlight > 0 || !m_server.canHandOff(*this, conn)) continue;
+        io_uring_sqe* sqe = getSqe();
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = (conn.id << 3) | OP_RECV;
+        sqe->user_data = OP_CANCEL;
+        conn.handingOff = true;
+    }
+}
+
+/**
+ * @brief   multishot recv ,    
+ *   -  .    ,
+ * recv    resumeRead
+ * @details          
+ * ,  ,    
+ */
+void UringLoop::restartRecv(UringConnection& conn) {
+    conn.recvCancelling = false;
+    if (conn.handingOff) {
+        conn.handingOff = false;
+        if (m_server.handOff(*this, conn)) {
+            logging::disconnected(conn.socket, "handed off to the new process");
+            forget(conn);
+            return;
+        }
+    }
+    if (conn.readStopped()) {
+        conn.recvStopped = true;
+        return;
+    }
+    armRecv(conn);
+}
+
+/**
+ * @details ,     ,    
+ * :    
+ */
+void UringLoop::pauseRecv(UringConnection& conn) {
+    if (conn.recvCancelling || conn.recvStopped) return;
+    conn.recvCancelling = true;
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = (conn.id << 3) | OP_RECV;
+    sqe->user_data = OP_CANCEL;
+}
+
+/**
+ * @details     , recv  restartRecv   CQE
+ */
+void UringLoop::resumeRead(Connection& conn) {
+    auto& uconn = static_cast<UringConnection&>(conn);
+    if (!uconn.recvStopped) return;
+    uconn.recvStopped = false;
+    armRecv(uconn);
+}
+
+/**
+ * @brief    ;    ,
+ *       
+ */
+void UringLoop::onRecv(uint64_t connId, const io_uring_cqe& cqe) {
+    const bool hasBuffer = (cqe.flags & IORING_CQE_F_BUFFER) != 0;
+    const int bufferId = hasBuffer ? static_cast<int>(cqe.flags >> IORING_CQE_BUFFER_SHIFT) : -1;
+    const bool more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+
+    UringConnection* conn = find(connId);
+    if (!conn) {
+        if (hasBuffer) recycleBuffer(bufferId);
+        return;
+    }
+
+    if (cqe.res > 0 && hasBuffer) {
+        conn->lastActivity = m_now;
+        metrics::add(metrics::Counter::BytesIn, static_cast<uint64_t>(cqe.res));
+        m_bufferRefs[bufferId] = 1;
+        m_currentBuffer = bufferId;
+        const char* data = m_buffers.data() + static_cast<size_t>(bufferId) * m_bufferSize;
+        bool open = m_server.onData(*this, *conn, data, static_cast<size_t>(cqe.res));
+        m_currentBuffer = -1;
+        releaseBuffer(bufferId);
+        if (open) rearmQuickAck(*conn);
+        if (open && !more) restartRecv(*conn);
+        else if (open && conn->replyBacklog && !conn->handingOff) pauseRecv(*conn);
+        return;
+    }
+
+    if (hasBuffer) recycleBuffer(bufferId);
+    if (cqe.res == 0) {
+        closeConnection(*conn, "graceful disconnect");
+    }
+    else if (cqe.res == -ENOBUFS) {
+        //    :     
+        if (!more) restartRecv(*conn);
+    }
+    else if (cqe.res == -ECANCELED && (conn->handingOff || conn->recvCancelling)) {
+        restartRecv(*conn);
+    }
+    else {
+        closeConnection(*conn, "socket error: " + std::to_string(-cqe.res));
+    }
+}
+
+/**
+ * @brief   
+ * @details     :   
+ *  (-ECANCELED)       .
+ * SEND_ZC   CQE:  ( IORING_CQE_F_MORE)  
+ * (IORING_CQE_F_NOTIF),       
+ */
+void UringLoop::onSend(UringSend* op, const io_uring_cqe& cqe) {
+    if (cqe.flags & IORING_CQE_F_NOTIF) {
+        if (cqe.res & IORING_NOTIF_USAGE_ZC_COPIED) {
+            //     (, loopback): 
+            //     
+            metrics::add(metrics::Counter::ZeroCopyCopied);
+            if (UringConnection* conn = find(op->connId)) conn->zeroCopy = false;
+        }
+        if (--op->notifications == 0 && op->retired) releaseSend(op);
+        return;
+    }
+    const int result = cqe.res;
+    op->inFlight = false;
+    if (cqe.flags & IORING_CQE_F_MORE) op->notifications++;
+    UringConnection* conn = find(op->connId);
+    if (!conn) {
+        retireSend(op);
+        return;
+    }
+    conn->inFlight--;
+    if (result < 0 && result != -ECANCELED) {
+        closeConnection(*conn, "socket error: " + std::to_string(-result));
+        return;
+    }
+    if (result > 0) {
+        op->offset += static_cast<size_t>(result);
+        conn->queuedBytes -= static_cast<size_t>(result);
+        conn->lastWrite = m_now;
+        metrics::add(metrics::Counter::BytesOut, static_cast<uint64_t>(result));
+    }
+    //    ,   
+    //      
+    if (op->offset == op->size) {
+        conn->sendQueue.pop_front();
+        retireSend(op);
+    }
+    //  : ,  ,  
+    if (!m_topics.drain(*this, *conn)) return;
+    if (conn->sendQueue.empty()) {
+        cancelWriteDeadline(*conn);
+    }
+    else if (conn->inFlight == 0) {
+        scheduleFlush(*conn);
+    }
+}
+
+bool UringLoop::sendFrame(Connection& conn, protocol::MessageType type, uint8_t flags,
+    const char* payload, size_t size, const buffers::Buffer* storage) {
+    auto& uconn = static_cast<UringConnection&>(conn);
+    UringSend* op = newSend(uconn);
+    op->size = protocol::encodeHeader(op->header, type, flags, size);
+    op->data = op->header;
+    uconn.queuedBytes += op->size;
+    if (size > 0) queueSend(uconn, payload, size, storage);
+    scheduleFlush(uconn);
+    return true;
+}
+
+bool UringLoop::sendEncoded(Connection& conn, const buffers::Buffer& frame) {
+    auto& uconn = static_cast<UringConnection&>(conn);
+    queueSend(uconn, frame.data(), frame.size(), &frame);
+    scheduleFlush(uconn);
+    return true;
+}
+
+/**
+ * @brief     ;   
+ *       storage  
+ */
+void UringLoop::queueSend(UringConnection& conn, const char* data, size_t size, const buffers::Buffer* storage) {
+    UringSend* op = newSend(conn);
+    op->size = size;
+    conn.queuedBytes += size;
+    op->zeroCopy = m_sendZeroCopy && conn.zeroCopy && size >= m_zeroCopyThreshold;
+
+    const char* current = m_currentBuffer >= 0
+        ? m_buffers.data() + static_cast<size_t>(m_currentBuffer) * m_bufferSize : nullptr;
+    if (current && data >= current && data + size <= current + m_bufferSize) {
+        //    :     
+        op->bufferId = m_currentBuffer;
+        m_bufferRefs[m_currentBuffer]++;
+        op->data = data;
+    }
+    else if (storage) {
+        //   :      
+        op->storage = *storage;
+        op->data = data;
+    }
+    else {
+        op->storage = buffers::BufferPool::get(size);
+        std::memcpy(op->storage.data(), data, size);
+        op->data = op->storage.data();
+    }
+}
+
+/**
+ * @brief          
+ */
+UringSend* UringLoop::newSend(UringConnection& conn) {
+    UringSend* op = acquireSend();
+    op->connId = conn.id;
+    op->offset = 0;
+    conn.sendQueue.push_back(op);
+    return op;
+}
+
+void UringLoop::scheduleFlush(UringConnection& conn) {
+    armWriteDeadline(conn);
+    if (conn.flushScheduled) return;
+    conn.flushScheduled = true;
+    m_flushList.push_back(conn.id);
+}
+
+/**
+ * @brief      IOSQE_IO_LINK
+ * @details    ,   ,    .
+ *      io_uring_enter,   
+ *    : getSqe()   SQ  .
+ *      SQE,     
+ */
+void UringLoop::flushSends(UringConnection& conn) {
+    if (conn.inFlight > 0) return;
+
+    const unsigned wanted = static_cast<unsigned>(std::min<size_t>(conn.sendQueue.size(), MAX_LINKED));
+    const unsigned limit = std::max(1u, std::min(wanted, reserveSqes(wanted)));
+    unsigned count = 0;
+    io_uring_sqe* previous = nullptr;
+    for (UringSend* op : conn.sendQueue) {
+        if (count == limit) break;
+        if (previous) {
+            // MSG_MORE:      ,  
+            //     
+            previous->flags |= IOSQE_IO_LINK;
+            previous->msg_flags |= MSG_MORE;
+        }
+        io_uring_sqe* sqe = getSqe();
+        sqe->opcode = op->zeroCopy ? IORING_OP_SEND_ZC : IORING_OP_SEND;
+        sqe->fd = conn.socket;
+        sqe->addr = reinterpret_cast<uint64_t>(op->data + op->offset);
+        sqe->len = static_cast<uint32_t>(op->size - op->offset);
+        sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+        sqe->user_data = reinterpret_cast<uint64_t>(op) | OP_SEND;
+        if (op->zeroCopy) {
+            //  ,       
+            sqe->ioprio = IORING_SEND_ZC_REPORT_USAGE;
+            metrics::add(metrics::Counter::ZeroCopySends);
+        }
+        op->inFlight = true;
+        previous = sqe;
+        ++count;
+    }
+    conn.inFlight = count;
+}
+
+/**
+ * @brief     
+ */
+void UringLoop::recycleBuffer(int bufferId) {
+    io_uring_buf& buf = m_bufRing[m_bufTail & (BUFFER_COUNT - 1)];
+    buf.addr = reinterpret_cast<uint64_t>(m_buffers.data() + static_cast<size_t>(bufferId) * m_bufferSize);
+    buf.len = static_cast<uint32_t>(m_bufferSize);
+    buf.bid = static_cast<uint16_t>(bufferId);
+    ++m_bufTail;
+    //      resv  
+    __atomic_store_n(&m_bufRing[0].resv, m_bufTail, __ATOMIC_RELEASE);
+}
+
+void UringLoop::releaseBuffer(int bufferId) {
+    if (--m_bufferRefs[bufferId] == 0) {
+        recycleBuffer(bufferId);
+    }
+}
+
+UringSend* UringLoop::acquireSend() {
+    if (m_freeSends.empty()) {
+        m_sendOps.push_back(std::make_unique<UringSend>());
+        return m_sendOps.back().get();
+    }
+    UringSend* op = m_freeSends.back();
+    m_freeSends.pop_back();
+    return op;
+}
+
+void UringLoop::releaseSend(UringSend* op) {
+    if (op->bufferId >= 0) {
+        releaseBuffer(op->bufferId);
+        op->bufferId = -1;
+    }
+    op->storage.reset();
+    op->data = nullptr;
+    op->zeroCopy = false;
+    op->retired = false;
+    m_freeSends.push_back(op);
+}
+
+/**
+ * @brief     ;  
+ *  SEND_ZC      
+ */
+void UringLoop::retireSend(UringSend* op) {
+    if (op->notifications > 0) {
+        op->retired = true;
+        return;
+    }
+    releaseSend(op);
+}
+
+/**
+ * @brief  ; ,    , 
+ *    CQE
+ * @details     ,  (,   )
+ *   send,    epoll-
+ */
+void UringLoop::closeConnection(Connection& conn, const std::string& reason) {
+    auto& uconn = static_cast<UringConnection&>(conn);
+    logging::disconnected(uconn.socket, reason);
+    if (uconn.session) uconn.session->close();
+    for (UringSend* op : uconn.sendQueue) {
+        if (op->inFlight) continue;
+        if (uconn.inFlight == 0) {
+            ::send(uconn.socket, op->data + op->offset, op->size - op->offset, MSG_NOSIGNAL | MSG_DONTWAIT);
+        }
+        retireSend(op);
+    }
+    // shutdown  multishot recv   
+    ::shutdown(uconn.socket, SHUT_RDWR);
+    forget(uconn);
+}
+
+/**
+ * @brief         
+ * @warning    conn 
+ */
+void UringLoop::forget(UringConnection& conn) {
+    m_topics.remove(conn);
+    cancelTimers(conn);
+    releaseSource(conn);
+    unregisterConnection(conn);
+    closesocket(conn.socket);
+    m_connections.erase(conn.id);
+    m_connectionCount--;
+    metrics::adjust(metrics::Gauge::Connections, -1);
+}
+
+void UringLoop::wake() {
+    uint64_t one = 1;
+    ssize_t written = ::write(m_wakeFd, &one, sizeof(one));
+    (void)written;
+}
+
+Connection* UringLoop::findConnection(SOCKET, uint64_t id) {
+    return find(id);
+}
+
+UringConnection* UringLoop::find(uint64_t connId) {
+    auto it = m_connections.find(connId);
+    return it == m_connections.end() ? nullptr : it->second.get();
+}
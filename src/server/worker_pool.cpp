@@ -0,0 +1,118 @@
+#include "../include/server/worker_pool.hpp"
+#include "../include/server/metrics.hpp"
+#include <algorithm>
+
+WorkerPool::WorkerPool(unsigned workers, size_t queueDepth)
+    : m_queueDepth(std::max<size_t>(1, queueDepth)) {
+    if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < workers; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    stop();
+}
+
+void WorkerPool::start() {
+    if (m_running.exchange(true)) return;
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        m_workers[i]->thread = std::thread(&WorkerPool::run, this, i);
+    }
+    metrics::adjust(metrics::Gauge::PoolWorkers, static_cast<int64_t>(m_workers.size()));
+}
+
+void WorkerPool::stop() {
+    if (!m_running.exchange(false)) return;
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_wakeup.notify_all();
+    }
+    for (auto& worker : m_workers) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+    for (auto& worker : m_workers) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        for (WorkItem* item : worker->queue) {
+            delete item;
+        }
+        metrics::adjust(metrics::Gauge::PoolQueued, -static_cast<int64_t>(worker->queue.size()));
+        m_queued.fetch_sub(worker->queue.size());
+        worker->queue.clear();
+    }
+    metrics::adjust(metrics::Gauge::PoolWorkers, -static_cast<int64_t>(m_workers.size()));
+}
+
+/**
+ * @details      :   
+ * queueDepth    
+ */
+bool WorkerPool::submit(WorkItem* item) {
+    if (m_queued.fetch_add(1) >= m_queueDepth) {
+        m_queued.fetch_sub(1);
+        return false;
+    }
+    Worker& worker = *m_workers[m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_workers.size()];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!m_running.load(std::memory_order_relaxed)) {
+            m_queued.fetch_sub(1);
+            return false;
+        }
+        worker.queue.push_back(item);
+    }
+    metrics::adjust(metrics::Gauge::PoolQueued, 1);
+    // m_queued  ,   m_sleeping:  
+    //   ,   
+    if (m_sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_wakeup.notify_one();
+    }
+    return true;
+}
+
+WorkItem* WorkerPool::popLocal(Worker& worker) {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.queue.empty()) return nullptr;
+    WorkItem* item = worker.queue.front();
+    worker.queue.pop_front();
+    return item;
+}
+
+/**
+ * @details     :    , 
+ *         
+ */
+WorkItem* WorkerPool::steal(size_t thief) {
+    for (size_t offset = 1; offset < m_workers.size(); ++offset) {
+        Worker& victim = *m_workers[(thief + offset) % m_workers.size()];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.queue.empty()) continue;
+        WorkItem* item = victim.queue.back();
+        victim.queue.pop_back();
+        metrics::add(metrics::Counter::PoolSteals);
+        return item;
+    }
+    return nullptr;
+}
+
+void WorkerPool::run(size_t index) {
+    Worker& self = *m_workers[index];
+    while (m_running.load(std::memory_order_relaxed)) {
+        WorkItem* item = popLocal(self);
+        if (!item) item = steal(index);
+        if (item) {
+            m_queued.fetch_sub(1);
+            metrics::adjust(metrics::Gauge::PoolQueued, -1);
+            item->run();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleeping.fetch_add(1);
+        //     ,   try_lock: m_queued 
+        // ,    ,    
+        m_wakeup.wait(lock, [this]() { return !m_running.load() || m_queued.load() > 0; });
+        m_sleeping.fetch_sub(1);
+    }
+}
@@ -0,0 +1,121 @@
+#include "check.hpp"
+#include "../include/server/capture_writer.hpp"
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    using std::chrono::microseconds;
+
+    std::string tempPath(const std::string& name) {
+        const std::string path = "/tmp/capture_test_" + std::to_string(getpid()) + "_" + name;
+        unlink(path.c_str());
+        return path;
+    }
+
+    protocol::FrameView frameOf(protocol::MessageType type, const std::string& payload, uint8_t flags = protocol::FLAG_NONE) {
+        protocol::FrameView frame;
+        frame.type = type;
+        frame.flags = flags;
+        frame.payload = payload.data();
+        frame.size = payload.size();
+        return frame;
+    }
+
+    size_t fileSize(const std::string& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        return file ? static_cast<size_t>(file.tellg()) : 0;
+    }
+
+    /**
+     * @details   -    :    
+     *  ,  Reader      
+     */
+    void roundTrip() {
+        const std::string path = tempPath("round_trip");
+        CaptureWriter writer;
+        CHECK(writer.open(path, capture::FILE_HEADER_SIZE + 4 * capture::BLOCK_SIZE));
+        CaptureWriter other;
+        CHECK(!other.open(path, capture::FILE_HEADER_SIZE + capture::BLOCK_SIZE)); //   
+
+        const Clock::time_point start = Clock::now();
+        const std::vector<std::string> payloads = { "first", "", std::string(1000, 'x'), "news\nhello", "last" };
+        CaptureWriter::Cursor even;
+        CaptureWriter::Cursor odd;
+        for (size_t i = 0; i < payloads.size(); ++i) {
+            const uint8_t flags = i == 3 ? protocol::FLAG_COMPRESSED : protocol::FLAG_NONE;
+            const protocol::MessageType type = i == 3 ? protocol::MessageType::Publish : protocol::MessageType::Text;
+            writer.record(i % 2 ? odd : even, i % 2 ? 2 : 1, start + microseconds(10 * (i + 1)),
+                frameOf(type, payloads[i], flags));
+        }
+        writer.close();
+        //      
+        CHECK(fileSize(path) == capture::FILE_HEADER_SIZE + 2 * capture::BLOCK_SIZE);
+
+        capture::Reader reader;
+        std::string error;
+        CHECK(reader.open(path, error));
+        CHECK(reader.startedAtNs() > 0);
+        const std::vector<capture::Record>& records = reader.records();
+        CHECK(records.size() == payloads.size());
+        for (size_t i = 0; i < records.size() && i < payloads.size(); ++i) {
+            CHECK(std::string(records[i].payload, records[i].size) == payloads[i]);
+            CHECK(records[i].connection == (i % 2 ? 2u : 1u));
+            if (i > 0) CHECK(records[i].timeNs > records[i - 1].timeNs);
+        }
+        if (records.size() > 3) {
+            CHECK(records[3].type == protocol::MessageType::Publish && records[3].flags == protocol::FLAG_COMPRESSED);
+        }
+        unlink(path.c_str());
+    }
+
+    /**
+     * @details ,     , ; ,
+     *   ,     
+     */
+    void limitAndTruncatedFile() {
+        const std::string path = tempPath("limit");
+        CaptureWriter writer;
+        CHECK(writer.open(path, capture::FILE_HEADER_SIZE + capture::BLOCK_SIZE));
+        const std::string payload(64 * 1024, 'p');
+        const size_t fitting = capture::BLOCK_SIZE / capture::recordSize(payload.size());
+        CaptureWriter::Cursor cursor;
+        const Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < fitting + 5; ++i) {
+            writer.record(cursor, 1, start + microseconds(i), frameOf(protocol::MessageType::Text, payload));
+        }
+        writer.close();
+
+        capture::Reader reader;
+        std::string error;
+        CHECK(reader.open(path, error));
+        CHECK(reader.records().size() == fitting);
+
+        CHECK(truncate(path.c_str(), static_cast<off_t>(capture::FILE_HEADER_SIZE
+            + 3 * capture::recordSize(payload.size()) + 100)) == 0);
+        CHECK(reader.open(path, error));
+        CHECK(reader.records().size() == 3);
+        if (!reader.records().empty()) CHECK(std::string(reader.records()[0].payload, reader.records()[0].size) == payload);
+        unlink(path.c_str());
+    }
+
+    void rejectsForeignFiles() {
+        const std::string path = tempPath("foreign");
+        std::ofstream(path, std::ios::binary) << std::string(capture::FILE_HEADER_SIZE * 2, 'z');
+        capture::Reader reader;
+        std::string error;
+        CHECK(!reader.open(path, error));
+        CHECK(error == "not a capture file");
+        CHECK(!reader.open(path + ".missing", error));
+        unlink(path.c_str());
+    }
+}
+
+int main() {
+    roundTrip();
+    limitAndTruncatedFile();
+    rejectsForeignFiles();
+    return check::result();
+}
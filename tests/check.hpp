@@ -0,0 +1,38 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <cstdio>
+
+/**
+ * @namespace check
+ * @brief       .
+ *
+ *  -  ,   ctest.  
+ *   :   ,  check::result()
+ *     main.
+ */
+namespace check {
+    inline int& failures() {
+        static int count = 0;
+        return count;
+    }
+
+    inline void fail(const char* expression, const char* file, int line) {
+        std::printf("%s:%d: check failed: %s\n", file, line, expression);
+        ++failures();
+    }
+
+    /**
+     * @return 0 -   , 1 -  
+     */
+    inline int result() {
+        if (failures() > 0) {
+            std::printf("%d checks failed\n", failures());
+            return 1;
+        }
+        return 0;
+    }
+}
+
+#define CHECK(condition) ((condition) ? (void)0 : check::fail(#condition, __FILE__, __LINE__))
+#endif
@@ -0,0 +1,166 @@
+#include "check.hpp"
+#include "../include/server/connection_registry.hpp"
+#include <chrono>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+    /**
+     * @details    (owner = nullptr): send  close
+     *      , 
+     *     
+     */
+    SOCKET socketOf(size_t number) {
+        return static_cast<SOCKET>(100 + number);
+    }
+
+    void addAndFind() {
+        ConnectionRegistry registry(8);
+        const ConnectionRegistry::Id first = registry.add(socketOf(1), nullptr, 11);
+        const ConnectionRegistry::Id second = registry.add(socketOf(2), nullptr, 12);
+        CHECK(first != ConnectionRegistry::INVALID_ID && second != ConnectionRegistry::INVALID_ID);
+        CHECK(first != second);
+        CHECK(registry.size() == 2);
+        ConnectionRegistry::Ref ref = registry.find(second);
+        CHECK(ref && ref->socket == socketOf(2) && ref->engineId == 12);
+        CHECK(!registry.find(ConnectionRegistry::INVALID_ID));
+        CHECK(!registry.find(first + 1000)); //    
+    }
+
+    /**
+     * @details     ,  
+     *  :     
+     */
+    void staleIdAfterReuse() {
+        ConnectionRegistry registry(1);
+        const ConnectionRegistry::Id old = registry.add(socketOf(1), nullptr, 1);
+        registry.remove(old);
+        CHECK(registry.size() == 0);
+        CHECK(!registry.find(old));
+        CHECK(!registry.send(old, protocol::MessageType::Text, "x", 1));
+        CHECK(!registry.close(old, "test"));
+        registry.remove(old); //     
+        CHECK(registry.size() == 0);
+
+        const ConnectionRegistry::Id reused = registry.add(socketOf(2), nullptr, 2);
+        CHECK(reused != ConnectionRegistry::INVALID_ID && reused != old);
+        CHECK(static_cast<uint32_t>(reused) == static_cast<uint32_t>(old)); //   
+        CHECK(!registry.find(old));
+        CHECK(!registry.close(old, "test"));
+        registry.remove(old); //      
+        ConnectionRegistry::Ref ref = registry.find(reused);
+        CHECK(ref && ref->socket == socketOf(2));
+        CHECK(registry.size() == 1);
+    }
+
+    void capacityLimit() {
+        ConnectionRegistry registry(2);
+        const ConnectionRegistry::Id first = registry.add(socketOf(1), nullptr, 1);
+        CHECK(registry.add(socketOf(2), nullptr, 2) != ConnectionRegistry::INVALID_ID);
+        CHECK(registry.add(socketOf(3), nullptr, 3) == ConnectionRegistry::INVALID_ID);
+        registry.remove(first);
+        CHECK(registry.add(socketOf(3), nullptr, 3) != ConnectionRegistry::INVALID_ID);
+        CHECK(ConnectionRegistry(ConnectionRegistry::MAX_CAPACITY * 2).capacity() == ConnectionRegistry::MAX_CAPACITY);
+    }
+
+    /**
+     * @details   :      
+     *   ,   
+     */
+    void growthAndForEach() {
+        const size_t capacity = ConnectionRegistry::CHUNK_SIZE * 2 + 10;
+        ConnectionRegistry registry(capacity);
+        std::vector<ConnectionRegistry::Id> ids;
+        for (size_t i = 0; i < capacity; ++i) {
+            ids.push_back(registry.add(socketOf(i), nullptr, i));
+        }
+        CHECK(registry.add(socketOf(capacity), nullptr, capacity) == ConnectionRegistry::INVALID_ID);
+        CHECK(std::set<ConnectionRegistry::Id>(ids.begin(), ids.end()).size() == capacity);
+        CHECK(ids.back() != ConnectionRegistry::INVALID_ID);
+        CHECK(registry.size() == capacity);
+
+        for (size_t i = 0; i < capacity; i += 2) {
+            registry.remove(ids[i]);
+        }
+        size_t visited = 0;
+        bool matches = true;
+        registry.forEach([&](ConnectionRegistry::Id id, const ConnectionRegistry::Slot& slot) {
+            ++visited;
+            if (slot.engineId >= capacity || ids[slot.engineId] != id || slot.engineId % 2 == 0) matches = false;
+        });
+        CHECK(visited == capacity / 2);
+        CHECK(matches);
+        registry.owned(ids[1]).messages.store(5, std::memory_order_relaxed);
+        CHECK(registry.find(ids[1])->messages.load() == 5);
+    }
+
+    /**
+     * @details remove    ,   ,
+     *   
+     */
+    void removeWaitsForRef() {
+        ConnectionRegistry registry(4);
+        const ConnectionRegistry::Id id = registry.add(socketOf(1), nullptr, 1);
+        std::atomic<bool> removed{ false };
+        std::thread remover;
+        {
+            ConnectionRegistry::Ref ref = registry.find(id);
+            remover = std::thread([&] {
+                registry.remove(id);
+                removed = true;
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            CHECK(!removed);
+            CHECK(!registry.find(id)); //     
+        }
+        remover.join();
+        CHECK(removed);
+        CHECK(registry.size() == 0);
+    }
+
+    /**
+     * @details       
+     * :    ,   - 
+     */
+    void concurrentAddRemove() {
+        constexpr unsigned THREADS = 4;
+        constexpr unsigned ROUNDS = 20000;
+        ConnectionRegistry registry(THREADS * 2);
+        std::atomic<bool> consistent{ true };
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&registry, &consistent, t] {
+                for (unsigned round = 0; round < ROUNDS; ++round) {
+                    const uint64_t engineId = uint64_t(t) << 32 | round;
+                    const ConnectionRegistry::Id id = registry.add(socketOf(t), nullptr, engineId);
+                    if (id == ConnectionRegistry::INVALID_ID) {
+                        consistent = false;
+                        return;
+                    }
+                    {
+                        ConnectionRegistry::Ref ref = registry.find(id);
+                        if (!ref || ref->engineId != engineId) consistent = false;
+                    }
+                    registry.remove(id);
+                    if (registry.find(id)) consistent = false;
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        CHECK(consistent);
+        CHECK(registry.size() == 0);
+    }
+}
+
+int main() {
+    addAndFind();
+    staleIdAfterReuse();
+    capacityLimit();
+    growthAndForEach();
+    removeWaitsForRef();
+    concurrentAddRemove();
+    return check::result();
+}
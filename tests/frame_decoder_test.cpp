@@ -0,0 +1,140 @@
+#include "check.hpp"
+#include "../include/common/protocol.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+    /**
+     * @struct Decoded
+     * @brief  ,   .
+     */
+    struct Decoded {
+        protocol::MessageType type;
+        uint8_t flags;
+        std::string payload;
+    };
+
+    std::string frameBytes(protocol::MessageType type, const std::string& payload, uint8_t flags = protocol::FLAG_NONE) {
+        return protocol::encodeFrame(type, payload, flags);
+    }
+
+    /**
+     * @brief  stream    chunk  (0 - )
+     */
+    protocol::DecodeStatus decode(const std::string& stream, size_t chunk, std::vector<Decoded>& out,
+        size_t limit = protocol::MAX_PAYLOAD_SIZE) {
+        protocol::FrameDecoder decoder;
+        decoder.setLimit(limit);
+        if (chunk == 0) chunk = stream.size();
+        for (size_t offset = 0; offset < stream.size(); offset += chunk) {
+            const size_t size = std::min(chunk, stream.size() - offset);
+            protocol::DecodeStatus status = decoder.feed(stream.data() + offset, size,
+                [&out](const protocol::FrameView& frame) {
+                    out.push_back({ frame.type, frame.flags, std::string(frame.payload, frame.size) });
+                    return true;
+                });
+            if (status != protocol::DecodeStatus::Ok) return status;
+        }
+        return decoder.hasPartial() ? protocol::DecodeStatus::Malformed : protocol::DecodeStatus::Ok;
+    }
+
+    void wholeFramesInOneChunk() {
+        const std::string stream = frameBytes(protocol::MessageType::Text, "one")
+            + frameBytes(protocol::MessageType::Subscribe, "news")
+            + frameBytes(protocol::MessageType::Text, "")
+            + frameBytes(protocol::MessageType::Publish, "news\nhello", protocol::FLAG_COMPRESSED);
+        std::vector<Decoded> frames;
+        CHECK(decode(stream, 0, frames) == protocol::DecodeStatus::Ok);
+        CHECK(frames.size() == 4);
+        if (frames.size() != 4) return;
+        CHECK(frames[0].type == protocol::MessageType::Text && frames[0].payload == "one");
+        CHECK(frames[1].type == protocol::MessageType::Subscribe && frames[1].payload == "news");
+        CHECK(frames[2].type == protocol::MessageType::Text && frames[2].payload.empty());
+        CHECK(frames[3].type == protocol::MessageType::Publish && frames[3].payload == "news\nhello");
+        CHECK(frames[3].flags == protocol::FLAG_COMPRESSED);
+    }
+
+    /**
+     * @details  300     varint,  
+     *    ,   ,   
+     */
+    void everySplitPoint() {
+        const std::string first(300, 'a');
+        const std::string second = "tail";
+        const std::string stream = frameBytes(protocol::MessageType::Text, first) + frameBytes(protocol::MessageType::Error, second);
+        for (size_t chunk = 1; chunk <= stream.size(); ++chunk) {
+            std::vector<Decoded> frames;
+            CHECK(decode(stream, chunk, frames) == protocol::DecodeStatus::Ok);
+            CHECK(frames.size() == 2);
+            if (frames.size() != 2) continue;
+            CHECK(frames[0].payload == first);
+            CHECK(frames[1].type == protocol::MessageType::Error && frames[1].payload == second);
+        }
+    }
+
+    void largeFrameAcrossManyChunks() {
+        std::string payload(protocol::MAX_PAYLOAD_SIZE, 'x');
+        for (size_t i = 0; i < payload.size(); i += 4096) payload[i] = static_cast<char>('a' + i / 4096 % 26);
+        std::vector<Decoded> frames;
+        CHECK(decode(frameBytes(protocol::MessageType::Text, payload), 65536, frames) == protocol::DecodeStatus::Ok);
+        CHECK(frames.size() == 1 && frames[0].payload == payload);
+    }
+
+    void limitsAndMalformedHeaders() {
+        std::vector<Decoded> frames;
+        CHECK(decode(frameBytes(protocol::MessageType::Text, std::string(101, 'a')), 0, frames, 100) == protocol::DecodeStatus::TooLarge);
+        CHECK(frames.empty());
+        CHECK(decode(frameBytes(protocol::MessageType::Text, std::string(100, 'a')), 0, frames, 100) == protocol::DecodeStatus::Ok);
+        CHECK(frames.size() == 1);
+
+        //    ,      
+        frames.clear();
+        CHECK(decode(frameBytes(protocol::MessageType::Text, std::string(101, 'a')), 1, frames, 100) == protocol::DecodeStatus::TooLarge);
+        CHECK(frames.empty());
+
+        // Varint  MAX_VARINT_SIZE 
+        const std::string endless(protocol::MAX_VARINT_SIZE + 2, '\x80');
+        CHECK(decode(endless, 0, frames) == protocol::DecodeStatus::Malformed);
+        CHECK(decode(endless, 1, frames) == protocol::DecodeStatus::Malformed);
+    }
+
+    void handlerStopsDecoding() {
+        const std::string stream = frameBytes(protocol::MessageType::Text, "one") + frameBytes(protocol::MessageType::Text, "two");
+        protocol::FrameDecoder decoder;
+        int calls = 0;
+        const protocol::DecodeStatus status = decoder.feed(stream.data(), stream.size(),
+            [&calls](const protocol::FrameView&) {
+                ++calls;
+                return false;
+            });
+        CHECK(status == protocol::DecodeStatus::Stopped);
+        CHECK(calls == 1);
+    }
+
+    void resetDropsPartialFrame() {
+        const std::string stream = frameBytes(protocol::MessageType::Text, "abcdef");
+        protocol::FrameDecoder decoder;
+        std::vector<std::string> payloads;
+        auto collect = [&payloads](const protocol::FrameView& frame) {
+            payloads.emplace_back(frame.payload, frame.size);
+            return true;
+        };
+        CHECK(decoder.feed(stream.data(), 4, collect) == protocol::DecodeStatus::Ok);
+        CHECK(decoder.hasPartial());
+        decoder.reset();
+        CHECK(!decoder.hasPartial());
+        CHECK(decoder.feed(stream.data(), stream.size(), collect) == protocol::DecodeStatus::Ok);
+        CHECK(payloads.size() == 1 && payloads[0] == "abcdef");
+    }
+}
+
+int main() {
+    wholeFramesInOneChunk();
+    everySplitPoint();
+    largeFrameAcrossManyChunks();
+    limitsAndMalformedHeaders();
+    handlerStopsDecoding();
+    resetDropsPartialFrame();
+    return check::result();
+}
@@ -0,0 +1,161 @@
+#include "check.hpp"
+#include "../include/server/input_validator.hpp"
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+    const InputValidator::Kernel KERNELS[] = {
+        InputValidator::Kernel::Scalar,
+        InputValidator::Kernel::Sse2,
+        InputValidator::Kernel::Avx2
+    };
+    //    16-  32-     AVX2
+    const size_t SIZES[] = { 0, 1, 15, 16, 17, 31, 32, 33, 47, 48, 49, 63, 64, 65, 95, 96, 97, 127, 128, 129 };
+
+    /**
+     * @brief        data
+     * @details     0..3,  
+     *   
+     */
+    void checkKernels(const std::string& data) {
+        const size_t expected = InputValidator::findInvalid(InputValidator::Kernel::Scalar, data.data(), data.size());
+        std::vector<char> shifted(data.size() + 4);
+        for (size_t shift = 0; shift < 4; ++shift) {
+            if (!data.empty()) std::memcpy(shifted.data() + shift, data.data(), data.size());
+            for (InputValidator::Kernel kernel : KERNELS) {
+                if (!InputValidator::isSupported(kernel)) continue;
+                const size_t actual = InputValidator::findInvalid(kernel, shifted.data() + shift, data.size());
+                if (actual != expected) {
+                    std::printf("%s: size %zu, shift %zu: expected %zu, got %zu\n",
+                        InputValidator::kernelName(kernel), data.size(), shift, expected, actual);
+                }
+                CHECK(actual == expected);
+            }
+        }
+    }
+
+    void scalarRules() {
+        const std::string text = "Hello,\tworld\n";
+        CHECK(InputValidator::findInvalid(InputValidator::Kernel::Scalar, text.data(), text.size()) == InputValidator::npos);
+        for (int value = 0; value < 256; ++value) {
+            const char byte = static_cast<char>(value);
+            const bool invalid = (value < 32 && value != 0x09 && value != 0x0A) || value == 0x7F;
+            const size_t found = InputValidator::findInvalid(InputValidator::Kernel::Scalar, &byte, 1);
+            CHECK(found == (invalid ? 0 : InputValidator::npos));
+        }
+    }
+
+    void invalidByteInEveryLane() {
+        for (size_t size : SIZES) {
+            std::string data(size, 'a');
+            checkKernels(data);
+            for (size_t pos = 0; pos < size; ++pos) {
+                for (int value : { 0x00, 0x01, 0x08, 0x0B, 0x0D, 0x1F, 0x7F }) {
+                    data[pos] = static_cast<char>(value);
+                    checkKernels(data);
+                    CHECK(InputValidator::findInvalid(data.data(), data.size()) == pos);
+                }
+                //    
+                for (int value : { 0x09, 0x0A, 0x20, 0x7E, 0x80 }) {
+                    data[pos] = static_cast<char>(value);
+                    checkKernels(data);
+                }
+                data[pos] = 'a';
+            }
+        }
+    }
+
+    void twoInvalidBytesReportFirst() {
+        for (size_t size : SIZES) {
+            if (size < 2) continue;
+            for (size_t first = 0; first + 1 < size; ++first) {
+                std::string data(size, 'b');
+                data[first] = '\x01';
+                data[size - 1] = '\x7F';
+                checkKernels(data);
+                CHECK(InputValidator::findInvalid(data.data(), data.size()) == first);
+            }
+        }
+    }
+
+    void nonAsciiIsValid() {
+        //   UTF-8    0x80..0xFF:       
+        const std::string utf8 = "\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82, \xD0\xBC\xD0\xB8\xD1\x80! "
+            "\xE2\x82\xAC \xF0\x9F\x98\x80";
+        CHECK(InputValidator::findInvalid(utf8.data(), utf8.size()) == InputValidator::npos);
+        checkKernels(utf8);
+        std::string high;
+        for (int value = 0x80; value < 0x100; ++value) high.push_back(static_cast<char>(value));
+        CHECK(InputValidator::findInvalid(high.data(), high.size()) == InputValidator::npos);
+        checkKernels(high);
+        for (size_t size : SIZES) {
+            checkKernels(std::string(size, '\xFF'));
+        }
+    }
+
+    void messageLimits() {
+        size_t offset = 0;
+        CHECK(!InputValidator::validateMessage(nullptr, 0, &offset));
+        CHECK(offset == InputValidator::npos);
+        CHECK(InputValidator::validateMessage(std::string("ok")));
+        CHECK(!InputValidator::validateMessage("a\x01" "b", 3, &offset));
+        CHECK(offset == 1);
+        const std::string tooLong(protocol::MAX_PAYLOAD_SIZE + 1, 'a');
+        CHECK(!InputValidator::validateMessage(tooLong.data(), tooLong.size(), &offset));
+        CHECK(offset == InputValidator::npos);
+    }
+
+    /**
+     * @brief validateBatch      ,  
+     *    
+     */
+    void batchMatchesSingleFrames() {
+        std::vector<std::string> payloads;
+        for (size_t size : SIZES) {
+            if (size > 0) payloads.push_back(std::string(size, 'c'));
+        }
+        std::vector<protocol::FrameView> frames(payloads.size());
+        for (size_t i = 0; i < payloads.size(); ++i) {
+            frames[i].payload = payloads[i].data();
+            frames[i].size = payloads[i].size();
+        }
+        InputValidator::BatchResult result = InputValidator::validateBatch(frames.data(), frames.size());
+        CHECK(result.frame == frames.size());
+        CHECK(result.offset == InputValidator::npos);
+        result = InputValidator::validateBatch(frames.data(), 0);
+        CHECK(result.frame == 0);
+
+        for (size_t bad = 0; bad < payloads.size(); ++bad) {
+            std::string saved = payloads[bad];
+            const size_t pos = payloads[bad].size() / 2;
+            payloads[bad][pos] = '\x1B';
+            result = InputValidator::validateBatch(frames.data(), frames.size());
+            CHECK(result.frame == bad);
+            CHECK(result.offset == pos);
+            //       
+            if (bad + 1 < payloads.size()) payloads[bad + 1][0] = '\x00';
+            result = InputValidator::validateBatch(frames.data(), frames.size());
+            CHECK(result.frame == bad);
+            if (bad + 1 < payloads.size()) payloads[bad + 1][0] = 'c';
+            payloads[bad] = saved;
+        }
+
+        protocol::FrameView empty[2];
+        empty[0] = frames[0];
+        result = InputValidator::validateBatch(empty, 2);
+        CHECK(result.frame == 1);
+        CHECK(result.offset == InputValidator::npos);
+    }
+}
+
+int main() {
+    std::printf("Active kernel: %s\n", InputValidator::kernelName(InputValidator::kernel()));
+    scalarRules();
+    invalidByteInEveryLane();
+    twoInvalidBytesReportFirst();
+    nonAsciiIsValid();
+    messageLimits();
+    batchMatchesSingleFrames();
+    return check::result();
+}
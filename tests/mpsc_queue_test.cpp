@@ -0,0 +1,86 @@
+#include "check.hpp"
+#include "../include/server/mpsc_queue.hpp"
+#include <thread>
+#include <vector>
+
+namespace {
+    /**
+     * @struct Item
+     * @brief  :      .
+     */
+    struct Item : MpscNode {
+        unsigned producer = 0;
+        unsigned seq = 0;
+    };
+
+    void singleThreadOrder() {
+        MpscQueue<Item> queue;
+        CHECK(queue.pop() == nullptr);
+        std::vector<Item> items(3);
+        for (unsigned i = 0; i < items.size(); ++i) {
+            items[i].seq = i;
+            queue.push(&items[i]);
+        }
+        for (unsigned i = 0; i < items.size(); ++i) {
+            Item* item = queue.pop();
+            CHECK(item == &items[i]);
+        }
+        CHECK(queue.pop() == nullptr);
+        // ,   ,   
+        queue.push(&items[0]);
+        CHECK(queue.pop() == &items[0]);
+        CHECK(queue.pop() == nullptr);
+    }
+
+    /**
+     * @details   ,   :
+     *           
+     */
+    void concurrentProducers() {
+        constexpr unsigned PRODUCERS = 4;
+        constexpr unsigned PER_PRODUCER = 200000;
+        MpscQueue<Item> queue;
+        std::vector<std::vector<Item>> items(PRODUCERS);
+        for (std::vector<Item>& own : items) {
+            own = std::vector<Item>(PER_PRODUCER);
+        }
+        std::vector<std::thread> producers;
+        for (unsigned p = 0; p < PRODUCERS; ++p) {
+            producers.emplace_back([&queue, &items, p] {
+                for (unsigned i = 0; i < PER_PRODUCER; ++i) {
+                    items[p][i].producer = p;
+                    items[p][i].seq = i;
+                    queue.push(&items[p][i]);
+                }
+            });
+        }
+
+        std::vector<unsigned> next(PRODUCERS, 0);
+        size_t received = 0;
+        bool ordered = true;
+        while (received < size_t(PRODUCERS) * PER_PRODUCER) {
+            Item* item = queue.pop();
+            if (!item) {
+                std::this_thread::yield();
+                continue;
+            }
+            if (item->producer >= PRODUCERS || item->seq != next[item->producer]) ordered = false;
+            else ++next[item->producer];
+            ++received;
+        }
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+        CHECK(ordered);
+        CHECK(queue.pop() == nullptr);
+        for (unsigned p = 0; p < PRODUCERS; ++p) {
+            CHECK(next[p] == PER_PRODUCER);
+        }
+    }
+}
+
+int main() {
+    singleThreadOrder();
+    concurrentProducers();
+    return check::result();
+}
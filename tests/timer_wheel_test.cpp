@@ -0,0 +1,140 @@
+#include "check.hpp"
+#include "../include/server/timer_wheel.hpp"
+#include <random>
+#include <vector>
+
+namespace {
+    using Clock = TimerWheel::Clock;
+    using std::chrono::milliseconds;
+
+    const Clock::time_point ORIGIN{};
+    constexpr milliseconds RESOLUTION{ 10 };
+
+    /**
+     * @struct Timer
+     * @brief  :    .
+     */
+    struct Timer {
+        TimerNode node;
+        Clock::time_point deadline;
+        Clock::time_point firedAt;
+        int fired = 0;
+    };
+
+    /**
+     * @details       (  );
+     *     ,       
+     */
+    void firesOnceWithinATick() {
+        TimerWheel wheel(RESOLUTION, ORIGIN);
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int64_t> offsets(0, 2 * 3600 * 1000);
+        std::vector<Timer> timers(2000);
+        for (Timer& timer : timers) {
+            timer.node.owner = &timer;
+            timer.deadline = ORIGIN + milliseconds(offsets(rng));
+            wheel.arm(timer.node, timer.deadline);
+        }
+        CHECK(wheel.size() == timers.size());
+
+        Clock::time_point now = ORIGIN;
+        const Clock::time_point end = ORIGIN + milliseconds(2 * 3600 * 1000) + 2 * RESOLUTION;
+        while (now < end) {
+            now += RESOLUTION;
+            wheel.advance(now, [now](TimerNode& node) {
+                Timer& timer = *static_cast<Timer*>(node.owner);
+                ++timer.fired;
+                timer.firedAt = now;
+            });
+        }
+        CHECK(wheel.size() == 0);
+        for (const Timer& timer : timers) {
+            CHECK(timer.fired == 1);
+            CHECK(timer.firedAt >= timer.deadline);
+            CHECK(timer.firedAt - timer.deadline < RESOLUTION + RESOLUTION);
+        }
+    }
+
+    void cancelAndRearm() {
+        TimerWheel wheel(RESOLUTION, ORIGIN);
+        Timer cancelled;
+        Timer moved;
+        wheel.arm(cancelled.node, ORIGIN + milliseconds(100));
+        wheel.arm(moved.node, ORIGIN + milliseconds(100));
+        CHECK(wheel.size() == 2);
+        wheel.cancel(cancelled.node);
+        CHECK(!cancelled.node.armed());
+        wheel.cancel(cancelled.node); //     
+        wheel.arm(moved.node, ORIGIN + milliseconds(5000)); //   
+        CHECK(wheel.size() == 1);
+
+        size_t fired = wheel.advance(ORIGIN + milliseconds(1000), [](TimerNode&) {});
+        CHECK(fired == 0);
+        fired = wheel.advance(ORIGIN + milliseconds(5000), [&moved](TimerNode& node) { CHECK(&node == &moved.node); });
+        CHECK(fired == 1);
+        CHECK(wheel.size() == 0);
+    }
+
+    /**
+     * @details         
+     *  :    
+     */
+    void handlerChangesTheBatch() {
+        TimerWheel wheel(RESOLUTION, ORIGIN);
+        Timer first;
+        Timer second;
+        first.node.owner = &first;
+        second.node.owner = &second;
+        wheel.arm(first.node, ORIGIN + milliseconds(50));
+        wheel.arm(second.node, ORIGIN + milliseconds(50));
+        int calls = 0;
+        wheel.advance(ORIGIN + milliseconds(50), [&](TimerNode& node) {
+            ++calls;
+            Timer& other = &node == &first.node ? second : first;
+            wheel.cancel(other.node);
+            wheel.arm(node, ORIGIN + milliseconds(200));
+        });
+        CHECK(calls == 1);
+        CHECK(wheel.size() == 1);
+        calls = 0;
+        wheel.advance(ORIGIN + milliseconds(200), [&calls](TimerNode&) { ++calls; });
+        CHECK(calls == 1);
+    }
+
+    void pastDeadlineAndLongJump() {
+        TimerWheel wheel(RESOLUTION, ORIGIN);
+        wheel.advance(ORIGIN + milliseconds(1000), [](TimerNode&) {});
+        Timer late;
+        wheel.arm(late.node, ORIGIN); //  :    
+        CHECK(wheel.advance(ORIGIN + milliseconds(1000), [](TimerNode&) {}) == 0);
+        CHECK(wheel.advance(ORIGIN + milliseconds(1010), [](TimerNode&) {}) == 1);
+
+        std::vector<Timer> timers(100);
+        for (size_t i = 0; i < timers.size(); ++i) {
+            wheel.arm(timers[i].node, ORIGIN + milliseconds(2000 + 60000 * static_cast<int64_t>(i)));
+        }
+        //         
+        CHECK(wheel.advance(ORIGIN + milliseconds(2000 + 60000 * 49), [](TimerNode&) {}) == 50);
+        CHECK(wheel.size() == 50);
+    }
+
+    void timeoutUntilNextEvent() {
+        TimerWheel wheel(RESOLUTION, ORIGIN);
+        CHECK(wheel.timeoutMs(ORIGIN) == -1);
+        Timer timer;
+        wheel.arm(timer.node, ORIGIN + milliseconds(1000));
+        const int timeout = wheel.timeoutMs(ORIGIN);
+        //   -      ,    
+        CHECK(timeout > 0 && timeout <= 1000);
+        CHECK(wheel.timeoutMs(ORIGIN + milliseconds(2000)) == 0);
+    }
+}
+
+int main() {
+    firesOnceWithinATick();
+    cancelAndRearm();
+    handlerChangesTheBatch();
+    pastDeadlineAndLongJump();
+    timeoutUntilNextEvent();
+    return check::result();
+}